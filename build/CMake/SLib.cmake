@@ -66,13 +66,16 @@ endif ()
 
 set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/core/animation.cpp"
+ "${SLIB_PATH}/src/slib/core/allocator.cpp"
  "${SLIB_PATH}/src/slib/core/app.cpp"
  "${SLIB_PATH}/src/slib/core/asm_x64.cpp"
  "${SLIB_PATH}/src/slib/core/asset.cpp"
  "${SLIB_PATH}/src/slib/core/async.cpp"
  "${SLIB_PATH}/src/slib/core/async_epoll.cpp"
+ "${SLIB_PATH}/src/slib/core/async_io_uring.cpp"
  "${SLIB_PATH}/src/slib/core/atomic.cpp"
  "${SLIB_PATH}/src/slib/core/base.cpp"
+ "${SLIB_PATH}/src/slib/core/cache.cpp"
  "${SLIB_PATH}/src/slib/core/charset.cpp"
  "${SLIB_PATH}/src/slib/core/charset_ext.cpp"
  "${SLIB_PATH}/src/slib/core/collection.cpp"
@@ -83,6 +86,7 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/core/event.cpp"
  "${SLIB_PATH}/src/slib/core/event_unix.cpp"
  "${SLIB_PATH}/src/slib/core/file.cpp"
+ "${SLIB_PATH}/src/slib/core/file_btree.cpp"
  "${SLIB_PATH}/src/slib/core/file_unix.cpp"
  "${SLIB_PATH}/src/slib/core/global_unique_instance.cpp"
  "${SLIB_PATH}/src/slib/core/global_unique_instance_unix.cpp"
@@ -97,7 +101,9 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/core/memory.cpp"
  "${SLIB_PATH}/src/slib/core/mutex.cpp"
  "${SLIB_PATH}/src/slib/core/object.cpp"
+ "${SLIB_PATH}/src/slib/core/open_file_cache.cpp"
  "${SLIB_PATH}/src/slib/core/parse.cpp"
+ "${SLIB_PATH}/src/slib/core/parallel_sort.cpp"
  "${SLIB_PATH}/src/slib/core/pipe.cpp"
  "${SLIB_PATH}/src/slib/core/pipe_unix.cpp"
  "${SLIB_PATH}/src/slib/core/preference.cpp"
@@ -124,6 +130,7 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/core/time.cpp"
  "${SLIB_PATH}/src/slib/core/time_unix.cpp"
  "${SLIB_PATH}/src/slib/core/timer.cpp"
+ "${SLIB_PATH}/src/slib/core/timer_wheel.cpp"
  "${SLIB_PATH}/src/slib/core/variant.cpp"
  "${SLIB_PATH}/src/slib/core/xml.cpp"
 
@@ -178,6 +185,7 @@ set (SLIB_CORE_FILES
  "${SLIB_PATH}/src/slib/network/dns.cpp"
  "${SLIB_PATH}/src/slib/network/ethernet.cpp"
  "${SLIB_PATH}/src/slib/network/http_common.cpp"
+ "${SLIB_PATH}/src/slib/network/http_content_cache.cpp"
  "${SLIB_PATH}/src/slib/network/http_io.cpp"
  "${SLIB_PATH}/src/slib/network/http_server.cpp"
  "${SLIB_PATH}/src/slib/network/http_openssl.cpp"
@@ -0,0 +1,94 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include <slib/core.h>
+
+using namespace slib;
+
+static const sl_uint32 KEYS_COUNT = 100000;
+static const sl_uint32 OPERATIONS_PER_THREAD = 1000000;
+// percent of the writes in the operations
+static const sl_uint32 WRITE_RATIO = 10;
+
+template <class MAP>
+static double Run(MAP* map, sl_uint32 nThreads)
+{
+	sl_int32 nReady = 0;
+	sl_int32* pReady = &nReady;
+	sl_bool flagStart = sl_false;
+	volatile sl_bool* pStart = &flagStart;
+	List< Ref<Thread> > threads;
+	for (sl_uint32 i = 0; i < nThreads; i++) {
+		threads.add(Thread::start([map, i, pReady, pStart]() {
+			sl_uint32 seed = i * 7919 + 1;
+			sl_uint64 sum = 0;
+			Base::interlockedIncrement32(pReady);
+			while (!(*pStart)) {
+				System::yield();
+			}
+			for (sl_uint32 k = 0; k < OPERATIONS_PER_THREAD; k++) {
+				seed = seed * 1103515245 + 12345;
+				sl_uint32 key = (seed >> 8) % KEYS_COUNT;
+				if ((seed >> 4) % 100 < WRITE_RATIO) {
+					map->put(key, k);
+				} else {
+					sl_uint32 value;
+					if (map->get(key, &value)) {
+						sum += value;
+					}
+				}
+			}
+			if (sum == 1) {
+				Println("");
+			}
+		}));
+	}
+	while (Base::interlockedAdd32(pReady, 0) < (sl_int32)nThreads) {
+		System::yield();
+	}
+	TimeCounter tc;
+	flagStart = sl_true;
+	for (auto& thread : threads) {
+		thread->finishAndWait();
+	}
+	double sec = (double)(tc.getElapsedMilliseconds()) / 1000.0;
+	return (double)nThreads * OPERATIONS_PER_THREAD / (sec > 0 ? sec : 0.001);
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("Processors: %d, Keys: %d, Writes: %d%%", System::getProcessorsCount(), KEYS_COUNT, WRITE_RATIO);
+	Println("Threads\tCHashMap (ops/sec)\tConcurrentHashMap (ops/sec)");
+	for (sl_uint32 nThreads = 1; nThreads <= 64; nThreads <<= 1) {
+		CHashMap<sl_uint32, sl_uint32> locked;
+		ConcurrentHashMap<sl_uint32, sl_uint32> concurrent;
+		for (sl_uint32 i = 0; i < KEYS_COUNT; i++) {
+			locked.put(i, i);
+			concurrent.put(i, i);
+		}
+		double opsLocked = Run(&locked, nThreads);
+		double opsConcurrent = Run(&concurrent, nThreads);
+		Println("%d\t%d\t%d", nThreads, (sl_int64)opsLocked, (sl_int64)opsConcurrent);
+	}
+	return 0;
+}
@@ -0,0 +1,208 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+static const sl_size BYTES_PER_RUN = 256 << 20;
+
+// the byte hash used before XXH3
+static sl_uint32 HashBytes_Fnv1a(const void* _buf, sl_size n)
+{
+	const sl_uint8* buf = (const sl_uint8*)_buf;
+	sl_uint32 hash = 0x811C9DC5;
+	for (sl_size i = 0; i < n; i++) {
+		hash = (hash ^ buf[i]) * 0x01000193;
+	}
+	return hash;
+}
+
+static sl_uint64 Random64(sl_uint64& state)
+{
+	state += SLIB_UINT64(0x9E3779B97F4A7C15);
+	sl_uint64 z = state;
+	z = (z ^ (z >> 30)) * SLIB_UINT64(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * SLIB_UINT64(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
+
+template <class FN>
+static sl_int64 MeasureThroughput(const sl_uint8* data, sl_size sizeData, sl_size sizeKey, const FN& fn)
+{
+	sl_size nKeys = sizeData / sizeKey;
+	sl_size nRuns = BYTES_PER_RUN / (nKeys * sizeKey);
+	if (!nRuns) {
+		nRuns = 1;
+	}
+	volatile sl_uint64 sink = 0;
+	sl_uint64 best = 0;
+	for (sl_uint32 k = 0; k < 3; k++) {
+		TimeCounter tc;
+		sl_uint64 h = 0;
+		for (sl_size r = 0; r < nRuns; r++) {
+			for (sl_size i = 0; i < nKeys; i++) {
+				h += fn(data + i * sizeKey, sizeKey);
+			}
+		}
+		sink = sink + h;
+		sl_uint64 ms = tc.getElapsedMilliseconds();
+		if (!ms) {
+			ms = 1;
+		}
+		sl_uint64 speed = (sl_uint64)(nRuns * nKeys * sizeKey) * 1000 / ms;
+		if (speed > best) {
+			best = speed;
+		}
+	}
+	// MB/sec
+	return (sl_int64)(best >> 20);
+}
+
+// Flips each input bit of random keys and returns the worst deviation (in per-mille) from 50% of the flip probability of each output bit
+template <class FN>
+static sl_uint32 MeasureAvalanche(sl_size sizeKey, sl_uint32 nOutputBits, const FN& fn)
+{
+	const sl_uint32 nSamples = 10000;
+	sl_uint8 key[64];
+	sl_uint32 counts[512][64];
+	Base::zeroMemory(counts, sizeof(counts));
+	sl_uint64 state = sizeKey;
+	for (sl_uint32 s = 0; s < nSamples; s++) {
+		for (sl_size i = 0; i < sizeKey; i++) {
+			key[i] = (sl_uint8)(Random64(state));
+		}
+		sl_uint64 h = fn(key, sizeKey);
+		for (sl_size bit = 0; bit < sizeKey * 8; bit++) {
+			key[bit >> 3] ^= (sl_uint8)(1 << (bit & 7));
+			sl_uint64 d = h ^ fn(key, sizeKey);
+			key[bit >> 3] ^= (sl_uint8)(1 << (bit & 7));
+			for (sl_uint32 o = 0; o < nOutputBits; o++) {
+				counts[bit][o] += (sl_uint32)((d >> o) & 1);
+			}
+		}
+	}
+	sl_uint32 worst = 0;
+	for (sl_size bit = 0; bit < sizeKey * 8; bit++) {
+		for (sl_uint32 o = 0; o < nOutputBits; o++) {
+			sl_int32 bias = (sl_int32)(counts[bit][o] * 1000 / nSamples) - 500;
+			if (bias < 0) {
+				bias = -bias;
+			}
+			if ((sl_uint32)bias > worst) {
+				worst = bias;
+			}
+		}
+	}
+	return worst * 2;
+}
+
+// Counts the keys sharing a bucket with a former key, when the sequential integers (as 8-byte keys) go to 2^16 buckets by the low bits of the hash
+template <class FN>
+static sl_uint32 MeasureBucketCollisions(const FN& fn)
+{
+	const sl_uint32 nBuckets = 1 << 16;
+	Memory mem = Memory::create(nBuckets);
+	sl_uint8* used = (sl_uint8*)(mem.getData());
+	Base::zeroMemory(used, nBuckets);
+	sl_uint32 nCollisions = 0;
+	for (sl_uint64 i = 0; i < nBuckets / 2; i++) {
+		// keys sharing the low bits, like aligned pointers or scaled ids
+		sl_uint64 key = i << 20;
+		sl_uint32 index = (sl_uint32)(fn(&key, 8)) & (nBuckets - 1);
+		if (used[index]) {
+			nCollisions++;
+		} else {
+			used[index] = 1;
+		}
+	}
+	return nCollisions;
+}
+
+static sl_bool CheckStreaming(const sl_uint8* data)
+{
+	sl_uint64 state = 7;
+	for (sl_uint32 k = 0; k < 2000; k++) {
+		sl_size n = (sl_size)(Random64(state) % 4000);
+		sl_uint64 seed = k & 1 ? Random64(state) : 0;
+		BytesHasher hasher(seed);
+		sl_size pos = 0;
+		while (pos < n) {
+			sl_size m = (sl_size)(Random64(state) % 300);
+			if (m > n - pos) {
+				m = n - pos;
+			}
+			hasher.update(data + pos, m);
+			pos += m;
+		}
+		if (hasher.finish64() != HashBytes64(data, n, seed)) {
+			return sl_false;
+		}
+	}
+	return sl_true;
+}
+
+int main(int argc, const char * argv[])
+{
+	const sl_size sizeData = 1 << 20;
+	Memory mem = Memory::create(sizeData);
+	sl_uint8* data = (sl_uint8*)(mem.getData());
+	sl_uint64 state = 1;
+	for (sl_size i = 0; i < sizeData; i++) {
+		data[i] = (sl_uint8)(Random64(state));
+	}
+
+	if (!CheckStreaming(data)) {
+		Println("BytesHasher: streaming result differs from HashBytes64");
+		return 1;
+	}
+
+	auto fnv = [](const void* p, sl_size n) -> sl_uint64 {
+		return HashBytes_Fnv1a(p, n);
+	};
+	auto xxh3 = [](const void* p, sl_size n) -> sl_uint64 {
+		return HashBytes64(p, n);
+	};
+
+	Println("Key size\tFNV-1a\tHashBytes64 (MB/sec)");
+	sl_size sizes[] = { 4, 8, 16, 32, 64, 128, 256, 1024, 4096, 65536 };
+	for (sl_size i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		sl_size n = sizes[i];
+		Println("%d\t%d\t%d", n, MeasureThroughput(data, sizeData, n, fnv), MeasureThroughput(data, sizeData, n, xxh3));
+	}
+
+	Println("");
+	Println("Worst avalanche bias (in percent, about 4 is the sampling noise of 10000 keys)");
+	Println("Key size\tFNV-1a (32 bits)\tHashBytes64 (64 bits)");
+	sl_size sizesAvalanche[] = { 4, 8, 16, 32, 64 };
+	for (sl_size i = 0; i < sizeof(sizesAvalanche) / sizeof(sizesAvalanche[0]); i++) {
+		sl_size n = sizesAvalanche[i];
+		sl_uint32 a = MeasureAvalanche(n, 32, fnv);
+		sl_uint32 b = MeasureAvalanche(n, 64, xxh3);
+		Println("%d\t%d.%d\t%d.%d", n, a / 10, a % 10, b / 10, b % 10);
+	}
+
+	Println("");
+	Println("Bucket collisions of 32768 sparse integer keys in 65536 buckets (about 7000 expected for a random hash)");
+	Println("FNV-1a: %d, HashBytes64: %d", MeasureBucketCollisions(fnv), MeasureBucketCollisions(xxh3));
+	return 0;
+}
@@ -0,0 +1,124 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+
+#include <slib/core.h>
+
+#include <regex>
+
+using namespace slib;
+
+static const sl_uint32 LINES_COUNT = 50000;
+
+static List<String> GenerateLines()
+{
+	static const char* words[] = { "GET", "POST", "/index.html", "/api/v1/users", "200", "404", "500", "user", "admin", "login", "timeout", "error", "warning", "info" };
+	List<String> lines;
+	sl_uint32 seed = 1;
+	for (sl_uint32 i = 0; i < LINES_COUNT; i++) {
+		StringBuffer sb;
+		sb.add(String::format("2024-01-%02d 12:%02d:%02d ", i % 28 + 1, i % 60, (i * 7) % 60));
+		sl_uint32 n = 6 + i % 6;
+		for (sl_uint32 k = 0; k < n; k++) {
+			seed = seed * 1103515245 + 12345;
+			sb.add(words[(seed >> 8) % (sizeof(words) / sizeof(words[0]))]);
+			sb.addStatic(" ", 1);
+		}
+		if (i % 1000 == 0) {
+			sb.add(String::format("contact: user%d@example.com", i));
+		}
+		lines.add(sb.merge());
+	}
+	return lines;
+}
+
+static void RunPattern(const List<String>& lines, const char* pattern)
+{
+	RegEx regex(pattern);
+	std::regex regexStd(pattern);
+	sl_uint32 nMatchedSlib = 0;
+	sl_uint32 nMatchedStd = 0;
+
+	TimeCounter tc;
+	for (auto& line : lines) {
+		if (regex.search(line)) {
+			nMatchedSlib++;
+		}
+	}
+	sl_uint64 timeSlib = tc.getElapsedMilliseconds();
+
+	tc.reset();
+	for (auto& line : lines) {
+		if (std::regex_search(line.getData(), line.getData() + line.getLength(), regexStd)) {
+			nMatchedStd++;
+		}
+	}
+	sl_uint64 timeStd = tc.getElapsedMilliseconds();
+
+	Println("%s", pattern);
+	Println("  RegEx: %dms (%d lines)   std::regex: %dms (%d lines)", timeSlib, nMatchedSlib, timeStd, nMatchedStd);
+}
+
+static void RunSet(const List<String>& lines)
+{
+	List<String> patterns = List<String>::create({ "timeout", "\\b500\\b", "admin +login", "[a-z0-9.]+@example\\.com", "POST /api/v[0-9]+/users 404" });
+	Ref<RegExSet> set = RegExSet::create(patterns);
+	List<RegEx> regexes;
+	for (auto& pattern : patterns) {
+		regexes.add(RegEx(pattern));
+	}
+	sl_size nSet = 0;
+	sl_size nEach = 0;
+
+	TimeCounter tc;
+	for (auto& line : lines) {
+		nSet += set->search(line).getCount();
+	}
+	sl_uint64 timeSet = tc.getElapsedMilliseconds();
+
+	tc.reset();
+	for (auto& line : lines) {
+		for (auto& regex : regexes) {
+			if (regex.search(line)) {
+				nEach++;
+			}
+		}
+	}
+	sl_uint64 timeEach = tc.getElapsedMilliseconds();
+
+	Println("RegExSet of %d patterns", patterns.getCount());
+	Println("  RegExSet: %dms (%d hits)   each RegEx: %dms (%d hits)", timeSet, nSet, timeEach, nEach);
+}
+
+int main(int argc, const char * argv[])
+{
+	List<String> lines = GenerateLines();
+	Println("Lines: %d", lines.getCount());
+	RunPattern(lines, "timeout");
+	RunPattern(lines, "error +[a-z]+ +404");
+	RunPattern(lines, "\\b(?:GET|POST) /api/v[0-9]+/[a-z]+ 500\\b");
+	RunPattern(lines, "[a-zA-Z0-9._-]+@[a-zA-Z0-9-]+(?:\\.[a-zA-Z0-9-]+)*");
+	RunPattern(lines, "^2024-01-(?:0[1-9]|1[0-9]) 12:30:[0-9]{2} .*admin");
+	RunSet(lines);
+	return 0;
+}
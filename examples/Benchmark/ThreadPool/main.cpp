@@ -0,0 +1,127 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include <slib/core.h>
+
+using namespace slib;
+
+static const sl_int32 TASKS_PER_PRODUCER = 200000;
+static const sl_int32 FANOUT_DEPTH = 16;
+
+static void WaitCompletion(sl_int32* counter, sl_int32 total)
+{
+	while (Base::interlockedAdd32(counter, 0) < total) {
+		System::sleep(1);
+	}
+}
+
+// tasks are added from several outside threads
+static double RunExternal(const Ref<ThreadPool>& pool, sl_uint32 nProducers)
+{
+	sl_int32 counter = 0;
+	sl_int32* pCounter = &counter;
+	sl_int32 total = (sl_int32)nProducers * TASKS_PER_PRODUCER;
+	TimeCounter tc;
+	List< Ref<Thread> > producers;
+	for (sl_uint32 i = 0; i < nProducers; i++) {
+		producers.add(Thread::start([pool, pCounter]() {
+			for (sl_int32 k = 0; k < TASKS_PER_PRODUCER; k++) {
+				pool->addTask([pCounter]() {
+					Base::interlockedIncrement32(pCounter);
+				});
+			}
+		}));
+	}
+	WaitCompletion(pCounter, total);
+	double sec = (double)(tc.getElapsedMilliseconds()) / 1000.0;
+	for (auto& thread : producers) {
+		thread->finishAndWait();
+	}
+	return (double)total / (sec > 0 ? sec : 0.001);
+}
+
+static void Spawn(ThreadPool* pool, sl_int32* counter, sl_int32 depth)
+{
+	Base::interlockedIncrement32(counter);
+	if (depth > 0) {
+		pool->addTask([pool, counter, depth]() {
+			Spawn(pool, counter, depth - 1);
+		});
+		pool->addTask([pool, counter, depth]() {
+			Spawn(pool, counter, depth - 1);
+		});
+	}
+}
+
+// tasks recursively add the sub-tasks from the workers
+static double RunFanout(const Ref<ThreadPool>& pool)
+{
+	sl_int32 counter = 0;
+	sl_int32* pCounter = &counter;
+	sl_int32 total = (1 << (FANOUT_DEPTH + 1)) - 1;
+	ThreadPool* p = pool.get();
+	TimeCounter tc;
+	pool->addTask([p, pCounter]() {
+		Spawn(p, pCounter, FANOUT_DEPTH);
+	});
+	WaitCompletion(pCounter, total);
+	double sec = (double)(tc.getElapsedMilliseconds()) / 1000.0;
+	return (double)total / (sec > 0 ? sec : 0.001);
+}
+
+static void CheckDelayed(const Ref<ThreadPool>& pool)
+{
+	sl_int32 fired = 0;
+	sl_int32* pFired = &fired;
+	TimeCounter tc;
+	pool->dispatch([pFired]() {
+		Base::interlockedIncrement32(pFired);
+	}, 200);
+	WaitCompletion(pFired, 1);
+	Println("  delayed dispatch (200ms) fired after %dms", (sl_int32)(tc.getElapsedMilliseconds()));
+}
+
+int main(int argc, const char * argv[])
+{
+	sl_uint32 nWorkers = System::getProcessorsCount();
+	sl_uint32 nProducers = nWorkers > 1 ? nWorkers / 2 : 1;
+	Println("Workers: %d, Producers: %d", nWorkers, nProducers);
+	
+	{
+		Ref<ThreadPool> pool = ThreadPool::create(nWorkers, nWorkers);
+		Println("ThreadPool (shared queue)");
+		Println("  external: %d tasks/sec", (sl_int64)(RunExternal(pool, nProducers)));
+		Println("  fan-out: %d tasks/sec", (sl_int64)(RunFanout(pool)));
+		CheckDelayed(pool);
+		pool->release();
+	}
+	{
+		Ref<ThreadPool> pool = ThreadPool::createWorkStealing(nWorkers);
+		Println("ThreadPool (work-stealing)");
+		Println("  external: %d tasks/sec", (sl_int64)(RunExternal(pool, nProducers)));
+		Println("  fan-out: %d tasks/sec", (sl_int64)(RunFanout(pool)));
+		CheckDelayed(pool);
+		pool->release();
+	}
+	return 0;
+}
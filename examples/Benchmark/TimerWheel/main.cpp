@@ -0,0 +1,199 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include <slib/core.h>
+
+using namespace slib;
+
+static const sl_uint32 TIMERS_COUNT = 100000;
+// the delays are spread over 1 ~ MAX_DELAY milliseconds
+static const sl_uint32 MAX_DELAY = 60000;
+// simulated loop iterations, 1 millisecond apart
+static const sl_uint32 STEPS_COUNT = 5000;
+
+static sl_uint32 Random(sl_uint32& seed)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+// scans every timer on each iteration, as `DispatchLoop` did with its timer list
+class LinearTimers
+{
+public:
+	struct Item
+	{
+		sl_uint64 timeExpire;
+		sl_uint64 interval;
+	};
+
+	List<Item> items;
+
+public:
+	sl_size process(sl_uint64 now, sl_int64& timeout)
+	{
+		sl_size nExpired = 0;
+		timeout = -1;
+		Item* data = items.getData();
+		sl_size n = items.getCount();
+		for (sl_size i = 0; i < n; i++) {
+			Item& item = data[i];
+			if (item.timeExpire <= now) {
+				item.timeExpire = now + item.interval;
+				nExpired++;
+			}
+			sl_int64 t = (sl_int64)(item.timeExpire - now);
+			if (timeout < 0 || t < timeout) {
+				timeout = t;
+			}
+		}
+		return nExpired;
+	}
+};
+
+static void RunLinear()
+{
+	LinearTimers timers;
+	sl_uint32 seed = 1;
+	for (sl_uint32 i = 0; i < TIMERS_COUNT; i++) {
+		LinearTimers::Item item;
+		item.interval = Random(seed) % MAX_DELAY + 1;
+		item.timeExpire = item.interval;
+		timers.items.add_NoLock(item);
+	}
+	TimeCounter tc;
+	sl_size nExpired = 0;
+	sl_int64 timeout = 0;
+	for (sl_uint32 step = 1; step <= STEPS_COUNT; step++) {
+		nExpired += timers.process(step, timeout);
+	}
+	sl_uint64 ms = tc.getElapsedMilliseconds();
+	Println("Linear scan:\t%d iterations in %d ms, expired: %d", STEPS_COUNT, (sl_uint32)ms, (sl_uint32)nExpired);
+}
+
+// runs again after its interval, like the linear timers
+class PeriodicTask
+{
+public:
+	TimerWheel* wheel;
+	sl_uint64* now;
+	sl_uint64 interval;
+	sl_size* count;
+
+public:
+	void operator()()
+	{
+		(*count)++;
+		wheel->add(*now, interval, PeriodicTask(*this));
+	}
+};
+
+static void RunWheel()
+{
+	TimerWheel wheel;
+	sl_uint32 seed = 1;
+	sl_size nExpired = 0;
+	sl_uint64 now = 0;
+	for (sl_uint32 i = 0; i < TIMERS_COUNT; i++) {
+		PeriodicTask task;
+		task.wheel = &wheel;
+		task.now = &now;
+		task.interval = Random(seed) % MAX_DELAY + 1;
+		task.count = &nExpired;
+		wheel.add(0, task.interval, task);
+	}
+	TimeCounter tc;
+	LinkedQueue< UniqueFunction<void()> > tasks;
+	UniqueFunction<void()> task;
+	for (sl_uint32 step = 1; step <= STEPS_COUNT; step++) {
+		now = step;
+		wheel.collect(now, &tasks);
+		while (tasks.pop_NoLock(&task)) {
+			task();
+		}
+		wheel.getTimeout(now);
+	}
+	sl_uint64 ms = tc.getElapsedMilliseconds();
+	Println("Timer wheel:\t%d iterations in %d ms, expired: %d", STEPS_COUNT, (sl_uint32)ms, (sl_uint32)nExpired);
+}
+
+static void RunWheelAddCancel()
+{
+	TimerWheel wheel;
+	sl_uint32 seed = 1;
+	List<sl_uint64> ids;
+	TimeCounter tcAdd;
+	for (sl_uint32 i = 0; i < TIMERS_COUNT; i++) {
+		ids.add_NoLock(wheel.add(0, Random(seed) % MAX_DELAY + 1, []() {}));
+	}
+	sl_uint64 msAdd = tcAdd.getElapsedMilliseconds();
+	TimeCounter tcCancel;
+	sl_size nCanceled = 0;
+	for (sl_size i = 0; i < ids.getCount(); i++) {
+		if (wheel.cancel(ids[i])) {
+			nCanceled++;
+		}
+	}
+	sl_uint64 msCancel = tcCancel.getElapsedMilliseconds();
+	Println("Timer wheel:\tadd %d in %d ms, cancel %d in %d ms", TIMERS_COUNT, (sl_uint32)msAdd, (sl_uint32)nCanceled, (sl_uint32)msCancel);
+}
+
+static void RunDispatchLoop()
+{
+	Ref<DispatchLoop> loop = DispatchLoop::create();
+	if (loop.isNull()) {
+		return;
+	}
+	sl_int32 nFired = 0;
+	sl_int32* pFired = &nFired;
+	List< Ref<Timer> > timers;
+	sl_uint32 seed = 1;
+	TimeCounter tcStart;
+	for (sl_uint32 i = 0; i < TIMERS_COUNT; i++) {
+		sl_uint64 interval = Random(seed) % 10000 + 100;
+		Ref<Timer> timer = Timer::startWithLoop(loop, [pFired](Timer*) {
+			Base::interlockedIncrement32(pFired);
+		}, interval);
+		timers.add_NoLock(timer);
+	}
+	sl_uint64 msStart = tcStart.getElapsedMilliseconds();
+	Thread::sleep(3000);
+	sl_int32 n = Base::interlockedAdd32(pFired, 0);
+	TimeCounter tcStop;
+	for (sl_size i = 0; i < timers.getCount(); i++) {
+		timers[i]->stop();
+	}
+	sl_uint64 msStop = tcStop.getElapsedMilliseconds();
+	loop->release();
+	Println("DispatchLoop:\tstart %d timers in %d ms, fired in 3 sec: %d, stop in %d ms", TIMERS_COUNT, (sl_uint32)msStart, n, (sl_uint32)msStop);
+}
+
+int main(int argc, const char * argv[])
+{
+	Println("Active timers: %d, delays: 1 ~ %d ms", TIMERS_COUNT, MAX_DELAY);
+	RunLinear();
+	RunWheel();
+	RunWheelAddCancel();
+	RunDispatchLoop();
+	return 0;
+}
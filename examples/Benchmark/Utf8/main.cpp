@@ -0,0 +1,175 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include <slib/core.h>
+
+using namespace slib;
+
+static const sl_size CORPUS_SIZE = 16 << 20;
+static const sl_uint32 REPEAT_COUNT = 10;
+
+static void AppendCodePoint(Memory& mem, sl_size& pos, sl_uint32 ch)
+{
+	sl_char8* p = (sl_char8*)(mem.getData()) + pos;
+	if (ch < 0x80) {
+		p[0] = (sl_char8)ch;
+		pos += 1;
+	} else if (ch < 0x800) {
+		p[0] = (sl_char8)((ch >> 6) | 0xC0);
+		p[1] = (sl_char8)((ch & 0x3F) | 0x80);
+		pos += 2;
+	} else if (ch < 0x10000) {
+		p[0] = (sl_char8)((ch >> 12) | 0xE0);
+		p[1] = (sl_char8)(((ch >> 6) & 0x3F) | 0x80);
+		p[2] = (sl_char8)((ch & 0x3F) | 0x80);
+		pos += 3;
+	} else {
+		p[0] = (sl_char8)((ch >> 18) | 0xF0);
+		p[1] = (sl_char8)(((ch >> 12) & 0x3F) | 0x80);
+		p[2] = (sl_char8)(((ch >> 6) & 0x3F) | 0x80);
+		p[3] = (sl_char8)((ch & 0x3F) | 0x80);
+		pos += 4;
+	}
+}
+
+// `type`: 0 - ASCII-heavy (English with a few accented letters), 1 - CJK-heavy, 2 - emoji-heavy
+static Memory CreateCorpus(sl_uint32 type)
+{
+	Memory mem = Memory::create(CORPUS_SIZE + 8);
+	sl_size pos = 0;
+	sl_uint32 seed = 1;
+	while (pos < CORPUS_SIZE) {
+		seed = seed * 1103515245 + 12345;
+		sl_uint32 r = (seed >> 8) % 100;
+		sl_uint32 ch;
+		if (type == 0) {
+			if (r < 1) {
+				ch = 0xE0 + (seed >> 16) % 32;
+			} else if (r < 17) {
+				ch = ' ';
+			} else {
+				ch = 'a' + (seed >> 16) % 26;
+			}
+		} else if (type == 1) {
+			if (r < 10) {
+				ch = r < 5 ? ' ' : '0' + (seed >> 16) % 10;
+			} else {
+				ch = 0x4E00 + (seed >> 12) % 0x5000;
+			}
+		} else {
+			if (r < 40) {
+				ch = 0x1F300 + (seed >> 12) % 0x300;
+			} else if (r < 50) {
+				ch = ' ';
+			} else {
+				ch = 'a' + (seed >> 16) % 26;
+			}
+		}
+		AppendCodePoint(mem, pos, ch);
+	}
+	return mem.sub(0, pos);
+}
+
+// reference byte-by-byte validation
+static sl_bool ValidateUtf8_Scalar(const sl_uint8* s, sl_size len)
+{
+	sl_size i = 0;
+	while (i < len) {
+		sl_uint32 ch = s[i];
+		sl_uint32 n;
+		if (ch < 0x80) {
+			i++;
+			continue;
+		} else if (ch >= 0xC2 && ch < 0xE0) {
+			n = 1;
+		} else if (ch >= 0xE0 && ch < 0xF0) {
+			n = 2;
+		} else if (ch >= 0xF0 && ch < 0xF5) {
+			n = 3;
+		} else {
+			return sl_false;
+		}
+		if (i + n >= len) {
+			return sl_false;
+		}
+		sl_uint32 ch1 = s[i + 1];
+		if ((ch == 0xE0 && ch1 < 0xA0) || (ch == 0xED && ch1 >= 0xA0) || (ch == 0xF0 && ch1 < 0x90) || (ch == 0xF4 && ch1 >= 0x90)) {
+			return sl_false;
+		}
+		for (sl_uint32 k = 1; k <= n; k++) {
+			if ((s[i + k] & 0xC0) != 0x80) {
+				return sl_false;
+			}
+		}
+		i += n + 1;
+	}
+	return sl_true;
+}
+
+template <class FN>
+static sl_int64 Measure(sl_size size, const FN& fn)
+{
+	TimeCounter tc;
+	for (sl_uint32 i = 0; i < REPEAT_COUNT; i++) {
+		fn();
+	}
+	sl_uint64 ms = tc.getElapsedMilliseconds();
+	if (!ms) {
+		ms = 1;
+	}
+	// MB/sec
+	return (sl_int64)((sl_uint64)size * REPEAT_COUNT * 1000 / ms / (1 << 20));
+}
+
+int main(int argc, const char * argv[])
+{
+	const char* names[] = { "ASCII", "CJK", "Emoji" };
+	Println("Corpus\tScalar validate\tvalidateUtf8\tutf8ToUtf16\tutf16ToUtf8 (MB/sec of UTF-8)");
+	for (sl_uint32 type = 0; type < 3; type++) {
+		Memory corpus = CreateCorpus(type);
+		const sl_char8* utf8 = (const sl_char8*)(corpus.getData());
+		sl_size len = corpus.getSize();
+		sl_size lenUtf16 = Charsets::utf8ToUtf16(utf8, len, sl_null, -1);
+		Memory mem16 = Memory::create(lenUtf16 * 2);
+		Memory mem8 = Memory::create(len);
+		sl_char16* utf16 = (sl_char16*)(mem16.getData());
+		sl_char8* output = (sl_char8*)(mem8.getData());
+		volatile sl_bool flagValid = sl_true;
+		sl_int64 speedScalar = Measure(len, [&]() {
+			flagValid = flagValid & ValidateUtf8_Scalar((const sl_uint8*)utf8, len);
+		});
+		sl_int64 speedValidate = Measure(len, [&]() {
+			flagValid = flagValid & Charsets::validateUtf8(utf8, len);
+		});
+		sl_int64 speedTo16 = Measure(len, [&]() {
+			Charsets::utf8ToUtf16(utf8, len, utf16, lenUtf16);
+		});
+		sl_int64 speedTo8 = Measure(len, [&]() {
+			Charsets::utf16ToUtf8(utf16, lenUtf16, output, len);
+		});
+		if (!flagValid || !Base::equalsMemory(utf8, output, len)) {
+			Println("%s: conversion error", names[type]);
+		}
+		Println("%s\t%d\t%d\t%d\t%d", names[type], speedScalar, speedValidate, speedTo16, speedTo8);
+	}
+	return 0;
+}
@@ -44,6 +44,7 @@
 #include "core/function.h"
 #include "core/promise.h"
 #include "core/new_helper.h"
+#include "core/allocator.h"
 
 #include "core/macro.h"
 #include "core/scoped.h"
@@ -70,13 +71,17 @@
 #include "core/list.h"
 #include "core/map.h"
 #include "core/hash_map.h"
+#include "core/flat_hash_map.h"
+#include "core/concurrent_hash_map.h"
 #include "core/hash_table.h"
 #include "core/linked_list.h"
 #include "core/queue.h"
 #include "core/queue_channel.h"
+#include "core/concurrent_queue.h"
 #include "core/linked_object.h"
 #include "core/loop_queue.h"
 #include "core/expire.h"
+#include "core/cache.h"
 #include "core/btree.h"
 
 #include "core/math.h"
@@ -89,12 +94,14 @@
 #include "core/process.h"
 #include "core/thread.h"
 #include "core/thread_pool.h"
+#include "core/parallel_sort.h"
 #include "core/rw_lock.h"
 #include "core/log.h"
 #include "core/asset.h"
 
 #include "core/io.h"
 #include "core/file.h"
+#include "core/file_btree.h"
 #include "core/pipe.h"
 #include "core/async.h"
 #include "core/dispatch.h"
@@ -0,0 +1,171 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_ALLOCATOR
+#define CHECKHEADER_SLIB_CORE_ALLOCATOR
+
+#include "definition.h"
+
+#include "ref.h"
+#include "new_helper.h"
+
+namespace slib
+{
+
+	/*
+		Size-class pool for the small blocks, such as the nodes of `CHashMap`, `CMap`, `HashTable` and `CLinkedList`.
+
+		Each thread keeps the freed blocks in its own free lists, so most of the allocations do not touch the heap nor any lock.
+		The lists exceeding their limits, and the lists of the exiting threads, are moved to a shared depot in batches.
+		A block may be freed on any thread, but the size passed to `free` should be the size passed to `allocate`.
+		The blocks larger than `MaximumBlockSize` are passed to `Base::createMemory` and `Base::freeMemory`.
+	*/
+	class SLIB_EXPORT MemoryPool
+	{
+	public:
+		enum {
+			MaximumBlockSize = 512
+		};
+
+	public:
+		static void* allocate(sl_size size) noexcept;
+
+		static void free(void* ptr, sl_size size) noexcept;
+
+		// moves the blocks cached by the current thread to the shared depot
+		static void releaseThreadCache() noexcept;
+
+	};
+
+// allocates the instances from `MemoryPool`. the new-expressions return null on failure
+#define SLIB_DECLARE_POOLED_NEW \
+	static void* operator new(sl_size_t size) noexcept \
+	{ \
+		return slib::MemoryPool::allocate(size); \
+	} \
+	static void* operator new(sl_size_t size, void* ptr) noexcept \
+	{ \
+		return ptr; \
+	} \
+	static void operator delete(void* ptr, sl_size_t size) noexcept \
+	{ \
+		slib::MemoryPool::free(ptr, size); \
+	} \
+	static void operator delete(void* ptr, void* place) noexcept \
+	{ \
+	}
+
+	/*
+		Monotonic allocator for the memory sharing a lifetime, such as the objects used while processing a request.
+
+		The allocations are carved from chunks, and the memory is released only by `reset` or by the destructor,
+		at once. The objects created by `create` are destructed at that time, in the reverse order.
+		Not thread-safe.
+	*/
+	class SLIB_EXPORT Arena : public Referable
+	{
+	public:
+		// `sizeChunk`: 0 means the default size (4KB). larger allocations get their own chunks
+		Arena(sl_size sizeChunk = 0) noexcept;
+
+		// `buf` (owned by the caller) is used before allocating any chunk, for example a buffer on the stack
+		Arena(void* buf, sl_size size, sl_size sizeChunk = 0) noexcept;
+
+		~Arena() noexcept;
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(Arena)
+
+	public:
+		// `alignment` should be a power of 2
+		void* allocate(sl_size size, sl_size alignment = sizeof(void*)) noexcept;
+
+		template <class T, class... ARGS>
+		T* create(ARGS&&... args) noexcept;
+
+		// returns null-terminated copy
+		sl_char8* copyString(const sl_char8* str, sl_size len) noexcept;
+
+		// destructs the created objects and releases the chunks. the largest chunk is kept for the next allocations
+		void reset() noexcept;
+
+		// total size of the allocations since the last `reset`
+		sl_size getAllocatedSize() const noexcept;
+
+	protected:
+		struct Chunk
+		{
+			Chunk* next;
+			sl_size size;
+		};
+
+		struct Destructor
+		{
+			Destructor* next;
+			void (*destruct)(void* object);
+			void* object;
+		};
+
+		template <class T>
+		static void _destruct(void* object) noexcept;
+
+		void* _allocateFromNewChunk(sl_size size, sl_size alignment) noexcept;
+
+		void _addDestructor(Destructor* destructor, void (*destruct)(void* object), void* object) noexcept;
+
+		void _release(sl_bool flagKeepChunk) noexcept;
+
+	protected:
+		sl_uint8* m_pos;
+		sl_uint8* m_end;
+		Chunk* m_chunks;
+		Destructor* m_destructors;
+		sl_size m_sizeChunk;
+		sl_size m_sizeAllocated;
+		void* m_bufInitial;
+		sl_size m_sizeInitial;
+
+	};
+
+	template <class T, class... ARGS>
+	T* Arena::create(ARGS&&... args) noexcept
+	{
+		// the destructor record is followed by the object
+		sl_size alignment = alignof(T) > sizeof(void*) ? alignof(T) : sizeof(void*);
+		sl_size offset = (sizeof(Destructor) + alignment - 1) & ~(alignment - 1);
+		sl_uint8* mem = (sl_uint8*)(allocate(offset + sizeof(T), alignment));
+		if (!mem) {
+			return sl_null;
+		}
+		T* object = new (mem + offset) T(Forward<ARGS>(args)...);
+		_addDestructor((Destructor*)mem, &(Arena::_destruct<T>), object);
+		return object;
+	}
+
+	template <class T>
+	void Arena::_destruct(void* object) noexcept
+	{
+		((T*)object)->~T();
+	}
+
+}
+
+#endif
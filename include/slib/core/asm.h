@@ -30,11 +30,18 @@ namespace slib
 	
 #ifdef SLIB_ARCH_IS_X64
 	sl_bool CanUseSse42();
+
+	sl_bool CanUseAvx2();
 #else
 	SLIB_INLINE static sl_bool CanUseSse42()
 	{
 		return sl_false;
 	}
+
+	SLIB_INLINE static sl_bool CanUseAvx2()
+	{
+		return sl_false;
+	}
 #endif
 	
 }
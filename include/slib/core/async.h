@@ -29,6 +29,10 @@
 #include "file.h"
 #include "variant.h"
 #include "function.h"
+#include "mutex.h"
+#include "time.h"
+#include "timer_wheel.h"
+#include "concurrent_queue.h"
 
 namespace slib
 {
@@ -42,6 +46,7 @@ namespace slib
 	};
 
 	class AsyncIoLoop;
+	class AsyncIoLoopGroup;
 	class AsyncIoInstance;
 	class AsyncIoObject;
 	class AsyncStreamInstance;
@@ -72,7 +77,7 @@ namespace slib
 		sl_bool isRunning();
 
 
-		sl_bool addTask(const Function<void()>& task);
+		sl_bool addTask(UniqueFunction<void()>&& task);
 	
 		void wake();
 
@@ -83,20 +88,35 @@ namespace slib
 
 		void requestOrder(AsyncIoInstance* instance);
 
-		sl_bool dispatch(const Function<void()>& callback, sl_uint64 delay_ms) override;
+		// the delayed callbacks are kept in a timing wheel and run by the loop thread
+		sl_bool dispatch(UniqueFunction<void()>&& task, sl_uint64 delay_ms) override;
+		
+		// number of the attached instances, used to balance the loops of `AsyncIoLoopGroup`
+		sl_size getInstancesCount();
+		
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		// native io_uring of the loop, or null when the kernel lacks io_uring and the loop runs on epoll only
+		void* getIoUring();
+#endif
 
 	protected:
 		sl_bool m_flagInit;
 		sl_bool m_flagRunning;
 		void* m_handle;
+		sl_reg m_nInstances;
 
 		Ref<Thread> m_thread;
 
-		LinkedQueue< Function<void()> > m_queueTasks;
+		// pushed by any thread, popped by the loop thread
+		MpscQueue< UniqueFunction<void()> > m_queueTasks;
 	
 		LinkedQueue< Ref<AsyncIoInstance> > m_queueInstancesOrder;
 		LinkedQueue< Ref<AsyncIoInstance> > m_queueInstancesClosing;
 		LinkedQueue< Ref<AsyncIoInstance> > m_queueInstancesClosed;
+		
+		TimerWheel m_timerWheel;
+		TimeCounter m_timeCounter;
+		Mutex m_lockTimer;
 
 	protected:
 		static void* _native_createHandle();
@@ -109,9 +129,49 @@ namespace slib
 	protected:
 		void _stepBegin();
 		void _stepEnd();
+		// milliseconds to wait for the events, limited by the next delayed callback
+		sl_int32 _getWaitTimeout(sl_int32 timeoutMax);
 	
 	};
 	
+	class SLIB_EXPORT AsyncIoLoopGroup : public Object
+	{
+		SLIB_DECLARE_OBJECT
+		
+	private:
+		AsyncIoLoopGroup();
+		
+		~AsyncIoLoopGroup();
+		
+	public:
+		// `nLoops = 0` means the number of the processors
+		static Ref<AsyncIoLoopGroup> create(sl_uint32 nLoops = 0, sl_bool flagAutoStart = sl_true, sl_bool flagPinToProcessors = sl_false);
+		
+	public:
+		void release();
+		
+		void start();
+		
+		sl_bool isRunning();
+		
+		sl_uint32 getLoopsCount();
+		
+		Ref<AsyncIoLoop> getLoop(sl_uint32 index);
+		
+		// round-robin
+		Ref<AsyncIoLoop> getNextLoop();
+		
+		// the loop having the fewest attached instances. ties are broken round-robin
+		Ref<AsyncIoLoop> getLeastLoadedLoop();
+		
+	protected:
+		Ref<AsyncIoLoop>* m_loops;
+		sl_uint32 m_nLoops;
+		sl_uint32 m_indexNext;
+		sl_bool m_flagRunning;
+		
+	};
+	
 	
 	class AsyncIoObject;
 	
@@ -242,6 +302,10 @@ namespace slib
 		Function<void(AsyncStreamResult&)> callback;
 		sl_bool flagRead;
 
+		// source of a `sendFile()` request (`data` is null)
+		Ref<File> file;
+		sl_uint64 offsetFile;
+
 	protected:
 		AsyncStreamRequest(const void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult&)>& callback, sl_bool flagRead);
 		
@@ -252,6 +316,8 @@ namespace slib
 
 		static Ref<AsyncStreamRequest> createWrite(const void* data, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult&)>& callback);
 
+		static Ref<AsyncStreamRequest> createSendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, Referable* userObject, const Function<void(AsyncStreamResult&)>& callback);
+
 	public:
 		void runCallback(AsyncStream* stream, sl_uint32 resultSize, sl_bool flagError);
 
@@ -272,6 +338,11 @@ namespace slib
 
 		virtual sl_bool write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject);
 
+		virtual sl_bool isSupportedSendFile();
+
+		// queues a write request taking the data from `file`. returns false if `isSupportedSendFile()` is false
+		sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject);
+
 		virtual sl_bool isSeekable();
 
 		virtual sl_bool seek(sl_uint64 pos);
@@ -323,6 +394,15 @@ namespace slib
 
 		virtual sl_bool write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null) = 0;
 
+		// whether the stream can send the contents of a file without copying them to the user space (`sendfile`, `splice`)
+		virtual sl_bool isSupportedSendFile();
+
+		/*
+			Writes [offset, offset + size) of `file` to the stream. `file` is not seeked, so it can be shared by the streams.
+			Returns false if the stream does not support sending files.
+		*/
+		virtual sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null);
+
 		virtual sl_bool isSeekable();
 
 		virtual sl_bool seek(sl_uint64 pos);
@@ -333,7 +413,7 @@ namespace slib
 	
 		sl_bool writeFromMemory(const Memory& mem, const Function<void(AsyncStreamResult&)>& callback);
 
-		virtual sl_bool addTask(const Function<void()>& callback) = 0;
+		virtual sl_bool addTask(UniqueFunction<void()>&& task) = 0;
 
 	};
 	
@@ -355,13 +435,17 @@ namespace slib
 
 		sl_bool write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null) override;
 
+		sl_bool isSupportedSendFile() override;
+
+		sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null) override;
+
 		sl_bool isSeekable() override;
 
 		sl_bool seek(sl_uint64 pos) override;
 
 		sl_uint64 getSize() override;
 
-		sl_bool addTask(const Function<void()>& callback) override;
+		sl_bool addTask(UniqueFunction<void()>&& task) override;
 
 		sl_size getWaitingSizeForWrite();
 	
@@ -388,7 +472,7 @@ namespace slib
 
 		sl_bool write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null) override;
 
-		sl_bool addTask(const Function<void()>& callback) override;
+		sl_bool addTask(UniqueFunction<void()>&& task) override;
 
 	protected:
 		virtual void processRequest(AsyncStreamRequest* request) = 0;
@@ -517,6 +601,13 @@ namespace slib
 
 		static Ref<AsyncStream> openIOCP(const StringParam& path, FileMode mode);
 #endif
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+		// reads and writes are completed by the io_uring of `loop`. returns null if the loop runs without io_uring, or the kernel lacks IORING_OP_READ/IORING_OP_WRITE (older than 5.6)
+		static Ref<AsyncStream> openIoUring(const StringParam& path, FileMode mode, const Ref<AsyncIoLoop>& loop);
+
+		static Ref<AsyncStream> openIoUring(const StringParam& path, FileMode mode);
+#endif
 	
 	public:
 		void close() override;
@@ -657,6 +748,8 @@ namespace slib
 		AsyncOutputBufferElement(const Memory& header);
 
 		AsyncOutputBufferElement(AsyncStream* stream, sl_uint64 size);
+
+		AsyncOutputBufferElement(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
 		
 		~AsyncOutputBufferElement();
 
@@ -671,17 +764,28 @@ namespace slib
 		sl_bool addHeader(const Memory& header);
 
 		void setBody(AsyncStream* stream, sl_uint64 size);
+
+		void setBodyFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
 	
 		MemoryQueue& getHeader();
 	
 		Ref<AsyncStream> getBody();
 	
 		sl_uint64 getBodySize();
+
+		Ref<File> getBodyFile();
+
+		sl_uint64 getBodyFileOffset();
+
+		// marks `size` bytes of the body file as sent
+		void skipBodyFile(sl_uint64 size);
 	
 	protected:
 		MemoryQueue m_header;
 		sl_uint64 m_sizeBody;
 		AtomicRef<AsyncStream> m_body;
+		AtomicRef<File> m_bodyFile;
+		sl_uint64 m_offsetBodyFile;
 
 	};
 	
@@ -701,13 +805,20 @@ namespace slib
 
 		sl_bool write(const Memory& mem);
 
+		// `size`: SLIB_UINT64_MAX copies until the stream results an empty reading
 		sl_bool copyFrom(AsyncStream* stream, sl_uint64 size);
 	
 		sl_bool copyFromFile(const String& path);
 
 		sl_bool copyFromFile(const String& path, const Ref<Dispatcher>& dispatcher);
 
+		// the output stream should support `AsyncStream::sendFile()`
+		sl_bool sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+
 		sl_uint64 getOutputLength() const;
+
+		// removes the first element, so the contents can be consumed by the other stages
+		sl_bool popElement(Ref<AsyncOutputBufferElement>* _out = sl_null);
 	
 	protected:
 		sl_uint64 m_lengthOutput;
@@ -760,6 +871,8 @@ namespace slib
 		
 		void onWriteStream(AsyncStreamResult& result);
 
+		void onSendFile(AsyncStreamResult& result);
+
 	protected:
 		void _onError();
 
@@ -808,7 +921,7 @@ namespace slib
 	
 		sl_bool write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null) override;
 	
-		sl_bool addTask(const Function<void()>& callback) override;
+		sl_bool addTask(UniqueFunction<void()>&& task) override;
 
 
 		void addReadData(void* data, sl_uint32 size, Referable* userObject);
@@ -166,6 +166,12 @@ namespace slib
 		static const sl_uint8* findMemoryUntilZero(const void* mem, sl_uint8 pattern, sl_size count) noexcept;
 
 
+		// Finds the first occurrence of `pattern` (`sizePattern` bytes) in `mem` (`size` bytes)
+		static const sl_uint8* findMemory(const void* mem, sl_size size, const void* pattern, sl_size sizePattern) noexcept;
+
+		static const sl_uint16* findMemory2(const sl_uint16* mem, sl_size count, const sl_uint16* pattern, sl_size countPattern) noexcept;
+
+
 		static sl_bool equalsString(const sl_char8* s1, const sl_char8* s2, sl_reg count = -1) noexcept;
 
 		static sl_bool equalsString2(const sl_char16* s1, const sl_char16* s2, sl_reg count = -1) noexcept;
@@ -180,6 +186,18 @@ namespace slib
 		static sl_compare_result compareString4(const sl_char32* s1, const sl_char32* s2, sl_reg count = -1) noexcept;
 
 
+		// ASCII letters are compared case-insensitively
+		static sl_bool equalsMemoryIgnoreCase(const void* mem1, const void* mem2, sl_size count) noexcept;
+
+		static sl_compare_result compareStringIgnoreCase(const sl_char8* s1, const sl_char8* s2, sl_reg count = -1) noexcept;
+
+
+		// White spaces: ' ', '\t', '\r', '\n'
+		static sl_size countLeadingWhitespaces(const sl_char8* s, sl_size count) noexcept;
+
+		static sl_size countTrailingWhitespaces(const sl_char8* s, sl_size count) noexcept;
+
+
 		static sl_size copyString(sl_char8* dst, const sl_char8* src, sl_reg count = -1) noexcept;
 
 		static sl_size copyString2(sl_char16* dst, const sl_char16* src, sl_reg count = -1) noexcept;
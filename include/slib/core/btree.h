@@ -228,7 +228,7 @@ namespace slib
 
 		friend class NodeDataScope;
 
-	private:
+	protected:
 		sl_uint32 m_order;
 		sl_uint32 m_maxLength;
 		sl_uint64 m_totalCount;
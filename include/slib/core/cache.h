@@ -0,0 +1,286 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_CACHE
+#define CHECKHEADER_SLIB_CORE_CACHE
+
+#include "definition.h"
+
+#include "object.h"
+#include "function.h"
+#include "event.h"
+#include "system.h"
+#include "flat_hash_map.h"
+
+namespace slib
+{
+
+	class SLIB_EXPORT CacheParam
+	{
+	public:
+		// default: 10000, maximum total weight of the entries. the weight of an entry is 1 unless a weigher is set
+		sl_uint64 capacity;
+
+		// default: 0, in milliseconds. time-to-live of the entries put without their own. 0 means the entries do not expire
+		sl_uint32 defaultTTL;
+
+	public:
+		CacheParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(CacheParam)
+
+	};
+
+	class SLIB_EXPORT CacheStatistics
+	{
+	public:
+		sl_uint64 hitCount;
+		sl_uint64 missCount;
+		sl_uint64 loadSuccessCount;
+		sl_uint64 loadFailureCount;
+		// entries removed to keep the capacity, including the candidates rejected by the admission
+		sl_uint64 evictionCount;
+		sl_uint64 expirationCount;
+
+	public:
+		CacheStatistics();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(CacheStatistics)
+
+	};
+
+	/*
+		Count-Min sketch with 4-bit counters, estimating how often the keys were accessed recently.
+		All counters are halved when the number of the increments reaches the sample size (10 times of the maximum size),
+		so the old popularity fades out.
+	*/
+	class SLIB_EXPORT FrequencySketch
+	{
+	public:
+		FrequencySketch() noexcept;
+
+		~FrequencySketch() noexcept;
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(FrequencySketch)
+
+	public:
+		// resizes the table for `maximumSize` distinct keys. the counters are cleared
+		sl_bool setMaximumSize(sl_uint64 maximumSize) noexcept;
+
+		// 0 ~ 15
+		sl_uint32 getFrequency(sl_uint64 hash) const noexcept;
+
+		void increment(sl_uint64 hash) noexcept;
+
+		void clear() noexcept;
+
+	protected:
+		sl_size _getIndex(sl_uint64 hash, sl_uint32 depth) const noexcept;
+
+		void _reset() noexcept;
+
+	protected:
+		sl_uint64* m_table;
+		sl_size m_tableMask;
+		sl_uint32 m_sampleSize;
+		sl_uint32 m_size;
+
+	};
+
+	namespace priv
+	{
+		namespace cache
+		{
+			extern const char g_classID[];
+		}
+	}
+
+	/*
+		Bounded cache with W-TinyLFU admission.
+
+		New entries go to a small LRU window (1% of the capacity). The entries evicted from the window compete with
+		the least recently used entry of the main area, and the one accessed more often according to `FrequencySketch` survives,
+		so a scan of one-time keys can not flush the popular entries.
+		The main area is a segmented LRU: the entries hit in the probation segment are promoted to the protected segment (80%).
+
+		Each entry can have its own time-to-live. Expired entries are dropped when they are accessed, or by `cleanUp`.
+		The loader passed to `get` (or set by `setLoader`) fills the missing entries, and the concurrent requests for the same key
+		wait for a single load instead of calling the loader again.
+	*/
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT Cache : public Object
+	{
+		SLIB_TEMPLATE_OBJECT(Object, priv::cache::g_classID)
+
+	public:
+		typedef Function<sl_bool(const KT& key, VT& value)> Loader;
+		typedef Function<sl_uint64(const KT& key, const VT& value)> Weigher;
+
+	public:
+		Cache() noexcept;
+
+		Cache(const CacheParam& param) noexcept;
+
+		~Cache() noexcept;
+
+	public:
+		sl_uint64 getCapacity() const noexcept;
+
+		// evicts the entries exceeding the new capacity
+		void setCapacity(sl_uint64 capacity) noexcept;
+
+		sl_uint32 getDefaultTTL() const noexcept;
+
+		void setDefaultTTL(sl_uint32 ttlMilliseconds) noexcept;
+
+		const Loader& getLoader() const noexcept;
+
+		void setLoader(const Loader& loader) noexcept;
+
+		const Weigher& getWeigher() const noexcept;
+
+		// should be set before putting any entry
+		void setWeigher(const Weigher& weigher) noexcept;
+
+	public:
+		sl_size getCount() const noexcept;
+
+		sl_uint64 getWeight() const noexcept;
+
+		// loads the missing entry by the loader set by `setLoader`, if any
+		sl_bool get(const KT& key, VT* _out = sl_null) noexcept;
+
+		// loads the missing entry by `loader`
+		sl_bool get(const KT& key, VT* _out, const Loader& loader) noexcept;
+
+		VT getValue(const KT& key, const VT& def) noexcept;
+
+		// does not load, and does not affect the statistics and the recency
+		sl_bool contains(const KT& key) noexcept;
+
+		// returns false if the weight of the entry exceeds the capacity
+		sl_bool put(const KT& key, const VT& value) noexcept;
+
+		// `ttlMilliseconds`: 0 means the entry does not expire
+		sl_bool put(const KT& key, const VT& value, sl_uint32 ttlMilliseconds) noexcept;
+
+		sl_bool remove(const KT& key, VT* outValue = sl_null) noexcept;
+
+		void removeAll() noexcept;
+
+		// removes the expired entries
+		void cleanUp() noexcept;
+
+		CacheStatistics getStatistics() const noexcept;
+
+		void resetStatistics() noexcept;
+
+	protected:
+		enum class Segment
+		{
+			Window = 0,
+			Probation = 1,
+			Protected = 2
+		};
+
+		struct Entry
+		{
+			KT key;
+			VT value;
+			sl_uint64 hash;
+			sl_uint64 weight;
+			// tick count in milliseconds. 0 means the entry does not expire
+			sl_uint64 timeExpire;
+			Segment segment;
+			Entry* before;
+			Entry* next;
+		};
+
+		// most recently used entry first
+		struct Queue
+		{
+			Entry* first;
+			Entry* last;
+			sl_uint64 weight;
+		};
+
+		class Loading : public Referable
+		{
+		public:
+			Ref<Event> event;
+			sl_bool flagSuccess;
+			VT value;
+		};
+
+	protected:
+		void _init(const CacheParam& param) noexcept;
+
+		sl_bool _get_NoLock(const KT& key, VT* _out, sl_uint64 now) noexcept;
+
+		sl_bool _put_NoLock(const KT& key, const VT& value, sl_uint32 ttl, sl_uint64 now) noexcept;
+
+		sl_bool _load(const KT& key, VT* _out, const Loader& loader) noexcept;
+
+		void _onAccess(Entry* entry) noexcept;
+
+		void _evict() noexcept;
+
+		void _evictEntry(Entry* entry) noexcept;
+
+		void _remove(Entry* entry) noexcept;
+
+		void _updateSegmentSizes() noexcept;
+
+		Queue& _getQueue(Segment segment) noexcept;
+
+		void _link(Queue& queue, Entry* entry, Segment segment) noexcept;
+
+		void _unlink(Entry* entry) noexcept;
+
+		sl_uint64 _getHash(const KT& key) const noexcept;
+
+	protected:
+		sl_uint64 m_capacity;
+		sl_uint64 m_capacityWindow;
+		sl_uint64 m_capacityProtected;
+		sl_uint32 m_defaultTTL;
+		Loader m_loader;
+		Weigher m_weigher;
+
+		FlatHashMap<KT, Entry*, HASH, KEY_EQUALS> m_map;
+		Queue m_queues[3];
+		sl_uint64 m_weight;
+		FrequencySketch m_sketch;
+		// number of the keys the sketch is sized for
+		sl_size m_sizeSketch;
+		CacheStatistics m_statistics;
+
+		FlatHashMap< KT, Ref<Loading>, HASH, KEY_EQUALS > m_loadings;
+		HASH m_hash;
+
+	};
+
+}
+
+#include "detail/cache.inc"
+
+#endif
@@ -225,6 +225,9 @@ namespace slib
 	class Charsets
 	{
 	public:
+		// returns true if `utf8` is well-formed (RFC 3629): no overlong forms, surrogates or code points above U+10FFFF
+		static sl_bool validateUtf8(const sl_char8* utf8, sl_size len) noexcept;
+
 		static sl_size utf8ToUtf16(const sl_char8* utf8, sl_reg lenUtf8, sl_char16* utf16, sl_reg lenUtf16Buffer) noexcept;
 
 		static sl_size encode8_UTF16BE(const sl_char8* utf8, sl_reg lenUtf8, void* utf16, sl_reg sizeUtf16Buffer) noexcept;
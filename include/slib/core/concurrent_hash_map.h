@@ -0,0 +1,192 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_CONCURRENT_HASH_MAP
+#define CHECKHEADER_SLIB_CORE_CONCURRENT_HASH_MAP
+
+#include "definition.h"
+
+#include "hash.h"
+#include "compare.h"
+#include "list.h"
+#include "mutex.h"
+
+#include <atomic>
+
+namespace slib
+{
+
+	/*
+		Hash map shared by many threads.
+
+		The keys are distributed over the shards, and each shard has its own lock for the writers.
+		The readers (`get`, `getValue`, `contains`) take no lock and never wait for the writers:
+		the entries are immutable once published (`put` on an existing key publishes a new entry),
+		and the replaced entries are freed only after the readers which could have seen them have left the shard.
+		A shard grows incrementally: every write moves a few buckets of the old table into the new one,
+		and the readers follow the moved buckets, so no single operation rehashes the whole shard.
+		The enumerations (`getAllKeys`, `getAllValues`) lock the shards one by one, so they are not a snapshot of the whole map.
+	*/
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT ConcurrentHashMap
+	{
+	public:
+		typedef KT KEY_TYPE;
+		typedef VT VALUE_TYPE;
+
+	public:
+		// `shardsCount` is rounded up to a power of 2. default: 64
+		ConcurrentHashMap(sl_uint32 shardsCount = 0, const HASH& hash = HASH(), const KEY_EQUALS& equals = KEY_EQUALS()) noexcept;
+
+		~ConcurrentHashMap() noexcept;
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(ConcurrentHashMap)
+
+	public:
+		sl_size getCount() const noexcept;
+
+		sl_bool isEmpty() const noexcept;
+
+		sl_bool isNotEmpty() const noexcept;
+
+		sl_bool contains(const KT& key) const noexcept;
+
+		sl_bool get(const KT& key, VT* _out = sl_null) const noexcept;
+
+		VT getValue(const KT& key) const noexcept;
+
+		VT getValue(const KT& key, const VT& def) const noexcept;
+
+		// replaces the value if the key exists, or inserts a new entry
+		template <class VALUE>
+		sl_bool put(const KT& key, VALUE&& value, sl_bool* isInsertion = sl_null) noexcept;
+
+		// inserts only if the key does not exist. otherwise returns false and copies the current value to `outExisting`
+		template <class VALUE>
+		sl_bool putIfAbsent(const KT& key, VALUE&& value, VT* outExisting = sl_null) noexcept;
+
+		/*
+			Updates the entry atomically.
+			`fn` is called as `sl_bool fn(VT& value, sl_bool flagExists)` under the lock of the shard,
+			where `value` is the current value (or a default-constructed one if the key does not exist).
+			Returning true stores `value`, and returning false removes the entry.
+			`fn` must not access this map.
+			Returns whether the key exists after the update.
+		*/
+		template <class FN>
+		sl_bool compute(const KT& key, const FN& fn) noexcept;
+
+		sl_bool remove(const KT& key, VT* outValue = sl_null) noexcept;
+
+		void removeAll() noexcept;
+
+		List<KT> getAllKeys() const noexcept;
+
+		List<VT> getAllValues() const noexcept;
+
+	protected:
+		struct Node
+		{
+			KT key;
+			VT value;
+			sl_size hash;
+			std::atomic<Node*> next;
+
+			template <class KEY, class... VALUE_ARGS>
+			Node(sl_size _hash, KEY&& _key, VALUE_ARGS&&... value_args) noexcept;
+		};
+
+		struct Table
+		{
+			sl_size capacity;
+			// the table receiving the buckets while this table is moved
+			Table* next;
+			std::atomic<Node*>* buckets;
+		};
+
+		struct Shard
+		{
+			Mutex lock;
+			// created on the first insertion
+			std::atomic<Table*> table;
+			std::atomic<sl_size> count;
+			// index of the next bucket to be moved while growing
+			sl_size indexMove;
+
+			std::atomic<sl_uint64> epoch;
+			std::atomic<sl_int32> readers[2];
+			// retired in the epochs of each parity
+			List<Node*> nodesRetired[2];
+			List<Table*> tablesRetired[2];
+
+			Shard() noexcept;
+		};
+
+		class ReadSection;
+
+	protected:
+		sl_size _getHash(const KT& key) const noexcept;
+
+		Shard* _getShard(sl_size hash) const noexcept;
+
+		Node* _find(Shard* shard, const KT& key, sl_size hash) const noexcept;
+
+		// returns the link pointing the entry of `key`, or null if not found
+		std::atomic<Node*>* _findLink(std::atomic<Node*>* bucket, const KT& key, sl_size hash) const noexcept;
+
+		// returns the table containing the bucket of `hash`, moving the bucket first if the shard is growing
+		Table* _prepareWrite(Shard* shard, sl_size hash) noexcept;
+
+		std::atomic<Node*>* _getBucket(Table* table, sl_size hash) const noexcept;
+
+		sl_bool _moveBucket(Shard* shard, Table* table, sl_size index) noexcept;
+
+		void _afterInsert(Shard* shard) noexcept;
+
+		void _retire(Shard* shard, Node* node) noexcept;
+
+		void _retire(Shard* shard, Table* table) noexcept;
+
+		void _reclaim(Shard* shard) noexcept;
+
+		static Table* _createTable(sl_size capacity) noexcept;
+
+		static void _freeTable(Table* table) noexcept;
+
+		static void _freeNodes(List<Node*>& nodes) noexcept;
+
+		static void _freeTables(List<Table*>& tables) noexcept;
+
+	protected:
+		Shard* m_shards;
+		sl_uint32 m_shardsCount;
+		sl_uint32 m_shardsBits;
+		HASH m_hash;
+		KEY_EQUALS m_equals;
+
+	};
+
+}
+
+#include "detail/concurrent_hash_map.inc"
+
+#endif
@@ -0,0 +1,260 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_CORE_CONCURRENT_QUEUE
+#define CHECKHEADER_SLIB_CORE_CONCURRENT_QUEUE
+
+#include "definition.h"
+
+#include "base.h"
+#include "macro.h"
+#include "cpp.h"
+
+#include <atomic>
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace concurrent_queue
+		{
+
+			enum {
+				CacheLineSize = 64
+			};
+
+		}
+	}
+
+	/*
+		Bounded single-producer single-consumer ring.
+		Only one thread may push and only one thread may pop at the same time. Neither side takes a lock nor allocates memory,
+		and each side reads the position of the other side only when its cached copy says the ring is full (or empty).
+	*/
+	template <class T>
+	class SLIB_EXPORT SpscRingQueue
+	{
+	public:
+		// `capacity` is rounded up to a power of 2
+		SpscRingQueue(sl_size capacity) noexcept;
+
+		~SpscRingQueue() noexcept;
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(SpscRingQueue)
+
+	public:
+		sl_size getCapacity() const noexcept;
+
+		// approximate while the other side is running
+		sl_size getCount() const noexcept;
+
+		sl_bool isEmpty() const noexcept;
+
+		sl_bool isNotEmpty() const noexcept;
+
+		// producer. returns false if the ring is full
+		template <class... ARGS>
+		sl_bool push(ARGS&&... args) noexcept;
+
+		// producer. returns the number of the pushed elements
+		sl_size pushElements(const T* values, sl_size count) noexcept;
+
+		// consumer
+		sl_bool pop(T* _out = sl_null) noexcept;
+
+		// consumer. returns the number of the popped elements
+		sl_size popElements(T* _out, sl_size maxCount) noexcept;
+
+		// consumer
+		void removeAll() noexcept;
+
+	protected:
+		T* m_data;
+		sl_size m_capacity;
+		sl_size m_mask;
+		char m_pad0[priv::concurrent_queue::CacheLineSize];
+
+		// consumer side
+		std::atomic<sl_size> m_head;
+		sl_size m_cachedTail;
+		char m_pad1[priv::concurrent_queue::CacheLineSize];
+
+		// producer side
+		std::atomic<sl_size> m_tail;
+		sl_size m_cachedHead;
+		char m_pad2[priv::concurrent_queue::CacheLineSize];
+
+	};
+
+	/*
+		Bounded multiple-producer multiple-consumer ring (Dmitry Vyukov's algorithm).
+		Every cell has a sequence number telling whether it is ready for the push or the pop of the current lap,
+		so a push or a pop costs one CAS on its position and no lock.
+		The batch functions claim the consecutive cells by a single CAS.
+	*/
+	template <class T>
+	class SLIB_EXPORT MpmcRingQueue
+	{
+	public:
+		// `capacity` is rounded up to a power of 2 (at least 2)
+		MpmcRingQueue(sl_size capacity) noexcept;
+
+		~MpmcRingQueue() noexcept;
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(MpmcRingQueue)
+
+	public:
+		sl_size getCapacity() const noexcept;
+
+		// approximate while other threads are running
+		sl_size getCount() const noexcept;
+
+		sl_bool isEmpty() const noexcept;
+
+		sl_bool isNotEmpty() const noexcept;
+
+		// returns false if the ring is full
+		template <class... ARGS>
+		sl_bool push(ARGS&&... args) noexcept;
+
+		// returns the number of the pushed elements
+		sl_size pushElements(const T* values, sl_size count) noexcept;
+
+		sl_bool pop(T* _out = sl_null) noexcept;
+
+		// returns the number of the popped elements
+		sl_size popElements(T* _out, sl_size maxCount) noexcept;
+
+		void removeAll() noexcept;
+
+	protected:
+		struct Cell
+		{
+			std::atomic<sl_size> sequence;
+			SLIB_ALIGN(8) char value[sizeof(T)];
+		};
+
+		sl_size _claimPush(sl_size count, sl_size& pos) noexcept;
+
+		sl_size _claimPop(sl_size count, sl_size& pos) noexcept;
+
+	protected:
+		Cell* m_cells;
+		sl_size m_capacity;
+		sl_size m_mask;
+		char m_pad0[priv::concurrent_queue::CacheLineSize];
+
+		std::atomic<sl_size> m_posPush;
+		char m_pad1[priv::concurrent_queue::CacheLineSize];
+
+		std::atomic<sl_size> m_posPop;
+		char m_pad2[priv::concurrent_queue::CacheLineSize];
+
+	};
+
+	/*
+		Unbounded multiple-producer single-consumer queue.
+		The elements are stored in linked segments of `SEGMENT_SIZE` slots. A push claims its slot by an atomic increment,
+		so it does not take a lock, and a new segment is allocated only once per `SEGMENT_SIZE` elements.
+		Only one thread may pop at the same time (the consumer).
+		A consumed segment is freed after every push which could have seen it has returned
+		(the running pushes are counted in two alternating counters), and the last freed segment is kept for reuse.
+	*/
+	template <class T, sl_size SEGMENT_SIZE = 64>
+	class SLIB_EXPORT MpscQueue
+	{
+	public:
+		MpscQueue() noexcept;
+
+		~MpscQueue() noexcept;
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(MpscQueue)
+
+	public:
+		// any thread
+		template <class... ARGS>
+		sl_bool push(ARGS&&... args) noexcept;
+
+		// consumer. an element is seen after its push returns
+		sl_bool pop(T* _out = sl_null) noexcept;
+
+		// consumer
+		sl_bool isEmpty() const noexcept;
+
+		// consumer
+		sl_bool isNotEmpty() const noexcept;
+
+		// consumer
+		void removeAll() noexcept;
+
+	protected:
+		struct Slot
+		{
+			std::atomic<sl_bool> flagReady;
+			SLIB_ALIGN(8) char value[sizeof(T)];
+		};
+
+		struct Segment
+		{
+			std::atomic<sl_size> indexPush;
+			std::atomic<Segment*> next;
+			Segment* nextRetired;
+			Slot slots[SEGMENT_SIZE];
+		};
+
+		static Segment* _createSegment() noexcept;
+
+		static void _initSegment(Segment* segment) noexcept;
+
+		Segment* _allocSegment() noexcept;
+
+		void _retire(Segment* segment) noexcept;
+
+		void _reclaim() noexcept;
+
+		void _freeSegments(Segment* segment) noexcept;
+
+	protected:
+		// producer side
+		std::atomic<Segment*> m_tail;
+		std::atomic<sl_uint32> m_epoch;
+		std::atomic<sl_size> m_nPushing[2];
+		std::atomic<Segment*> m_spare;
+		char m_pad0[priv::concurrent_queue::CacheLineSize];
+
+		// consumer side
+		Segment* m_head;
+		sl_size m_indexPop;
+		// retired before the last flip of `m_epoch`, waiting for the pushes of the previous epoch
+		Segment* m_retiredWaiting;
+		// retired after the last flip
+		Segment* m_retiredPending;
+
+	};
+
+}
+
+#include "detail/concurrent_queue.inc"
+
+#endif
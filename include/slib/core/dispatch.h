@@ -40,7 +40,7 @@ namespace slib
 		~Dispatcher();
 
 	public:
-		virtual sl_bool dispatch(const Function<void()>& callback, sl_uint64 delay_ms = 0) = 0;
+		virtual sl_bool dispatch(UniqueFunction<void()>&& task, sl_uint64 delay_ms = 0) = 0;
 
 	};
 	
@@ -49,13 +49,13 @@ namespace slib
 	class SLIB_EXPORT Dispatch
 	{
 	public:
-		static sl_bool dispatch(const Ref<Dispatcher>& dispatcher, const Function<void()>& task);
+		static sl_bool dispatch(const Ref<Dispatcher>& dispatcher, UniqueFunction<void()>&& task);
 		
-		static sl_bool dispatch(const Function<void()>& task);
+		static sl_bool dispatch(UniqueFunction<void()>&& task);
 		
-		static sl_bool setTimeout(const Ref<Dispatcher>& dispatcher, const Function<void()>& task, sl_uint64 delay_ms);
+		static sl_bool setTimeout(const Ref<Dispatcher>& dispatcher, UniqueFunction<void()>&& task, sl_uint64 delay_ms);
 		
-		static sl_bool setTimeout(const Function<void()>& task, sl_uint64 delay_ms);
+		static sl_bool setTimeout(UniqueFunction<void()>&& task, sl_uint64 delay_ms);
 		
 		static Ref<Timer> setInterval(const Ref<DispatchLoop>& loop, const Function<void(Timer*)>& task, sl_uint64 interval_ms);
 		
@@ -29,6 +29,9 @@
 #include "thread.h"
 #include "time.h"
 #include "map.h"
+#include "hash_map.h"
+#include "timer_wheel.h"
+#include "concurrent_queue.h"
 
 namespace slib
 {
@@ -56,7 +59,7 @@ namespace slib
 
 		sl_bool isRunning();
 
-		sl_bool dispatch(const Function<void()>& task, sl_uint64 delay_ms = 0) override;
+		sl_bool dispatch(UniqueFunction<void()>&& task, sl_uint64 delay_ms = 0) override;
 
 		sl_bool addTimer(const Ref<Timer>& timer);
 		
@@ -71,32 +74,26 @@ namespace slib
 
 		TimeCounter m_timeCounter;
 
-		LinkedQueue< Function<void()> > m_queueTasks;
+		MpscQueue< UniqueFunction<void()> > m_queueTasks;
 
-		struct TimeTask
+		// delayed tasks and started timers
+		TimerWheel m_timerWheel;
+		struct TimerEntry
 		{
-			sl_uint64 time;
-			Function<void()> task;
+			// distinguishes the wheel task of the current registration from the stale ones
+			sl_uint64 sequence;
+			sl_uint64 taskId;
 		};
-		CMap<sl_uint64, TimeTask> m_timeTasks;
-		Mutex m_lockTimeTasks;
-
-		class TimerTask
-		{
-		public:
-			WeakRef<Timer> timer;
-
-		public:
-			sl_bool operator==(const TimerTask& other) const;
-		};
-		LinkedQueue<TimerTask> m_queueTimers;
+		CHashMap<Timer*, TimerEntry> m_mapTimers;
+		sl_uint64 m_sequenceTimer;
 		Mutex m_lockTimer;
 
 	protected:
 		void _wake();
 		sl_int32 _getTimeout();
-		sl_int32 _getTimeout_TimeTasks();
-		sl_int32 _getTimeout_Timer();
+		sl_int32 _processTimerWheel();
+		sl_bool _scheduleTimer_NoLock(Timer* timer, sl_uint64 sequence, sl_uint64 now);
+		void _runTimer(Timer* key, const WeakRef<Timer>& weak, sl_uint64 sequence);
 		void _runLoop();
 
 	};
@@ -33,6 +33,8 @@ typedef sl_reg sl_file;
 
 namespace slib
 {
+
+	class MappedFile;
 	
 	class FileMode
 	{
@@ -108,6 +110,26 @@ namespace slib
 	
 	};
 	
+	enum class FileMapMode
+	{
+		Read = 0,
+		// the writes go to the file, and are visible to the other mappings of the file
+		Write = 1,
+		// the writes are private to the mapping, and the file is not changed
+		CopyOnWrite = 2
+	};
+
+	enum class FileMapHint
+	{
+		Normal = 0,
+		Sequential = 1,
+		Random = 2,
+		// starts reading the pages ahead
+		WillNeed = 3,
+		// the pages can be dropped. the changes of a `CopyOnWrite` mapping in the range are discarded
+		DontNeed = 4
+	};
+
 	class SLIB_EXPORT File : public IO
 	{
 		SLIB_DECLARE_OBJECT
@@ -170,6 +192,15 @@ namespace slib
 		sl_int32 read32(void* buf, sl_uint32 size) override;
 
 		sl_int32 write32(const void* buf, sl_uint32 size) override;
+
+		// reads at `offset` without using the file position, so the file can be shared by the readers
+		sl_int32 readAt32(sl_uint64 offset, void* buf, sl_uint32 size);
+
+		// writes at `offset` without using the file position
+		sl_int32 writeAt32(sl_uint64 offset, const void* buf, sl_uint32 size);
+
+		// waits until the written data reaches the storage device
+		sl_bool sync();
 	
 	
 		// works only if the file is already opened
@@ -283,6 +314,18 @@ namespace slib
 
 		static sl_bool appendAllTextUTF16BE(const StringParam& path, const StringParam& text);
 
+
+		// `size`: 0 means to the end of the file
+		Ref<MappedFile> map(sl_uint64 offset = 0, sl_uint64 size = 0, FileMapMode mode = FileMapMode::Read);
+
+		/*
+			Same as `readAllBytes`, except that the large files are mapped (copy-on-write) instead of being copied into a buffer.
+			The returned memory can be modified without changing the file.
+			The pages not touched yet are still backed by the file, so the memory should be released before the file can be truncated by others:
+			use it for reading and discarding the content in a call, and `readAllBytes` for the memory kept after the call.
+		*/
+		static Memory mapAllBytes(const StringParam& path, sl_size maxSize = SLIB_SIZE_MAX);
+
 	
 		static String getParentDirectoryPath(const String& path);
 
@@ -322,6 +365,82 @@ namespace slib
 
 	};
 	
+	/*
+		View of a region of the file mapped into the address space.
+		The pages are loaded from the page cache of the system on access, so the file is not copied into a buffer.
+		The view (and the memory returned by `getMemory`) stays valid until the object is freed, even if the file is closed.
+		Accessing the view after the file is truncated by another writer raises SIGBUS on Unix.
+	*/
+	class SLIB_EXPORT MappedFile : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		MappedFile();
+
+		~MappedFile();
+
+	public:
+		// `size`: 0 means to the end of the file
+		static Ref<MappedFile> create(const Ref<File>& file, sl_uint64 offset = 0, sl_uint64 size = 0, FileMapMode mode = FileMapMode::Read);
+
+		static Ref<MappedFile> open(const StringParam& path, FileMapMode mode = FileMapMode::Read);
+
+	public:
+		void* getData();
+
+		sl_size getSize();
+
+		// offset in the file
+		sl_uint64 getOffset();
+
+		FileMapMode getMode();
+
+		const Ref<File>& getFile();
+
+		// the memory keeps this object alive
+		Memory getMemory();
+
+		// `size`: 0 means to the end of the view
+		sl_bool advise(FileMapHint hint, sl_size offset = 0, sl_size size = 0);
+
+		// writes the modified pages of a `Write` mapping to the file
+		sl_bool flush(sl_bool flagAsync = sl_false);
+
+		/*
+			Extends the file if needed, and maps `size` bytes from the offset (`Write` mapping only).
+			The data may move to another address. The previous views stay valid until the object is freed.
+		*/
+		sl_bool setSize(sl_uint64 size);
+
+	protected:
+		sl_bool _map(sl_uint64 offset, sl_size size);
+
+		static void _unmap(void* base, sl_size size);
+
+		static sl_size _getAlignment();
+
+	protected:
+		Ref<File> m_file;
+		FileMapMode m_mode;
+		sl_uint64 m_offset;
+		sl_uint8* m_data;
+		sl_size m_size;
+
+		// start of the mapping, aligned to `_getAlignment()`
+		void* m_base;
+		sl_size m_sizeMapped;
+
+		// mappings replaced by `setSize`. unmapped when the object is freed
+		struct OldMapping
+		{
+			void* base;
+			sl_size size;
+		};
+		List<OldMapping> m_listOldMappings;
+
+	};
+
 	// FilePathSegments is not thread-safe
 	class SLIB_EXPORT FilePathSegments
 	{
@@ -0,0 +1,263 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_FILE_BTREE
+#define CHECKHEADER_SLIB_CORE_FILE_BTREE
+
+#include "definition.h"
+
+#include "btree.h"
+#include "file.h"
+#include "flat_hash_map.h"
+#include "mio.h"
+
+namespace slib
+{
+
+	class SLIB_EXPORT FileBTreeParam
+	{
+	public:
+		String path;
+
+		// default: 4096, size of the pages in a new file. a page should be large enough to store `order` items of the tree
+		sl_uint32 pageSize;
+
+		// default: 1024, number of the pages kept in the memory, not counting the pages modified after the last commit
+		sl_uint32 cacheCapacity;
+
+	public:
+		FileBTreeParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(FileBTreeParam)
+
+	};
+
+	/*
+		Page file of `FileBTree`, with a write-ahead log.
+
+		Page 0 is the header, keeping the root page, the number of the pages and the head of the free pages.
+		The free pages are chained through their first 8 bytes.
+		`commit` writes the modified pages and the header to the log ("<path>-wal") and syncs it before writing them to the page file.
+		When the file is opened, a complete log left by an interrupted commit is applied again and an incomplete log is discarded,
+		so the page file always has the state of the last successful commit.
+	*/
+	class SLIB_EXPORT FileBTreeStorage
+	{
+	public:
+		FileBTreeStorage();
+
+		~FileBTreeStorage();
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(FileBTreeStorage)
+
+	public:
+		// `pageSize` is used for a new file. `order` is recorded in a new file, and should match for an existing file
+		sl_bool open(const StringParam& path, sl_uint32 pageSize, sl_uint32 order);
+
+		void close();
+
+		sl_bool isOpened() const noexcept;
+
+		sl_uint32 getPageSize() const noexcept;
+
+		sl_uint64 getRootPage() const noexcept;
+
+		void setRootPage(sl_uint64 page) noexcept;
+
+		// returns 0 on failure
+		sl_uint64 allocatePage();
+
+		void freePage(sl_uint64 page);
+
+		sl_bool readPage(sl_uint64 page, void* buf);
+
+		// `pages`: `count` pages of `getPageSize()` bytes, in the order of `indices`
+		sl_bool commit(const sl_uint64* indices, const void* pages, sl_size count);
+
+	protected:
+		sl_bool _readHeader();
+
+		sl_bool _loadFreePages(sl_uint64 head, sl_uint64 count);
+
+		sl_bool _recover();
+
+		sl_bool _applyLog(const sl_uint8* log, sl_size size);
+
+	protected:
+		Ref<File> m_file;
+		Ref<File> m_fileLog;
+		sl_uint32 m_pageSize;
+		sl_uint32 m_order;
+		sl_uint64 m_countPages;
+		sl_uint64 m_rootPage;
+
+		// stack of the free pages. the last one is the head of the chain
+		List<sl_uint64> m_freePages;
+		// number of the free pages from the bottom of the stack, whose links are already in the file
+		sl_size m_countFreePagesCommitted;
+		sl_bool m_flagModified;
+
+	};
+
+	/*
+		Serialization of the keys and the values stored in `FileBTree`.
+		The default implementation copies the bytes of the value, so it fits only the trivially copyable types.
+		The integers and the floating point numbers are stored in little endian, and `String`, `String16` and `Memory` with their length.
+	*/
+	template <class T>
+	class SLIB_EXPORT FileBTreeSerializer
+	{
+	public:
+		static sl_size getSize(const T& value) noexcept;
+
+		// returns the end of the written bytes
+		static sl_uint8* write(sl_uint8* buf, const T& value) noexcept;
+
+		// returns the end of the read bytes, or null if the data is invalid
+		static const sl_uint8* read(const sl_uint8* buf, const sl_uint8* end, T& value) noexcept;
+
+	};
+
+	/*
+		B-tree stored in the fixed-size pages of a file.
+
+		The nodes are decoded into a bounded page cache (buffer pool), and the least recently used clean pages are dropped
+		when the cache is full. The modified pages stay in the memory until `commit`, which writes them through the
+		write-ahead log of `FileBTreeStorage`, so a crash loses the changes after the last commit but never corrupts the tree.
+		When the modified pages exceed the cache capacity, they are committed at the end of the current operation.
+		`close` (and the destructor) commits the remaining changes.
+
+		Serialized `order` items should fit in a page: the operations fail when a node does not fit.
+	*/
+	template < class KT, class VT, class KEY_COMPARE = Compare<KT>, class KEY_SERIALIZER = FileBTreeSerializer<KT>, class VALUE_SERIALIZER = FileBTreeSerializer<VT> >
+	class SLIB_EXPORT FileBTree : public BTree<KT, VT, KEY_COMPARE>
+	{
+	public:
+		typedef typename BTree<KT, VT, KEY_COMPARE>::NodeData NodeData;
+
+	public:
+		FileBTree(sl_uint32 order = SLIB_BTREE_DEFAULT_ORDER);
+
+		FileBTree(const KEY_COMPARE& compare, sl_uint32 order = SLIB_BTREE_DEFAULT_ORDER);
+
+		~FileBTree();
+
+	public:
+		sl_bool open(const FileBTreeParam& param);
+
+		sl_bool open(const StringParam& path);
+
+		void close();
+
+		sl_bool isOpened() const noexcept;
+
+		// fails while a node is in use
+		sl_bool commit();
+
+		sl_uint32 getCacheCapacity() const noexcept;
+
+		void setCacheCapacity(sl_uint32 capacity);
+
+		// number of the pages in the memory
+		sl_size getCachedPagesCount() const noexcept;
+
+		/*
+			Builds an empty tree from the items sorted by the key, filling the pages bottom-up without splitting them.
+			The pages are committed on the way when the modified pages exceed the cache capacity.
+			If the process stops during the load, the tree is still empty but the pages written so far are not reused.
+		*/
+		sl_bool bulkLoad(const KT* keys, const VT* values, sl_size count);
+
+	protected:
+		struct Page
+		{
+			// the first member, so the node data given to `BTree` can be converted back to the page
+			NodeData data;
+			sl_uint64 index;
+			sl_uint32 countRef;
+			sl_bool flagDirty;
+			sl_bool flagDeleted;
+			// list of the clean pages not in use, most recently used first
+			Page* before;
+			Page* next;
+		};
+
+	protected:
+		BTreeNode getRootNode() const override;
+
+		sl_bool setRootNode(BTreeNode node) override;
+
+		BTreeNode createNode(NodeData* data) override;
+
+		sl_bool deleteNode(BTreeNode node) override;
+
+		NodeData* readNodeData(const BTreeNode& node) const override;
+
+		sl_bool writeNodeData(const BTreeNode& node, NodeData* data) override;
+
+		void releaseNodeData(NodeData* data) override;
+
+	protected:
+		// `data`: the arrays are moved to the page. null to allocate new arrays
+		Page* _createPage(sl_uint64 index, NodeData* data);
+
+		void _freePage(Page* page);
+
+		Page* _getPage(sl_uint64 index);
+
+		void _releasePage(Page* page);
+
+		void _setDirty(Page* page);
+
+		void _linkClean(Page* page);
+
+		void _unlinkClean(Page* page);
+
+		void _evict();
+
+		void _freeAllPages();
+
+		sl_size _getSerializedSize(NodeData* data) const;
+
+		void _serialize(NodeData* data, sl_uint8* buf) const;
+
+		sl_bool _deserialize(const sl_uint8* buf, NodeData* data) const;
+
+		sl_uint64 _buildSubtree(const KT* keys, const VT* values, sl_size count, sl_uint64 parent);
+
+	protected:
+		FileBTreeStorage m_storage;
+		FlatHashMap<sl_uint64, Page*> m_pages;
+		Page* m_pageCleanFirst;
+		Page* m_pageCleanLast;
+		sl_uint32 m_cacheCapacity;
+		sl_size m_countPinned;
+		sl_size m_countDirty;
+		Memory m_bufPage;
+
+	};
+
+}
+
+#include "detail/file_btree.inc"
+
+#endif
@@ -0,0 +1,233 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_FLAT_HASH_MAP
+#define CHECKHEADER_SLIB_CORE_FLAT_HASH_MAP
+
+#include "definition.h"
+
+#include "map_common.h"
+#include "hash.h"
+#include "compare.h"
+#include "list.h"
+#include "pair.h"
+#include "new_helper.h"
+
+#ifdef SLIB_SUPPORT_STD_TYPES
+#include <initializer_list>
+#endif
+
+namespace slib
+{
+
+	template <class KT, class VT>
+	class SLIB_EXPORT FlatHashMapNode
+	{
+	public:
+		KT key;
+		VT value;
+
+	public:
+		template <class KEY, class... VALUE_ARGS>
+		FlatHashMapNode(KEY&& _key, VALUE_ARGS&&... value_args) noexcept;
+
+	};
+
+	namespace priv
+	{
+		namespace flat_hash_map
+		{
+
+			/*
+				Control byte of a slot.
+				Full slots keep the low 7 bits (H2) of the hash, so the sign bit tells whether the slot is full.
+			*/
+			enum class Control : sl_int8
+			{
+				Empty = -128,
+				Deleted = -2
+			};
+
+		}
+	}
+
+	/*
+		Open-addressing hash map with contiguous storage.
+
+		The entries live in a single array of slots, and a parallel array of one-byte control words is
+		probed a group at a time (16 slots with SSE2, 8 slots with the portable 64-bit fallback),
+		so a lookup usually touches one control group and one slot without chasing any pointer.
+		Node pointers and iterators are invalidated by the insertions causing a rehash, and by `reserve`.
+		Unlike `CHashMap`, this class is not an `Object` and is not thread-safe: the owner is responsible for locking.
+	*/
+	template < class KT, class VT, class HASH = Hash<KT>, class KEY_EQUALS = Equals<KT> >
+	class SLIB_EXPORT FlatHashMap
+	{
+	public:
+		typedef KT KEY_TYPE;
+		typedef VT VALUE_TYPE;
+		typedef FlatHashMapNode<KT, VT> NODE;
+
+		class Iterator
+		{
+		public:
+			Iterator() noexcept;
+
+			Iterator(const sl_int8* ctrl, NODE* slot, const sl_int8* ctrlEnd) noexcept;
+
+		public:
+			NODE& operator*() const noexcept;
+
+			NODE* operator->() const noexcept;
+
+			sl_bool operator==(const Iterator& other) const noexcept;
+
+			sl_bool operator!=(const Iterator& other) const noexcept;
+
+			Iterator& operator++() noexcept;
+
+		public:
+			NODE* getNode() const noexcept;
+
+		protected:
+			void _skipEmpty() noexcept;
+
+		protected:
+			const sl_int8* m_ctrl;
+			NODE* m_slot;
+			const sl_int8* m_ctrlEnd;
+
+		};
+
+	public:
+		FlatHashMap(sl_size capacity = 0, const HASH& hash = HASH(), const KEY_EQUALS& equals = KEY_EQUALS()) noexcept;
+
+		~FlatHashMap() noexcept;
+
+	public:
+		FlatHashMap(const FlatHashMap& other) noexcept;
+
+		FlatHashMap& operator=(const FlatHashMap& other) noexcept;
+
+		FlatHashMap(FlatHashMap&& other) noexcept;
+
+		FlatHashMap& operator=(FlatHashMap&& other) noexcept;
+
+#ifdef SLIB_SUPPORT_STD_TYPES
+		FlatHashMap(const std::initializer_list< Pair<KT, VT> >& l, const HASH& hash = HASH(), const KEY_EQUALS& equals = KEY_EQUALS()) noexcept;
+#endif
+
+	public:
+		sl_size getCount() const noexcept;
+
+		sl_bool isEmpty() const noexcept;
+
+		sl_bool isNotEmpty() const noexcept;
+
+		// number of the slots, always zero or a power of 2
+		sl_size getCapacity() const noexcept;
+
+		NODE* find(const KT& key) const noexcept;
+
+		sl_bool contains(const KT& key) const noexcept;
+
+		VT* getItemPointer(const KT& key) const noexcept;
+
+		sl_bool get(const KT& key, VT* _out = sl_null) const noexcept;
+
+		VT getValue(const KT& key) const noexcept;
+
+		VT getValue(const KT& key, const VT& def) const noexcept;
+
+		// replaces the value if the key exists, or inserts a new entry
+		template <class KEY, class VALUE>
+		NODE* put(KEY&& key, VALUE&& value, sl_bool* isInsertion = sl_null) noexcept;
+
+		// replaces the value only if the key exists
+		template <class KEY, class VALUE>
+		NODE* replace(const KEY& key, VALUE&& value) noexcept;
+
+		// inserts a new entry only if the key does not exist. on failure, `node` of the result points the existing entry
+		template <class KEY, class... VALUE_ARGS>
+		MapEmplaceReturn<NODE> emplace(KEY&& key, VALUE_ARGS&&... value_args) noexcept;
+
+		template <class MAP>
+		sl_bool putAll(const MAP& other) noexcept;
+
+		sl_bool remove(const KT& key, VT* outValue = sl_null) noexcept;
+
+		// `node` must belong to this map. the other nodes and the iterators are not moved
+		void removeAt(NODE* node) noexcept;
+
+		sl_size removeAll() noexcept;
+
+		// prepares the slots for `count` entries without rehashing
+		sl_bool reserve(sl_size count) noexcept;
+
+		List<KT> getAllKeys() const noexcept;
+
+		List<VT> getAllValues() const noexcept;
+
+	public:
+		Iterator begin() const noexcept;
+
+		Iterator end() const noexcept;
+
+	protected:
+		sl_size _getHash(const KT& key) const noexcept;
+
+		sl_size _findIndex(const KT& key, sl_size hash) const noexcept;
+
+		sl_size _findInsertIndex(sl_size hash) const noexcept;
+
+		sl_size _prepareInsert(sl_size hash) noexcept;
+
+		void _setControl(sl_size index, sl_int8 h2) noexcept;
+
+		void _eraseAt(sl_size index) noexcept;
+
+		sl_bool _rehash(sl_size capacity) noexcept;
+
+		void _free() noexcept;
+
+		void _init() noexcept;
+
+		template <class KEY, class... VALUE_ARGS>
+		NODE* _insertAt(sl_size index, sl_size hash, KEY&& key, VALUE_ARGS&&... value_args) noexcept;
+
+	protected:
+		sl_int8* m_ctrl;
+		NODE* m_slots;
+		sl_size m_capacity;
+		sl_size m_count;
+		// number of the entries to be inserted before the next rehash
+		sl_size m_growthLeft;
+		HASH m_hash;
+		KEY_EQUALS m_equals;
+
+	};
+
+}
+
+#include "detail/flat_hash_map.inc"
+
+#endif
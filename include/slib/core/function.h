@@ -30,6 +30,7 @@
 #include "tuple.h"
 #include "null_value.h"
 #include "list.h"
+#include "allocator.h"
 
 namespace slib
 {
@@ -46,6 +47,9 @@ namespace slib
 	template <class T>
 	class FunctionList;
 
+	template <class T>
+	class UniqueFunction;
+
 	class CallableBase : public Referable
 	{
 	public:
@@ -220,6 +224,93 @@ namespace slib
 	};
 
 	
+	namespace priv
+	{
+		namespace function
+		{
+			
+			template <class RET_TYPE, class... ARGS>
+			struct UniqueFunctionOps
+			{
+				RET_TYPE (*invoke)(void* storage, ARGS... args);
+				// moves the callable from `source` (destructed after) to `target`
+				void (*move)(void* target, void* source);
+				void (*destruct)(void* storage);
+			};
+			
+		}
+	}
+	
+	/*
+		Move-only function holding small callables (up to the size of 4 pointers) in its own storage,
+		so wrapping a lambda does not allocate any memory nor change any reference count.
+		Larger callables are allocated from `MemoryPool`. A `Function` is held by its reference.
+	*/
+	template <class RET_TYPE, class... ARGS>
+	class SLIB_EXPORT UniqueFunction<RET_TYPE(ARGS...)>
+	{
+	public:
+		UniqueFunction() noexcept;
+		
+		UniqueFunction(sl_null_t) noexcept;
+		
+		UniqueFunction(UniqueFunction&& other) noexcept;
+		
+		UniqueFunction(const UniqueFunction& other) = delete;
+		
+		template <class FUNC>
+		UniqueFunction(FUNC&& func) noexcept;
+		
+		~UniqueFunction() noexcept;
+		
+	public:
+		UniqueFunction& operator=(UniqueFunction&& other) noexcept;
+		
+		UniqueFunction& operator=(const UniqueFunction& other) = delete;
+		
+		UniqueFunction& operator=(sl_null_t) noexcept;
+		
+		template <class FUNC>
+		UniqueFunction& operator=(FUNC&& func) noexcept;
+		
+		RET_TYPE operator()(ARGS... args) const;
+		
+	public:
+		sl_bool isNull() const noexcept;
+		
+		sl_bool isNotNull() const noexcept;
+		
+		void setNull() noexcept;
+		
+		// moves the callable to a `Function`. the held `Function` is returned without allocation
+		Function<RET_TYPE(ARGS...)> release() noexcept;
+		
+	protected:
+		template <class FUNC>
+		void _init(FUNC&& func) noexcept;
+		
+		template <class T>
+		void _init(T* func) noexcept;
+		
+		void _init(const Function<RET_TYPE(ARGS...)>& func) noexcept;
+		
+		void _init(Function<RET_TYPE(ARGS...)>& func) noexcept;
+		
+		void _init(Function<RET_TYPE(ARGS...)>&& func) noexcept;
+		
+		void _init(const Atomic< Function<RET_TYPE(ARGS...)> >& func) noexcept;
+		
+		template <class FUNC, class VALUE>
+		void _set(VALUE&& value) noexcept;
+		
+		void _moveFrom(UniqueFunction& other) noexcept;
+		
+	protected:
+		const priv::function::UniqueFunctionOps<RET_TYPE, ARGS...>* m_ops;
+		mutable void* m_storage[4];
+		
+	};
+	
 	template <class RET_TYPE, class... ARGS>
 	class SLIB_EXPORT FunctionList<RET_TYPE(ARGS...)> : public Callable<RET_TYPE(ARGS...)>
 	{
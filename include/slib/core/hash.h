@@ -74,11 +74,51 @@ namespace slib
 #endif
 	}
 	
+	// XXH3 (64-bit) hash of the bytes. The 32-bit hash is the folded 64-bit hash
 	sl_uint32 HashBytes32(const void* buf, sl_size n) noexcept;
 	
+	sl_uint32 HashBytes32(const void* buf, sl_size n, sl_uint64 seed) noexcept;
+	
 	sl_uint64 HashBytes64(const void* buf, sl_size n) noexcept;
 	
+	sl_uint64 HashBytes64(const void* buf, sl_size n, sl_uint64 seed) noexcept;
+	
 	sl_size HashBytes(const void* buf, sl_size n) noexcept;
+	
+	sl_size HashBytes(const void* buf, sl_size n, sl_uint64 seed) noexcept;
+	
+	/*
+		Streaming form of `HashBytes`: hashing the bytes in several pieces gives the same result as hashing them at once.
+	*/
+	class SLIB_EXPORT BytesHasher
+	{
+	public:
+		BytesHasher() noexcept;
+		
+		BytesHasher(sl_uint64 seed) noexcept;
+		
+	public:
+		void start(sl_uint64 seed = 0) noexcept;
+		
+		void update(const void* data, sl_size size) noexcept;
+		
+		// does not change the state, so more bytes can be added after
+		sl_uint32 finish32() const noexcept;
+		
+		sl_uint64 finish64() const noexcept;
+		
+		sl_size finish() const noexcept;
+		
+	private:
+		sl_uint64 m_acc[8];
+		sl_uint8 m_secret[192];
+		sl_uint8 m_buffer[256];
+		sl_uint64 m_sizeTotal;
+		sl_uint64 m_seed;
+		sl_uint32 m_sizeBuffered;
+		sl_uint32 m_nStripesInBlock;
+		
+	};
 
 	template <>
 	class Hash<char>
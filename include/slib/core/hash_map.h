@@ -70,6 +70,8 @@ namespace slib
 		template <class KEY, class... VALUE_ARGS>
 		HashMapNode(KEY&& _key, VALUE_ARGS&&... value_args) noexcept;
 		
+		SLIB_DECLARE_POOLED_NEW
+		
 	public:
 		HashMapNode* getNext() const noexcept;
 		
@@ -28,6 +28,7 @@
 #include "map_common.h"
 #include "hash.h"
 #include "list.h"
+#include "allocator.h"
 
 namespace slib
 {
@@ -45,6 +46,8 @@ namespace slib
 		template <class KEY, class... VALUE_ARGS>
 		HashTableNode(KEY&& _key, VALUE_ARGS&&... value_args) noexcept;
 		
+		SLIB_DECLARE_POOLED_NEW
+		
 	};
 	
 	template <class KT, class VT>
@@ -28,6 +28,7 @@
 #include "object.h"
 #include "list.h"
 #include "array.h"
+#include "allocator.h"
 
 namespace slib
 {
@@ -31,6 +31,7 @@
 #include "pair.h"
 #include "red_black_tree.h"
 #include "nullable.h"
+#include "allocator.h"
 
 #ifdef SLIB_SUPPORT_STD_TYPES
 #include <initializer_list>
@@ -71,6 +72,8 @@ namespace slib
 		template <class KEY, class... VALUE_ARGS>
 		MapNode(KEY&& _key, VALUE_ARGS&&... value_args) noexcept;
 		
+		SLIB_DECLARE_POOLED_NEW
+		
 	public:
 		MapNode* getNext() const noexcept;
 		
@@ -0,0 +1,170 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_OPEN_FILE_CACHE
+#define CHECKHEADER_SLIB_CORE_OPEN_FILE_CACHE
+
+#include "definition.h"
+
+#include "object.h"
+#include "file.h"
+#include "hash_map.h"
+#include "mutex.h"
+#include "thread.h"
+
+namespace slib
+{
+
+	class SLIB_EXPORT OpenFileInfo : public Referable
+	{
+	public:
+		String path;
+		sl_bool flagExists;
+		sl_bool flagDirectory;
+		sl_uint64 size;
+		Time modifiedTime;
+
+		// opened for reading. null for directories and missing files. do not seek: the file is shared by the readers
+		Ref<File> file;
+
+	public:
+		OpenFileInfo();
+
+		~OpenFileInfo();
+
+	};
+
+	class SLIB_EXPORT OpenFileCacheParam
+	{
+	public:
+		// default: 1000
+		sl_uint32 maxFilesCount;
+
+		// default: 2000, in milliseconds. entries are validated again after this interval when their changes can not be watched
+		sl_uint32 validationInterval;
+
+		// default: true, watches the changes of the directories (inotify on Linux)
+		sl_bool flagWatchChanges;
+
+	public:
+		OpenFileCacheParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(OpenFileCacheParam)
+
+	};
+
+	/*
+		Keeps the descriptors and the attributes of the recently used files.
+		The least recently used entries are closed when the cache is full.
+		Missing files are also cached, so repeated requests to the nonexistent paths do not hit the file system.
+		On Linux, the parent directories of the entries are watched by inotify and the entries are dropped as soon as the files change.
+		Renaming an ancestor of the parent directory is not detected.
+	*/
+	class SLIB_EXPORT OpenFileCache : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		OpenFileCache();
+
+		~OpenFileCache();
+
+	public:
+		static Ref<OpenFileCache> create(const OpenFileCacheParam& param);
+
+		static Ref<OpenFileCache> create();
+
+	public:
+		// returns the cached entry, or the attributes read from the file system
+		Ref<OpenFileInfo> get(const String& path);
+
+		void invalidate(const String& path);
+
+		void invalidateAll();
+
+		sl_size getCount();
+
+		// whether the changes are notified by the system
+		sl_bool isWatching();
+
+		void release();
+
+	protected:
+		struct Entry
+		{
+			Ref<OpenFileInfo> info;
+			String directory;
+			sl_uint64 timeValidated;
+			sl_bool flagWatched;
+			Entry* before;
+			Entry* next;
+		};
+
+		Ref<OpenFileInfo> _load(const String& path);
+
+		void _link(Entry* entry);
+
+		void _unlink(Entry* entry);
+
+		void _remove(Entry* entry);
+
+		void _removeAll();
+
+		void _invalidate(const String& path);
+
+		void _invalidateDirectory(const String& directory);
+
+		sl_bool _startWatching();
+
+		void _stopWatching();
+
+		// called outside of the lock
+		sl_bool _watch(const String& directory);
+
+		void _runWatching();
+
+	protected:
+		sl_uint32 m_maxFilesCount;
+		sl_uint32 m_validationInterval;
+
+		Mutex m_lock;
+		CHashMap<String, Entry*> m_map;
+		// most recently used entry first
+		Entry* m_first;
+		Entry* m_last;
+		sl_size m_count;
+		// increased on every invalidation, so the entries loaded during an invalidation are not cached
+		sl_uint64 m_seqInvalidation;
+
+		int m_fdWatch;
+		Ref<Thread> m_threadWatch;
+		Mutex m_lockWatch;
+		// directory => watch descriptor
+		CHashMap<String, sl_int32> m_mapWatchDirectories;
+		// watch descriptor => directories (a directory can be watched by the different paths)
+		CHashMap< sl_int32, List<String> > m_mapWatchDescriptors;
+
+	};
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#ifndef CHECKHEADER_SLIB_CORE_PARALLEL_SORT
+#define CHECKHEADER_SLIB_CORE_PARALLEL_SORT
+
+#include "definition.h"
+
+#include "sort.h"
+#include "thread_pool.h"
+#include "system.h"
+#include "function.h"
+
+namespace slib
+{
+
+	/*
+		Sorts on a ThreadPool.
+		The list is split into a chunk per thread (the calling thread works too), the chunks are sorted concurrently, and then merged in log2(chunks) rounds.
+		Each merge is split at the merge-path points into equal parts, so every round keeps all threads busy.
+		The lists shorter than 8192 items, and the lists whose merge buffer (n items) can not be allocated, are sorted on the calling thread.
+		`pool`: null means the shared work-stealing pool (see `getDefaultThreadPool`).
+	*/
+	class SLIB_EXPORT ParallelSort
+	{
+	public:
+		// not stable. the chunks are sorted by `IntroSort`
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortAsc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE(), ThreadPool* pool = sl_null) noexcept;
+
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortDesc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE(), ThreadPool* pool = sl_null) noexcept;
+
+		// stable. the chunks are sorted by `MergeSort`
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortStableAsc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE(), ThreadPool* pool = sl_null) noexcept;
+
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortStableDesc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE(), ThreadPool* pool = sl_null) noexcept;
+
+	public:
+		// work-stealing pool with a worker per processor, created on the first use
+		static Ref<ThreadPool> getDefaultThreadPool();
+
+		// calls `task` with the indices 0 ~ `count - 1` on the pool and on the calling thread, and returns after all the calls are finished
+		static void run(ThreadPool* pool, sl_size count, const Function<void(sl_size index)>& task);
+
+	};
+
+}
+
+#include "detail/parallel_sort.inc"
+
+#endif
@@ -104,6 +104,14 @@ namespace slib
 
 	typedef ULONGLONG (WINAPI *WINAPI_GetTickCount64)();
 
+	// `VirtualAddresses`: array of WIN32_MEMORY_RANGE_ENTRY (Windows 8 or later)
+	typedef BOOL (WINAPI *WINAPI_PrefetchVirtualMemory)(
+		HANDLE hProcess,
+		ULONG_PTR NumberOfEntries,
+		PVOID VirtualAddresses,
+		ULONG Flags
+	);
+
 	typedef BOOL (WINAPI *WINAPI_ShowScrollBar)(
 		HWND hWnd,
 		int  wBar,
@@ -217,6 +225,8 @@ namespace slib
 
 		static WINAPI_GetTickCount64 getAPI_GetTickCount64();
 
+		static WINAPI_PrefetchVirtualMemory getAPI_PrefetchVirtualMemory();
+
 		static HMODULE loadLibrary_user32();
 
 		static WINAPI_ShowScrollBar getAPI_ShowScrollBar();
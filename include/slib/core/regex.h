@@ -27,6 +27,7 @@
 
 #include "object.h"
 #include "string.h"
+#include "list.h"
 
 namespace slib
 {
@@ -74,6 +75,25 @@ namespace slib
 		};
 	};
 	
+	namespace priv
+	{
+		namespace regex
+		{
+			class Program;
+			class Dfa;
+		}
+	}
+
+	/*
+		Patterns are compiled by the native engine: a Thompson NFA over the bytes of the UTF-8 string, run by a lazily built DFA.
+		The time of `match` and `search` is linear in the length of the string, and no recursion depends on the string.
+		`indexOf` finds the match position by a Pike VM simulating the NFA (also linear), preferring the alternatives and the quantifiers as ECMAScript does.
+		A literal prefix of the pattern is searched by `Base::findMemory` before running the automaton.
+
+		The native engine supports the ECMAScript grammar without back-references and look-arounds.
+		The other patterns (or the flags other than `Icase`, `Nosubs`, `Optimize` and `ECMAScript`) are passed to `std::regex`.
+		`NotBol`, `NotEol`, `NotBow`, `NotEow`, `NotNull` and `Continuous` are supported by the native engine, and the other match flags do not change the result.
+	*/
 	class CRegEx : public Object
 	{
 		SLIB_DECLARE_OBJECT
@@ -89,12 +109,26 @@ namespace slib
 		static Ref<CRegEx> create(const String& pattern, const RegExFlags& flags) noexcept;
 
 	public:
+		// whole string
 		sl_bool match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+
+		// any substring
+		sl_bool search(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+
+		// returns the index of the leftmost match, or -1
+		sl_reg indexOf(const String& str, sl_size* outLength = sl_null, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+
+		// false if the pattern is matched by `std::regex`
+		sl_bool isNative() noexcept;
 		
 	private:
 		static Ref<CRegEx> _create(const String& pattern, int flags) noexcept;
 		
 	private:
+		priv::regex::Program* m_program;
+		priv::regex::Dfa* m_dfaMatch;
+		priv::regex::Dfa* m_dfaSearch;
+		priv::regex::Dfa* m_dfaPrefix;
 		void* m_obj;
 		
 	};
@@ -114,6 +148,10 @@ namespace slib
 	public:
 		sl_bool match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
 
+		sl_bool search(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+
+		sl_reg indexOf(const String& str, sl_size* outLength = sl_null, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+
 	private:
 		AtomicRef<CRegEx> ref;
 		
@@ -133,6 +171,10 @@ namespace slib
 				
 	public:
 		sl_bool match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+
+		sl_bool search(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+
+		sl_reg indexOf(const String& str, sl_size* outLength = sl_null, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
 		
 	public:
 		static sl_bool matchEmail(const String& str) noexcept;
@@ -141,6 +183,39 @@ namespace slib
 		Ref<CRegEx> ref;
 		
 	};
+	
+	/*
+		Matches a string against many patterns in a single pass, by a DFA built from the union of the patterns.
+		Each state of the automaton keeps the patterns matched so far, so `search` reports every pattern found anywhere in the string.
+	*/
+	class SLIB_EXPORT RegExSet : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		RegExSet() noexcept;
+
+		~RegExSet() noexcept;
+
+	public:
+		// returns null if any pattern is invalid or is not supported by the native engine
+		static Ref<RegExSet> create(const ListParam<String>& patterns, const RegExFlags& flags = RegExFlags::Default) noexcept;
+
+	public:
+		sl_uint32 getPatternsCount() noexcept;
+
+		// indices of the patterns matching the whole string, in ascending order
+		List<sl_uint32> match(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+
+		// indices of the patterns matching any substring, in ascending order
+		List<sl_uint32> search(const String& str, const RegExMatchFlags& flags = RegExMatchFlags::Default) noexcept;
+
+	private:
+		priv::regex::Program* m_program;
+		priv::regex::Dfa* m_dfaMatch;
+		priv::regex::Dfa* m_dfaSearch;
+
+	};
 
 }
 
@@ -25,9 +25,12 @@
 
 #include "definition.h"
 
+#include "base.h"
 #include "cpp.h"
 #include "compare.h"
 
+#include <new>
+
 namespace slib
 {
 	
@@ -69,6 +72,76 @@ namespace slib
 		static void sortDesc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE()) noexcept;
 
 	};
+	
+	class SLIB_EXPORT HeapSort
+	{
+	public:
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortAsc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE()) noexcept;
+
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortDesc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE()) noexcept;
+
+	};
+	
+	/*
+		Pattern-defeating quicksort.
+		Pivots are chosen by the median of 3 (the pseudo-median of 9 for the large ranges), the runs of the items equal to the previous pivot are
+		split off in a linear pass, and the already partitioned ranges are finished by a bounded insertion sort.
+		The worst case is O(n log n): the range is passed to `HeapSort` after log(n) badly unbalanced partitions.
+		Not stable.
+	*/
+	class SLIB_EXPORT IntroSort
+	{
+	public:
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortAsc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE()) noexcept;
+
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortDesc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE()) noexcept;
+
+	};
+	
+	/*
+		Stable natural merge sort, following TimSort.
+		The list is scanned for the ascending and the strictly descending runs (the latter are reversed), the short runs are extended by binary insertion sort,
+		and the runs are merged while keeping the TimSort invariants on the run stack. O(n) for the presorted lists and O(n log n) in the worst case.
+		Uses a buffer of up to n/2 items, and falls back to the in-place merging if the buffer can not be allocated.
+	*/
+	class SLIB_EXPORT MergeSort
+	{
+	public:
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortAsc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE()) noexcept;
+
+		template < class TYPE, class COMPARE = Compare<TYPE> >
+		static void sortDesc(TYPE* list, sl_size size, const COMPARE& compare = COMPARE()) noexcept;
+
+	};
+	
+	/*
+		Stable LSD radix sort on 8-bit digits, for the integer and the floating point keys.
+		The passes whose digit is same for every item are skipped.
+		Floating point keys are ordered by their sign and magnitude: -NaN < -Inf < ... < -0 < +0 < ... < +Inf < +NaN.
+		Uses a buffer of n items (n keys and indices for `sortByKey`), and falls back to the comparison sort if it can not be allocated.
+	*/
+	class SLIB_EXPORT RadixSort
+	{
+	public:
+		template <class TYPE>
+		static void sortAsc(TYPE* list, sl_size size) noexcept;
+
+		template <class TYPE>
+		static void sortDesc(TYPE* list, sl_size size) noexcept;
+
+		// `getKey`: returns the integer or floating point key of an item
+		template <class TYPE, class KEY_GETTER>
+		static void sortByKeyAsc(TYPE* list, sl_size size, const KEY_GETTER& getKey) noexcept;
+
+		template <class TYPE, class KEY_GETTER>
+		static void sortByKeyDesc(TYPE* list, sl_size size, const KEY_GETTER& getKey) noexcept;
+
+	};
 
 }
 
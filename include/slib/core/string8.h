@@ -174,6 +174,28 @@ namespace slib
 		 * `ref` should be used to keep the alive of the string content.
 		 */
 		static String fromRef(const Ref<Referable>& ref, const sl_char8* str, sl_reg len = -1) noexcept;
+
+		/**
+		 * Returns the interned string having the same content as `str`.
+		 * All the interned strings of the same content share one container, so copying them costs no reference counting,
+		 * comparing them is a pointer comparison, and their hash code is computed only once.
+		 * The interned strings are never freed, and must not be modified.
+		 * Returns a newly created string if `str` is longer than 128 characters, or too many strings are already interned.
+		 * The table is shared by the process and limited, so intern only the trusted strings (names known to the program).
+		 * Interning the input of a peer lets it fill the table with the strings which are never freed; use `findInterned()` for such input.
+		 */
+		static String intern(const sl_char8* str, sl_reg len = -1) noexcept;
+
+		/**
+		 * Returns the interned string having the same content.
+		 */
+		String intern() const noexcept;
+
+		/**
+		 * Returns the interned string having the same content as `str`, without adding it to the table.
+		 * Returns null if `str` is not interned.
+		 */
+		static String findInterned(const sl_char8* str, sl_reg len = -1) noexcept;
 		
 		/**
 		 * Creates a string pointing the `mem` as the UTF-8 content, without copying the data.
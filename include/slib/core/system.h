@@ -57,6 +57,9 @@ namespace slib
 		static String getUserName();
 		
 		static String getFullUserName();
+		
+		
+		static sl_uint32 getProcessorsCount();
 
 
 		static sl_uint32 getTickCount();
@@ -86,6 +86,9 @@ namespace slib
 		ThreadPriority getPriority();
 	
 		void setPriority(ThreadPriority priority);
+		
+		// binds the thread to the processor at `indexProcessor`. returns false when the platform does not support it
+		sl_bool setProcessorAffinity(sl_uint32 indexProcessor);
 	
 		sl_bool isRunning();
 
@@ -28,6 +28,8 @@
 #include "queue.h"
 #include "thread.h"
 #include "dispatch.h"
+#include "time.h"
+#include "timer_wheel.h"
 
 namespace slib
 {
@@ -35,6 +37,9 @@ namespace slib
 	class SLIB_EXPORT ThreadPool : public Dispatcher
 	{
 		SLIB_DECLARE_OBJECT
+		
+	public:
+		class StealingWorker;
 
 	private:
 		ThreadPool();
@@ -43,6 +48,13 @@ namespace slib
 
 	public:
 		static Ref<ThreadPool> create(sl_uint32 minThreads = 0, sl_uint32 maxThreads = 30);
+		
+		/*
+			Creates a pool of fixed workers, each owning a task deque.
+			Tasks added from a worker are executed LIFO by the same worker, and idle workers steal from the others.
+			`nWorkers = 0` means the number of the processors.
+		*/
+		static Ref<ThreadPool> createWorkStealing(sl_uint32 nWorkers = 0);
 	
 	public:
 		void release();
@@ -50,10 +62,12 @@ namespace slib
 		sl_bool isRunning();
 
 		sl_uint32 getThreadsCount();
+		
+		sl_bool isWorkStealing();
 	
-		sl_bool addTask(const Function<void()>& task);
+		sl_bool addTask(UniqueFunction<void()>&& task);
 
-		sl_bool dispatch(const Function<void()>& callback, sl_uint64 delay_ms = 0) override;
+		sl_bool dispatch(UniqueFunction<void()>&& task, sl_uint64 delay_ms = 0) override;
 	
 	public:
 		SLIB_PROPERTY(sl_uint32, MinimumThreadsCount)
@@ -62,13 +76,31 @@ namespace slib
 	
 	protected:
 		void onRunWorker();
+		
+		void onRunStealingWorker(sl_uint32 index);
+		
+		void onRunTimer();
+		
+		sl_bool _addStealingTask(UniqueFunction<void()>&& task);
+		
+		void _wakeStealingWorker();
 	
 	protected:
 		CList< Ref<Thread> > m_threadWorkers;
 		LinkedQueue< Ref<Thread> > m_threadSleeping;
-		LinkedQueue< Function<void()> > m_tasks;
+		LinkedQueue< UniqueFunction<void()> > m_tasks;
 
 		sl_bool m_flagRunning;
+		
+		StealingWorker** m_stealingWorkers;
+		sl_uint32 m_nStealingWorkers;
+		sl_uint32 m_indexNextWorker;
+		sl_int32 m_nSleepingWorkers;
+		
+		TimerWheel m_timerWheel;
+		TimeCounter m_timeCounter;
+		Ref<Thread> m_threadTimer;
+		Mutex m_lockTimer;
 
 	};
 
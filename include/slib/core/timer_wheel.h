@@ -0,0 +1,123 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_TIMER_WHEEL
+#define CHECKHEADER_SLIB_CORE_TIMER_WHEEL
+
+#include "definition.h"
+
+#include "function.h"
+#include "queue.h"
+#include "hash_map.h"
+#include "allocator.h"
+
+namespace slib
+{
+
+	/*
+		Hierarchical timing wheel.
+
+		Every level has 64 slots, and a slot of the level `k` covers 64^k ticks. A task is linked to the lowest level whose range reaches its expiration,
+		so adding and canceling a task are O(1). When the current tick enters a slot of an upper level, the tasks of the slot are cascaded to the lower levels,
+		and the tasks of a slot of the lowest level expire together (the tasks of the same tick are collected at once).
+		The occupied slots are tracked by bitmaps, so `collect` and `getTimeout` jump over the empty slots instead of walking the ticks.
+		The delays beyond the range of the top level (64^6 ticks) wait in the top level and are linked again on each rotation.
+		All times are absolute milliseconds on the caller's monotonic clock (for example, `TimeCounter`).
+		This class is not thread-safe: the owner is responsible for locking.
+	*/
+	class SLIB_EXPORT TimerWheel
+	{
+	public:
+		TimerWheel(sl_uint32 tickMilliseconds = 1) noexcept;
+
+		~TimerWheel() noexcept;
+
+		SLIB_DELETE_CLASS_DEFAULT_MEMBERS(TimerWheel)
+
+	public:
+		// returns the identifier of the added task (non-zero), or zero on failure
+		sl_uint64 add(sl_uint64 now, sl_uint64 delay, UniqueFunction<void()>&& task) noexcept;
+
+		sl_bool cancel(sl_uint64 taskId) noexcept;
+
+		void removeAll() noexcept;
+
+		sl_size getCount() const noexcept;
+
+		sl_bool isEmpty() const noexcept;
+
+		sl_uint32 getTickMilliseconds() const noexcept;
+
+		// moves the tasks expired at `now` into `output`, and returns the number of the expired tasks
+		sl_size collect(sl_uint64 now, LinkedQueue< UniqueFunction<void()> >* output) noexcept;
+
+		// milliseconds until the next expiration. negative means there is no task
+		sl_int64 getTimeout(sl_uint64 now) noexcept;
+
+	public:
+		enum {
+			SlotBits = 6,
+			SlotsCount = 1 << SlotBits,
+			LevelsCount = 6
+		};
+
+	protected:
+		struct Node
+		{
+			sl_uint64 id;
+			sl_uint64 tick;
+			UniqueFunction<void()> task;
+			sl_uint32 level;
+			sl_uint32 slot;
+			Node* before;
+			Node* next;
+
+			SLIB_DECLARE_POOLED_NEW
+		};
+
+		void _init(sl_uint64 now) noexcept;
+
+		void _link(Node* node) noexcept;
+
+		void _unlink(Node* node) noexcept;
+
+		void _cascade(sl_uint32 level) noexcept;
+
+		// the earliest tick when a slot is to be processed, and the level of the slot. returns false if there is no task
+		sl_bool _getNextTick(sl_uint64& tick, sl_uint32& level) noexcept;
+
+	protected:
+		sl_uint32 m_tick;
+		Node* m_slots[LevelsCount][SlotsCount];
+		sl_uint64 m_bitmaps[LevelsCount];
+
+		sl_bool m_flagInit;
+		sl_uint64 m_tickCurrent;
+		sl_uint64 m_lastId;
+		sl_size m_count;
+
+		CHashMap<sl_uint64, Node*> m_mapNodes;
+
+	};
+}
+
+#endif
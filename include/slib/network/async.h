@@ -93,7 +93,7 @@ namespace slib
 		void _onError();
 		
 	private:
-		static Ref<AsyncTcpSocketInstance> _createInstance(const Ref<Socket>& socket);
+		static Ref<AsyncTcpSocketInstance> _createInstance(const Ref<Socket>& socket, const Ref<AsyncIoLoop>& loop);
 		
 	protected:
 		Function<void(AsyncTcpSocket*, sl_bool flagError)> m_onConnect;
@@ -117,6 +117,8 @@ namespace slib
 		sl_bool flagIPv6; // default: false
 		sl_bool flagAutoStart; // default: true
 		sl_bool flagLogError; // default: true
+		// SO_REUSEPORT: several listeners (for example, one per I/O loop) can share the bind address
+		sl_bool flagReusePort; // default: false
 		Ref<AsyncIoLoop> ioLoop;
 		
 		Function<void(AsyncTcpServer*, Socket*, const SocketAddress&)> onAccept;
@@ -177,6 +177,7 @@ namespace slib
 		static const String& Cookie;
 		static const String& Range;
 		static const String& IfModifiedSince;
+		static const String& IfNoneMatch;
 		
 		// Response Headers
 		static const String& TransferEncoding;
@@ -186,6 +187,8 @@ namespace slib
 		static const String& ContentRange;
 		static const String& LastModified;
 		static const String& Location;
+		static const String& ETag;
+		static const String& Vary;
 		
 	};
 
@@ -431,6 +434,13 @@ namespace slib
 		
 		void setRequestIfModifiedSince(const Time& time);
 		
+		String getRequestIfNoneMatch() const;
+		
+		void setRequestIfNoneMatch(const String& etags);
+		
+		// whether `Accept-Encoding` allows `encoding` (for example, "gzip") with non-zero quality
+		sl_bool isAcceptingEncoding(const String& encoding) const;
+		
 		HttpCacheControlRequest getRequestCacheControl() const;
 		
 		void setRequestCacheControl(const HttpCacheControlRequest&);
@@ -633,6 +643,10 @@ namespace slib
 		
 		void setResponseLastModified(const Time& time);
 		
+		String getResponseETag() const;
+		
+		void setResponseETag(const String& etag);
+		
 		HttpCacheControlResponse getResponseCacheControl() const;
 		
 		void setResponseCacheControl(const HttpCacheControlResponse&);
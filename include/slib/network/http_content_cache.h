@@ -0,0 +1,154 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_NETWORK_HTTP_CONTENT_CACHE
+#define CHECKHEADER_SLIB_NETWORK_HTTP_CONTENT_CACHE
+
+#include "definition.h"
+
+#include "../core/object.h"
+#include "../core/memory.h"
+#include "../core/time.h"
+#include "../core/hash_map.h"
+#include "../core/mutex.h"
+
+namespace slib
+{
+
+	// static content prepared for the responses
+	class SLIB_EXPORT HttpContent : public Referable
+	{
+	public:
+		String key;
+		String contentType;
+		// zero if unknown
+		Time modifiedTime;
+
+		Memory data;
+		// strong entity tag of `data`, including the quotes
+		String etag;
+
+		// null if the content type is not compressible, or the compression does not reduce the size
+		Memory dataGzip;
+		String etagGzip;
+
+	public:
+		HttpContent();
+
+		~HttpContent();
+
+	public:
+		sl_size getMemorySize() const;
+
+	};
+
+	class SLIB_EXPORT HttpContentCacheParam
+	{
+	public:
+		// default: 32MB, total size of the cached contents
+		sl_uint64 maxMemorySize;
+
+		// default: 1MB, larger contents are not cached
+		sl_uint32 maxContentSize;
+
+		// default: 256, smaller contents are not compressed
+		sl_uint32 minCompressSize;
+
+		// default: 9, the contents are compressed once
+		sl_int32 compressionLevel;
+
+	public:
+		HttpContentCacheParam();
+
+		SLIB_DECLARE_CLASS_DEFAULT_MEMBERS(HttpContentCacheParam)
+
+	};
+
+	/*
+		Keeps the raw and the gzip-compressed bodies of the static contents with their entity tags.
+		The least recently used contents are removed when the total size exceeds the memory budget.
+	*/
+	class SLIB_EXPORT HttpContentCache : public Object
+	{
+		SLIB_DECLARE_OBJECT
+
+	protected:
+		HttpContentCache();
+
+		~HttpContentCache();
+
+	public:
+		static Ref<HttpContentCache> create(const HttpContentCacheParam& param);
+
+		static Ref<HttpContentCache> create();
+
+	public:
+		Ref<HttpContent> get(const String& key);
+
+		// prepares the content and caches it if the size is allowed. returns null if `data` is null
+		Ref<HttpContent> add(const String& key, const Memory& data, const String& contentType, const Time& modifiedTime);
+
+		void remove(const String& key);
+
+		void removeAll();
+
+		sl_size getCount();
+
+		sl_uint64 getMemorySize();
+
+		sl_uint32 getMaxContentSize();
+
+		static sl_bool isCompressibleContentType(const String& contentType);
+
+	protected:
+		struct Entry
+		{
+			Ref<HttpContent> content;
+			Entry* before;
+			Entry* next;
+		};
+
+		void _link(Entry* entry);
+
+		void _unlink(Entry* entry);
+
+		void _remove(Entry* entry);
+
+	protected:
+		sl_uint64 m_maxMemorySize;
+		sl_uint32 m_maxContentSize;
+		sl_uint32 m_minCompressSize;
+		sl_int32 m_compressionLevel;
+
+		Mutex m_lock;
+		CHashMap<String, Entry*> m_map;
+		// most recently used entry first
+		Entry* m_first;
+		Entry* m_last;
+		sl_size m_count;
+		sl_uint64 m_memorySize;
+
+	};
+
+}
+
+#endif
@@ -26,6 +26,7 @@
 #include "definition.h"
 
 #include "../core/string.h"
+#include "../core/mutex.h"
 #include "../crypto/zlib.h"
 
 #include "async.h"
@@ -57,6 +58,9 @@ namespace slib
 		
 		void copyFromFile(const String& path, const Ref<Dispatcher>& dispatcher);
 		
+		// the output stream should support `AsyncStream::sendFile()`
+		void sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+		
 		sl_uint64 getOutputLength() const;
 		
 	protected:
@@ -139,6 +143,67 @@ namespace slib
 		HttpContentReaderOnComplete m_onComplete;
 
 	};
+	
+	/*
+		Reads the contents of an output buffer as the body compressed by gzip or deflate, in the chunked transfer coding.
+		The memory parts are compressed when they are read, the stream parts are read asynchronously and the file parts are read by `File::readAt32()`.
+		An empty reading means that the last chunk was read, so the compressor can be the source of `AsyncOutputBuffer::copyFrom()` with the unknown size.
+	*/
+	class SLIB_EXPORT HttpContentCompressor : public AsyncStream
+	{
+		SLIB_DECLARE_OBJECT
+		
+	protected:
+		HttpContentCompressor();
+		
+		~HttpContentCompressor();
+		
+	public:
+		// takes the contents of `source`. `flagGzip`: false for the zlib format (`deflate` coding)
+		static Ref<HttpContentCompressor> create(AsyncOutputBuffer* source, sl_bool flagGzip, sl_int32 level = 6);
+		
+	public:
+		void close() override;
+		
+		sl_bool isOpened() override;
+		
+		sl_bool read(void* data, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null) override;
+		
+		// not supported
+		sl_bool write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject = sl_null) override;
+		
+		sl_bool addTask(UniqueFunction<void()>&& task) override;
+		
+	protected:
+		void _process();
+		
+		// returns false while waiting for the body stream
+		sl_bool _prepareChunk(sl_uint32 sizeChunk);
+		
+		sl_uint32 _popChunk(void* data, sl_uint32 size);
+		
+		sl_bool _compress(const void* data, sl_size size, sl_bool flagFinish);
+		
+		void _onReadBody(AsyncStreamResult& result);
+		
+	protected:
+		Mutex m_lock;
+		sl_bool m_flagOpened;
+		sl_bool m_flagError;
+		sl_bool m_flagReadingBody;
+		sl_bool m_flagProcessing;
+		sl_bool m_flagCompressed;
+		sl_bool m_flagEnded;
+		
+		ZlibCompress m_zlib;
+		LinkedQueue< Ref<AsyncOutputBufferElement> > m_elements;
+		Ref<AsyncOutputBufferElement> m_elementCurrent;
+		Ref<AsyncStreamRequest> m_requestRead;
+		MemoryQueue m_bufCompressed;
+		Memory m_bufInput;
+		Memory m_bufOutput;
+		
+	};
 
 }
 
@@ -30,6 +30,11 @@
 #include "socket_address.h"
 
 #include "../core/thread_pool.h"
+#include "../core/open_file_cache.h"
+#include "../core/string_view.h"
+#include "../core/queue.h"
+#include "../core/allocator.h"
+#include "http_content_cache.h"
 #include "../crypto/tls.h"
 
 namespace slib
@@ -37,6 +42,7 @@ namespace slib
 
 	class HttpServer;
 	class HttpServerConnection;
+	class HttpServerCompiledRouter;
 	
 	class SLIB_EXPORT HttpServerContext : public Object, public HttpRequest, public HttpResponse, public HttpOutputBuffer
 	{
@@ -51,6 +57,7 @@ namespace slib
 		static Ref<HttpServerContext> create(const Ref<HttpServerConnection>& connection);
 		
 	public:
+		// refers to the read buffer of the connection, which is reused after the response is completed
 		Memory getRawRequestHeader() const;
 		
 		sl_uint64 getRequestContentLength() const;
@@ -91,19 +98,35 @@ namespace slib
 		
 		void setKeepAlive(sl_bool flag = sl_true);
 		
+		// the output is compressed by `HttpContentCompressor` when the response is sent. decided by the server after the request is processed
+		sl_bool isCompressingResponse() const;
+		
+		void setCompressingResponse(sl_bool flag = sl_true);
+		
+		// arena for the memory used while processing the request. created on the first call, and released at once with the context
+		const Ref<Arena>& getArena();
+		
 	protected:
-		HttpHeaderReader m_requestHeaderReader;
-		AtomicMemory m_requestHeader;
+		// the header is parsed in the read buffer of the connection
+		sl_bool m_flagParsedRequestHeader;
+		const void* m_requestHeaderData;
+		sl_size m_requestHeaderSize;
+		Ref<Referable> m_refRequestHeader;
 		sl_uint64 m_requestContentLength;
-		MemoryQueue m_requestBodyBuffer;
 		AtomicMemory m_requestBody;
+		sl_size m_requestBodySizeReceived;
 		
 		sl_bool m_flagProcessed;
 		sl_bool m_flagClosingConnection;
 		sl_bool m_flagProcessingByThread;
 		sl_bool m_flagKeepAlive;
+		sl_bool m_flagCompressingResponse;
 
 		sl_bool m_flagBeganProcessing;
+		// the response is ready to be written after the responses of the previous pipelined requests
+		sl_bool m_flagCompleted;
+		
+		Ref<Arena> m_arena;
 		
 	private:
 		WeakRef<HttpServerConnection> m_connection;
@@ -160,24 +183,80 @@ namespace slib
 		Ref<AsyncStream> m_io;
 		Ref<AsyncOutput> m_output;
 		
+		// the request being read
 		AtomicRef<HttpServerContext> m_contextCurrent;
+		// the requests being processed, in the order of their responses
+		LinkedQueue< Ref<HttpServerContext> > m_queueContexts;
 		
 		sl_bool m_flagClosed;
-		Memory m_bufRead;
 		sl_bool m_flagReading;
+		sl_bool m_flagReadingBody;
 		sl_bool m_flagKeepAlive;
-		List<char> m_bufReadUnprocessed;
+		// no more request is parsed because the last one closes the connection
+		sl_bool m_flagStopInput;
+		// the client has finished sending
+		sl_bool m_flagInputEnded;
+		// waiting for the next request on a keep-alive connection
+		sl_bool m_flagIdle;
+		sl_bool m_flagProcessingInput;
+		sl_bool m_flagWritingResponses;
+		
+		// the requests are parsed in place. [m_posRead, m_posRead + m_sizeRead) is the unprocessed input
+		Memory m_bufRead;
+		sl_size m_posRead;
+		sl_size m_sizeRead;
+		// the unprocessed input before this position does not contain the end of the header
+		sl_size m_posHeaderScan;
+		
+		sl_uint32 m_countRequests;
+		// tick counts in milliseconds
+		sl_uint64 m_timeRequestStart;
+		// the connection is closed when the input is not received until this time. zero if not limited
+		sl_uint64 m_timeDeadline;
+		// expiration time of the armed timer, zero if the timer is not armed
+		sl_uint64 m_timeTimer;
 		
 	protected:
 		void _read();
 		
-		void _processInput(const void* data, sl_uint32 size);
+		void _processInput();
+		
+		// returns true if the next request can be processed
+		sl_bool _processNextInput(HttpServer* server);
+		
+		void _processBadRequest();
+		
+		// the request is not queued yet
+		void _processServerError();
+		
+		// responds to the queued request with 500, after the pending responses
+		void _completeContextWithServerError(HttpServerContext* context);
+		
+		// updates the deadline of the input before reading
+		void _updateDeadline(HttpServer* server);
+		
+		void _setDeadline(sl_uint64 deadline);
+		
+		void _onTimer(sl_uint64 timeTimer);
+		
+		// returns the size of the header including the empty line, or zero if the header is not completed
+		sl_size _findHeaderEnd();
+		
+		sl_bool _growReadBuffer(sl_size maxSize);
 		
 		void _processContext(const Ref<HttpServerContext>& context);
 		
+		// writes the completed responses in the order of the requests
+		void _writeResponses();
+		
+		sl_bool _writeResponse(HttpServerContext* context);
+		
 	public:
 		void completeContext(HttpServerContext* context);
 		
+		// whether the connection is waiting for the next request
+		sl_bool isIdle();
+		
 	protected:
 		void onReadStream(AsyncStreamResult& result);
 
@@ -290,6 +369,114 @@ namespace slib
 		
 		void ALL(const String& path, const Function<Variant(HttpServerContext*)>& onRequest);
 		
+		// freezes the current routes. later changes of this router are not reflected to the compiled router
+		Ref<HttpServerCompiledRouter> compile() const;
+		
+	};
+	
+	class SLIB_EXPORT HttpServerRouteParameters
+	{
+	public:
+		enum {
+			MaxCount = 16
+		};
+		sl_uint32 count;
+		// refers to the names in the compiled route
+		const String* names[MaxCount];
+		// refers to the matched path (not percent-decoded)
+		StringView values[MaxCount];
+		
+	public:
+		HttpServerRouteParameters();
+		
+	};
+	
+	/*
+		Immutable form of HttpServerRoute, stored in the flat arrays of a radix tree.
+		The chains of static segments without branches are merged into single edges,
+		and the static edges of a node are sorted to be found by binary search.
+		Matching does not allocate: the parameters are returned as the views of the path.
+		Unlike HttpServerRoute::getRoute(), a node without the handler does not match,
+		so the other branches (parameter, `*`, `**`) are tried in that case.
+	*/
+	class SLIB_EXPORT HttpServerCompiledRoute : public Referable
+	{
+	public:
+		HttpServerCompiledRoute();
+		
+		~HttpServerCompiledRoute();
+		
+	public:
+		static Ref<HttpServerCompiledRoute> create(const HttpServerRoute& route);
+		
+	public:
+		// returns null if no handler is matched
+		const Function<Variant(HttpServerContext*)>* match(const StringView& path, HttpServerRouteParameters& parameters) const;
+		
+		Variant processRequest(const String& path, HttpServerContext* context) const;
+		
+	protected:
+		struct Node
+		{
+			Function<Variant(HttpServerContext*)> onRequest;
+			// static edges are followed by parameter edges
+			sl_uint32 indexEdges;
+			sl_uint32 countStaticEdges;
+			sl_uint32 countParameterEdges;
+			sl_int32 indexDefault;
+			sl_int32 indexEllipsis;
+		};
+		
+		struct Edge
+		{
+			// static edge: merged segments joined by '/', parameter edge: the name of the parameter
+			String label;
+			sl_size lengthFirstSegment;
+			sl_uint32 indexNode;
+		};
+		
+		sl_int32 _build(const HttpServerRoute& route);
+		
+		const Function<Variant(HttpServerContext*)>* _match(const Node* nodes, const Edge* edges, sl_uint32 indexNode, const sl_char8* path, sl_size len, HttpServerRouteParameters& parameters) const;
+		
+	protected:
+		List<Node> m_nodes;
+		List<Edge> m_edges;
+		
+	};
+	
+	class SLIB_EXPORT HttpServerCompiledRouter : public Referable
+	{
+	public:
+		HttpServerCompiledRouter();
+		
+		~HttpServerCompiledRouter();
+		
+	public:
+		static Ref<HttpServerCompiledRouter> create(const HttpServerRouter& router);
+		
+	public:
+		Variant processRequest(const String& path, HttpServerContext* context) const;
+		
+		Variant preProcessRequest(const String& path, HttpServerContext* context) const;
+		
+		Variant postProcessRequest(const String& path, HttpServerContext* context) const;
+		
+	protected:
+		enum {
+			MethodsCount = (int)(HttpMethod::PATCH) + 1
+		};
+		
+		static void _compile(Ref<HttpServerCompiledRoute>* dst, const HashMap<HttpMethod, HttpServerRoute>& src);
+		
+		static Variant _process(const Ref<HttpServerCompiledRoute>* routes, const String& path, HttpServerContext* context);
+		
+	protected:
+		// indexed by HttpMethod, HttpMethod::Unknown for all methods
+		Ref<HttpServerCompiledRoute> m_routes[MethodsCount];
+		Ref<HttpServerCompiledRoute> m_preRoutes[MethodsCount];
+		Ref<HttpServerCompiledRoute> m_postRoutes[MethodsCount];
+		
 	};
 	
 	class SLIB_EXPORT HttpServerParam
@@ -301,14 +488,53 @@ namespace slib
 		sl_uint32 maxThreadsCount;
 		sl_bool flagProcessByThreads;
 		
+		sl_uint32 ioLoopsCount; // default: 1, 0 means the number of the processors
+		sl_bool flagPinIoLoops; // default: false, binds each I/O loop to a processor
+		// default: false. If set, every binding listens with one SO_REUSEPORT socket per I/O loop,
+		// otherwise one listener hands the accepted connections to the least-loaded loop
+		sl_bool flagReusePort;
+		
 		sl_bool flagUseWebRoot;
 		String webRootPath;
+		// default: 1000, number of the web root files kept opened. 0 disables the cache
+		sl_uint32 maxOpenFilesCount;
+		// default: true, sends the web root files by `sendfile` or `splice` when the connection supports
+		sl_bool flagUseSendFile;
 
 		sl_bool flagUseAsset;
 		String prefixAsset;
 		
+		// default: true, keeps the compressible web root files and the assets in memory with their gzip variants and ETags
+		sl_bool flagUseContentCache;
+		// default: 32MB
+		sl_uint64 contentCacheSize;
+		// default: 1MB, larger files are not kept in memory
+		sl_uint32 maxCachedContentSize;
+		
+		// default: false, compresses the responses of the compressible content types by gzip or deflate in the chunked transfer coding
+		sl_bool flagCompressResponse;
+		// default: 256, smaller responses are sent as they are
+		sl_uint32 minCompressResponseSize;
+		// default: 6
+		sl_int32 responseCompressionLevel;
+		
 		sl_uint64 maxRequestHeadersSize;
 		sl_uint64 maxRequestBodySize;
+		// default: 16, pipelined requests parsed ahead on a connection while the previous responses are pending. 1 disables the pipelining
+		sl_uint32 maxPipelinedRequestsCount;
+		
+		// default: 10000, 0 means unlimited. When reached, an idle keep-alive connection is closed for the new connection,
+		// or the new connection is answered by "503 Service Unavailable" if every connection is busy
+		sl_uint32 maxConnectionsCount;
+		// timeouts in milliseconds, 0 disables each limit
+		// default: 30000, from the first byte of a request (or the connection) to the end of the header
+		sl_uint32 requestHeaderTimeout;
+		// default: 60000, between the reads of a request body
+		sl_uint32 requestBodyTimeout;
+		// default: 300000, from the first byte of a request to the end of the body
+		sl_uint32 requestTimeout;
+		// default: 75000, waiting for the next request on a keep-alive connection
+		sl_uint32 keepAliveTimeout;
 		
 		sl_bool flagAllowCrossOrigin;
 		
@@ -362,6 +588,8 @@ namespace slib
 		
 		Ref<AsyncIoLoop> getAsyncIoLoop();
 		
+		Ref<AsyncIoLoopGroup> getAsyncIoLoopGroup();
+		
 		Ref<ThreadPool> getThreadPool();
 		
 		const HttpServerParam& getParam();
@@ -379,12 +607,21 @@ namespace slib
 		
 		sl_bool processFile(HttpServerContext* context, const String& path);
 		
+		Ref<OpenFileCache> getOpenFileCache();
+		
+		Ref<HttpContentCache> getContentCache();
+		
+		// responds with the cached content, choosing the gzip variant by `Accept-Encoding`
+		sl_bool processContent(HttpServerContext* context, HttpContent* content);
+		
 		sl_bool processRangeRequest(HttpServerContext* context, sl_uint64 totalLength, const String& range, sl_uint64& outStart, sl_uint64& outLength);
 		
 		virtual Ref<HttpServerConnection> addConnection(const Ref<AsyncStream>& stream, const SocketAddress& remoteAddress, const SocketAddress& localAddress);
 		
 		virtual void closeConnection(HttpServerConnection* connection);
 		
+		sl_size getConnectionsCount();
+		
 	protected:
 		virtual Variant onRequest(HttpServerContext* context);
 		
@@ -412,15 +649,35 @@ namespace slib
 		
 		sl_bool addHttpsBinding(const TlsAcceptStreamParam& param, const IPAddress& addr, sl_uint16 port = 443);
 		
+		
+		// used by the connection providers to listen on the I/O loops
+		List< Ref<AsyncTcpServer> > createTcpListeners(const SocketAddress& addr, const Function<void(AsyncTcpServer*, Socket*, const SocketAddress&)>& onAccept);
+		
+		// I/O loop to attach a connection accepted by `listener`
+		Ref<AsyncIoLoop> getAcceptIoLoop(AsyncTcpServer* listener);
+		
 
 	protected:
 		sl_bool _init(const HttpServerParam& param);
 		
 		void _processCacheControl(HttpServerContext* context);
 		
+		sl_bool _processFile(HttpServerContext* context, const String& path, sl_uint64 totalSize, const Time& lastModifiedTime, const Ref<File>& file);
+		
+		sl_bool _sendFile(HttpServerContext* context, const Ref<File>& file, sl_uint64 offset, sl_uint64 size);
+		
+		// sets the headers of the compressed response if the compression is applicable
+		sl_bool _prepareCompressingResponse(HttpServerContext* context);
+		
+		// closes an idle keep-alive connection to accept a new connection
+		sl_bool _closeIdleConnection();
+		
 	protected:
 		AtomicRef<AsyncIoLoop> m_ioLoop;
+		AtomicRef<AsyncIoLoopGroup> m_ioLoopGroup;
 		AtomicRef<ThreadPool> m_threadPool;
+		AtomicRef<OpenFileCache> m_fileCache;
+		AtomicRef<HttpContentCache> m_contentCache;
 		sl_bool m_flagReleased;
 		sl_bool m_flagRunning;
 		
@@ -429,6 +686,8 @@ namespace slib
 		CList< Ref<HttpServerConnectionProvider> > m_connectionProviders;
 		
 		HttpServerParam m_param;
+		// compiled from `m_param.router` on initialization
+		Ref<HttpServerCompiledRouter> m_router;
 		
 	};
 
@@ -0,0 +1,412 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/allocator.h"
+
+#include "slib/core/base.h"
+#include "slib/core/spin_lock.h"
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace memory_pool
+		{
+
+			enum {
+				SizeClassUnit = 16,
+				CountOfSizeClasses = MemoryPool::MaximumBlockSize / SizeClassUnit,
+				// bytes of the free blocks kept by each thread, per size class
+				ThreadCacheBytes = 8192,
+				ThreadCacheMinimumCount = 16,
+				// bytes of the free blocks kept by the depot, per size class
+				DepotBytes = 65536
+			};
+
+			struct FreeBlock
+			{
+				FreeBlock* next;
+			};
+
+			struct FreeList
+			{
+				FreeBlock* first;
+				sl_uint32 count;
+			};
+
+			struct Depot
+			{
+				SpinLock lock;
+				FreeList list;
+			};
+
+			static Depot g_depots[CountOfSizeClasses];
+
+			SLIB_INLINE static sl_uint32 GetSizeClass(sl_size size) noexcept
+			{
+				return (sl_uint32)((size - 1) / SizeClassUnit);
+			}
+
+			SLIB_INLINE static sl_size GetBlockSize(sl_uint32 sizeClass) noexcept
+			{
+				return (sl_size)(sizeClass + 1) * SizeClassUnit;
+			}
+
+			SLIB_INLINE static sl_uint32 GetThreadCacheLimit(sl_uint32 sizeClass) noexcept
+			{
+				sl_uint32 n = (sl_uint32)(ThreadCacheBytes / GetBlockSize(sizeClass));
+				return n < (sl_uint32)ThreadCacheMinimumCount ? (sl_uint32)ThreadCacheMinimumCount : n;
+			}
+
+			// moves `count` blocks from the front of `list` to the depot, and frees the blocks exceeding the capacity of the depot
+			static void PushToDepot(sl_uint32 sizeClass, FreeList& list, sl_uint32 count) noexcept
+			{
+				if (!count) {
+					return;
+				}
+				FreeBlock* first = list.first;
+				FreeBlock* last = first;
+				for (sl_uint32 i = 1; i < count; i++) {
+					last = last->next;
+				}
+				list.first = last->next;
+				list.count -= count;
+
+				Depot& depot = g_depots[sizeClass];
+				sl_uint32 limit = (sl_uint32)(DepotBytes / GetBlockSize(sizeClass));
+				FreeBlock* overflow = sl_null;
+				{
+					SpinLocker lock(&(depot.lock));
+					if (depot.list.count + count <= limit) {
+						last->next = depot.list.first;
+						depot.list.first = first;
+						depot.list.count += count;
+					} else {
+						last->next = sl_null;
+						overflow = first;
+					}
+				}
+				while (overflow) {
+					FreeBlock* next = overflow->next;
+					Base::freeMemory(overflow);
+					overflow = next;
+				}
+			}
+
+			// moves at most `count` blocks from the depot to `list`
+			static void PopFromDepot(sl_uint32 sizeClass, FreeList& list, sl_uint32 count) noexcept
+			{
+				Depot& depot = g_depots[sizeClass];
+				SpinLocker lock(&(depot.lock));
+				FreeBlock* first = depot.list.first;
+				if (!first) {
+					return;
+				}
+				if (count > depot.list.count) {
+					count = depot.list.count;
+				}
+				FreeBlock* last = first;
+				for (sl_uint32 i = 1; i < count; i++) {
+					last = last->next;
+				}
+				depot.list.first = last->next;
+				depot.list.count -= count;
+				last->next = list.first;
+				list.first = first;
+				list.count += count;
+			}
+
+			class ThreadCache
+			{
+			public:
+				FreeList lists[CountOfSizeClasses];
+
+			public:
+				ThreadCache() noexcept;
+
+				~ThreadCache() noexcept;
+
+			public:
+				void release() noexcept
+				{
+					for (sl_uint32 i = 0; i < CountOfSizeClasses; i++) {
+						PushToDepot(i, lists[i], lists[i].count);
+					}
+				}
+
+			};
+
+			enum class ThreadCacheState
+			{
+				None = 0,
+				Alive = 1,
+				Destroyed = 2
+			};
+
+			// trivial, so it can be checked while the thread-local objects are being destroyed
+			static SLIB_THREAD_OLD ThreadCacheState g_stateThreadCache = ThreadCacheState::None;
+
+			ThreadCache::ThreadCache() noexcept
+			{
+				Base::zeroMemory(lists, sizeof(lists));
+				g_stateThreadCache = ThreadCacheState::Alive;
+			}
+
+			ThreadCache::~ThreadCache() noexcept
+			{
+				g_stateThreadCache = ThreadCacheState::Destroyed;
+				release();
+			}
+
+			static ThreadCache* GetThreadCache() noexcept
+			{
+				if (g_stateThreadCache == ThreadCacheState::Destroyed) {
+					return sl_null;
+				}
+				static SLIB_THREAD ThreadCache cache;
+				return &cache;
+			}
+
+		}
+	}
+
+	using namespace priv::memory_pool;
+
+	void* MemoryPool::allocate(sl_size size) noexcept
+	{
+		if (!size) {
+			size = 1;
+		}
+		if (size > MaximumBlockSize) {
+			return Base::createMemory(size);
+		}
+		sl_uint32 sizeClass = GetSizeClass(size);
+		ThreadCache* cache = GetThreadCache();
+		if (cache) {
+			FreeList& list = cache->lists[sizeClass];
+			if (!(list.first)) {
+				PopFromDepot(sizeClass, list, GetThreadCacheLimit(sizeClass) / 2);
+			}
+			FreeBlock* block = list.first;
+			if (block) {
+				list.first = block->next;
+				list.count--;
+				return block;
+			}
+		}
+		return Base::createMemory(GetBlockSize(sizeClass));
+	}
+
+	void MemoryPool::free(void* ptr, sl_size size) noexcept
+	{
+		if (!ptr) {
+			return;
+		}
+		if (!size) {
+			size = 1;
+		}
+		if (size > MaximumBlockSize) {
+			Base::freeMemory(ptr);
+			return;
+		}
+		sl_uint32 sizeClass = GetSizeClass(size);
+		FreeBlock* block = (FreeBlock*)ptr;
+		ThreadCache* cache = GetThreadCache();
+		if (cache) {
+			FreeList& list = cache->lists[sizeClass];
+			block->next = list.first;
+			list.first = block;
+			list.count++;
+			sl_uint32 limit = GetThreadCacheLimit(sizeClass);
+			if (list.count > limit) {
+				PushToDepot(sizeClass, list, limit / 2);
+			}
+		} else {
+			FreeList list;
+			block->next = sl_null;
+			list.first = block;
+			list.count = 1;
+			PushToDepot(sizeClass, list, 1);
+		}
+	}
+
+	void MemoryPool::releaseThreadCache() noexcept
+	{
+		ThreadCache* cache = GetThreadCache();
+		if (cache) {
+			cache->release();
+		}
+	}
+
+
+	namespace priv
+	{
+		namespace arena
+		{
+
+			enum {
+				DefaultChunkSize = 4096
+			};
+
+			SLIB_INLINE static sl_uint8* AlignPointer(sl_uint8* p, sl_size alignment) noexcept
+			{
+				return (sl_uint8*)(((sl_size)p + alignment - 1) & ~(alignment - 1));
+			}
+
+		}
+	}
+
+	Arena::Arena(sl_size sizeChunk) noexcept
+	{
+		m_pos = sl_null;
+		m_end = sl_null;
+		m_chunks = sl_null;
+		m_destructors = sl_null;
+		m_sizeChunk = sizeChunk ? sizeChunk : (sl_size)(priv::arena::DefaultChunkSize);
+		m_sizeAllocated = 0;
+		m_bufInitial = sl_null;
+		m_sizeInitial = 0;
+	}
+
+	Arena::Arena(void* buf, sl_size size, sl_size sizeChunk) noexcept: Arena(sizeChunk)
+	{
+		m_bufInitial = buf;
+		m_sizeInitial = size;
+		m_pos = (sl_uint8*)buf;
+		m_end = m_pos + size;
+	}
+
+	Arena::~Arena() noexcept
+	{
+		_release(sl_false);
+	}
+
+	void* Arena::allocate(sl_size size, sl_size alignment) noexcept
+	{
+		if (!size) {
+			size = 1;
+		}
+		sl_uint8* p = priv::arena::AlignPointer(m_pos, alignment);
+		if (p >= m_pos && p <= m_end && size <= (sl_size)(m_end - p)) {
+			m_pos = p + size;
+			m_sizeAllocated += size;
+			return p;
+		}
+		return _allocateFromNewChunk(size, alignment);
+	}
+
+	sl_char8* Arena::copyString(const sl_char8* str, sl_size len) noexcept
+	{
+		sl_char8* ret = (sl_char8*)(allocate(len + 1, 1));
+		if (ret) {
+			Base::copyMemory(ret, str, len);
+			ret[len] = 0;
+		}
+		return ret;
+	}
+
+	void Arena::reset() noexcept
+	{
+		_release(sl_true);
+	}
+
+	sl_size Arena::getAllocatedSize() const noexcept
+	{
+		return m_sizeAllocated;
+	}
+
+	void* Arena::_allocateFromNewChunk(sl_size size, sl_size alignment) noexcept
+	{
+		sl_size sizeChunk = sizeof(Chunk) + alignment - 1 + size;
+		if (sizeChunk < size) {
+			return sl_null;
+		}
+		if (sizeChunk < m_sizeChunk) {
+			sizeChunk = m_sizeChunk;
+		}
+		Chunk* chunk = (Chunk*)(Base::createMemory(sizeChunk));
+		if (!chunk) {
+			return sl_null;
+		}
+		chunk->size = sizeChunk;
+		chunk->next = m_chunks;
+		m_chunks = chunk;
+		sl_uint8* start = priv::arena::AlignPointer((sl_uint8*)chunk + sizeof(Chunk), alignment);
+		sl_uint8* end = (sl_uint8*)chunk + sizeChunk;
+		sl_uint8* p = start + size;
+		// keeps allocating from the chunk which has more space left
+		if (end - p >= m_end - m_pos) {
+			m_pos = p;
+			m_end = end;
+		}
+		m_sizeAllocated += size;
+		return start;
+	}
+
+	void Arena::_addDestructor(Destructor* destructor, void (*destruct)(void* object), void* object) noexcept
+	{
+		destructor->destruct = destruct;
+		destructor->object = object;
+		destructor->next = m_destructors;
+		m_destructors = destructor;
+	}
+
+	void Arena::_release(sl_bool flagKeepChunk) noexcept
+	{
+		Destructor* destructor = m_destructors;
+		while (destructor) {
+			destructor->destruct(destructor->object);
+			destructor = destructor->next;
+		}
+		m_destructors = sl_null;
+		Chunk* chunkKeep = sl_null;
+		Chunk* chunk = m_chunks;
+		while (chunk) {
+			Chunk* next = chunk->next;
+			if (flagKeepChunk && (!chunkKeep || chunk->size > chunkKeep->size)) {
+				if (chunkKeep) {
+					Base::freeMemory(chunkKeep);
+				}
+				chunkKeep = chunk;
+			} else {
+				Base::freeMemory(chunk);
+			}
+			chunk = next;
+		}
+		m_sizeAllocated = 0;
+		if (chunkKeep && chunkKeep->size - sizeof(Chunk) > m_sizeInitial) {
+			chunkKeep->next = sl_null;
+			m_chunks = chunkKeep;
+			m_pos = (sl_uint8*)chunkKeep + sizeof(Chunk);
+			m_end = (sl_uint8*)chunkKeep + chunkKeep->size;
+		} else {
+			if (chunkKeep) {
+				Base::freeMemory(chunkKeep);
+			}
+			m_chunks = sl_null;
+			m_pos = (sl_uint8*)m_bufInitial;
+			m_end = m_pos + m_sizeInitial;
+		}
+	}
+
+}
@@ -50,6 +50,46 @@ namespace slib
 #endif
 			}
 
+			static sl_bool CanUseAvx2()
+			{
+#if defined(SLIB_COMPILER_IS_VC)
+				int cpu_info[4];
+				__cpuid(cpu_info, 0);
+				if (cpu_info[0] < 7) {
+					return sl_false;
+				}
+				__cpuid(cpu_info, 1);
+				// OSXSAVE, AVX
+				if ((cpu_info[2] & ((1 << 27) | (1 << 28))) != ((1 << 27) | (1 << 28))) {
+					return sl_false;
+				}
+				// the OS saves the XMM and YMM registers
+				if ((_xgetbv(0) & 6) != 6) {
+					return sl_false;
+				}
+				__cpuidex(cpu_info, 7, 0);
+				return (cpu_info[1] & (1 << 5)) != 0;
+#else
+				unsigned int eax, ebx, ecx, edx;
+				if (__get_cpuid_max(0, sl_null) < 7) {
+					return sl_false;
+				}
+				__cpuid(1, eax, ebx, ecx, edx);
+				// OSXSAVE, AVX
+				if ((ecx & ((1 << 27) | (1 << 28))) != ((1 << 27) | (1 << 28))) {
+					return sl_false;
+				}
+				// the OS saves the XMM and YMM registers
+				unsigned int xcr0, xcr0High;
+				__asm__ __volatile__ ("xgetbv" : "=a"(xcr0), "=d"(xcr0High) : "c"(0));
+				if ((xcr0 & 6) != 6) {
+					return sl_false;
+				}
+				__cpuid_count(7, 0, eax, ebx, ecx, edx);
+				return (ebx & (1 << 5)) != 0;
+#endif
+			}
+
 		}
 	}
 	
@@ -58,6 +98,12 @@ namespace slib
 		static sl_bool f = priv::asm_x64::CanUseSse42();
 		return f;
 	}
+
+	sl_bool CanUseAvx2()
+	{
+		static sl_bool f = priv::asm_x64::CanUseAvx2();
+		return f;
+	}
 	
 }
 
@@ -23,6 +23,10 @@
 #include "slib/core/async.h"
 
 #include "slib/core/safe_static.h"
+#include "slib/core/system.h"
+
+#include "async_config.h"
+#include "async_io_uring.h"
 
 namespace slib
 {
@@ -38,6 +42,7 @@ namespace slib
 		m_flagInit = sl_false;
 		m_flagRunning = sl_false;
 		m_handle = sl_null;
+		m_nInstances = 0;
 	}
 
 	AsyncIoLoop::~AsyncIoLoop()
@@ -105,6 +110,9 @@ namespace slib
 		m_queueInstancesClosing.removeAll();
 		m_queueInstancesClosed.removeAll();
 		
+		MutexLocker lockTimer(&m_lockTimer);
+		m_timerWheel.removeAll();
+		
 	}
 
 	void AsyncIoLoop::start()
@@ -127,21 +135,40 @@ namespace slib
 		return m_flagRunning;
 	}
 
-	sl_bool AsyncIoLoop::addTask(const Function<void()>& task)
+	sl_bool AsyncIoLoop::addTask(UniqueFunction<void()>&& task)
 	{
 		if (task.isNull()) {
 			return sl_false;
 		}
-		if (m_queueTasks.push(task)) {
+		if (m_queueTasks.push(Move(task))) {
 			wake();
 			return sl_true;
 		}
 		return sl_false;
 	}
 
-	sl_bool AsyncIoLoop::dispatch(const Function<void()>& callback, sl_uint64 delay_ms)
+	sl_bool AsyncIoLoop::dispatch(UniqueFunction<void()>&& task, sl_uint64 delay_ms)
 	{
-		return addTask(callback);
+		if (!delay_ms) {
+			return addTask(Move(task));
+		}
+		if (task.isNull()) {
+			return sl_false;
+		}
+		{
+			MutexLocker lock(&m_lockTimer);
+			if (!m_flagInit) {
+				return sl_false;
+			}
+			if (!(m_timerWheel.add(m_timeCounter.getElapsedMilliseconds(), delay_ms, Move(task)))) {
+				return sl_false;
+			}
+		}
+		// the loop thread calculates the timeout after running the tasks
+		if (Thread::getCurrent() != m_thread) {
+			wake();
+		}
+		return sl_true;
 	}
 
 	void AsyncIoLoop::wake()
@@ -158,7 +185,10 @@ namespace slib
 		if (m_handle) {
 			if (instance && instance->isOpened()) {
 				ObjectLocker lock(this);
-				return _native_attachInstance(instance, mode);
+				if (_native_attachInstance(instance, mode)) {
+					Base::interlockedIncrement(&m_nInstances);
+					return sl_true;
+				}
 			}
 		}
 		return sl_false;
@@ -187,14 +217,36 @@ namespace slib
 		}
 	}
 
+	sl_size AsyncIoLoop::getInstancesCount()
+	{
+		sl_reg n = m_nInstances;
+		return n > 0 ? (sl_size)n : 0;
+	}
+
 	void AsyncIoLoop::_stepBegin()
 	{
+		// Delayed Tasks
+		{
+			LinkedQueue< UniqueFunction<void()> > tasks;
+			{
+				MutexLocker lock(&m_lockTimer);
+				if (!(m_timerWheel.isEmpty())) {
+					m_timerWheel.collect(m_timeCounter.getElapsedMilliseconds(), &tasks);
+				}
+			}
+			UniqueFunction<void()> task;
+			while (tasks.pop_NoLock(&task)) {
+				task();
+			}
+		}
+		
 		// Async Tasks
 		{
-			LinkedQueue< Function<void()> > tasks;
-			tasks.merge(&m_queueTasks);
-			Function<void()> task;
-			while (tasks.pop(&task)) {
+			UniqueFunction<void()> task;
+			for (sl_uint32 i = 0; i < ASYNC_MAX_TASKS_PER_STEP; i++) {
+				if (!(m_queueTasks.pop(&task))) {
+					break;
+				}
 				task();
 			}
 		}
@@ -212,18 +264,175 @@ namespace slib
 		}
 	}
 
+	sl_int32 AsyncIoLoop::_getWaitTimeout(sl_int32 timeoutMax)
+	{
+		if (m_queueTasks.isNotEmpty()) {
+			return 0;
+		}
+		MutexLocker lock(&m_lockTimer);
+		if (m_timerWheel.isEmpty()) {
+			return timeoutMax;
+		}
+		sl_int64 timeout = m_timerWheel.getTimeout(m_timeCounter.getElapsedMilliseconds());
+		if (timeout < 0 || timeout > timeoutMax) {
+			return timeoutMax;
+		}
+		return (sl_int32)timeout;
+	}
+
 	void AsyncIoLoop::_stepEnd()
 	{
 		Ref<AsyncIoInstance> instance;
 		while (m_queueInstancesClosing.pop(&instance)) {
 			if (instance.isNotNull() && instance->isOpened()) {
 				_native_detachInstance(instance.get());
+				Base::interlockedDecrement(&m_nInstances);
 				instance->close();
 				m_queueInstancesClosed.push(instance);
 			}
 		}
 	}
 
+/*************************************
+		AsyncIoLoopGroup
+**************************************/
+
+	SLIB_DEFINE_OBJECT(AsyncIoLoopGroup, Object)
+
+	AsyncIoLoopGroup::AsyncIoLoopGroup()
+	{
+		m_loops = sl_null;
+		m_nLoops = 0;
+		m_indexNext = 0;
+		m_flagRunning = sl_false;
+	}
+
+	AsyncIoLoopGroup::~AsyncIoLoopGroup()
+	{
+		release();
+		if (m_loops) {
+			delete[] m_loops;
+		}
+	}
+
+	Ref<AsyncIoLoopGroup> AsyncIoLoopGroup::create(sl_uint32 nLoops, sl_bool flagAutoStart, sl_bool flagPinToProcessors)
+	{
+		sl_uint32 nProcessors = System::getProcessorsCount();
+		if (!nProcessors) {
+			nProcessors = 1;
+		}
+		if (!nLoops) {
+			nLoops = nProcessors;
+		}
+		Ref<AsyncIoLoopGroup> ret = new AsyncIoLoopGroup;
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		Ref<AsyncIoLoop>* loops = new Ref<AsyncIoLoop>[nLoops];
+		if (!loops) {
+			return sl_null;
+		}
+		for (sl_uint32 i = 0; i < nLoops; i++) {
+			Ref<AsyncIoLoop> loop = AsyncIoLoop::create(sl_false);
+			if (loop.isNull()) {
+				for (sl_uint32 k = 0; k < i; k++) {
+					loops[k]->release();
+				}
+				delete[] loops;
+				return sl_null;
+			}
+			if (flagPinToProcessors) {
+				// runs on the loop thread at the first step
+				sl_uint32 indexProcessor = i % nProcessors;
+				loop->addTask([indexProcessor]() {
+					Ref<Thread> thread = Thread::getCurrent();
+					if (thread.isNotNull()) {
+						thread->setProcessorAffinity(indexProcessor);
+					}
+				});
+			}
+			loops[i] = Move(loop);
+		}
+		// the group owns the loops only after all of them are created
+		ret->m_loops = loops;
+		ret->m_nLoops = nLoops;
+		if (flagAutoStart) {
+			ret->start();
+		}
+		return ret;
+	}
+
+	void AsyncIoLoopGroup::release()
+	{
+		ObjectLocker lock(this);
+		m_flagRunning = sl_false;
+		for (sl_uint32 i = 0; i < m_nLoops; i++) {
+			if (m_loops[i].isNotNull()) {
+				m_loops[i]->release();
+			}
+		}
+	}
+
+	void AsyncIoLoopGroup::start()
+	{
+		ObjectLocker lock(this);
+		if (m_flagRunning) {
+			return;
+		}
+		m_flagRunning = sl_true;
+		for (sl_uint32 i = 0; i < m_nLoops; i++) {
+			if (m_loops[i].isNotNull()) {
+				m_loops[i]->start();
+			}
+		}
+	}
+
+	sl_bool AsyncIoLoopGroup::isRunning()
+	{
+		return m_flagRunning;
+	}
+
+	sl_uint32 AsyncIoLoopGroup::getLoopsCount()
+	{
+		return m_nLoops;
+	}
+
+	Ref<AsyncIoLoop> AsyncIoLoopGroup::getLoop(sl_uint32 index)
+	{
+		if (index < m_nLoops) {
+			return m_loops[index];
+		}
+		return sl_null;
+	}
+
+	Ref<AsyncIoLoop> AsyncIoLoopGroup::getNextLoop()
+	{
+		if (!m_nLoops) {
+			return sl_null;
+		}
+		sl_uint32 index = ((sl_uint32)(Base::interlockedIncrement32((sl_int32*)&m_indexNext))) % m_nLoops;
+		return m_loops[index];
+	}
+
+	Ref<AsyncIoLoop> AsyncIoLoopGroup::getLeastLoadedLoop()
+	{
+		if (!m_nLoops) {
+			return sl_null;
+		}
+		sl_uint32 start = ((sl_uint32)(Base::interlockedIncrement32((sl_int32*)&m_indexNext))) % m_nLoops;
+		sl_uint32 indexMin = start;
+		sl_size nMin = m_loops[start]->getInstancesCount();
+		for (sl_uint32 i = 1; i < m_nLoops && nMin; i++) {
+			sl_uint32 index = (start + i) % m_nLoops;
+			sl_size n = m_loops[index]->getInstancesCount();
+			if (n < nMin) {
+				nMin = n;
+				indexMin = index;
+			}
+		}
+		return m_loops[indexMin];
+	}
+
 /*************************************
 		AsyncIoInstance
 **************************************/
@@ -396,7 +605,7 @@ namespace slib
 		Referable* _userObject,
 		const Function<void(AsyncStreamResult&)>& _callback,
 		sl_bool _flagRead)
-	 : data((void*)_data), size(_size), userObject(_userObject), callback(_callback), flagRead(_flagRead)
+	 : data((void*)_data), size(_size), userObject(_userObject), callback(_callback), flagRead(_flagRead), offsetFile(0)
 	{
 	}
 	
@@ -428,6 +637,24 @@ namespace slib
 		return new AsyncStreamRequest(data, size, userObject, callback, sl_false);
 	}
 
+	Ref<AsyncStreamRequest> AsyncStreamRequest::createSendFile(
+		const Ref<File>& file,
+		sl_uint64 offset,
+		sl_uint32 size,
+		Referable* userObject,
+		const Function<void(AsyncStreamResult&)>& callback)
+	{
+		if (!size || file.isNull()) {
+			return sl_null;
+		}
+		Ref<AsyncStreamRequest> ret = new AsyncStreamRequest(sl_null, size, userObject, callback, sl_false);
+		if (ret.isNotNull()) {
+			ret->file = file;
+			ret->offsetFile = offset;
+		}
+		return ret;
+	}
+
 	void AsyncStreamRequest::runCallback(AsyncStream* stream, sl_uint32 resultSize, sl_bool flagError)
 	{
 		if (callback.isNotNull()) {
@@ -473,6 +700,24 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool AsyncStreamInstance::isSupportedSendFile()
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncStreamInstance::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject)
+	{
+		if (!(isSupportedSendFile())) {
+			return sl_false;
+		}
+		Ref<AsyncStreamRequest> req = AsyncStreamRequest::createSendFile(file, offset, size, userObject, callback);
+		if (req.isNotNull()) {
+			m_requestsWrite.push(req);
+			return sl_true;
+		}
+		return sl_false;
+	}
+
 	sl_bool AsyncStreamInstance::isSeekable()
 	{
 		return sl_false;
@@ -567,6 +812,16 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_bool AsyncStream::isSupportedSendFile()
+	{
+		return sl_false;
+	}
+
+	sl_bool AsyncStream::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject)
+	{
+		return sl_false;
+	}
+
 	sl_bool AsyncStream::isSeekable()
 	{
 		return sl_false;
@@ -682,6 +937,31 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool AsyncStreamBase::isSupportedSendFile()
+	{
+		Ref<AsyncStreamInstance> instance = getIoInstance();
+		if (instance.isNotNull()) {
+			return instance->isSupportedSendFile();
+		}
+		return sl_false;
+	}
+
+	sl_bool AsyncStreamBase::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject)
+	{
+		Ref<AsyncIoLoop> loop = getIoLoop();
+		if (loop.isNull()) {
+			return sl_false;
+		}
+		Ref<AsyncStreamInstance> instance = getIoInstance();
+		if (instance.isNotNull()) {
+			if (instance->sendFile(file, offset, size, callback, userObject)) {
+				loop->requestOrder(instance.get());
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
 	sl_bool AsyncStreamBase::isSeekable()
 	{
 		Ref<AsyncStreamInstance> instance = getIoInstance();
@@ -710,11 +990,11 @@ namespace slib
 		return sl_false;
 	}
 
-	sl_bool AsyncStreamBase::addTask(const Function<void()>& callback)
+	sl_bool AsyncStreamBase::addTask(UniqueFunction<void()>&& task)
 	{
 		Ref<AsyncIoLoop> loop = getIoLoop();
 		if (loop.isNotNull()) {
-			return loop->addTask(callback);
+			return loop->addTask(Move(task));
 		}
 		return sl_false;
 	}
@@ -765,11 +1045,11 @@ namespace slib
 		return sl_false;
 	}
 
-	sl_bool AsyncStreamSimulator::addTask(const Function<void()>& callback)
+	sl_bool AsyncStreamSimulator::addTask(UniqueFunction<void()>&& task)
 	{
 		Ref<Dispatcher> dispatcher(m_dispatcher);
 		if (dispatcher.isNotNull()) {
-			return dispatcher->dispatch(callback);
+			return dispatcher->dispatch(Move(task));
 		}
 		return sl_false;
 	}
@@ -1192,7 +1472,15 @@ namespace slib
 			ret->m_onEnd = param.onEnd;
 			ret->m_sizeTotal = param.size;
 			for (sl_uint32 i = 0; i < param.bufferCount; i++) {
+#if defined(ASYNC_USE_IO_URING)
+				// buffers registered to the ring of the source save the page mapping on every read
+				Memory mem = priv::async_io_uring::AllocateFixedBuffer(param.source.get(), param.bufferSize);
+				if (mem.isNull()) {
+					mem = Memory::create(param.bufferSize);
+				}
+#else
 				Memory mem = Memory::create(param.bufferSize);
+#endif
 				if (mem.isNotNull()) {
 					Ref<Buffer> buf = new Buffer;
 					if (buf.isNotNull()) {
@@ -1315,6 +1603,13 @@ namespace slib
 		m_bufferReading.setNull();
 
 		if (bufferReading.isNotNull()) {
+			if (!(result.flagError) && result.size == 0 && m_sizeTotal == SLIB_UINT64_MAX) {
+				// end of the source of the unknown size
+				m_sizeTotal = m_sizeRead;
+				m_buffersRead.pushBack(bufferReading);
+				enqueue();
+				return;
+			}
 			m_sizeRead += result.size;
 			Memory memWrite = bufferReading->mem.sub(0, result.size);
 			if (memWrite.isNull()) {
@@ -1461,18 +1756,28 @@ namespace slib
 	AsyncOutputBufferElement::AsyncOutputBufferElement()
 	{
 		m_sizeBody = 0;
+		m_offsetBodyFile = 0;
 	}
 
 	AsyncOutputBufferElement::AsyncOutputBufferElement(const Memory& header)
 	{
 		m_header.add(header);
 		m_sizeBody = 0;
+		m_offsetBodyFile = 0;
 	}
 
 	AsyncOutputBufferElement::AsyncOutputBufferElement(AsyncStream* stream, sl_uint64 size)
 	{
 		m_body = stream;
 		m_sizeBody = size;
+		m_offsetBodyFile = 0;
+	}
+
+	AsyncOutputBufferElement::AsyncOutputBufferElement(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_bodyFile = file;
+		m_offsetBodyFile = offset;
+		m_sizeBody = size;
 	}
 	
 	AsyncOutputBufferElement::~AsyncOutputBufferElement()
@@ -1481,7 +1786,7 @@ namespace slib
 
 	sl_bool AsyncOutputBufferElement::isEmpty() const
 	{
-		if (m_header.getSize() == 0 && (m_sizeBody == 0 || m_body.isNull())) {
+		if (m_header.getSize() == 0 && (m_sizeBody == 0 || (m_body.isNull() && m_bodyFile.isNull()))) {
 			return sl_true;
 		}
 		return sl_false;
@@ -1489,7 +1794,7 @@ namespace slib
 
 	sl_bool AsyncOutputBufferElement::isEmptyBody() const
 	{
-		if (m_sizeBody == 0 || m_body.isNull()) {
+		if (m_sizeBody == 0 || (m_body.isNull() && m_bodyFile.isNull())) {
 			return sl_true;
 		}
 		return sl_false;
@@ -1506,6 +1811,13 @@ namespace slib
 		m_sizeBody = size;
 	}
 
+	void AsyncOutputBufferElement::setBodyFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_bodyFile = file;
+		m_offsetBodyFile = offset;
+		m_sizeBody = size;
+	}
+
 	MemoryQueue& AsyncOutputBufferElement::getHeader()
 	{
 		return m_header;
@@ -1521,6 +1833,25 @@ namespace slib
 		return m_sizeBody;
 	}
 
+	Ref<File> AsyncOutputBufferElement::getBodyFile()
+	{
+		return m_bodyFile;
+	}
+
+	sl_uint64 AsyncOutputBufferElement::getBodyFileOffset()
+	{
+		return m_offsetBodyFile;
+	}
+
+	void AsyncOutputBufferElement::skipBodyFile(sl_uint64 size)
+	{
+		if (size > m_sizeBody) {
+			size = m_sizeBody;
+		}
+		m_offsetBodyFile += size;
+		m_sizeBody -= size;
+	}
+
 
 /**********************************************
 		AsyncOutputBuffer
@@ -1581,16 +1912,18 @@ namespace slib
 		if (!stream) {
 			return sl_false;
 		}
+		// the length of the unknown size is not counted
+		sl_uint64 sizeCounted = size == SLIB_UINT64_MAX ? 0 : size;
 		ObjectLocker lock(this);
 		Link< Ref<AsyncOutputBufferElement> >* link = m_queueOutput.getBack();
 		if (link && link->value->isEmptyBody()) {
 			link->value->setBody(stream, size);
-			m_lengthOutput += size;
+			m_lengthOutput += sizeCounted;
 		} else {
 			Ref<AsyncOutputBufferElement> data = new AsyncOutputBufferElement(stream, size);
 			if (data.isNotNull()) {
 				if (m_queueOutput.push(data)) {
-					m_lengthOutput += size;
+					m_lengthOutput += sizeCounted;
 				} else {
 					return sl_false;
 				}
@@ -1615,6 +1948,17 @@ namespace slib
 		}
 		return sl_false;
 #else
+#	if defined(SLIB_PLATFORM_IS_LINUX)
+		if (File::exists(path)) {
+			sl_uint64 size = File::getSize(path);
+			if (size > 0) {
+				Ref<AsyncStream> file = AsyncFile::openIoUring(path, FileMode::Read);
+				if (file.isNotNull()) {
+					return copyFrom(file.get(), size);
+				}
+			}
+		}
+#	endif
 		return copyFromFile(path, Ref<Dispatcher>::null());
 #endif
 	}
@@ -1636,6 +1980,57 @@ namespace slib
 		return sl_true;
 	}
 
+	sl_bool AsyncOutputBuffer::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		if (size == 0) {
+			return sl_true;
+		}
+		if (file.isNull()) {
+			return sl_false;
+		}
+		ObjectLocker lock(this);
+		Link< Ref<AsyncOutputBufferElement> >* link = m_queueOutput.getBack();
+		if (link && link->value->isEmptyBody()) {
+			link->value->setBodyFile(file, offset, size);
+			m_lengthOutput += size;
+		} else {
+			Ref<AsyncOutputBufferElement> data = new AsyncOutputBufferElement(file, offset, size);
+			if (data.isNotNull()) {
+				if (m_queueOutput.push(data)) {
+					m_lengthOutput += size;
+				} else {
+					return sl_false;
+				}
+			} else {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	sl_bool AsyncOutputBuffer::popElement(Ref<AsyncOutputBufferElement>* _out)
+	{
+		ObjectLocker lock(this);
+		Ref<AsyncOutputBufferElement> element;
+		if (m_queueOutput.pop(&element)) {
+			sl_uint64 size = element->getBodySize();
+			if (size == SLIB_UINT64_MAX) {
+				size = 0;
+			}
+			size += element->getHeader().getSize();
+			if (size < m_lengthOutput) {
+				m_lengthOutput -= size;
+			} else {
+				m_lengthOutput = 0;
+			}
+			if (_out) {
+				*_out = element;
+			}
+			return sl_true;
+		}
+		return sl_false;
+	}
+
 	sl_uint64 AsyncOutputBuffer::getOutputLength() const
 	{
 		return m_lengthOutput;
@@ -1644,6 +2039,9 @@ namespace slib
 /**********************************************
 				AsyncOutput
 **********************************************/
+
+// bytes of the file requested to the stream at once
+#define ASYNC_OUTPUT_SEND_FILE_CHUNK_SIZE 0x1000000
 	
 	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(AsyncOutputParam)
 	
@@ -1753,6 +2151,16 @@ namespace slib
 			}
 		} else {
 			sl_uint64 sizeBody = m_elementWriting->getBodySize();
+			Ref<File> file = m_elementWriting->getBodyFile();
+			if (sizeBody != 0 && file.isNotNull()) {
+				sl_uint32 size = sizeBody > ASYNC_OUTPUT_SEND_FILE_CHUNK_SIZE ? ASYNC_OUTPUT_SEND_FILE_CHUNK_SIZE : (sl_uint32)sizeBody;
+				m_flagWriting = sl_true;
+				if (!(m_streamOutput->sendFile(file, m_elementWriting->getBodyFileOffset(), size, SLIB_FUNCTION_WEAKREF(AsyncOutput, onSendFile, this)))) {
+					m_flagWriting = sl_false;
+					_onError();
+				}
+				return;
+			}
 			Ref<AsyncStream> body = m_elementWriting->getBody();
 			if (sizeBody != 0 && body.isNotNull()) {
 				m_flagWriting = sl_true;
@@ -1795,6 +2203,22 @@ namespace slib
 		_write(sl_true);
 	}
 
+	void AsyncOutput::onSendFile(AsyncStreamResult& result)
+	{
+		m_flagWriting = sl_false;
+		if (result.flagError || result.size != result.requestSize) {
+			_onError();
+			return;
+		}
+		{
+			ObjectLocker lock(this);
+			if (m_elementWriting.isNotNull()) {
+				m_elementWriting->skipBodyFile(result.size);
+			}
+		}
+		_write(sl_true);
+	}
+
 	void AsyncOutput::_onError()
 	{
 		m_onEnd(this, sl_true);
@@ -2047,11 +2471,11 @@ namespace slib
 		}
 	}
 
-	sl_bool AsyncStreamFilter::addTask(const Function<void()>& callback)
+	sl_bool AsyncStreamFilter::addTask(UniqueFunction<void()>&& task)
 	{
 		Ref<AsyncStream> stream = m_stream;
 		if (stream.isNotNull()) {
-			return stream->addTask(callback);
+			return stream->addTask(Move(task));
 		}
 		return sl_false;
 	}
@@ -31,10 +31,18 @@
 #define ASYNC_USE_KQUEUE
 #elif defined(SLIB_PLATFORM_IS_LINUX)
 #define ASYNC_USE_EPOLL
+#	if !defined(SLIB_PLATFORM_IS_ANDROID) && defined(__has_include)
+#		if __has_include(<linux/io_uring.h>)
+#			define ASYNC_USE_IO_URING
+#		endif
+#	endif
 #elif defined(SLIB_PLATFORM_IS_FREEBSD)
 #define ASYNC_USE_KEVENT
 #endif
 
 #define ASYNC_MAX_WAIT_EVENT 256
 
+// the tasks left over run in the next step, without waiting for the events
+#define ASYNC_MAX_TASKS_PER_STEP 1024
+
 #endif
@@ -27,6 +27,10 @@
 #include "slib/core/async.h"
 #include "slib/core/pipe.h"
 
+#if defined(ASYNC_USE_IO_URING)
+#include "async_io_uring.h"
+#endif
+
 #include <unistd.h>
 #include <sys/epoll.h>
 #include <sys/errno.h>
@@ -46,6 +50,10 @@ namespace slib
 			{
 				int fdEpoll;
 				Ref<PipeEvent> eventWake;
+#if defined(ASYNC_USE_IO_URING)
+				// completions of io_uring are notified through epoll by polling the ring
+				priv::async_io_uring::IoUring* ring;
+#endif
 			};
 		}
 	}
@@ -74,6 +82,18 @@ namespace slib
 				ev.data.ptr = sl_null;
 				ev.events = EPOLLIN | EPOLLPRI | EPOLLET;
 				if (0 == epoll_ctl(fdEpoll, EPOLL_CTL_ADD, (int)(pipe->getReadPipeHandle()), &ev)) {
+#if defined(ASYNC_USE_IO_URING)
+					handle->ring = priv::async_io_uring::IoUring::create();
+					if (handle->ring) {
+						ev.data.ptr = handle->ring;
+						ev.events = EPOLLIN | EPOLLET;
+						if (0 != epoll_ctl(fdEpoll, EPOLL_CTL_ADD, handle->ring->getHandle(), &ev)) {
+							// fall back to epoll
+							delete handle->ring;
+							handle->ring = sl_null;
+						}
+					}
+#endif
 					return handle;
 				}
 				delete handle;
@@ -86,6 +106,11 @@ namespace slib
 	void AsyncIoLoop::_native_closeHandle(void* _handle)
 	{
 		AsyncIoLoopHandle* handle = (AsyncIoLoopHandle*)_handle;
+#if defined(ASYNC_USE_IO_URING)
+		if (handle->ring) {
+			delete handle->ring;
+		}
+#endif
 		::close(handle->fdEpoll);
 		delete handle;
 	}
@@ -100,7 +125,18 @@ namespace slib
 
 			_stepBegin();
 
-			int nEvents = ::epoll_wait(handle->fdEpoll, waitEvents, ASYNC_MAX_WAIT_EVENT, 5000);
+			int timeout = _getWaitTimeout(5000);
+#if defined(ASYNC_USE_IO_URING)
+			priv::async_io_uring::IoUring* ring = handle->ring;
+			if (ring) {
+				// the requests prepared during this step are sent in one system call
+				ring->submit();
+				if (ring->hasCompletions()) {
+					timeout = 0;
+				}
+			}
+#endif
+			int nEvents = ::epoll_wait(handle->fdEpoll, waitEvents, ASYNC_MAX_WAIT_EVENT, timeout);
 			if (m_queueInstancesClosed.isNotEmpty()) {
 				m_queueInstancesClosed.removeAll();
 			}
@@ -113,6 +149,11 @@ namespace slib
 
 			for (int i = 0; m_flagRunning && i < nEvents; i++) {
 				epoll_event& ev = waitEvents[i];
+#if defined(ASYNC_USE_IO_URING)
+				if (ring && ev.data.ptr == ring) {
+					continue;
+				}
+#endif
 				AsyncIoInstance* instance = (AsyncIoInstance*)(ev.data.ptr);
 				if (instance) {
 					if (!(instance->isClosing())) {
@@ -141,6 +182,12 @@ namespace slib
 				}
 			}
 
+#if defined(ASYNC_USE_IO_URING)
+			if (ring && m_flagRunning) {
+				ring->processCompletions();
+			}
+#endif
+
 			if (m_flagRunning) {
 				_stepEnd();
 			}
@@ -154,6 +201,17 @@ namespace slib
 		handle->eventWake->set();
 	}
 
+	void* AsyncIoLoop::getIoUring()
+	{
+#if defined(ASYNC_USE_IO_URING)
+		AsyncIoLoopHandle* handle = (AsyncIoLoopHandle*)m_handle;
+		if (handle) {
+			return handle->ring;
+		}
+#endif
+		return sl_null;
+	}
+
 	sl_bool AsyncIoLoop::_native_attachInstance(AsyncIoInstance* instance, AsyncIoMode mode)
 	{
 		AsyncIoLoopHandle* handle = (AsyncIoLoopHandle*)m_handle;
@@ -0,0 +1,800 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "async_io_uring.h"
+
+#if defined(ASYNC_USE_IO_URING)
+
+#include "slib/core/file.h"
+
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+#ifndef __NR_io_uring_setup
+#define __NR_io_uring_setup 425
+#endif
+#ifndef __NR_io_uring_enter
+#define __NR_io_uring_enter 426
+#endif
+#ifndef __NR_io_uring_register
+#define __NR_io_uring_register 427
+#endif
+#ifndef IORING_FEAT_FAST_POLL
+#define IORING_FEAT_FAST_POLL (1U << 5)
+#endif
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace async_io_uring
+		{
+
+			static int SetupRing(sl_uint32 entries, io_uring_params* params)
+			{
+				return (int)(syscall(__NR_io_uring_setup, entries, params));
+			}
+
+			static int EnterRing(int fd, sl_uint32 toSubmit, sl_uint32 minComplete, sl_uint32 flags)
+			{
+				return (int)(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, sl_null, 0));
+			}
+
+			static int RegisterRing(int fd, sl_uint32 opcode, const void* arg, sl_uint32 nArgs)
+			{
+				return (int)(syscall(__NR_io_uring_register, fd, opcode, arg, nArgs));
+			}
+
+			// returns the bit flags of the supported opcodes. zero on the kernels older than 5.6, which fail the probe with EINVAL
+			static sl_uint64 ProbeOpcodes(int fd)
+			{
+				sl_uint32 sizeProbe = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+				io_uring_probe* probe = (io_uring_probe*)(Base::createMemory(sizeProbe));
+				if (!probe) {
+					return 0;
+				}
+				Base::zeroMemory(probe, sizeProbe);
+				sl_uint64 opcodes = 0;
+				if (!(RegisterRing(fd, IORING_REGISTER_PROBE, probe, 256))) {
+					for (sl_uint32 i = 0; i < probe->ops_len && i < 64; i++) {
+						io_uring_probe_op& op = probe->ops[i];
+						if ((op.flags & IO_URING_OP_SUPPORTED) && op.op < 64) {
+							opcodes |= ((sl_uint64)1) << op.op;
+						}
+					}
+				}
+				Base::freeMemory(probe);
+				return opcodes;
+			}
+
+			class FixedBuffer : public Referable
+			{
+			public:
+				Ref<FixedBufferPool> pool;
+				sl_uint32 index;
+
+			public:
+				~FixedBuffer()
+				{
+					pool->_free(index);
+				}
+
+			};
+
+			Operation::Operation()
+			{
+				m_before = sl_null;
+				m_next = sl_null;
+			}
+
+			Operation::~Operation()
+			{
+			}
+
+			FixedBufferPool::FixedBufferPool()
+			{
+				m_data = sl_null;
+				m_nBuffers = 0;
+				m_sizeBuffer = 0;
+				m_stackFree = sl_null;
+				m_nFree = 0;
+			}
+
+			FixedBufferPool::~FixedBufferPool()
+			{
+				if (m_data) {
+					::munmap(m_data, (sl_size)m_nBuffers * m_sizeBuffer);
+				}
+				if (m_stackFree) {
+					Base::freeMemory(m_stackFree);
+				}
+			}
+
+			Ref<FixedBufferPool> FixedBufferPool::create(sl_uint32 nBuffers, sl_uint32 sizeBuffer)
+			{
+				Ref<FixedBufferPool> ret = new FixedBufferPool;
+				if (ret.isNull()) {
+					return sl_null;
+				}
+				void* data = ::mmap(sl_null, (sl_size)nBuffers * sizeBuffer, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (data == MAP_FAILED) {
+					return sl_null;
+				}
+				ret->m_data = (sl_uint8*)data;
+				ret->m_nBuffers = nBuffers;
+				ret->m_sizeBuffer = sizeBuffer;
+				ret->m_stackFree = (sl_uint32*)(Base::createMemory(sizeof(sl_uint32) * nBuffers));
+				if (!(ret->m_stackFree)) {
+					return sl_null;
+				}
+				for (sl_uint32 i = 0; i < nBuffers; i++) {
+					ret->m_stackFree[i] = nBuffers - 1 - i;
+				}
+				ret->m_nFree = nBuffers;
+				return ret;
+			}
+
+			Memory FixedBufferPool::allocate(sl_uint32 size)
+			{
+				if (!size || size > m_sizeBuffer) {
+					return sl_null;
+				}
+				sl_uint32 index;
+				{
+					SpinLocker lock(&m_lock);
+					if (!m_nFree) {
+						return sl_null;
+					}
+					m_nFree--;
+					index = m_stackFree[m_nFree];
+				}
+				Ref<FixedBuffer> buffer = new FixedBuffer;
+				if (buffer.isNull()) {
+					_free(index);
+					return sl_null;
+				}
+				buffer->pool = this;
+				buffer->index = index;
+				return Memory::createStatic(m_data + (sl_size)index * m_sizeBuffer, size, buffer.get());
+			}
+
+			sl_int32 FixedBufferPool::getIndex(const void* _data, sl_uint32 size)
+			{
+				const sl_uint8* data = (const sl_uint8*)_data;
+				if (data < m_data) {
+					return -1;
+				}
+				sl_size offset = data - m_data;
+				sl_size index = offset / m_sizeBuffer;
+				if (index >= m_nBuffers) {
+					return -1;
+				}
+				if (offset + size > (index + 1) * m_sizeBuffer) {
+					return -1;
+				}
+				return (sl_int32)index;
+			}
+
+			void FixedBufferPool::_free(sl_uint32 index)
+			{
+				SpinLocker lock(&m_lock);
+				m_stackFree[m_nFree] = index;
+				m_nFree++;
+			}
+
+			IoUring::IoUring()
+			{
+				m_fd = -1;
+				m_features = 0;
+				m_opcodes = 0;
+				m_ringSq = sl_null;
+				m_sizeRingSq = 0;
+				m_ringCq = sl_null;
+				m_sizeRingCq = 0;
+				m_sqes = sl_null;
+				m_sizeSqes = 0;
+				m_sqTailLocal = 0;
+				m_nToSubmit = 0;
+				m_opFirst = sl_null;
+				m_nOperations = 0;
+			}
+
+			IoUring::~IoUring()
+			{
+				if (m_fd >= 0) {
+					_cancelAll();
+				}
+				if (m_sqes) {
+					::munmap(m_sqes, m_sizeSqes);
+				}
+				if (m_ringCq && m_ringCq != m_ringSq) {
+					::munmap(m_ringCq, m_sizeRingCq);
+				}
+				if (m_ringSq) {
+					::munmap(m_ringSq, m_sizeRingSq);
+				}
+				if (m_fd >= 0) {
+					::close(m_fd);
+				}
+			}
+
+			IoUring* IoUring::create(sl_uint32 nEntries)
+			{
+				io_uring_params params;
+				Base::zeroMemory(&params, sizeof(params));
+				int fd = SetupRing(nEntries, &params);
+				if (fd < 0) {
+					// ENOSYS: the kernel is older than 5.1, or io_uring is disabled
+					return sl_null;
+				}
+				IoUring* ring = new IoUring;
+				if (!ring) {
+					::close(fd);
+					return sl_null;
+				}
+				ring->m_fd = fd;
+				ring->m_features = params.features;
+				ring->m_opcodes = ProbeOpcodes(fd);
+
+				sl_size sizeSq = params.sq_off.array + params.sq_entries * sizeof(sl_uint32);
+				sl_size sizeCq = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+				sl_bool flagSingleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+				if (flagSingleMmap) {
+					if (sizeCq > sizeSq) {
+						sizeSq = sizeCq;
+					}
+					sizeCq = sizeSq;
+				}
+				void* ringSq = ::mmap(sl_null, sizeSq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+				if (ringSq == MAP_FAILED) {
+					delete ring;
+					return sl_null;
+				}
+				ring->m_ringSq = ringSq;
+				ring->m_sizeRingSq = sizeSq;
+				void* ringCq;
+				if (flagSingleMmap) {
+					ringCq = ringSq;
+				} else {
+					ringCq = ::mmap(sl_null, sizeCq, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+					if (ringCq == MAP_FAILED) {
+						delete ring;
+						return sl_null;
+					}
+				}
+				ring->m_ringCq = ringCq;
+				ring->m_sizeRingCq = sizeCq;
+				sl_size sizeSqes = params.sq_entries * sizeof(io_uring_sqe);
+				void* sqes = ::mmap(sl_null, sizeSqes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+				if (sqes == MAP_FAILED) {
+					delete ring;
+					return sl_null;
+				}
+				ring->m_sqes = (io_uring_sqe*)sqes;
+				ring->m_sizeSqes = sizeSqes;
+
+				sl_uint8* sq = (sl_uint8*)ringSq;
+				ring->m_sqHead = (sl_uint32*)(sq + params.sq_off.head);
+				ring->m_sqTail = (sl_uint32*)(sq + params.sq_off.tail);
+				ring->m_sqMask = *((sl_uint32*)(sq + params.sq_off.ring_mask));
+				ring->m_sqEntries = *((sl_uint32*)(sq + params.sq_off.ring_entries));
+				ring->m_sqArray = (sl_uint32*)(sq + params.sq_off.array);
+				ring->m_sqTailLocal = *(ring->m_sqTail);
+				// submission entries are used in order, so the indirection array is the identity
+				for (sl_uint32 i = 0; i < ring->m_sqEntries; i++) {
+					ring->m_sqArray[i] = i;
+				}
+				sl_uint8* cq = (sl_uint8*)ringCq;
+				ring->m_cqHead = (sl_uint32*)(cq + params.cq_off.head);
+				ring->m_cqTail = (sl_uint32*)(cq + params.cq_off.tail);
+				ring->m_cqMask = *((sl_uint32*)(cq + params.cq_off.ring_mask));
+				ring->m_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+				// registered buffers are optional: registration fails when RLIMIT_MEMLOCK is too small on old kernels
+				Ref<FixedBufferPool> pool = FixedBufferPool::create(ASYNC_IO_URING_FIXED_BUFFER_COUNT, ASYNC_IO_URING_FIXED_BUFFER_SIZE);
+				if (pool.isNotNull()) {
+					iovec iov[ASYNC_IO_URING_FIXED_BUFFER_COUNT];
+					for (sl_uint32 i = 0; i < ASYNC_IO_URING_FIXED_BUFFER_COUNT; i++) {
+						iov[i].iov_base = pool->m_data + (sl_size)i * ASYNC_IO_URING_FIXED_BUFFER_SIZE;
+						iov[i].iov_len = ASYNC_IO_URING_FIXED_BUFFER_SIZE;
+					}
+					if (!(RegisterRing(fd, IORING_REGISTER_BUFFERS, iov, ASYNC_IO_URING_FIXED_BUFFER_COUNT))) {
+						ring->m_fixedBuffers = pool;
+					}
+				}
+				return ring;
+			}
+
+			int IoUring::getHandle()
+			{
+				return m_fd;
+			}
+
+			sl_bool IoUring::isSupportingOpcode(sl_uint8 opcode)
+			{
+				if (opcode < 64) {
+					return (m_opcodes & (((sl_uint64)1) << opcode)) != 0;
+				}
+				return sl_false;
+			}
+
+			sl_bool IoUring::isSupportingFile()
+			{
+				return isSupportingOpcode(IORING_OP_READ) && isSupportingOpcode(IORING_OP_WRITE);
+			}
+
+			sl_bool IoUring::isSupportingSocket()
+			{
+				if (!(m_features & IORING_FEAT_FAST_POLL)) {
+					return sl_false;
+				}
+				return isSupportingOpcode(IORING_OP_RECV) && isSupportingOpcode(IORING_OP_SEND) && isSupportingOpcode(IORING_OP_CONNECT);
+			}
+
+			sl_bool IoUring::isSupportingSplice()
+			{
+				return isSupportingOpcode(IORING_OP_SPLICE);
+			}
+
+			Ref<FixedBufferPool> IoUring::getFixedBufferPool()
+			{
+				return m_fixedBuffers;
+			}
+
+			io_uring_sqe* IoUring::_getSqe()
+			{
+				sl_uint32 head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+				if (m_sqTailLocal - head >= m_sqEntries) {
+					submit();
+					head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+					if (m_sqTailLocal - head >= m_sqEntries) {
+						return sl_null;
+					}
+				}
+				io_uring_sqe* sqe = m_sqes + (m_sqTailLocal & m_sqMask);
+				Base::zeroMemory(sqe, sizeof(io_uring_sqe));
+				m_sqTailLocal++;
+				m_nToSubmit++;
+				return sqe;
+			}
+
+			io_uring_sqe* IoUring::_prepare(sl_uint8 opcode, int fd, const void* addr, sl_uint32 len, sl_uint64 offset, sl_uint32 flags, Operation* op)
+			{
+				io_uring_sqe* sqe = _getSqe();
+				if (!sqe) {
+					return sl_null;
+				}
+				sqe->opcode = opcode;
+				sqe->fd = fd;
+				sqe->addr = (sl_uint64)(sl_size)addr;
+				sqe->len = len;
+				sqe->off = offset;
+				sqe->msg_flags = flags;
+				sqe->user_data = (sl_uint64)(sl_size)op;
+				op->increaseReference();
+				op->m_before = sl_null;
+				op->m_next = m_opFirst;
+				if (m_opFirst) {
+					m_opFirst->m_before = op;
+				}
+				m_opFirst = op;
+				m_nOperations++;
+				return sqe;
+			}
+
+			sl_bool IoUring::prepareRead(int fd, void* buf, sl_uint32 size, sl_uint64 offset, Operation* op)
+			{
+				sl_int32 indexFixed = m_fixedBuffers.isNotNull() ? m_fixedBuffers->getIndex(buf, size) : -1;
+				io_uring_sqe* sqe = _prepare(indexFixed >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ, fd, buf, size, offset, 0, op);
+				if (sqe) {
+					if (indexFixed >= 0) {
+						sqe->buf_index = (sl_uint16)indexFixed;
+					}
+					return sl_true;
+				}
+				return sl_false;
+			}
+
+			sl_bool IoUring::prepareWrite(int fd, const void* buf, sl_uint32 size, sl_uint64 offset, Operation* op)
+			{
+				sl_int32 indexFixed = m_fixedBuffers.isNotNull() ? m_fixedBuffers->getIndex(buf, size) : -1;
+				io_uring_sqe* sqe = _prepare(indexFixed >= 0 ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE, fd, buf, size, offset, 0, op);
+				if (sqe) {
+					if (indexFixed >= 0) {
+						sqe->buf_index = (sl_uint16)indexFixed;
+					}
+					return sl_true;
+				}
+				return sl_false;
+			}
+
+			sl_bool IoUring::prepareRecv(int fd, void* buf, sl_uint32 size, Operation* op)
+			{
+				sl_int32 indexFixed = m_fixedBuffers.isNotNull() ? m_fixedBuffers->getIndex(buf, size) : -1;
+				if (indexFixed >= 0) {
+					// reading a stream socket is receiving without flags
+					io_uring_sqe* sqe = _prepare(IORING_OP_READ_FIXED, fd, buf, size, 0, 0, op);
+					if (sqe) {
+						sqe->buf_index = (sl_uint16)indexFixed;
+						return sl_true;
+					}
+					return sl_false;
+				}
+				return _prepare(IORING_OP_RECV, fd, buf, size, 0, 0, op) != sl_null;
+			}
+
+			sl_bool IoUring::prepareSend(int fd, const void* buf, sl_uint32 size, Operation* op)
+			{
+				return _prepare(IORING_OP_SEND, fd, buf, size, 0, MSG_NOSIGNAL, op) != sl_null;
+			}
+
+			sl_bool IoUring::prepareConnect(int fd, const void* addr, sl_uint32 sizeAddr, Operation* op)
+			{
+				// the length of the address is passed in the offset field
+				return _prepare(IORING_OP_CONNECT, fd, addr, 0, sizeAddr, 0, op) != sl_null;
+			}
+
+			sl_bool IoUring::prepareSplice(int fdIn, sl_int64 offsetIn, int fdOut, sl_int64 offsetOut, sl_uint32 size, Operation* op)
+			{
+				io_uring_sqe* sqe = _prepare(IORING_OP_SPLICE, fdOut, sl_null, size, (sl_uint64)offsetOut, 0, op);
+				if (sqe) {
+					sqe->splice_fd_in = fdIn;
+					sqe->splice_off_in = (sl_uint64)offsetIn;
+					return sl_true;
+				}
+				return sl_false;
+			}
+
+			sl_uint32 IoUring::submit()
+			{
+				if (!m_nToSubmit) {
+					return 0;
+				}
+				__atomic_store_n(m_sqTail, m_sqTailLocal, __ATOMIC_RELEASE);
+				int n = EnterRing(m_fd, m_nToSubmit, 0, 0);
+				if (n <= 0) {
+					// EAGAIN, EBUSY: retried on the next submission
+					return 0;
+				}
+				if ((sl_uint32)n > m_nToSubmit) {
+					n = (int)m_nToSubmit;
+				}
+				m_nToSubmit -= n;
+				return (sl_uint32)n;
+			}
+
+			sl_bool IoUring::hasCompletions()
+			{
+				return *m_cqHead != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+			}
+
+			sl_uint32 IoUring::processCompletions()
+			{
+				return _processCompletions(sl_true);
+			}
+
+			sl_uint32 IoUring::_processCompletions(sl_bool flagDispatch)
+			{
+				sl_uint32 nCompletions = 0;
+				sl_uint32 head = *m_cqHead;
+				for (;;) {
+					sl_uint32 tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+					if (head == tail) {
+						break;
+					}
+					io_uring_cqe* cqe = m_cqes + (head & m_cqMask);
+					Operation* op = (Operation*)(sl_size)(cqe->user_data);
+					sl_int32 result = cqe->res;
+					head++;
+					__atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+					if (op) {
+						if (op->m_before) {
+							op->m_before->m_next = op->m_next;
+						} else {
+							m_opFirst = op->m_next;
+						}
+						if (op->m_next) {
+							op->m_next->m_before = op->m_before;
+						}
+						m_nOperations--;
+						if (flagDispatch) {
+							op->onComplete(result);
+						}
+						op->decreaseReference();
+						nCompletions++;
+					}
+				}
+				return nCompletions;
+			}
+
+			void IoUring::_cancelAll()
+			{
+				if (!m_nOperations) {
+					return;
+				}
+				Operation* op = m_opFirst;
+				while (op) {
+					io_uring_sqe* sqe = _getSqe();
+					if (!sqe) {
+						break;
+					}
+					sqe->opcode = IORING_OP_ASYNC_CANCEL;
+					sqe->fd = -1;
+					sqe->addr = (sl_uint64)(sl_size)op;
+					op = op->m_next;
+				}
+				submit();
+				// buffers of the operations must stay alive until the kernel completes them
+				while (m_nOperations) {
+					_processCompletions(sl_false);
+					if (!m_nOperations) {
+						break;
+					}
+					int n = EnterRing(m_fd, m_nToSubmit, 1, IORING_ENTER_GETEVENTS);
+					if (n < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+						break;
+					}
+				}
+			}
+
+			IoUring* GetIoUring(AsyncIoLoop* loop)
+			{
+				if (loop) {
+					return (IoUring*)(loop->getIoUring());
+				}
+				return sl_null;
+			}
+
+			Memory AllocateFixedBuffer(AsyncStream* stream, sl_uint32 size)
+			{
+				if (!stream) {
+					return sl_null;
+				}
+				Ref<AsyncIoLoop> loop = stream->getIoLoop();
+				IoUring* ring = GetIoUring(loop.get());
+				if (ring) {
+					Ref<FixedBufferPool> pool = ring->getFixedBufferPool();
+					if (pool.isNotNull()) {
+						return pool->allocate(size);
+					}
+				}
+				return sl_null;
+			}
+
+			class FileStreamInstance;
+
+			class FileOperation : public Operation
+			{
+			public:
+				WeakRef<FileStreamInstance> instance;
+				Ref<AsyncStreamRequest> request;
+				Ref<File> file;
+
+			public:
+				void onComplete(sl_int32 result) override;
+
+			};
+
+			class FileStreamInstance : public AsyncStreamInstance
+			{
+			public:
+				AtomicRef<File> m_file;
+				Ref<FileOperation> m_operation;
+				sl_uint64 m_offset;
+
+			public:
+				FileStreamInstance()
+				{
+					m_offset = 0;
+				}
+
+				~FileStreamInstance()
+				{
+					close();
+				}
+
+			public:
+				static Ref<FileStreamInstance> open(const StringParam& path, FileMode mode)
+				{
+					Ref<File> file = File::open(path, mode);
+					if (file.isNotNull()) {
+						Ref<FileStreamInstance> ret = new FileStreamInstance;
+						if (ret.isNotNull()) {
+							ret->m_file = file;
+							ret->setHandle(file->getHandle());
+							if (mode & FileMode::SeekToEnd) {
+								ret->m_offset = file->getSize();
+							}
+							return ret;
+						}
+					}
+					return sl_null;
+				}
+
+				void close() override
+				{
+					// an operation in flight keeps the file opened until its completion
+					m_file.setNull();
+					setHandle(SLIB_FILE_INVALID_HANDLE);
+				}
+
+				void onOrder() override
+				{
+					if (m_operation.isNotNull()) {
+						return;
+					}
+					Ref<File> file = m_file;
+					if (file.isNull()) {
+						return;
+					}
+					Ref<AsyncIoLoop> loop = getLoop();
+					IoUring* ring = GetIoUring(loop.get());
+					if (!ring) {
+						return;
+					}
+					for (;;) {
+						Ref<AsyncStreamRequest> req;
+						if (!(popReadRequest(req))) {
+							if (!(popWriteRequest(req))) {
+								return;
+							}
+						}
+						if (req.isNull()) {
+							return;
+						}
+						if (!(req->data && req->size)) {
+							doCallback(req.get(), req->size, sl_false);
+							continue;
+						}
+						Ref<FileOperation> op = new FileOperation;
+						if (op.isNull()) {
+							doCallback(req.get(), 0, sl_true);
+							return;
+						}
+						op->instance = this;
+						op->request = req;
+						op->file = file;
+						sl_bool flagPrepared;
+						if (req->flagRead) {
+							flagPrepared = ring->prepareRead((int)(file->getHandle()), req->data, req->size, m_offset, op.get());
+						} else {
+							flagPrepared = ring->prepareWrite((int)(file->getHandle()), req->data, req->size, m_offset, op.get());
+						}
+						if (flagPrepared) {
+							m_operation = op;
+						} else {
+							doCallback(req.get(), 0, sl_true);
+						}
+						return;
+					}
+				}
+
+				void onEvent(EventDesc* pev) override
+				{
+				}
+
+				void onComplete(FileOperation* op, sl_int32 result)
+				{
+					m_operation.setNull();
+					AsyncStreamRequest* req = op->request.get();
+					if (result > 0) {
+						m_offset += result;
+						doCallback(req, (sl_uint32)result, sl_false);
+					} else {
+						// zero means the end of the file
+						doCallback(req, 0, sl_true);
+					}
+					if (isOpened() && !(isClosing())) {
+						onOrder();
+					}
+				}
+
+				void doCallback(AsyncStreamRequest* req, sl_uint32 size, sl_bool flagError)
+				{
+					Ref<AsyncIoObject> object = getObject();
+					if (object.isNotNull()) {
+						req->runCallback(static_cast<AsyncStream*>(object.get()), size, flagError);
+					}
+				}
+
+				sl_bool isSeekable() override
+				{
+					return sl_true;
+				}
+
+				sl_bool seek(sl_uint64 pos) override
+				{
+					m_offset = pos;
+					return sl_true;
+				}
+
+				sl_uint64 getSize() override
+				{
+					Ref<File> file = m_file;
+					if (file.isNotNull()) {
+						return file->getSize();
+					}
+					return 0;
+				}
+
+			};
+
+			void FileOperation::onComplete(sl_int32 result)
+			{
+				Ref<FileStreamInstance> _instance(instance);
+				if (_instance.isNotNull()) {
+					_instance->onComplete(this, result);
+				}
+			}
+
+		}
+	}
+
+	using namespace priv::async_io_uring;
+
+	Ref<AsyncStream> AsyncFile::openIoUring(const StringParam& path, FileMode mode, const Ref<AsyncIoLoop>& loop)
+	{
+		IoUring* ring = GetIoUring(loop.get());
+		if (!ring || !(ring->isSupportingFile())) {
+			return sl_null;
+		}
+		Ref<FileStreamInstance> instance = FileStreamInstance::open(path, mode);
+		if (instance.isNotNull()) {
+			// completions are delivered by the ring, so the file is not registered to epoll
+			return AsyncStream::create(instance.get(), AsyncIoMode::None, loop);
+		}
+		return sl_null;
+	}
+
+	Ref<AsyncStream> AsyncFile::openIoUring(const StringParam& path, FileMode mode)
+	{
+		return AsyncFile::openIoUring(path, mode, AsyncIoLoop::getDefault());
+	}
+
+}
+
+#elif defined(SLIB_PLATFORM_IS_LINUX)
+
+#include "slib/core/async.h"
+
+namespace slib
+{
+
+	Ref<AsyncStream> AsyncFile::openIoUring(const StringParam& path, FileMode mode, const Ref<AsyncIoLoop>& loop)
+	{
+		return sl_null;
+	}
+
+	Ref<AsyncStream> AsyncFile::openIoUring(const StringParam& path, FileMode mode)
+	{
+		return sl_null;
+	}
+
+}
+
+#endif
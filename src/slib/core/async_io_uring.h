@@ -0,0 +1,211 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#ifndef CHECKHEADER_SLIB_CORE_ASYNC_IO_URING
+#define CHECKHEADER_SLIB_CORE_ASYNC_IO_URING
+
+#include "async_config.h"
+
+#if defined(ASYNC_USE_IO_URING)
+
+#include "slib/core/async.h"
+#include "slib/core/spin_lock.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+#define ASYNC_IO_URING_ENTRIES 1024
+#define ASYNC_IO_URING_FIXED_BUFFER_SIZE 0x10000
+#define ASYNC_IO_URING_FIXED_BUFFER_COUNT 64
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace async_io_uring
+		{
+
+			/*
+				Operation submitted to the ring.
+				The ring keeps a reference to the operation until its completion is reaped.
+			*/
+			class Operation : public Referable
+			{
+			public:
+				Operation();
+
+				~Operation();
+
+			public:
+				// called on the loop thread. `result` is a byte count or a negative `errno`
+				virtual void onComplete(sl_int32 result) = 0;
+
+			private:
+				Operation* m_before;
+				Operation* m_next;
+
+				friend class IoUring;
+			};
+
+			// Buffers registered to the kernel (`IORING_REGISTER_BUFFERS`), used by `IORING_OP_READ_FIXED` and `IORING_OP_WRITE_FIXED`
+			class FixedBufferPool : public Referable
+			{
+			public:
+				FixedBufferPool();
+
+				~FixedBufferPool();
+
+			public:
+				static Ref<FixedBufferPool> create(sl_uint32 nBuffers, sl_uint32 sizeBuffer);
+
+			public:
+				// returns null if every buffer is in use or `size` exceeds the buffer size
+				Memory allocate(sl_uint32 size);
+
+				// index of the registered buffer containing [data, data + size), or negative
+				sl_int32 getIndex(const void* data, sl_uint32 size);
+
+			public:
+				sl_uint8* m_data;
+				sl_uint32 m_nBuffers;
+				sl_uint32 m_sizeBuffer;
+
+				sl_uint32* m_stackFree;
+				sl_uint32 m_nFree;
+				SpinLock m_lock;
+
+			private:
+				void _free(sl_uint32 index);
+
+				friend class FixedBuffer;
+			};
+
+			/*
+				Submission and completion rings of an `AsyncIoLoop`.
+				Except `getFixedBufferPool()`, every method must be called on the loop thread.
+				Prepared requests are queued and sent to the kernel in a batch by `submit()`.
+			*/
+			class IoUring
+			{
+			public:
+				IoUring();
+
+				~IoUring();
+
+			public:
+				// returns null if the kernel does not support io_uring
+				static IoUring* create(sl_uint32 nEntries = ASYNC_IO_URING_ENTRIES);
+
+			public:
+				int getHandle();
+
+				// the kernel accepts `opcode` on this ring (probed by `IORING_REGISTER_PROBE`)
+				sl_bool isSupportingOpcode(sl_uint8 opcode);
+
+				// reading and writing files (IORING_OP_READ, IORING_OP_WRITE) are available
+				sl_bool isSupportingFile();
+
+				// poll-driven socket operations (IORING_FEAT_FAST_POLL, IORING_OP_RECV, IORING_OP_SEND, IORING_OP_CONNECT) are available
+				sl_bool isSupportingSocket();
+
+				// sending files through a pipe (IORING_OP_SPLICE) is available
+				sl_bool isSupportingSplice();
+
+				Ref<FixedBufferPool> getFixedBufferPool();
+
+				sl_bool prepareRead(int fd, void* buf, sl_uint32 size, sl_uint64 offset, Operation* op);
+
+				sl_bool prepareWrite(int fd, const void* buf, sl_uint32 size, sl_uint64 offset, Operation* op);
+
+				sl_bool prepareRecv(int fd, void* buf, sl_uint32 size, Operation* op);
+
+				sl_bool prepareSend(int fd, const void* buf, sl_uint32 size, Operation* op);
+
+				sl_bool prepareConnect(int fd, const void* addr, sl_uint32 sizeAddr, Operation* op);
+
+				// one of the descriptors must be a pipe. pass -1 as the offset of a pipe
+				sl_bool prepareSplice(int fdIn, sl_int64 offsetIn, int fdOut, sl_int64 offsetOut, sl_uint32 size, Operation* op);
+
+				// sends the prepared requests to the kernel, and returns the number of the submitted requests
+				sl_uint32 submit();
+
+				sl_bool hasCompletions();
+
+				// dispatches the reaped completions, and returns the number of the completions
+				sl_uint32 processCompletions();
+
+			protected:
+				io_uring_sqe* _getSqe();
+
+				io_uring_sqe* _prepare(sl_uint8 opcode, int fd, const void* addr, sl_uint32 len, sl_uint64 offset, sl_uint32 flags, Operation* op);
+
+				sl_uint32 _processCompletions(sl_bool flagDispatch);
+
+				void _cancelAll();
+
+			protected:
+				int m_fd;
+				sl_uint32 m_features;
+				sl_uint64 m_opcodes; // bit flags indexed by the supported opcodes
+
+				void* m_ringSq;
+				sl_size m_sizeRingSq;
+				void* m_ringCq;
+				sl_size m_sizeRingCq;
+				io_uring_sqe* m_sqes;
+				sl_size m_sizeSqes;
+
+				sl_uint32* m_sqHead;
+				sl_uint32* m_sqTail;
+				sl_uint32 m_sqMask;
+				sl_uint32 m_sqEntries;
+				sl_uint32* m_sqArray;
+				sl_uint32 m_sqTailLocal;
+				sl_uint32 m_nToSubmit;
+
+				sl_uint32* m_cqHead;
+				sl_uint32* m_cqTail;
+				sl_uint32 m_cqMask;
+				io_uring_cqe* m_cqes;
+
+				Operation* m_opFirst;
+				sl_size m_nOperations;
+
+				Ref<FixedBufferPool> m_fixedBuffers;
+
+			};
+
+			// the ring of `loop`, or null when the loop runs on epoll only
+			IoUring* GetIoUring(AsyncIoLoop* loop);
+
+			// memory in a registered buffer of the loop running `stream`, or null
+			Memory AllocateFixedBuffer(AsyncStream* stream, sl_uint32 size);
+
+		}
+	}
+
+}
+
+#endif
+
+#endif
@@ -105,7 +105,7 @@ namespace slib
 
 			DWORD nCount = 0;
 			
-			if (!fGetQueuedCompletionStatusEx(handle->hCompletionPort, entries, ASYNC_MAX_WAIT_EVENT, &nCount, 5000, FALSE)) {
+			if (!fGetQueuedCompletionStatusEx(handle->hCompletionPort, entries, ASYNC_MAX_WAIT_EVENT, &nCount, (DWORD)(_getWaitTimeout(5000)), FALSE)) {
 				nCount = 0;
 			}
 			if (m_queueInstancesClosed.isNotEmpty()) {
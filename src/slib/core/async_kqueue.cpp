@@ -92,9 +92,10 @@ namespace slib
 
 			_stepBegin();
 
+			sl_int32 msTimeout = _getWaitTimeout(5000);
 			timespec timeout;
-			timeout.tv_nsec = 0;
-			timeout.tv_sec = 5;
+			timeout.tv_sec = msTimeout / 1000;
+			timeout.tv_nsec = (msTimeout % 1000) * 1000000;
 			int nEvents = ::kevent(handle->kq, sl_null, 0, waitEvents, ASYNC_MAX_WAIT_EVENT, &timeout);
 			if (m_queueInstancesClosed.isNotEmpty()) {
 				m_queueInstancesClosed.removeAll();
@@ -42,6 +42,27 @@
 #	define NOT_SUPPORT_ATOMIC_64BIT
 #endif
 
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define SUPPORT_SSE2
+#	include <emmintrin.h>
+#	if defined(SLIB_ARCH_IS_X64) && !defined(SLIB_PLATFORM_IS_MOBILE)
+#		define SUPPORT_AVX2
+#		include <immintrin.h>
+#		include "slib/core/asm.h"
+#		if defined(SLIB_COMPILER_IS_VC)
+#			define AVX2_FUNCTION
+#		else
+#			define AVX2_FUNCTION __attribute__((target("avx2")))
+#		endif
+#	endif
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64)
+#	define SUPPORT_NEON
+#	include <arm_neon.h>
+#endif
+
 namespace slib
 {
 	
@@ -135,6 +156,506 @@ namespace slib
 		std::char_traits<sl_int64>::assign(dst, count, value);
 	}
 
+	namespace priv
+	{
+		namespace base
+		{
+
+#if defined(SUPPORT_SSE2)
+			// `x` must not be zero
+			SLIB_INLINE static sl_uint32 GetLowestBit(sl_uint32 x) noexcept
+			{
+#	if defined(SLIB_COMPILER_IS_VC)
+				unsigned long index;
+				_BitScanForward(&index, x);
+				return (sl_uint32)index;
+#	else
+				return (sl_uint32)(__builtin_ctz(x));
+#	endif
+			}
+
+			// `x` must not be zero
+			SLIB_INLINE static sl_uint32 GetHighestBit(sl_uint32 x) noexcept
+			{
+#	if defined(SLIB_COMPILER_IS_VC)
+				unsigned long index;
+				_BitScanReverse(&index, x);
+				return (sl_uint32)index;
+#	else
+				return 31 - (sl_uint32)(__builtin_clz(x));
+#	endif
+			}
+
+			// bit `i` of the masks stands for the byte `i` of the vectors. `ElementBits` selects one bit per element
+			template <class T>
+			class Sse2;
+
+			template <>
+			class Sse2<sl_uint8>
+			{
+			public:
+				enum { ElementBits = 0xFFFF };
+				SLIB_INLINE static __m128i set(sl_uint8 v) noexcept { return _mm_set1_epi8((char)v); }
+				SLIB_INLINE static __m128i equals(__m128i a, __m128i b) noexcept { return _mm_cmpeq_epi8(a, b); }
+			};
+
+			template <>
+			class Sse2<sl_uint16>
+			{
+			public:
+				enum { ElementBits = 0x5555 };
+				SLIB_INLINE static __m128i set(sl_uint16 v) noexcept { return _mm_set1_epi16((short)v); }
+				SLIB_INLINE static __m128i equals(__m128i a, __m128i b) noexcept { return _mm_cmpeq_epi16(a, b); }
+			};
+
+			template <>
+			class Sse2<sl_uint32>
+			{
+			public:
+				enum { ElementBits = 0x1111 };
+				SLIB_INLINE static __m128i set(sl_uint32 v) noexcept { return _mm_set1_epi32((int)v); }
+				SLIB_INLINE static __m128i equals(__m128i a, __m128i b) noexcept { return _mm_cmpeq_epi32(a, b); }
+			};
+
+			SLIB_INLINE static __m128i Load128(const void* p) noexcept
+			{
+				return _mm_loadu_si128((const __m128i*)p);
+			}
+
+			SLIB_INLINE static sl_uint32 GetMask128(__m128i v) noexcept
+			{
+				return (sl_uint32)(_mm_movemask_epi8(v));
+			}
+
+			// returns the number of the elements scanned without finding `pattern`
+			template <class T>
+			SLIB_INLINE static sl_size Find_Sse2(const T* m, T pattern, sl_size count, const T*& found) noexcept
+			{
+				const sl_size n = 16 / sizeof(T);
+				__m128i p = Sse2<T>::set(pattern);
+				sl_size i = 0;
+				for (; i + n <= count; i += n) {
+					sl_uint32 mask = GetMask128(Sse2<T>::equals(Load128(m + i), p));
+					if (mask) {
+						found = m + i + GetLowestBit(mask) / sizeof(T);
+						return i;
+					}
+				}
+				return i;
+			}
+
+			// returns the number of the elements not scanned
+			template <class T>
+			SLIB_INLINE static sl_size FindReverse_Sse2(const T* m, T pattern, sl_size count, const T*& found) noexcept
+			{
+				const sl_size n = 16 / sizeof(T);
+				__m128i p = Sse2<T>::set(pattern);
+				sl_size i = count;
+				while (i >= n) {
+					i -= n;
+					sl_uint32 mask = GetMask128(Sse2<T>::equals(Load128(m + i), p));
+					if (mask) {
+						found = m + i + GetHighestBit(mask) / sizeof(T);
+						return i;
+					}
+				}
+				return i;
+			}
+
+			// returns the index of the first different element, or the number of the elements scanned
+			template <class T>
+			SLIB_INLINE static sl_size Mismatch_Sse2(const T* m1, const T* m2, sl_size count) noexcept
+			{
+				const sl_size n = 16 / sizeof(T);
+				sl_size i = 0;
+				for (; i + n <= count; i += n) {
+					sl_uint32 mask = GetMask128(Sse2<T>::equals(Load128(m1 + i), Load128(m2 + i))) ^ 0xFFFF;
+					if (mask) {
+						return i + GetLowestBit(mask) / sizeof(T);
+					}
+				}
+				return i;
+			}
+
+			// first and last element filter: only the positions matching both the first and the last element of the pattern are compared
+			template <class T>
+			SLIB_INLINE static sl_size FindPattern_Sse2(const T* m, sl_size count, const T* pattern, sl_size countPattern, const T*& found) noexcept
+			{
+				const sl_size n = 16 / sizeof(T);
+				__m128i first = Sse2<T>::set(pattern[0]);
+				__m128i last = Sse2<T>::set(pattern[countPattern - 1]);
+				sl_size nStarts = count - countPattern + 1;
+				sl_size i = 0;
+				for (; i + n <= nStarts; i += n) {
+					__m128i a = Sse2<T>::equals(Load128(m + i), first);
+					__m128i b = Sse2<T>::equals(Load128(m + i + countPattern - 1), last);
+					sl_uint32 mask = GetMask128(_mm_and_si128(a, b)) & Sse2<T>::ElementBits;
+					while (mask) {
+						sl_size k = i + GetLowestBit(mask) / sizeof(T);
+						if (!(memcmp(m + k + 1, pattern + 1, (countPattern - 2) * sizeof(T)))) {
+							found = m + k;
+							return i;
+						}
+						mask &= mask - 1;
+					}
+				}
+				return i;
+			}
+
+			SLIB_INLINE static __m128i ToUpper_Sse2(__m128i v) noexcept
+			{
+				// 'a'~'z' are moved to -128~-103, so that a signed comparison picks them
+				__m128i t = _mm_add_epi8(v, _mm_set1_epi8((char)(0x80 - 'a')));
+				__m128i lower = _mm_cmplt_epi8(t, _mm_set1_epi8((char)(0x80 + 26)));
+				return _mm_sub_epi8(v, _mm_and_si128(lower, _mm_set1_epi8(0x20)));
+			}
+
+			SLIB_INLINE static __m128i IsWhitespace_Sse2(__m128i v) noexcept
+			{
+				__m128i a = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\t')));
+				__m128i b = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+				return _mm_or_si128(a, b);
+			}
+#endif
+
+#if defined(SUPPORT_AVX2)
+#define AVX2_MIN_SIZE 128
+
+			template <class T>
+			class Avx2;
+
+			template <>
+			class Avx2<sl_uint8>
+			{
+			public:
+				enum : sl_uint32 { ElementBits = 0xFFFFFFFF };
+				AVX2_FUNCTION SLIB_INLINE static __m256i set(sl_uint8 v) noexcept { return _mm256_set1_epi8((char)v); }
+				AVX2_FUNCTION SLIB_INLINE static __m256i equals(__m256i a, __m256i b) noexcept { return _mm256_cmpeq_epi8(a, b); }
+			};
+
+			template <>
+			class Avx2<sl_uint16>
+			{
+			public:
+				enum : sl_uint32 { ElementBits = 0x55555555 };
+				AVX2_FUNCTION SLIB_INLINE static __m256i set(sl_uint16 v) noexcept { return _mm256_set1_epi16((short)v); }
+				AVX2_FUNCTION SLIB_INLINE static __m256i equals(__m256i a, __m256i b) noexcept { return _mm256_cmpeq_epi16(a, b); }
+			};
+
+			template <>
+			class Avx2<sl_uint32>
+			{
+			public:
+				enum : sl_uint32 { ElementBits = 0x11111111 };
+				AVX2_FUNCTION SLIB_INLINE static __m256i set(sl_uint32 v) noexcept { return _mm256_set1_epi32((int)v); }
+				AVX2_FUNCTION SLIB_INLINE static __m256i equals(__m256i a, __m256i b) noexcept { return _mm256_cmpeq_epi32(a, b); }
+			};
+
+			AVX2_FUNCTION SLIB_INLINE static __m256i Load256(const void* p) noexcept
+			{
+				return _mm256_loadu_si256((const __m256i*)p);
+			}
+
+			AVX2_FUNCTION SLIB_INLINE static sl_uint32 GetMask256(__m256i v) noexcept
+			{
+				return (sl_uint32)(_mm256_movemask_epi8(v));
+			}
+
+			template <class T>
+			AVX2_FUNCTION static sl_size Find_Avx2(const T* m, T pattern, sl_size count, const T*& found) noexcept
+			{
+				const sl_size n = 32 / sizeof(T);
+				__m256i p = Avx2<T>::set(pattern);
+				sl_size i = 0;
+				for (; i + n <= count; i += n) {
+					sl_uint32 mask = GetMask256(Avx2<T>::equals(Load256(m + i), p));
+					if (mask) {
+						found = m + i + GetLowestBit(mask) / sizeof(T);
+						return i;
+					}
+				}
+				return i;
+			}
+
+			template <class T>
+			AVX2_FUNCTION static sl_size FindPattern_Avx2(const T* m, sl_size count, const T* pattern, sl_size countPattern, const T*& found) noexcept
+			{
+				const sl_size n = 32 / sizeof(T);
+				__m256i first = Avx2<T>::set(pattern[0]);
+				__m256i last = Avx2<T>::set(pattern[countPattern - 1]);
+				sl_size nStarts = count - countPattern + 1;
+				sl_size i = 0;
+				for (; i + n <= nStarts; i += n) {
+					__m256i a = Avx2<T>::equals(Load256(m + i), first);
+					__m256i b = Avx2<T>::equals(Load256(m + i + countPattern - 1), last);
+					sl_uint32 mask = GetMask256(_mm256_and_si256(a, b)) & Avx2<T>::ElementBits;
+					while (mask) {
+						sl_size k = i + GetLowestBit(mask) / sizeof(T);
+						if (!(memcmp(m + k + 1, pattern + 1, (countPattern - 2) * sizeof(T)))) {
+							found = m + k;
+							return i;
+						}
+						mask &= mask - 1;
+					}
+				}
+				return i;
+			}
+#endif
+
+#if defined(SUPPORT_NEON)
+			// the blocks having any match are searched again by the scalar loops
+			template <class T>
+			class Neon;
+
+			template <>
+			class Neon<sl_uint8>
+			{
+			public:
+				typedef uint8x16_t V;
+				SLIB_INLINE static V set(sl_uint8 v) noexcept { return vdupq_n_u8(v); }
+				SLIB_INLINE static V load(const sl_uint8* p) noexcept { return vld1q_u8(p); }
+				SLIB_INLINE static V equals(V a, V b) noexcept { return vceqq_u8(a, b); }
+				SLIB_INLINE static sl_bool isAny(V v) noexcept { return vmaxvq_u8(v) != 0; }
+				SLIB_INLINE static sl_bool isAll(V v) noexcept { return vminvq_u8(v) != 0; }
+				SLIB_INLINE static V both(V a, V b) noexcept { return vandq_u8(a, b); }
+			};
+
+			template <>
+			class Neon<sl_uint16>
+			{
+			public:
+				typedef uint16x8_t V;
+				SLIB_INLINE static V set(sl_uint16 v) noexcept { return vdupq_n_u16(v); }
+				SLIB_INLINE static V load(const sl_uint16* p) noexcept { return vld1q_u16(p); }
+				SLIB_INLINE static V equals(V a, V b) noexcept { return vceqq_u16(a, b); }
+				SLIB_INLINE static sl_bool isAny(V v) noexcept { return vmaxvq_u16(v) != 0; }
+				SLIB_INLINE static sl_bool isAll(V v) noexcept { return vminvq_u16(v) != 0; }
+				SLIB_INLINE static V both(V a, V b) noexcept { return vandq_u16(a, b); }
+			};
+
+			template <>
+			class Neon<sl_uint32>
+			{
+			public:
+				typedef uint32x4_t V;
+				SLIB_INLINE static V set(sl_uint32 v) noexcept { return vdupq_n_u32(v); }
+				SLIB_INLINE static V load(const sl_uint32* p) noexcept { return vld1q_u32(p); }
+				SLIB_INLINE static V equals(V a, V b) noexcept { return vceqq_u32(a, b); }
+				SLIB_INLINE static sl_bool isAny(V v) noexcept { return vmaxvq_u32(v) != 0; }
+				SLIB_INLINE static sl_bool isAll(V v) noexcept { return vminvq_u32(v) != 0; }
+				SLIB_INLINE static V both(V a, V b) noexcept { return vandq_u32(a, b); }
+			};
+
+			// returns the start of the first block containing `pattern`
+			template <class T>
+			SLIB_INLINE static sl_size Find_Neon(const T* m, T pattern, sl_size count) noexcept
+			{
+				const sl_size n = 16 / sizeof(T);
+				typename Neon<T>::V p = Neon<T>::set(pattern);
+				sl_size i = 0;
+				for (; i + n <= count; i += n) {
+					if (Neon<T>::isAny(Neon<T>::equals(Neon<T>::load(m + i), p))) {
+						return i;
+					}
+				}
+				return i;
+			}
+
+			// returns the end of the last block containing `pattern`
+			template <class T>
+			SLIB_INLINE static sl_size FindReverse_Neon(const T* m, T pattern, sl_size count) noexcept
+			{
+				const sl_size n = 16 / sizeof(T);
+				typename Neon<T>::V p = Neon<T>::set(pattern);
+				sl_size i = count;
+				while (i >= n) {
+					if (Neon<T>::isAny(Neon<T>::equals(Neon<T>::load(m + i - n), p))) {
+						return i;
+					}
+					i -= n;
+				}
+				return i;
+			}
+
+			// returns the start of the first block containing a different element
+			template <class T>
+			SLIB_INLINE static sl_size Mismatch_Neon(const T* m1, const T* m2, sl_size count) noexcept
+			{
+				const sl_size n = 16 / sizeof(T);
+				sl_size i = 0;
+				for (; i + n <= count; i += n) {
+					if (!(Neon<T>::isAll(Neon<T>::equals(Neon<T>::load(m1 + i), Neon<T>::load(m2 + i))))) {
+						return i;
+					}
+				}
+				return i;
+			}
+
+			// returns the start of the first block containing a candidate position
+			template <class T>
+			SLIB_INLINE static sl_size FindPattern_Neon(const T* m, sl_size count, const T* pattern, sl_size countPattern) noexcept
+			{
+				const sl_size n = 16 / sizeof(T);
+				typename Neon<T>::V first = Neon<T>::set(pattern[0]);
+				typename Neon<T>::V last = Neon<T>::set(pattern[countPattern - 1]);
+				sl_size nStarts = count - countPattern + 1;
+				sl_size i = 0;
+				for (; i + n <= nStarts; i += n) {
+					typename Neon<T>::V a = Neon<T>::equals(Neon<T>::load(m + i), first);
+					typename Neon<T>::V b = Neon<T>::equals(Neon<T>::load(m + i + countPattern - 1), last);
+					if (Neon<T>::isAny(Neon<T>::both(a, b))) {
+						return i;
+					}
+				}
+				return i;
+			}
+
+			SLIB_INLINE static uint8x16_t ToUpper_Neon(uint8x16_t v) noexcept
+			{
+				uint8x16_t lower = vcleq_u8(vsubq_u8(v, vdupq_n_u8('a')), vdupq_n_u8(25));
+				return vsubq_u8(v, vandq_u8(lower, vdupq_n_u8(0x20)));
+			}
+
+			SLIB_INLINE static uint8x16_t IsWhitespace_Neon(uint8x16_t v) noexcept
+			{
+				uint8x16_t a = vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), vceqq_u8(v, vdupq_n_u8('\t')));
+				uint8x16_t b = vorrq_u8(vceqq_u8(v, vdupq_n_u8('\r')), vceqq_u8(v, vdupq_n_u8('\n')));
+				return vorrq_u8(a, b);
+			}
+#endif
+
+			template <class T>
+			static const T* Find(const T* m, T pattern, sl_size count) noexcept
+			{
+				sl_size i = 0;
+#if defined(SUPPORT_SSE2)
+				const T* found = sl_null;
+#	if defined(SUPPORT_AVX2)
+				if (count * sizeof(T) >= AVX2_MIN_SIZE && CanUseAvx2()) {
+					i = Find_Avx2(m, pattern, count, found);
+				} else {
+					i = Find_Sse2(m, pattern, count, found);
+				}
+#	else
+				i = Find_Sse2(m, pattern, count, found);
+#	endif
+				if (found) {
+					return found;
+				}
+#elif defined(SUPPORT_NEON)
+				i = Find_Neon(m, pattern, count);
+#endif
+				for (; i < count; i++) {
+					if (m[i] == pattern) {
+						return m + i;
+					}
+				}
+				return sl_null;
+			}
+
+			template <class T>
+			static const T* FindReverse(const T* m, T pattern, sl_size count) noexcept
+			{
+				sl_size i = count;
+#if defined(SUPPORT_SSE2)
+				const T* found = sl_null;
+				i = FindReverse_Sse2(m, pattern, count, found);
+				if (found) {
+					return found;
+				}
+#elif defined(SUPPORT_NEON)
+				i = FindReverse_Neon(m, pattern, count);
+#endif
+				while (i > 0) {
+					i--;
+					if (m[i] == pattern) {
+						return m + i;
+					}
+				}
+				return sl_null;
+			}
+
+			template <class T>
+			static sl_compare_result Compare(const T* m1, const T* m2, sl_size count) noexcept
+			{
+				sl_size i = 0;
+#if defined(SUPPORT_SSE2)
+				i = Mismatch_Sse2(m1, m2, count);
+#elif defined(SUPPORT_NEON)
+				i = Mismatch_Neon(m1, m2, count);
+#endif
+				for (; i < count; i++) {
+					T v1 = m1[i];
+					T v2 = m2[i];
+					if (v1 != v2) {
+						return v1 < v2 ? -1 : 1;
+					}
+				}
+				return 0;
+			}
+
+			template <class T>
+			static const T* FindPattern(const T* m, sl_size count, const T* pattern, sl_size countPattern) noexcept
+			{
+				if (!countPattern) {
+					return m;
+				}
+				if (count < countPattern) {
+					return sl_null;
+				}
+				if (countPattern == 1) {
+					return Find(m, pattern[0], count);
+				}
+				sl_size i = 0;
+#if defined(SUPPORT_SSE2)
+				const T* found = sl_null;
+#	if defined(SUPPORT_AVX2)
+				if (count * sizeof(T) >= AVX2_MIN_SIZE && CanUseAvx2()) {
+					i = FindPattern_Avx2(m, count, pattern, countPattern, found);
+				} else {
+					i = FindPattern_Sse2(m, count, pattern, countPattern, found);
+				}
+#	else
+				i = FindPattern_Sse2(m, count, pattern, countPattern, found);
+#	endif
+				if (found) {
+					return found;
+				}
+#endif
+				T first = pattern[0];
+				T last = pattern[countPattern - 1];
+				sl_size nStarts = count - countPattern + 1;
+				for (;;) {
+#if defined(SUPPORT_NEON)
+					i += FindPattern_Neon(m + i, count - i, pattern, countPattern);
+#endif
+					const T* p = Find(m + i, first, nStarts - i);
+					if (!p) {
+						return sl_null;
+					}
+					if (p[countPattern - 1] == last && !(memcmp(p + 1, pattern + 1, (countPattern - 2) * sizeof(T)))) {
+						return p;
+					}
+					i = (sl_size)(p - m) + 1;
+					if (i >= nStarts) {
+						return sl_null;
+					}
+				}
+			}
+
+			SLIB_INLINE static sl_uint8 ToUpper(sl_uint8 c) noexcept
+			{
+				return (c >= 'a' && c <= 'z') ? (c - ('a' - 'A')) : c;
+			}
+
+			SLIB_INLINE static sl_bool IsWhitespace(sl_uint8 c) noexcept
+			{
+				return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+			}
+
+		}
+	}
+
 	sl_bool Base::equalsMemory(const void* m1, const void* m2, sl_size count) noexcept
 	{
 		return memcmp(m1, m2, count) == 0;
@@ -182,7 +703,7 @@ namespace slib
 
 	sl_compare_result Base::compareMemory2(const sl_uint16* m1, const sl_uint16* m2, sl_size count) noexcept
 	{
-		return (sl_compare_result)(std::char_traits<sl_base_char16>::compare((sl_base_char16*)m1, (sl_base_char16*)m2, count));
+		return priv::base::Compare(m1, m2, count);
 	}
 
 	sl_compare_result Base::compareMemory2(const sl_int16* m1, const sl_int16* m2, sl_size count) noexcept
@@ -192,7 +713,7 @@ namespace slib
 
 	sl_compare_result Base::compareMemory4(const sl_uint32* m1, const sl_uint32* m2, sl_size count) noexcept
 	{
-		return (sl_compare_result)(std::char_traits<sl_base_char32>::compare((sl_base_char32*)m1, (sl_base_char32*)m2, count));
+		return priv::base::Compare(m1, m2, count);
 	}
 
 	sl_compare_result Base::compareMemory4(const sl_int32* m1, const sl_int32* m2, sl_size count) noexcept
@@ -393,22 +914,22 @@ namespace slib
 
 	const sl_uint16* Base::findMemory2(const sl_uint16* m, sl_uint16 pattern, sl_size count) noexcept
 	{
-		return (const sl_uint16*)(std::char_traits<sl_base_char16>::find((sl_base_char16*)m, count, (sl_base_char16)pattern));
+		return priv::base::Find(m, pattern, count);
 	}
 
 	const sl_int16* Base::findMemory2(const sl_int16* m, sl_int16 pattern, sl_size count) noexcept
 	{
-		return (const sl_int16*)(std::char_traits<sl_base_char16>::find((sl_base_char16*)m, count, (sl_base_char16)pattern));
+		return (const sl_int16*)(priv::base::Find((const sl_uint16*)m, (sl_uint16)pattern, count));
 	}
 
 	const sl_uint32* Base::findMemory4(const sl_uint32* m, sl_uint32 pattern, sl_size count) noexcept
 	{
-		return (const sl_uint32*)(std::char_traits<sl_base_char32>::find((sl_base_char32*)m, count, (sl_base_char32)pattern));
+		return priv::base::Find(m, pattern, count);
 	}
 
 	const sl_int32* Base::findMemory4(const sl_int32* m, sl_int32 pattern, sl_size count) noexcept
 	{
-		return (const sl_int32*)(std::char_traits<sl_base_char32>::find((sl_base_char32*)m, count, (sl_base_char32)pattern));
+		return (const sl_int32*)(priv::base::Find((const sl_uint32*)m, (sl_uint32)pattern, count));
 	}
 
 	const sl_uint64* Base::findMemory8(const sl_uint64* m, sl_uint64 pattern, sl_size count) noexcept
@@ -423,53 +944,27 @@ namespace slib
 
 	const sl_uint8* Base::findMemoryReverse(const void* mem, sl_uint8 pattern, sl_size count) noexcept
 	{
-		sl_uint8* m = (sl_uint8*)mem;
-		for (sl_reg i = count - 1; i >= 0; i--) {
-			if (m[i] == pattern) {
-				return m + i;
-			}
-		}
-		return sl_null;
+		return priv::base::FindReverse((const sl_uint8*)mem, pattern, count);
 	}
 
 	const sl_uint16* Base::findMemoryReverse2(const sl_uint16* m, sl_uint16 pattern, sl_size count) noexcept
 	{
-		for (sl_reg i = count - 1; i >= 0; i--) {
-			if (m[i] == pattern) {
-				return m + i;
-			}
-		}
-		return sl_null;
+		return priv::base::FindReverse(m, pattern, count);
 	}
 
 	const sl_int16* Base::findMemoryReverse2(const sl_int16* m, sl_int16 pattern, sl_size count) noexcept
 	{
-		for (sl_reg i = count - 1; i >= 0; i--) {
-			if (m[i] == pattern) {
-				return m + i;
-			}
-		}
-		return sl_null;
+		return (const sl_int16*)(priv::base::FindReverse((const sl_uint16*)m, (sl_uint16)pattern, count));
 	}
 
 	const sl_uint32* Base::findMemoryReverse4(const sl_uint32* m, sl_uint32 pattern, sl_size count) noexcept
 	{
-		for (sl_reg i = count - 1; i >= 0; i--) {
-			if (m[i] == pattern) {
-				return m + i;
-			}
-		}
-		return sl_null;
+		return priv::base::FindReverse(m, pattern, count);
 	}
 
 	const sl_int32* Base::findMemoryReverse4(const sl_int32* m, sl_int32 pattern, sl_size count) noexcept
 	{
-		for (sl_reg i = count - 1; i >= 0; i--) {
-			if (m[i] == pattern) {
-				return m + i;
-			}
-		}
-		return sl_null;
+		return (const sl_int32*)(priv::base::FindReverse((const sl_uint32*)m, (sl_uint32)pattern, count));
 	}
 
 	const sl_uint64* Base::findMemoryReverse8(const sl_uint64* mem, sl_uint64 pattern, sl_size count) noexcept
@@ -497,7 +992,36 @@ namespace slib
 	const sl_uint8* Base::findMemoryUntilZero(const void* mem, sl_uint8 pattern, sl_size count) noexcept
 	{
 		sl_uint8* m = (sl_uint8*)mem;
-		for (sl_size i = 0; i < count; i++) {
+		if (!pattern) {
+			return sl_null;
+		}
+		sl_size i = 0;
+#if defined(SUPPORT_SSE2)
+		{
+			__m128i p = _mm_set1_epi8((char)pattern);
+			__m128i zero = _mm_setzero_si128();
+			for (; i + 16 <= count; i += 16) {
+				__m128i v = priv::base::Load128(m + i);
+				sl_uint32 mask = priv::base::GetMask128(_mm_or_si128(_mm_cmpeq_epi8(v, p), _mm_cmpeq_epi8(v, zero)));
+				if (mask) {
+					i += priv::base::GetLowestBit(mask);
+					break;
+				}
+			}
+		}
+#elif defined(SUPPORT_NEON)
+		{
+			uint8x16_t p = vdupq_n_u8(pattern);
+			uint8x16_t zero = vdupq_n_u8(0);
+			for (; i + 16 <= count; i += 16) {
+				uint8x16_t v = vld1q_u8(m + i);
+				if (vmaxvq_u8(vorrq_u8(vceqq_u8(v, p), vceqq_u8(v, zero)))) {
+					break;
+				}
+			}
+		}
+#endif
+		for (; i < count; i++) {
 			if (m[i] == 0) {
 				break;
 			}
@@ -508,6 +1032,16 @@ namespace slib
 		return sl_null;
 	}
 
+	const sl_uint8* Base::findMemory(const void* mem, sl_size size, const void* pattern, sl_size sizePattern) noexcept
+	{
+		return priv::base::FindPattern((const sl_uint8*)mem, size, (const sl_uint8*)pattern, sizePattern);
+	}
+
+	const sl_uint16* Base::findMemory2(const sl_uint16* mem, sl_size count, const sl_uint16* pattern, sl_size countPattern) noexcept
+	{
+		return priv::base::FindPattern(mem, count, pattern, countPattern);
+	}
+
 #define STRING_LENGTH_LIMIT 0x1000000
 
 	sl_bool Base::equalsString(const sl_char8 *s1, const sl_char8 *s2, sl_reg count) noexcept
@@ -610,6 +1144,141 @@ namespace slib
 #endif
 	}
 
+	sl_bool Base::equalsMemoryIgnoreCase(const void* mem1, const void* mem2, sl_size count) noexcept
+	{
+		const sl_uint8* m1 = (const sl_uint8*)mem1;
+		const sl_uint8* m2 = (const sl_uint8*)mem2;
+		sl_size i = 0;
+#if defined(SUPPORT_SSE2)
+		for (; i + 16 <= count; i += 16) {
+			__m128i v1 = priv::base::ToUpper_Sse2(priv::base::Load128(m1 + i));
+			__m128i v2 = priv::base::ToUpper_Sse2(priv::base::Load128(m2 + i));
+			if (priv::base::GetMask128(_mm_cmpeq_epi8(v1, v2)) != 0xFFFF) {
+				return sl_false;
+			}
+		}
+#elif defined(SUPPORT_NEON)
+		for (; i + 16 <= count; i += 16) {
+			uint8x16_t v1 = priv::base::ToUpper_Neon(vld1q_u8(m1 + i));
+			uint8x16_t v2 = priv::base::ToUpper_Neon(vld1q_u8(m2 + i));
+			if (!(vminvq_u8(vceqq_u8(v1, v2)))) {
+				return sl_false;
+			}
+		}
+#endif
+		for (; i < count; i++) {
+			if (priv::base::ToUpper(m1[i]) != priv::base::ToUpper(m2[i])) {
+				return sl_false;
+			}
+		}
+		return sl_true;
+	}
+
+	sl_compare_result Base::compareStringIgnoreCase(const sl_char8* s1, const sl_char8* s2, sl_reg _count) noexcept
+	{
+		const sl_uint8* m1 = (const sl_uint8*)s1;
+		const sl_uint8* m2 = (const sl_uint8*)s2;
+		sl_size count;
+		sl_size i = 0;
+		if (_count < 0) {
+			// the length is unknown, so the blocks can not be loaded
+			count = STRING_LENGTH_LIMIT;
+		} else {
+			count = _count;
+#if defined(SUPPORT_SSE2)
+			__m128i zero = _mm_setzero_si128();
+			for (; i + 16 <= count; i += 16) {
+				__m128i v1 = priv::base::Load128(m1 + i);
+				__m128i v2 = priv::base::Load128(m2 + i);
+				sl_uint32 mask = (priv::base::GetMask128(_mm_cmpeq_epi8(priv::base::ToUpper_Sse2(v1), priv::base::ToUpper_Sse2(v2))) ^ 0xFFFF) | priv::base::GetMask128(_mm_cmpeq_epi8(v1, zero));
+				if (mask) {
+					i += priv::base::GetLowestBit(mask);
+					break;
+				}
+			}
+#elif defined(SUPPORT_NEON)
+			uint8x16_t zero = vdupq_n_u8(0);
+			for (; i + 16 <= count; i += 16) {
+				uint8x16_t v1 = vld1q_u8(m1 + i);
+				uint8x16_t v2 = vld1q_u8(m2 + i);
+				uint8x16_t stop = vorrq_u8(vmvnq_u8(vceqq_u8(priv::base::ToUpper_Neon(v1), priv::base::ToUpper_Neon(v2))), vceqq_u8(v1, zero));
+				if (vmaxvq_u8(stop)) {
+					break;
+				}
+			}
+#endif
+		}
+		for (; i < count; i++) {
+			sl_uint8 c1 = priv::base::ToUpper(m1[i]);
+			sl_uint8 c2 = priv::base::ToUpper(m2[i]);
+			if (c1 < c2) {
+				return -1;
+			}
+			if (c1 > c2) {
+				return 1;
+			}
+			if (!c1) {
+				break;
+			}
+		}
+		return 0;
+	}
+
+	sl_size Base::countLeadingWhitespaces(const sl_char8* s, sl_size count) noexcept
+	{
+		const sl_uint8* m = (const sl_uint8*)s;
+		sl_size i = 0;
+#if defined(SUPPORT_SSE2)
+		for (; i + 16 <= count; i += 16) {
+			sl_uint32 mask = priv::base::GetMask128(priv::base::IsWhitespace_Sse2(priv::base::Load128(m + i))) ^ 0xFFFF;
+			if (mask) {
+				return i + priv::base::GetLowestBit(mask);
+			}
+		}
+#elif defined(SUPPORT_NEON)
+		for (; i + 16 <= count; i += 16) {
+			if (!(vminvq_u8(priv::base::IsWhitespace_Neon(vld1q_u8(m + i))))) {
+				break;
+			}
+		}
+#endif
+		for (; i < count; i++) {
+			if (!(priv::base::IsWhitespace(m[i]))) {
+				return i;
+			}
+		}
+		return count;
+	}
+
+	sl_size Base::countTrailingWhitespaces(const sl_char8* s, sl_size count) noexcept
+	{
+		const sl_uint8* m = (const sl_uint8*)s;
+		sl_size i = count;
+#if defined(SUPPORT_SSE2)
+		while (i >= 16) {
+			sl_uint32 mask = priv::base::GetMask128(priv::base::IsWhitespace_Sse2(priv::base::Load128(m + i - 16))) ^ 0xFFFF;
+			if (mask) {
+				return count - (i - 16 + priv::base::GetHighestBit(mask) + 1);
+			}
+			i -= 16;
+		}
+#elif defined(SUPPORT_NEON)
+		while (i >= 16) {
+			if (!(vminvq_u8(priv::base::IsWhitespace_Neon(vld1q_u8(m + i - 16))))) {
+				break;
+			}
+			i -= 16;
+		}
+#endif
+		while (i > 0) {
+			if (!(priv::base::IsWhitespace(m[i - 1]))) {
+				return count - i;
+			}
+			i--;
+		}
+		return count;
+	}
+
 	sl_size Base::copyString(sl_char8* dst, const sl_char8* src, sl_reg count) noexcept
 	{
 		if (count < 0) {
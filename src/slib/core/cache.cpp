@@ -0,0 +1,187 @@
+/*
+ *   Copyright (c) 2008-2019 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/cache.h"
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace cache
+		{
+
+			const char g_classID[] = "cache";
+
+			static const sl_uint64 g_seeds[] = {
+				SLIB_UINT64(0xc3a5c85c97cb3127),
+				SLIB_UINT64(0xb492b66fbe98f273),
+				SLIB_UINT64(0x9ae16a3b2f90404f),
+				SLIB_UINT64(0xcbf29ce484222325)
+			};
+
+			static const sl_uint64 g_maxTableSize = 1 << 24;
+
+			SLIB_INLINE static sl_uint64 Spread(sl_uint64 x)
+			{
+				x *= SLIB_UINT64(0x9E3779B97F4A7C15);
+				return x ^ (x >> 32);
+			}
+
+		}
+	}
+
+	using namespace priv::cache;
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(CacheParam)
+
+	CacheParam::CacheParam()
+	{
+		capacity = 10000;
+		defaultTTL = 0;
+	}
+
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(CacheStatistics)
+
+	CacheStatistics::CacheStatistics()
+	{
+		hitCount = 0;
+		missCount = 0;
+		loadSuccessCount = 0;
+		loadFailureCount = 0;
+		evictionCount = 0;
+		expirationCount = 0;
+	}
+
+
+	FrequencySketch::FrequencySketch() noexcept
+	{
+		m_table = sl_null;
+		m_tableMask = 0;
+		m_sampleSize = 0;
+		m_size = 0;
+	}
+
+	FrequencySketch::~FrequencySketch() noexcept
+	{
+		if (m_table) {
+			Base::freeMemory(m_table);
+		}
+	}
+
+	sl_bool FrequencySketch::setMaximumSize(sl_uint64 maximumSize) noexcept
+	{
+		// every 64-bit word has 16 counters, and a key uses 4 counters in the different words
+		sl_uint64 n = 16;
+		while (n < maximumSize && n < g_maxTableSize) {
+			n <<= 1;
+		}
+		sl_uint64* table = (sl_uint64*)(Base::createZeroMemory((sl_size)(n * sizeof(sl_uint64))));
+		if (!table) {
+			return sl_false;
+		}
+		if (m_table) {
+			Base::freeMemory(m_table);
+		}
+		m_table = table;
+		m_tableMask = (sl_size)(n - 1);
+		sl_uint64 sampleSize = maximumSize * 10;
+		if (sampleSize > 0x7FFFFFFF) {
+			sampleSize = 0x7FFFFFFF;
+		}
+		if (sampleSize < 16) {
+			sampleSize = 16;
+		}
+		m_sampleSize = (sl_uint32)sampleSize;
+		m_size = 0;
+		return sl_true;
+	}
+
+	sl_uint32 FrequencySketch::getFrequency(sl_uint64 hash) const noexcept
+	{
+		if (!m_table) {
+			return 0;
+		}
+		hash = Spread(hash);
+		sl_uint32 start = (sl_uint32)(hash & 3) << 2;
+		sl_uint32 frequency = 15;
+		for (sl_uint32 i = 0; i < 4; i++) {
+			sl_uint32 offset = (start + i) << 2;
+			sl_uint32 count = (sl_uint32)((m_table[_getIndex(hash, i)] >> offset) & 15);
+			if (count < frequency) {
+				frequency = count;
+			}
+		}
+		return frequency;
+	}
+
+	void FrequencySketch::increment(sl_uint64 hash) noexcept
+	{
+		if (!m_table) {
+			return;
+		}
+		hash = Spread(hash);
+		sl_uint32 start = (sl_uint32)(hash & 3) << 2;
+		sl_bool flagAdded = sl_false;
+		for (sl_uint32 i = 0; i < 4; i++) {
+			sl_uint32 offset = (start + i) << 2;
+			sl_uint64 mask = (sl_uint64)15 << offset;
+			sl_uint64& word = m_table[_getIndex(hash, i)];
+			if ((word & mask) != mask) {
+				word += (sl_uint64)1 << offset;
+				flagAdded = sl_true;
+			}
+		}
+		if (flagAdded) {
+			m_size++;
+			if (m_size >= m_sampleSize) {
+				_reset();
+			}
+		}
+	}
+
+	void FrequencySketch::clear() noexcept
+	{
+		if (m_table) {
+			Base::zeroMemory(m_table, (m_tableMask + 1) * sizeof(sl_uint64));
+		}
+		m_size = 0;
+	}
+
+	sl_size FrequencySketch::_getIndex(sl_uint64 hash, sl_uint32 depth) const noexcept
+	{
+		sl_uint64 x = (hash + g_seeds[depth]) * g_seeds[depth];
+		x += x >> 32;
+		return (sl_size)x & m_tableMask;
+	}
+
+	void FrequencySketch::_reset() noexcept
+	{
+		sl_size n = m_tableMask + 1;
+		for (sl_size i = 0; i < n; i++) {
+			m_table[i] = (m_table[i] >> 1) & SLIB_UINT64(0x7777777777777777);
+		}
+		m_size >>= 1;
+	}
+
+}
@@ -23,8 +23,44 @@
 #include "slib/core/charset.h"
 
 #include "slib/core/endian.h"
+#include "slib/core/base.h"
+#include "slib/core/mio.h"
 #include "slib/core/macro.h"
 
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define SUPPORT_SSE2
+#	include <emmintrin.h>
+#	if defined(SLIB_ARCH_IS_X64) && !defined(SLIB_PLATFORM_IS_MOBILE)
+#		define SUPPORT_AVX2
+#		include <immintrin.h>
+#		include "slib/core/asm.h"
+#		if defined(SLIB_COMPILER_IS_VC)
+#			define SSE42_FUNCTION
+#			define AVX2_FUNCTION
+#		else
+#			define SSE42_FUNCTION __attribute__((target("sse4.2")))
+#			define AVX2_FUNCTION __attribute__((target("avx2")))
+#		endif
+#	endif
+#	if defined(SLIB_COMPILER_IS_VC)
+#		include <intrin.h>
+#	endif
+#elif defined(SLIB_ARCH_IS_ARM64) && !defined(__ARM_BIG_ENDIAN)
+#	define SUPPORT_NEON
+#	include <arm_neon.h>
+#endif
+
+#if defined(SUPPORT_SSE2) || defined(SUPPORT_NEON)
+#	define SUPPORT_ASCII_BLOCKS
+#endif
+
+// keeps the block conversions out of the scalar loops, which are slowed down by inlining them
+#if defined(SLIB_COMPILER_IS_VC)
+#	define NOINLINE_FUNCTION __declspec(noinline)
+#else
+#	define NOINLINE_FUNCTION __attribute__((noinline))
+#endif
+
 namespace slib
 {
 	
@@ -86,6 +122,593 @@ namespace slib
 					d[3] = (sl_uint8)(v);
 				}
 			}
+
+#if defined(SUPPORT_SSE2)
+			// `x` must not be zero
+			SLIB_INLINE static sl_uint32 GetLowestBit(sl_uint32 x) noexcept
+			{
+#	if defined(SLIB_COMPILER_IS_VC)
+				unsigned long index;
+				_BitScanForward(&index, x);
+				return (sl_uint32)index;
+#	else
+				return (sl_uint32)(__builtin_ctz(x));
+#	endif
+			}
+#endif
+
+#if defined(SUPPORT_ASCII_BLOCKS)
+			// the block conversions are tried only at the runs of ASCII characters not too short to pay off
+			SLIB_INLINE static sl_bool IsAscii8(const sl_char8* s) noexcept
+			{
+				sl_uint64 v = MIO::readUint64LE(s);
+				return !(v & SLIB_UINT64(0x8080808080808080));
+			}
+
+			template <EndianType endian>
+			SLIB_INLINE static sl_bool IsAscii4_16(const sl_uint8* s) noexcept
+			{
+				sl_uint64 v = MIO::readUint64LE(s);
+				if (endian == EndianType::Little) {
+					return !(v & SLIB_UINT64(0xFF80FF80FF80FF80));
+				} else {
+					return !(v & SLIB_UINT64(0x80FF80FF80FF80FF));
+				}
+			}
+
+			// returns the index of the first non-ASCII byte in the block of 16 bytes, or 16
+			SLIB_INLINE static sl_uint32 FindNonAscii16(const sl_uint8* s) noexcept
+			{
+#	if defined(SUPPORT_SSE2)
+				sl_uint32 mask = (sl_uint32)(_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)s)));
+				if (mask) {
+					return GetLowestBit(mask);
+				}
+#	else
+				if (vmaxvq_u8(vld1q_u8(s)) >= 0x80) {
+					sl_uint32 k = 0;
+					while (s[k] < 0x80) {
+						k++;
+					}
+					return k;
+				}
+#	endif
+				return 16;
+			}
+
+			// returns the index of the first unit not in ASCII range in the block of 8 units, or 8
+			template <EndianType endian>
+			SLIB_INLINE static sl_uint32 FindNonAscii8_16(const sl_uint8* s) noexcept
+			{
+#	if defined(SUPPORT_SSE2)
+				__m128i v = _mm_loadu_si128((const __m128i*)s);
+				if (endian == EndianType::Big) {
+					v = _mm_or_si128(_mm_srli_epi16(v, 8), _mm_slli_epi16(v, 8));
+				}
+				sl_uint32 mask = (sl_uint32)(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16((short)0xFF80)), _mm_setzero_si128())));
+				if (mask != 0xFFFF) {
+					return GetLowestBit(~mask & 0xFFFF) >> 1;
+				}
+#	else
+				uint8x16_t v = vld1q_u8(s);
+				if (endian == EndianType::Big) {
+					v = vrev16q_u8(v);
+				}
+				if (vmaxvq_u16(vreinterpretq_u16_u8(v)) >= 0x80) {
+					sl_uint32 k = 0;
+					while ((sl_uint16)(Read16<endian>(s, k)) < 0x80) {
+						k++;
+					}
+					return k;
+				}
+#	endif
+				return 8;
+			}
+
+			// 16 ASCII characters to 16 UTF-16 units
+			template <EndianType endian>
+			SLIB_INLINE static void WidenAscii16_16(const sl_uint8* s, sl_uint8* d) noexcept
+			{
+#	if defined(SUPPORT_SSE2)
+				__m128i v = _mm_loadu_si128((const __m128i*)s);
+				__m128i z = _mm_setzero_si128();
+				if (endian == EndianType::Little) {
+					_mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi8(v, z));
+					_mm_storeu_si128((__m128i*)(d + 16), _mm_unpackhi_epi8(v, z));
+				} else {
+					_mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi8(z, v));
+					_mm_storeu_si128((__m128i*)(d + 16), _mm_unpackhi_epi8(z, v));
+				}
+#	else
+				uint8x16_t v = vld1q_u8(s);
+				uint8x16_t z = vdupq_n_u8(0);
+				if (endian == EndianType::Little) {
+					vst1q_u8(d, vzip1q_u8(v, z));
+					vst1q_u8(d + 16, vzip2q_u8(v, z));
+				} else {
+					vst1q_u8(d, vzip1q_u8(z, v));
+					vst1q_u8(d + 16, vzip2q_u8(z, v));
+				}
+#	endif
+			}
+
+			// 16 ASCII characters to 16 UTF-32 units
+			template <EndianType endian>
+			SLIB_INLINE static void WidenAscii16_32(const sl_uint8* s, sl_uint8* d) noexcept
+			{
+#	if defined(SUPPORT_SSE2)
+				__m128i v = _mm_loadu_si128((const __m128i*)s);
+				__m128i z = _mm_setzero_si128();
+				if (endian == EndianType::Little) {
+					__m128i a = _mm_unpacklo_epi8(v, z);
+					__m128i b = _mm_unpackhi_epi8(v, z);
+					_mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi16(a, z));
+					_mm_storeu_si128((__m128i*)(d + 16), _mm_unpackhi_epi16(a, z));
+					_mm_storeu_si128((__m128i*)(d + 32), _mm_unpacklo_epi16(b, z));
+					_mm_storeu_si128((__m128i*)(d + 48), _mm_unpackhi_epi16(b, z));
+				} else {
+					__m128i a = _mm_unpacklo_epi8(z, v);
+					__m128i b = _mm_unpackhi_epi8(z, v);
+					_mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi16(z, a));
+					_mm_storeu_si128((__m128i*)(d + 16), _mm_unpackhi_epi16(z, a));
+					_mm_storeu_si128((__m128i*)(d + 32), _mm_unpacklo_epi16(z, b));
+					_mm_storeu_si128((__m128i*)(d + 48), _mm_unpackhi_epi16(z, b));
+				}
+#	else
+				uint8x16_t v = vld1q_u8(s);
+				uint8x16_t z = vdupq_n_u8(0);
+				uint16x8_t z16 = vdupq_n_u16(0);
+				if (endian == EndianType::Little) {
+					uint16x8_t a = vreinterpretq_u16_u8(vzip1q_u8(v, z));
+					uint16x8_t b = vreinterpretq_u16_u8(vzip2q_u8(v, z));
+					vst1q_u16((uint16_t*)d, vzip1q_u16(a, z16));
+					vst1q_u16((uint16_t*)(d + 16), vzip2q_u16(a, z16));
+					vst1q_u16((uint16_t*)(d + 32), vzip1q_u16(b, z16));
+					vst1q_u16((uint16_t*)(d + 48), vzip2q_u16(b, z16));
+				} else {
+					uint16x8_t a = vreinterpretq_u16_u8(vzip1q_u8(z, v));
+					uint16x8_t b = vreinterpretq_u16_u8(vzip2q_u8(z, v));
+					vst1q_u16((uint16_t*)d, vzip1q_u16(z16, a));
+					vst1q_u16((uint16_t*)(d + 16), vzip2q_u16(z16, a));
+					vst1q_u16((uint16_t*)(d + 32), vzip1q_u16(z16, b));
+					vst1q_u16((uint16_t*)(d + 48), vzip2q_u16(z16, b));
+				}
+#	endif
+			}
+
+			// 8 UTF-16 units in ASCII range to 8 characters
+			template <EndianType endian>
+			SLIB_INLINE static void NarrowAscii8_16(const sl_uint8* s, sl_char8* d) noexcept
+			{
+#	if defined(SUPPORT_SSE2)
+				__m128i v = _mm_loadu_si128((const __m128i*)s);
+				if (endian == EndianType::Big) {
+					v = _mm_srli_epi16(v, 8);
+				}
+				_mm_storel_epi64((__m128i*)d, _mm_packus_epi16(v, v));
+#	else
+				uint8x16_t v = vld1q_u8(s);
+				if (endian == EndianType::Big) {
+					v = vrev16q_u8(v);
+				}
+				vst1_u8((uint8_t*)d, vmovn_u16(vreinterpretq_u16_u8(v)));
+#	endif
+			}
+
+			// returns the number of the leading ASCII characters converted. `dst` can be null
+			template <EndianType endian>
+			NOINLINE_FUNCTION static sl_size CopyAsciiToUtf16(const sl_uint8* src, sl_size count, sl_uint8* dst) noexcept
+			{
+				sl_size i = 0;
+				while (i + 16 <= count) {
+					sl_uint32 k = FindNonAscii16(src + i);
+					if (k < 16) {
+						if (dst) {
+							for (sl_uint32 j = 0; j < k; j++) {
+								Write16<endian>(dst, i + j, (sl_char16)(src[i + j]));
+							}
+						}
+						return i + k;
+					}
+					if (dst) {
+						WidenAscii16_16<endian>(src + i, dst + (i << 1));
+					}
+					i += 16;
+				}
+				return i;
+			}
+
+			// returns the number of the leading ASCII characters converted. `dst` can be null
+			template <EndianType endian>
+			NOINLINE_FUNCTION static sl_size CopyAsciiToUtf32(const sl_uint8* src, sl_size count, sl_uint8* dst) noexcept
+			{
+				sl_size i = 0;
+				while (i + 16 <= count) {
+					sl_uint32 k = FindNonAscii16(src + i);
+					if (k < 16) {
+						if (dst) {
+							for (sl_uint32 j = 0; j < k; j++) {
+								Write32<endian>(dst, i + j, (sl_char32)(src[i + j]));
+							}
+						}
+						return i + k;
+					}
+					if (dst) {
+						WidenAscii16_32<endian>(src + i, dst + (i << 2));
+					}
+					i += 16;
+				}
+				return i;
+			}
+
+			// returns the number of the leading UTF-16 units in ASCII range converted. `dst` can be null
+			template <EndianType endian>
+			NOINLINE_FUNCTION static sl_size CopyAsciiFromUtf16(const sl_uint8* src, sl_size count, sl_char8* dst) noexcept
+			{
+				sl_size i = 0;
+				while (i + 8 <= count) {
+					sl_uint32 k = FindNonAscii8_16<endian>(src + (i << 1));
+					if (k < 8) {
+						if (dst) {
+							for (sl_uint32 j = 0; j < k; j++) {
+								dst[i + j] = (sl_char8)(Read16<endian>(src, i + j));
+							}
+						}
+						return i + k;
+					}
+					if (dst) {
+						NarrowAscii8_16<endian>(src + (i << 1), dst + i);
+					}
+					i += 8;
+				}
+				return i;
+			}
+#endif
+
+			// RFC 3629: rejects the overlong forms, the surrogates and the code points above U+10FFFF
+			static sl_bool ValidateUtf8_General(const sl_uint8* s, sl_size len) noexcept
+			{
+				sl_size i = 0;
+				while (i < len) {
+					if (i + 8 <= len) {
+						if (!(MIO::readUint64LE(s + i) & SLIB_UINT64(0x8080808080808080))) {
+							i += 8;
+							continue;
+						}
+					}
+					sl_uint32 ch = s[i];
+					if (ch < 0x80) {
+						i++;
+					} else if (ch < 0xC2) {
+						return sl_false;
+					} else if (ch < 0xE0) {
+						if (i + 1 >= len || (s[i + 1] & 0xC0) != 0x80) {
+							return sl_false;
+						}
+						i += 2;
+					} else if (ch < 0xF0) {
+						if (i + 2 >= len) {
+							return sl_false;
+						}
+						sl_uint32 ch1 = s[i + 1];
+						if ((ch1 & 0xC0) != 0x80 || (s[i + 2] & 0xC0) != 0x80) {
+							return sl_false;
+						}
+						if (ch == 0xE0 && ch1 < 0xA0) {
+							return sl_false;
+						}
+						if (ch == 0xED && ch1 >= 0xA0) {
+							return sl_false;
+						}
+						i += 3;
+					} else if (ch < 0xF5) {
+						if (i + 3 >= len) {
+							return sl_false;
+						}
+						sl_uint32 ch1 = s[i + 1];
+						if ((ch1 & 0xC0) != 0x80 || (s[i + 2] & 0xC0) != 0x80 || (s[i + 3] & 0xC0) != 0x80) {
+							return sl_false;
+						}
+						if (ch == 0xF0 && ch1 < 0x90) {
+							return sl_false;
+						}
+						if (ch == 0xF4 && ch1 >= 0x90) {
+							return sl_false;
+						}
+						i += 4;
+					} else {
+						return sl_false;
+					}
+				}
+				return sl_true;
+			}
+
+#if defined(SUPPORT_AVX2) || defined(SUPPORT_NEON)
+			/*
+				Lookup tables classifying the errors by the high nibble of the previous byte, the low nibble of the previous byte,
+				and the high nibble of the current byte. A pair of bytes is invalid when the three entries have a common bit.
+				Only `TWO_CONTS` may be set on the valid pairs, where it must match the continuations required by the
+				3-byte and 4-byte leads two or three bytes before.
+			*/
+			enum
+			{
+				TOO_SHORT = 1 << 0, // 11______ 0_______, 11______ 11______
+				TOO_LONG = 1 << 1, // 0_______ 10______
+				OVERLONG_3 = 1 << 2, // 11100000 100_____
+				TOO_LARGE = 1 << 3, // 11110100 1001____, 11110100 101_____, 11110101 ~ 11111111
+				SURROGATE = 1 << 4, // 11101101 101_____
+				OVERLONG_2 = 1 << 5, // 1100000_ 10______
+				TOO_LARGE_1000 = 1 << 6, // 11110101 1000____ ~ 11111111 1000____
+				OVERLONG_4 = 1 << 6, // 11110000 1000____
+				TWO_CONTS = 1 << 7, // 10______ 10______
+				CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS
+			};
+
+			static const sl_uint8 g_tableUtf8ErrorByte1High[16] = {
+				TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+				TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+				TOO_SHORT | OVERLONG_2,
+				TOO_SHORT,
+				TOO_SHORT | OVERLONG_3 | SURROGATE,
+				TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+			};
+
+			static const sl_uint8 g_tableUtf8ErrorByte1Low[16] = {
+				CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+				CARRY | OVERLONG_2,
+				CARRY,
+				CARRY,
+				CARRY | TOO_LARGE,
+				CARRY | TOO_LARGE | TOO_LARGE_1000,
+				CARRY | TOO_LARGE | TOO_LARGE_1000,
+				CARRY | TOO_LARGE | TOO_LARGE_1000,
+				CARRY | TOO_LARGE | TOO_LARGE_1000,
+				CARRY | TOO_LARGE | TOO_LARGE_1000,
+				CARRY | TOO_LARGE | TOO_LARGE_1000,
+				CARRY | TOO_LARGE | TOO_LARGE_1000,
+				CARRY | TOO_LARGE | TOO_LARGE_1000,
+				CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+				CARRY | TOO_LARGE | TOO_LARGE_1000,
+				CARRY | TOO_LARGE | TOO_LARGE_1000
+			};
+
+			static const sl_uint8 g_tableUtf8ErrorByte2High[16] = {
+				TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+				TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+				TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+				TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+				TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+				TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+			};
+
+			// the last bytes of a block that can not end the block: leads needing 3, 2 and 1 more bytes
+			static const sl_uint8 g_tableUtf8IncompleteMax[32] = {
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+				0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+			};
+#endif
+
+#if defined(SUPPORT_AVX2)
+			class Utf8Validator_Sse42
+			{
+			public:
+				__m128i tableByte1High;
+				__m128i tableByte1Low;
+				__m128i tableByte2High;
+				__m128i incompleteMax;
+				__m128i error;
+				__m128i prev;
+				__m128i prevIncomplete;
+
+			public:
+				SSE42_FUNCTION SLIB_INLINE Utf8Validator_Sse42() noexcept
+				{
+					tableByte1High = _mm_loadu_si128((const __m128i*)g_tableUtf8ErrorByte1High);
+					tableByte1Low = _mm_loadu_si128((const __m128i*)g_tableUtf8ErrorByte1Low);
+					tableByte2High = _mm_loadu_si128((const __m128i*)g_tableUtf8ErrorByte2High);
+					incompleteMax = _mm_loadu_si128((const __m128i*)(g_tableUtf8IncompleteMax + 16));
+					error = _mm_setzero_si128();
+					prev = error;
+					prevIncomplete = error;
+				}
+
+			public:
+				SSE42_FUNCTION SLIB_INLINE void check(__m128i input) noexcept
+				{
+					if (!(_mm_movemask_epi8(input))) {
+						error = _mm_or_si128(error, prevIncomplete);
+					} else {
+						__m128i mask4 = _mm_set1_epi8(0x0F);
+						__m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+						__m128i byte1High = _mm_shuffle_epi8(tableByte1High, _mm_and_si128(_mm_srli_epi16(prev1, 4), mask4));
+						__m128i byte1Low = _mm_shuffle_epi8(tableByte1Low, _mm_and_si128(prev1, mask4));
+						__m128i byte2High = _mm_shuffle_epi8(tableByte2High, _mm_and_si128(_mm_srli_epi16(input, 4), mask4));
+						__m128i special = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+						__m128i prev2 = _mm_alignr_epi8(input, prev, 14);
+						__m128i prev3 = _mm_alignr_epi8(input, prev, 13);
+						__m128i must23 = _mm_or_si128(_mm_subs_epu8(prev2, _mm_set1_epi8(0xE0 - 0x80)), _mm_subs_epu8(prev3, _mm_set1_epi8(0xF0 - 0x80)));
+						must23 = _mm_and_si128(must23, _mm_set1_epi8((char)0x80));
+						error = _mm_or_si128(error, _mm_xor_si128(must23, special));
+						prevIncomplete = _mm_subs_epu8(input, incompleteMax);
+					}
+					prev = input;
+				}
+
+				SSE42_FUNCTION SLIB_INLINE sl_bool finish() noexcept
+				{
+					error = _mm_or_si128(error, prevIncomplete);
+					return _mm_testz_si128(error, error) != 0;
+				}
+
+			};
+
+			SSE42_FUNCTION static sl_bool ValidateUtf8_Sse42(const sl_uint8* s, sl_size len) noexcept
+			{
+				Utf8Validator_Sse42 validator;
+				sl_size i = 0;
+				for (; i + 16 <= len; i += 16) {
+					validator.check(_mm_loadu_si128((const __m128i*)(s + i)));
+				}
+				if (i < len) {
+					sl_uint8 last[16] = {0};
+					Base::copyMemory(last, s + i, len - i);
+					validator.check(_mm_loadu_si128((const __m128i*)last));
+				}
+				return validator.finish();
+			}
+
+			class Utf8Validator_Avx2
+			{
+			public:
+				__m256i tableByte1High;
+				__m256i tableByte1Low;
+				__m256i tableByte2High;
+				__m256i incompleteMax;
+				__m256i error;
+				__m256i prev;
+				__m256i prevIncomplete;
+
+			public:
+				AVX2_FUNCTION SLIB_INLINE Utf8Validator_Avx2() noexcept
+				{
+					tableByte1High = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)g_tableUtf8ErrorByte1High));
+					tableByte1Low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)g_tableUtf8ErrorByte1Low));
+					tableByte2High = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)g_tableUtf8ErrorByte2High));
+					incompleteMax = _mm256_loadu_si256((const __m256i*)g_tableUtf8IncompleteMax);
+					error = _mm256_setzero_si256();
+					prev = error;
+					prevIncomplete = error;
+				}
+
+			public:
+				AVX2_FUNCTION SLIB_INLINE void check(__m256i input) noexcept
+				{
+					if (!(_mm256_movemask_epi8(input))) {
+						error = _mm256_or_si256(error, prevIncomplete);
+					} else {
+						__m256i mask4 = _mm256_set1_epi8(0x0F);
+						// the 16 bytes before the high lane of `input`
+						__m256i before = _mm256_permute2x128_si256(prev, input, 0x21);
+						__m256i prev1 = _mm256_alignr_epi8(input, before, 15);
+						__m256i byte1High = _mm256_shuffle_epi8(tableByte1High, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), mask4));
+						__m256i byte1Low = _mm256_shuffle_epi8(tableByte1Low, _mm256_and_si256(prev1, mask4));
+						__m256i byte2High = _mm256_shuffle_epi8(tableByte2High, _mm256_and_si256(_mm256_srli_epi16(input, 4), mask4));
+						__m256i special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+						__m256i prev2 = _mm256_alignr_epi8(input, before, 14);
+						__m256i prev3 = _mm256_alignr_epi8(input, before, 13);
+						__m256i must23 = _mm256_or_si256(_mm256_subs_epu8(prev2, _mm256_set1_epi8(0xE0 - 0x80)), _mm256_subs_epu8(prev3, _mm256_set1_epi8(0xF0 - 0x80)));
+						must23 = _mm256_and_si256(must23, _mm256_set1_epi8((char)0x80));
+						error = _mm256_or_si256(error, _mm256_xor_si256(must23, special));
+						prevIncomplete = _mm256_subs_epu8(input, incompleteMax);
+					}
+					prev = input;
+				}
+
+				AVX2_FUNCTION SLIB_INLINE sl_bool finish() noexcept
+				{
+					error = _mm256_or_si256(error, prevIncomplete);
+					return _mm256_testz_si256(error, error) != 0;
+				}
+
+			};
+
+			AVX2_FUNCTION static sl_bool ValidateUtf8_Avx2(const sl_uint8* s, sl_size len) noexcept
+			{
+				Utf8Validator_Avx2 validator;
+				sl_size i = 0;
+				for (; i + 64 <= len; i += 64) {
+					__m256i a = _mm256_loadu_si256((const __m256i*)(s + i));
+					__m256i b = _mm256_loadu_si256((const __m256i*)(s + i + 32));
+					if (!(_mm256_movemask_epi8(_mm256_or_si256(a, b)))) {
+						// ASCII only
+						validator.error = _mm256_or_si256(validator.error, validator.prevIncomplete);
+						validator.prev = b;
+					} else {
+						validator.check(a);
+						validator.check(b);
+					}
+				}
+				for (; i + 32 <= len; i += 32) {
+					validator.check(_mm256_loadu_si256((const __m256i*)(s + i)));
+				}
+				if (i < len) {
+					sl_uint8 last[32] = {0};
+					Base::copyMemory(last, s + i, len - i);
+					validator.check(_mm256_loadu_si256((const __m256i*)last));
+				}
+				return validator.finish();
+			}
+#endif
+
+#if defined(SUPPORT_NEON)
+			class Utf8Validator_Neon
+			{
+			public:
+				uint8x16_t tableByte1High;
+				uint8x16_t tableByte1Low;
+				uint8x16_t tableByte2High;
+				uint8x16_t incompleteMax;
+				uint8x16_t error;
+				uint8x16_t prev;
+				uint8x16_t prevIncomplete;
+
+			public:
+				SLIB_INLINE Utf8Validator_Neon() noexcept
+				{
+					tableByte1High = vld1q_u8(g_tableUtf8ErrorByte1High);
+					tableByte1Low = vld1q_u8(g_tableUtf8ErrorByte1Low);
+					tableByte2High = vld1q_u8(g_tableUtf8ErrorByte2High);
+					incompleteMax = vld1q_u8(g_tableUtf8IncompleteMax + 16);
+					error = vdupq_n_u8(0);
+					prev = error;
+					prevIncomplete = error;
+				}
+
+			public:
+				SLIB_INLINE void check(uint8x16_t input) noexcept
+				{
+					if (vmaxvq_u8(input) < 0x80) {
+						error = vorrq_u8(error, prevIncomplete);
+					} else {
+						uint8x16_t mask4 = vdupq_n_u8(0x0F);
+						uint8x16_t prev1 = vextq_u8(prev, input, 15);
+						uint8x16_t byte1High = vqtbl1q_u8(tableByte1High, vshrq_n_u8(prev1, 4));
+						uint8x16_t byte1Low = vqtbl1q_u8(tableByte1Low, vandq_u8(prev1, mask4));
+						uint8x16_t byte2High = vqtbl1q_u8(tableByte2High, vshrq_n_u8(input, 4));
+						uint8x16_t special = vandq_u8(vandq_u8(byte1High, byte1Low), byte2High);
+						uint8x16_t prev2 = vextq_u8(prev, input, 14);
+						uint8x16_t prev3 = vextq_u8(prev, input, 13);
+						uint8x16_t must23 = vorrq_u8(vqsubq_u8(prev2, vdupq_n_u8(0xE0 - 0x80)), vqsubq_u8(prev3, vdupq_n_u8(0xF0 - 0x80)));
+						must23 = vandq_u8(must23, vdupq_n_u8(0x80));
+						error = vorrq_u8(error, veorq_u8(must23, special));
+						prevIncomplete = vqsubq_u8(input, incompleteMax);
+					}
+					prev = input;
+				}
+
+				SLIB_INLINE sl_bool finish() noexcept
+				{
+					error = vorrq_u8(error, prevIncomplete);
+					return vmaxvq_u8(error) == 0;
+				}
+
+			};
+
+			static sl_bool ValidateUtf8_Neon(const sl_uint8* s, sl_size len) noexcept
+			{
+				Utf8Validator_Neon validator;
+				sl_size i = 0;
+				for (; i + 16 <= len; i += 16) {
+					validator.check(vld1q_u8(s + i));
+				}
+				if (i < len) {
+					sl_uint8 last[16] = {0};
+					Base::copyMemory(last, s + i, len - i);
+					validator.check(vld1q_u8(last));
+				}
+				return validator.finish();
+			}
+#endif
 			
 			template <EndianType endian>
 			static sl_size ConvertUtf8ToUtf16(const sl_char8* utf8, sl_reg lenUtf8, void* utf16, sl_reg lenUtf16Buffer) noexcept
@@ -118,6 +741,22 @@ namespace slib
 						}
 					}
 					if (ch < 0x80) {
+#if defined(SUPPORT_ASCII_BLOCKS)
+						if (!flagSz) {
+							sl_reg m = lenUtf8 - i;
+							if (m >= 16 && IsAscii8(utf8 + i)) {
+								if (lenUtf16Buffer >= 0 && m > lenUtf16Buffer - n) {
+									m = lenUtf16Buffer - n;
+								}
+								if (m >= 16) {
+									sl_size k = CopyAsciiToUtf16<endian>((const sl_uint8*)utf8 + i, m, utf16 ? (sl_uint8*)utf16 + (n << 1) : sl_null);
+									i += k;
+									n += k;
+									continue;
+								}
+							}
+						}
+#endif
 						if (utf16) {
 							Write16<endian>(utf16, n++, (sl_char16)ch);
 						} else {
@@ -230,6 +869,22 @@ namespace slib
 						}
 					}
 					if (ch < 0x80) {
+#if defined(SUPPORT_ASCII_BLOCKS)
+						if (!flagSz) {
+							sl_reg m = lenUtf8 - i;
+							if (m >= 16 && IsAscii8(utf8 + i)) {
+								if (lenUtf32Buffer >= 0 && m > lenUtf32Buffer - n) {
+									m = lenUtf32Buffer - n;
+								}
+								if (m >= 16) {
+									sl_size k = CopyAsciiToUtf32<endian>((const sl_uint8*)utf8 + i, m, utf32 ? (sl_uint8*)utf32 + (n << 2) : sl_null);
+									i += k;
+									n += k;
+									continue;
+								}
+							}
+						}
+#endif
 						if (utf32) {
 							Write32<endian>(utf32, n++, (sl_char32)ch);
 						} else {
@@ -357,6 +1012,22 @@ namespace slib
 						}
 					}
 					if (ch < 0x80) {
+#if defined(SUPPORT_ASCII_BLOCKS)
+						if (!flagSz) {
+							sl_reg m = lenUtf16 - i;
+							if (m >= 8 && IsAscii4_16<endian>((const sl_uint8*)utf16 + (i << 1))) {
+								if (lenUtf8Buffer >= 0 && m > lenUtf8Buffer - n) {
+									m = lenUtf8Buffer - n;
+								}
+								if (m >= 8) {
+									sl_size k = CopyAsciiFromUtf16<endian>((const sl_uint8*)utf16 + (i << 1), m, utf8 ? utf8 + n : sl_null);
+									i += k;
+									n += k;
+									continue;
+								}
+							}
+						}
+#endif
 						if (utf8) {
 							utf8[n++] = (sl_char8)(ch);
 						} else {
@@ -617,6 +1288,24 @@ namespace slib
 	
 	using namespace priv::charset;
 	
+	sl_bool Charsets::validateUtf8(const sl_char8* utf8, sl_size len) noexcept
+	{
+		const sl_uint8* s = (const sl_uint8*)utf8;
+#if defined(SUPPORT_AVX2)
+		if (len >= 64 && CanUseAvx2()) {
+			return ValidateUtf8_Avx2(s, len);
+		}
+		if (len >= 16 && CanUseSse42()) {
+			return ValidateUtf8_Sse42(s, len);
+		}
+#elif defined(SUPPORT_NEON)
+		if (len >= 16) {
+			return ValidateUtf8_Neon(s, len);
+		}
+#endif
+		return ValidateUtf8_General(s, len);
+	}
+
 	sl_size Charsets::utf8ToUtf16(const sl_char8* utf8, sl_reg lenUtf8, sl_char16* utf16, sl_reg lenUtf16Buffer) noexcept
 	{
 		if (Endian::isBE()) {
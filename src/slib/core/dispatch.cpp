@@ -40,30 +40,30 @@ namespace slib
 	}
 	
 	
-	sl_bool Dispatch::dispatch(const Ref<Dispatcher>& dispatcher, const Function<void()>& task)
+	sl_bool Dispatch::dispatch(const Ref<Dispatcher>& dispatcher, UniqueFunction<void()>&& task)
 	{
 		if (dispatcher.isNotNull()) {
-			return dispatcher->dispatch(task);
+			return dispatcher->dispatch(Move(task));
 		}
 		return sl_false;
 	}
 
-	sl_bool Dispatch::dispatch(const Function<void()>& task)
+	sl_bool Dispatch::dispatch(UniqueFunction<void()>&& task)
 	{
-		return Dispatch::dispatch(DispatchLoop::getDefault(), task);
+		return Dispatch::dispatch(DispatchLoop::getDefault(), Move(task));
 	}
 
-	sl_bool Dispatch::setTimeout(const Ref<Dispatcher>& dispatcher, const Function<void()>& task, sl_uint64 delay_ms)
+	sl_bool Dispatch::setTimeout(const Ref<Dispatcher>& dispatcher, UniqueFunction<void()>&& task, sl_uint64 delay_ms)
 	{
 		if (dispatcher.isNotNull()) {
-			return dispatcher->dispatch(task, delay_ms);
+			return dispatcher->dispatch(Move(task), delay_ms);
 		}
 		return sl_false;
 	}
 
-	sl_bool Dispatch::setTimeout(const Function<void()>& task, sl_uint64 delay_ms)
+	sl_bool Dispatch::setTimeout(UniqueFunction<void()>&& task, sl_uint64 delay_ms)
 	{
-		return Dispatch::setTimeout(DispatchLoop::getDefault(), task, delay_ms);
+		return Dispatch::setTimeout(DispatchLoop::getDefault(), Move(task), delay_ms);
 	}
 
 	Ref<Timer> Dispatch::setInterval(const Ref<DispatchLoop>& loop, const Function<void(Timer*)>& task, sl_uint64 interval_ms)
@@ -86,6 +86,7 @@ namespace slib
 	{
 		m_flagInit = sl_false;
 		m_flagRunning = sl_false;
+		m_sequenceTimer = 0;
 	}
 
 	DispatchLoop::~DispatchLoop()
@@ -142,8 +143,9 @@ namespace slib
 
 		m_queueTasks.removeAll();
 		
-		MutexLocker lockTime(&m_lockTimeTasks);
-		m_timeTasks.removeAll();
+		MutexLocker lockTimer(&m_lockTimer);
+		m_timerWheel.removeAll();
+		m_mapTimers.removeAll_NoLock();
 	}
 
 	void DispatchLoop::start()
@@ -178,119 +180,99 @@ namespace slib
 	sl_int32 DispatchLoop::_getTimeout()
 	{
 		m_timeCounter.update();
-		sl_int32 t1 = _getTimeout_TimeTasks();
-		sl_int32 t2 = _getTimeout_Timer();
+		sl_int32 timeout = _processTimerWheel();
 		if (m_queueTasks.isNotEmpty()) {
 			return 0;
 		}
-		if (t1 < 0) {
-			return t2;
-		} else {
-			if (t2 < 0) {
-				return t1;
-			} else {
-				return SLIB_MIN(t1, t2);
-			}
-		}
+		return timeout;
 	}
 
-	sl_bool DispatchLoop::dispatch(const Function<void()>& task, sl_uint64 delay_ms)
+	sl_bool DispatchLoop::dispatch(UniqueFunction<void()>&& task, sl_uint64 delay_ms)
 	{
 		if (task.isNull()) {
 			return sl_false;
 		}
 		if (delay_ms == 0) {
-			if (m_queueTasks.push(task)) {
+			if (m_queueTasks.push(Move(task))) {
 				_wake();
 				return sl_true;
 			}
 		} else {
-			MutexLocker lock(&m_lockTimeTasks);
-			TimeTask tt;
-			tt.time = getElapsedMilliseconds() + delay_ms;
-			tt.task = task;
-			if (m_timeTasks.add(tt.time, tt)) {
-				_wake();
+			MutexLocker lock(&m_lockTimer);
+			if (m_timerWheel.add(getElapsedMilliseconds(), delay_ms, Move(task))) {
+				lock.unlock();
+				// the loop thread calculates the timeout after running the tasks
+				if (Thread::getCurrent() != m_thread) {
+					_wake();
+				}
 				return sl_true;
 			}
 		}
 		return sl_false;
 	}
 
-	sl_int32 DispatchLoop::_getTimeout_TimeTasks()
+	sl_int32 DispatchLoop::_processTimerWheel()
 	{
-		MutexLocker lock(&m_lockTimeTasks);
-		sl_uint64 rel = getElapsedMilliseconds();
-		if (m_timeTasks.getCount() == 0) {
-			return -1;
-		}
-		sl_int32 timeout = -1;
-		LinkedQueue< Function<void()> > tasks;
-		while (MapNode<sl_uint64, TimeTask>* node = m_timeTasks.getFirstNode()) {
-			if (rel >= node->key) {
-				tasks.push(node->value.task);
-				m_timeTasks.removeAt(node);
-			} else {
-				timeout = (sl_int32)(node->key - rel);
-				break;
+		LinkedQueue< UniqueFunction<void()> > tasks;
+		{
+			MutexLocker lock(&m_lockTimer);
+			if (m_timerWheel.isEmpty()) {
+				return -1;
 			}
+			m_timerWheel.collect(getElapsedMilliseconds(), &tasks);
 		}
-		lock.unlock();
-
-		Function<void()> task;
-		while (tasks.pop(&task)) {
+		UniqueFunction<void()> task;
+		while (tasks.pop_NoLock(&task)) {
 			task();
 		}
-		return timeout;
+		MutexLocker lock(&m_lockTimer);
+		sl_int64 timeout = m_timerWheel.getTimeout(getElapsedMilliseconds());
+		if (timeout > 0x7fffffff) {
+			return 0x7fffffff;
+		}
+		return (sl_int32)timeout;
 	}
 
-	sl_int32 DispatchLoop::_getTimeout_Timer()
+	sl_bool DispatchLoop::_scheduleTimer_NoLock(Timer* timer, sl_uint64 sequence, sl_uint64 now)
 	{
-		MutexLocker lock(&m_lockTimer);
-
-		sl_int32 timeout = -1;
-		LinkedQueue< Ref<Timer> > tasks;
-
-		sl_uint64 rel = getElapsedMilliseconds();
-		Link<TimerTask>* link = m_queueTimers.getFront();
-		while (link) {
-			Ref<Timer> timer(link->value.timer);
-			if (timer.isNotNull()) {
-				if (timer->isStarted()) {
-					sl_uint64 t = rel - timer->getLastRunTime();
-					if (t >= timer->getInterval()) {
-						tasks.push(timer);
-						timer->setLastRunTime(rel);
-						t = timer->getInterval();
-					} else {
-						t = timer->getInterval() - t;
-					}
-					if (timeout < 0 || t < (sl_uint64)timeout) {
-						timeout = (sl_uint32)t;
-					}
-				}
-				link = link->next;
-			} else {
-				Link<TimerTask>* linkRemove = link;
-				link = link->next;
-				m_queueTimers.removeAt(linkRemove);
-			}
+		WeakRef<Timer> weak(timer);
+		sl_uint64 taskId = m_timerWheel.add(now, timer->getInterval(), [this, timer, weak, sequence]() {
+			_runTimer(timer, weak, sequence);
+		});
+		if (!taskId) {
+			return sl_false;
 		}
-
-		lock.unlock();
-
-		Ref<Timer> task;
-		while (tasks.pop(&task)) {
-			if (task.isNotNull()) {
-				task->run();
-			}
+		TimerEntry entry;
+		entry.sequence = sequence;
+		entry.taskId = taskId;
+		if (m_mapTimers.put_NoLock(timer, entry)) {
+			return sl_true;
 		}
-		return timeout;
+		m_timerWheel.cancel(taskId);
+		return sl_false;
 	}
 
-	sl_bool DispatchLoop::TimerTask::operator==(const DispatchLoop::TimerTask& other) const
+	void DispatchLoop::_runTimer(Timer* key, const WeakRef<Timer>& weak, sl_uint64 sequence)
 	{
-		return timer == other.timer;
+		Ref<Timer> timer(weak);
+		{
+			MutexLocker lock(&m_lockTimer);
+			TimerEntry entry;
+			if (!(m_mapTimers.get_NoLock(key, &entry)) || entry.sequence != sequence) {
+				// removed or added again
+				return;
+			}
+			if (timer.isNull() || !(timer->isStarted())) {
+				m_mapTimers.remove_NoLock(key);
+				return;
+			}
+			sl_uint64 now = getElapsedMilliseconds();
+			timer->setLastRunTime(now);
+			if (!(_scheduleTimer_NoLock(key, sequence, now))) {
+				m_mapTimers.remove_NoLock(key);
+			}
+		}
+		timer->run();
 	}
 
 	sl_bool DispatchLoop::addTimer(const Ref<Timer>& timer)
@@ -298,23 +280,32 @@ namespace slib
 		if (timer.isNull()) {
 			return sl_false;
 		}
-		TimerTask t;
-		t.timer = timer;
 		MutexLocker lock(&m_lockTimer);
-		if (m_queueTimers.push(t)) {
-			_wake();
+		TimerEntry entry;
+		if (m_mapTimers.get_NoLock(timer.get(), &entry)) {
+			m_timerWheel.cancel(entry.taskId);
+		}
+		m_sequenceTimer++;
+		sl_uint64 now = getElapsedMilliseconds();
+		timer->setLastRunTime(now);
+		if (_scheduleTimer_NoLock(timer.get(), m_sequenceTimer, now)) {
+			lock.unlock();
+			if (Thread::getCurrent() != m_thread) {
+				_wake();
+			}
 			return sl_true;
-		} else {
-			return sl_false;
 		}
+		m_mapTimers.remove_NoLock(timer.get());
+		return sl_false;
 	}
 
 	void DispatchLoop::removeTimer(const Ref<Timer>& timer)
 	{
 		MutexLocker lock(&m_lockTimer);
-		TimerTask t;
-		t.timer = timer;
-		m_queueTimers.remove(t);
+		TimerEntry entry;
+		if (m_mapTimers.remove_NoLock(timer.get(), &entry)) {
+			m_timerWheel.cancel(entry.taskId);
+		}
 	}
 
 	sl_uint64 DispatchLoop::getElapsedMilliseconds()
@@ -329,10 +320,12 @@ namespace slib
 
 			// Async Tasks
 			{
-				LinkedQueue< Function<void()> > tasks;
-				tasks.merge(&m_queueTasks);
-				Function<void()> task;
-				while (tasks.pop_NoLock(&task)) {
+				// the tasks left over run after the timers, without sleeping
+				UniqueFunction<void()> task;
+				for (sl_uint32 i = 0; i < 1024; i++) {
+					if (!(m_queueTasks.pop(&task))) {
+						break;
+					}
 					task();
 				}
 			}
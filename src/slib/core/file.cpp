@@ -25,11 +25,15 @@
 #include "slib/core/string_buffer.h"
 #include "slib/core/scoped.h"
 
+#define SLIB_FILE_MAP_MIN_SIZE 0x10000
+
 namespace slib
 {
 
 	SLIB_DEFINE_OBJECT(File, IO)
 
+	SLIB_DEFINE_OBJECT(MappedFile, Object)
+
 	File::File(sl_file file): m_file(file)
 	{
 	}
@@ -282,6 +286,31 @@ namespace slib
 		}
 		return sl_null;
 	}
+
+	Ref<MappedFile> File::map(sl_uint64 offset, sl_uint64 size, FileMapMode mode)
+	{
+		return MappedFile::create(this, offset, size, mode);
+	}
+
+	Memory File::mapAllBytes(const StringParam& path, sl_size maxSize)
+	{
+		Ref<File> file = File::openForRead(path);
+		if (file.isNull()) {
+			return sl_null;
+		}
+		sl_uint64 size = file->getSize();
+		if (size > maxSize) {
+			size = maxSize;
+		}
+		// the small files are cheaper to copy than to map
+		if (size >= SLIB_FILE_MAP_MIN_SIZE) {
+			Ref<MappedFile> mapped = MappedFile::create(file, 0, size, FileMapMode::CopyOnWrite);
+			if (mapped.isNotNull()) {
+				return mapped->getMemory();
+			}
+		}
+		return file->readAllBytes(maxSize);
+	}
 	
 	String File::readAllTextUTF8(sl_size maxSize)
 	{
@@ -690,4 +719,136 @@ namespace slib
 		return ret.merge();
 	}
 
+	MappedFile::MappedFile()
+	{
+		m_mode = FileMapMode::Read;
+		m_offset = 0;
+		m_data = sl_null;
+		m_size = 0;
+		m_base = sl_null;
+		m_sizeMapped = 0;
+	}
+
+	MappedFile::~MappedFile()
+	{
+		if (m_base) {
+			_unmap(m_base, m_sizeMapped);
+		}
+		ListElements<OldMapping> oldMappings(m_listOldMappings);
+		for (sl_size i = 0; i < oldMappings.count; i++) {
+			_unmap(oldMappings[i].base, oldMappings[i].size);
+		}
+	}
+
+	Ref<MappedFile> MappedFile::create(const Ref<File>& file, sl_uint64 offset, sl_uint64 size, FileMapMode mode)
+	{
+		if (file.isNull() || !(file->isOpened())) {
+			return sl_null;
+		}
+		sl_uint64 sizeFile = file->getSize();
+		if (!size) {
+			if (offset >= sizeFile) {
+				return sl_null;
+			}
+			size = sizeFile - offset;
+		} else if (offset + size > sizeFile) {
+			if (mode != FileMapMode::Write) {
+				return sl_null;
+			}
+			if (!(file->setSize(offset + size))) {
+				return sl_null;
+			}
+		}
+		if (size > SLIB_SIZE_MAX) {
+			return sl_null;
+		}
+		Ref<MappedFile> ret = new MappedFile;
+		if (ret.isNotNull()) {
+			ret->m_file = file;
+			ret->m_mode = mode;
+			if (ret->_map(offset, (sl_size)size)) {
+				return ret;
+			}
+		}
+		return sl_null;
+	}
+
+	Ref<MappedFile> MappedFile::open(const StringParam& path, FileMapMode mode)
+	{
+		Ref<File> file;
+		if (mode == FileMapMode::Write) {
+			file = File::open(path, FileMode::Read | FileMode::Write | FileMode::NotTruncate);
+		} else {
+			file = File::openForRead(path);
+		}
+		return create(file, 0, 0, mode);
+	}
+
+	void* MappedFile::getData()
+	{
+		return m_data;
+	}
+
+	sl_size MappedFile::getSize()
+	{
+		return m_size;
+	}
+
+	sl_uint64 MappedFile::getOffset()
+	{
+		return m_offset;
+	}
+
+	FileMapMode MappedFile::getMode()
+	{
+		return m_mode;
+	}
+
+	const Ref<File>& MappedFile::getFile()
+	{
+		return m_file;
+	}
+
+	Memory MappedFile::getMemory()
+	{
+		ObjectLocker lock(this);
+		if (m_data) {
+			return Memory::createStatic(m_data, m_size, this);
+		}
+		return sl_null;
+	}
+
+	sl_bool MappedFile::setSize(sl_uint64 size)
+	{
+		if (m_mode != FileMapMode::Write) {
+			return sl_false;
+		}
+		if (!size || size > SLIB_SIZE_MAX) {
+			return sl_false;
+		}
+		ObjectLocker lock(this);
+		if (size == m_size) {
+			return sl_true;
+		}
+		sl_uint64 end = m_offset + size;
+		if (end > m_file->getSize()) {
+			if (!(m_file->setSize(end))) {
+				return sl_false;
+			}
+		}
+		void* base = m_base;
+		sl_size sizeMapped = m_sizeMapped;
+		if (!(_map(m_offset, (sl_size)size))) {
+			return sl_false;
+		}
+		if (base) {
+			// the memory returned by `getMemory` may still refer the old mapping
+			OldMapping old;
+			old.base = base;
+			old.size = sizeMapped;
+			m_listOldMappings.add_NoLock(old);
+		}
+		return sl_true;
+	}
+
 }
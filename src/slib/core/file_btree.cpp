@@ -0,0 +1,407 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/file_btree.h"
+
+#include "slib/core/hash.h"
+
+#define HEADER_MAGIC SLIB_UINT64(0x3145455254424c53)
+#define LOG_MAGIC SLIB_UINT64(0x314c415754424c53)
+#define LOG_COMMIT_MAGIC SLIB_UINT64(0x54494d4d4f434c53)
+#define MIN_PAGE_SIZE 128
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace file_btree
+		{
+
+			/*
+				Header page
+					0: magic
+					8: page size (4 bytes)
+					12: order (4 bytes)
+					16: count of the pages
+					24: root page
+					32: head of the free pages
+					40: count of the free pages
+					48: hash of the above bytes
+			*/
+			static const sl_uint32 g_sizeHeader = 56;
+
+			/*
+				Log
+					magic, page size (4 bytes), count of the records (4 bytes)
+					records: page index, page data
+					hash of the above bytes, commit magic
+			*/
+			static const sl_uint32 g_sizeLogHeader = 16;
+			static const sl_uint32 g_sizeLogTrailer = 16;
+
+			static sl_bool WriteAt(File* file, sl_uint64 offset, const void* _buf, sl_size size)
+			{
+				const sl_uint8* buf = (const sl_uint8*)_buf;
+				while (size) {
+					sl_uint32 n = size > 0x40000000 ? 0x40000000 : (sl_uint32)size;
+					sl_int32 m = file->writeAt32(offset, buf, n);
+					if (m <= 0) {
+						return sl_false;
+					}
+					offset += m;
+					buf += m;
+					size -= m;
+				}
+				return sl_true;
+			}
+
+			static sl_bool ReadAt(File* file, sl_uint64 offset, void* _buf, sl_size size)
+			{
+				sl_uint8* buf = (sl_uint8*)_buf;
+				while (size) {
+					sl_uint32 n = size > 0x40000000 ? 0x40000000 : (sl_uint32)size;
+					sl_int32 m = file->readAt32(offset, buf, n);
+					if (m <= 0) {
+						return sl_false;
+					}
+					offset += m;
+					buf += m;
+					size -= m;
+				}
+				return sl_true;
+			}
+
+		}
+	}
+
+	using namespace priv::file_btree;
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(FileBTreeParam)
+
+	FileBTreeParam::FileBTreeParam()
+	{
+		pageSize = 4096;
+		cacheCapacity = 1024;
+	}
+
+
+	FileBTreeStorage::FileBTreeStorage()
+	{
+		m_pageSize = 0;
+		m_order = 0;
+		m_countPages = 0;
+		m_rootPage = 0;
+		m_countFreePagesCommitted = 0;
+		m_flagModified = sl_false;
+	}
+
+	FileBTreeStorage::~FileBTreeStorage()
+	{
+		close();
+	}
+
+	sl_bool FileBTreeStorage::open(const StringParam& _path, sl_uint32 pageSize, sl_uint32 order)
+	{
+		close();
+		String path = _path.toString();
+		if (path.isEmpty()) {
+			return sl_false;
+		}
+		if (pageSize < MIN_PAGE_SIZE) {
+			return sl_false;
+		}
+		m_file = File::openForRandomAccess(path);
+		if (m_file.isNotNull()) {
+			m_fileLog = File::openForRandomAccess(path + "-wal");
+			if (m_fileLog.isNotNull()) {
+				m_pageSize = pageSize;
+				m_order = order;
+				if (_recover()) {
+					if (m_file->getSize()) {
+						if (_readHeader()) {
+							return sl_true;
+						}
+					} else {
+						// the new file is created by the first commit
+						m_countPages = 1;
+						m_rootPage = 0;
+						m_flagModified = sl_true;
+						if (commit(sl_null, sl_null, 0)) {
+							return sl_true;
+						}
+					}
+				}
+			}
+		}
+		close();
+		return sl_false;
+	}
+
+	void FileBTreeStorage::close()
+	{
+		m_file.setNull();
+		m_fileLog.setNull();
+		m_countPages = 0;
+		m_rootPage = 0;
+		m_freePages.setNull();
+		m_countFreePagesCommitted = 0;
+		m_flagModified = sl_false;
+	}
+
+	sl_bool FileBTreeStorage::isOpened() const noexcept
+	{
+		return m_file.isNotNull();
+	}
+
+	sl_uint32 FileBTreeStorage::getPageSize() const noexcept
+	{
+		return m_pageSize;
+	}
+
+	sl_uint64 FileBTreeStorage::getRootPage() const noexcept
+	{
+		return m_rootPage;
+	}
+
+	void FileBTreeStorage::setRootPage(sl_uint64 page) noexcept
+	{
+		if (m_rootPage != page) {
+			m_rootPage = page;
+			m_flagModified = sl_true;
+		}
+	}
+
+	sl_uint64 FileBTreeStorage::allocatePage()
+	{
+		if (m_file.isNull()) {
+			return 0;
+		}
+		m_flagModified = sl_true;
+		sl_uint64 page;
+		if (m_freePages.popBack_NoLock(&page)) {
+			sl_size n = m_freePages.getCount();
+			if (m_countFreePagesCommitted > n) {
+				m_countFreePagesCommitted = n;
+			}
+			return page;
+		}
+		return m_countPages++;
+	}
+
+	void FileBTreeStorage::freePage(sl_uint64 page)
+	{
+		if (!page || page >= m_countPages) {
+			return;
+		}
+		if (m_freePages.add_NoLock(page)) {
+			m_flagModified = sl_true;
+		}
+	}
+
+	sl_bool FileBTreeStorage::readPage(sl_uint64 page, void* buf)
+	{
+		if (m_file.isNull()) {
+			return sl_false;
+		}
+		if (!page || page >= m_countPages) {
+			return sl_false;
+		}
+		return ReadAt(m_file.get(), page * m_pageSize, buf, m_pageSize);
+	}
+
+	sl_bool FileBTreeStorage::commit(const sl_uint64* indices, const void* pages, sl_size count)
+	{
+		if (m_file.isNull()) {
+			return sl_false;
+		}
+		ListElements<sl_uint64> freePages(m_freePages);
+		sl_size countNewFree = freePages.count - m_countFreePagesCommitted;
+		if (!count && !countNewFree && !m_flagModified) {
+			return sl_true;
+		}
+		sl_size nRecords = 1 + count + countNewFree;
+		sl_size sizeRecord = 8 + m_pageSize;
+		sl_size sizeLog = g_sizeLogHeader + nRecords * sizeRecord + g_sizeLogTrailer;
+		Memory memLog = Memory::create(sizeLog);
+		if (memLog.isNull()) {
+			return sl_false;
+		}
+		sl_uint8* log = (sl_uint8*)(memLog.getData());
+		Base::zeroMemory(log, sizeLog);
+		MIO::writeUint64LE(log, LOG_MAGIC);
+		MIO::writeUint32LE(log + 8, m_pageSize);
+		MIO::writeUint32LE(log + 12, (sl_uint32)nRecords);
+		sl_uint8* p = log + g_sizeLogHeader;
+		{
+			// header page
+			MIO::writeUint64LE(p, 0);
+			sl_uint8* h = p + 8;
+			MIO::writeUint64LE(h, HEADER_MAGIC);
+			MIO::writeUint32LE(h + 8, m_pageSize);
+			MIO::writeUint32LE(h + 12, m_order);
+			MIO::writeUint64LE(h + 16, m_countPages);
+			MIO::writeUint64LE(h + 24, m_rootPage);
+			MIO::writeUint64LE(h + 32, freePages.count ? freePages[freePages.count - 1] : 0);
+			MIO::writeUint64LE(h + 40, freePages.count);
+			MIO::writeUint64LE(h + 48, HashBytes64(h, 48));
+			p += sizeRecord;
+		}
+		for (sl_size i = 0; i < count; i++) {
+			MIO::writeUint64LE(p, indices[i]);
+			Base::copyMemory(p + 8, (const sl_uint8*)pages + i * m_pageSize, m_pageSize);
+			p += sizeRecord;
+		}
+		for (sl_size i = m_countFreePagesCommitted; i < freePages.count; i++) {
+			// links the free pages pushed after the last commit
+			MIO::writeUint64LE(p, freePages[i]);
+			MIO::writeUint64LE(p + 8, i ? freePages[i - 1] : 0);
+			p += sizeRecord;
+		}
+		MIO::writeUint64LE(p, HashBytes64(log, p - log));
+		MIO::writeUint64LE(p + 8, LOG_COMMIT_MAGIC);
+		if (!(WriteAt(m_fileLog.get(), 0, log, sizeLog))) {
+			return sl_false;
+		}
+		if (!(m_fileLog->sync())) {
+			return sl_false;
+		}
+		if (!(_applyLog(log, sizeLog))) {
+			return sl_false;
+		}
+		// a log left by the failed truncation is applied again on the next open, which does not change the pages
+		m_fileLog->setSize(0);
+		m_countFreePagesCommitted = freePages.count;
+		m_flagModified = sl_false;
+		return sl_true;
+	}
+
+	sl_bool FileBTreeStorage::_readHeader()
+	{
+		sl_uint8 h[g_sizeHeader];
+		if (!(ReadAt(m_file.get(), 0, h, g_sizeHeader))) {
+			return sl_false;
+		}
+		if (MIO::readUint64LE(h) != HEADER_MAGIC) {
+			return sl_false;
+		}
+		if (MIO::readUint64LE(h + 48) != HashBytes64(h, 48)) {
+			return sl_false;
+		}
+		sl_uint32 pageSize = MIO::readUint32LE(h + 8);
+		if (pageSize < MIN_PAGE_SIZE) {
+			return sl_false;
+		}
+		if (MIO::readUint32LE(h + 12) != m_order) {
+			return sl_false;
+		}
+		m_pageSize = pageSize;
+		m_countPages = MIO::readUint64LE(h + 16);
+		m_rootPage = MIO::readUint64LE(h + 24);
+		if (m_rootPage >= m_countPages) {
+			return sl_false;
+		}
+		return _loadFreePages(MIO::readUint64LE(h + 32), MIO::readUint64LE(h + 40));
+	}
+
+	sl_bool FileBTreeStorage::_loadFreePages(sl_uint64 head, sl_uint64 count)
+	{
+		if (count >= m_countPages) {
+			return sl_false;
+		}
+		sl_size n = (sl_size)count;
+		if (!n) {
+			return sl_true;
+		}
+		if (!(m_freePages.setCount_NoLock(n))) {
+			return sl_false;
+		}
+		sl_uint64* pages = m_freePages.getData();
+		sl_uint64 page = head;
+		// the head is the top of the stack
+		for (sl_size i = 0; i < n; i++) {
+			if (!page || page >= m_countPages) {
+				return sl_false;
+			}
+			pages[n - 1 - i] = page;
+			sl_uint8 link[8];
+			if (!(ReadAt(m_file.get(), page * m_pageSize, link, 8))) {
+				return sl_false;
+			}
+			page = MIO::readUint64LE(link);
+		}
+		m_countFreePagesCommitted = n;
+		return sl_true;
+	}
+
+	sl_bool FileBTreeStorage::_recover()
+	{
+		sl_uint64 size = m_fileLog->getSize();
+		if (!size) {
+			return sl_true;
+		}
+		if (size <= SLIB_SIZE_MAX) {
+			Memory mem = Memory::create((sl_size)size);
+			if (mem.isNull()) {
+				return sl_false;
+			}
+			sl_uint8* log = (sl_uint8*)(mem.getData());
+			if (!(ReadAt(m_fileLog.get(), 0, log, (sl_size)size))) {
+				return sl_false;
+			}
+			if (size >= g_sizeLogHeader + g_sizeLogTrailer && MIO::readUint64LE(log) == LOG_MAGIC) {
+				sl_uint32 pageSize = MIO::readUint32LE(log + 8);
+				sl_uint64 nRecords = MIO::readUint32LE(log + 12);
+				sl_uint64 sizeLog = g_sizeLogHeader + nRecords * (8 + (sl_uint64)pageSize) + g_sizeLogTrailer;
+				if (pageSize >= MIN_PAGE_SIZE && sizeLog <= size) {
+					const sl_uint8* trailer = log + (sl_size)sizeLog - g_sizeLogTrailer;
+					if (MIO::readUint64LE(trailer + 8) == LOG_COMMIT_MAGIC && MIO::readUint64LE(trailer) == HashBytes64(log, trailer - log)) {
+						if (!(_applyLog(log, (sl_size)sizeLog))) {
+							return sl_false;
+						}
+					}
+				}
+			}
+		}
+		// the incomplete log is discarded: the page file is not changed before the log is complete
+		if (!(m_fileLog->setSize(0))) {
+			return sl_false;
+		}
+		return m_fileLog->sync();
+	}
+
+	sl_bool FileBTreeStorage::_applyLog(const sl_uint8* log, sl_size size)
+	{
+		sl_uint32 pageSize = MIO::readUint32LE(log + 8);
+		sl_uint32 nRecords = MIO::readUint32LE(log + 12);
+		const sl_uint8* p = log + g_sizeLogHeader;
+		for (sl_uint32 i = 0; i < nRecords; i++) {
+			sl_uint64 page = MIO::readUint64LE(p);
+			if (!(WriteAt(m_file.get(), page * pageSize, p + 8, pageSize))) {
+				return sl_false;
+			}
+			p += 8 + pageSize;
+		}
+		return m_file->sync();
+	}
+
+}
@@ -31,6 +31,7 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/mman.h>
 #if defined(SLIB_PLATFORM_IS_DESKTOP)
 #	include <sys/ioctl.h>
 #	if defined(SLIB_PLATFORM_IS_MACOS)
@@ -180,6 +181,51 @@ namespace slib
 		return -1;
 	}
 
+	sl_int32 File::readAt32(sl_uint64 offset, void* buf, sl_uint32 size)
+	{
+		if (isOpened()) {
+			if (size == 0) {
+				return 0;
+			}
+			int fd = (int)m_file;
+			ssize_t n = ::pread(fd, buf, size, (off_t)offset);
+			if (n > 0) {
+				return (sl_int32)n;
+			}
+		}
+		return -1;
+	}
+
+	sl_int32 File::writeAt32(sl_uint64 offset, const void* buf, sl_uint32 size)
+	{
+		if (isOpened()) {
+			if (size == 0) {
+				return 0;
+			}
+			int fd = (int)m_file;
+			ssize_t n = ::pwrite(fd, buf, size, (off_t)offset);
+			if (n > 0) {
+				return (sl_int32)n;
+			}
+		}
+		return -1;
+	}
+
+	sl_bool File::sync()
+	{
+		if (isOpened()) {
+			int fd = (int)m_file;
+#if defined(SLIB_PLATFORM_IS_APPLE)
+			// fsync does not flush the cache of the drive on Apple platforms
+			if (0 == fcntl(fd, F_FULLFSYNC)) {
+				return sl_true;
+			}
+#endif
+			return 0 == fsync(fd);
+		}
+		return sl_false;
+	}
+
 	sl_int32 File::write32(const void* buf, sl_uint32 size)
 	{
 		if (isOpened()) {
@@ -600,6 +646,102 @@ namespace slib
 		return realpath(filePath.getData(), path);
 	}
 
+	sl_bool MappedFile::_map(sl_uint64 offset, sl_size size)
+	{
+		int fd = (int)(m_file->getHandle());
+		if (fd == -1) {
+			return sl_false;
+		}
+		sl_size delta = (sl_size)(offset % _getAlignment());
+		sl_size sizeMap = size + delta;
+		if (sizeMap < size) {
+			return sl_false;
+		}
+		int prot = PROT_READ;
+		int flags;
+		if (m_mode == FileMapMode::Write) {
+			prot |= PROT_WRITE;
+			flags = MAP_SHARED;
+		} else if (m_mode == FileMapMode::CopyOnWrite) {
+			prot |= PROT_WRITE;
+			flags = MAP_PRIVATE;
+		} else {
+			flags = MAP_SHARED;
+		}
+		void* base = mmap(sl_null, sizeMap, prot, flags, fd, (off_t)(offset - delta));
+		if (base == MAP_FAILED) {
+			return sl_false;
+		}
+		m_base = base;
+		m_sizeMapped = sizeMap;
+		m_data = (sl_uint8*)base + delta;
+		m_size = size;
+		m_offset = offset;
+		return sl_true;
+	}
+
+	void MappedFile::_unmap(void* base, sl_size size)
+	{
+		munmap(base, size);
+	}
+
+	sl_size MappedFile::_getAlignment()
+	{
+		static sl_size alignment = 0;
+		if (!alignment) {
+			long n = sysconf(_SC_PAGESIZE);
+			alignment = n > 0 ? (sl_size)n : 4096;
+		}
+		return alignment;
+	}
+
+	sl_bool MappedFile::advise(FileMapHint hint, sl_size offset, sl_size size)
+	{
+		ObjectLocker lock(this);
+		if (!m_data || offset >= m_size) {
+			return sl_false;
+		}
+		if (!size || size > m_size - offset) {
+			size = m_size - offset;
+		}
+		sl_uint8* start = m_data + offset;
+		// madvise requires the address aligned to the page
+		sl_size delta = (sl_size)(start - (sl_uint8*)m_base) % _getAlignment();
+		start -= delta;
+		size += delta;
+		int advice;
+		switch (hint) {
+			case FileMapHint::Sequential:
+				advice = MADV_SEQUENTIAL;
+				break;
+			case FileMapHint::Random:
+				advice = MADV_RANDOM;
+				break;
+			case FileMapHint::WillNeed:
+				advice = MADV_WILLNEED;
+				break;
+			case FileMapHint::DontNeed:
+				advice = MADV_DONTNEED;
+				break;
+			default:
+				advice = MADV_NORMAL;
+				break;
+		}
+		return 0 == madvise(start, size, advice);
+	}
+
+	sl_bool MappedFile::flush(sl_bool flagAsync)
+	{
+		ObjectLocker lock(this);
+		if (!m_base) {
+			return sl_false;
+		}
+		if (m_mode != FileMapMode::Write) {
+			return sl_true;
+		}
+		return 0 == msync(m_base, m_sizeMapped, flagAsync ? MS_ASYNC : MS_SYNC);
+	}
+
 }
 
 #endif
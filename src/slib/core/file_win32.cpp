@@ -26,6 +26,8 @@
 
 #include "slib/core/file.h"
 
+#include "slib/core/platform_windows.h"
+
 #include <windows.h>
 
 namespace slib
@@ -165,6 +167,57 @@ namespace slib
 		return -1;
 	}
 
+	sl_int32 File::readAt32(sl_uint64 offset, void* buf, sl_uint32 size)
+	{
+		if (isOpened()) {
+			if (size == 0) {
+				return 0;
+			}
+			OVERLAPPED overlapped;
+			Base::zeroMemory(&overlapped, sizeof(overlapped));
+			overlapped.Offset = (DWORD)offset;
+			overlapped.OffsetHigh = (DWORD)(offset >> 32);
+			sl_uint32 ret = 0;
+			HANDLE handle = (HANDLE)m_file;
+			if (ReadFile(handle, buf, size, (DWORD*)&ret, &overlapped)) {
+				if (ret > 0) {
+					return ret;
+				}
+			}
+		}
+		return -1;
+	}
+
+	sl_int32 File::writeAt32(sl_uint64 offset, const void* buf, sl_uint32 size)
+	{
+		if (isOpened()) {
+			if (size == 0) {
+				return 0;
+			}
+			OVERLAPPED overlapped;
+			Base::zeroMemory(&overlapped, sizeof(overlapped));
+			overlapped.Offset = (DWORD)offset;
+			overlapped.OffsetHigh = (DWORD)(offset >> 32);
+			sl_uint32 ret = 0;
+			HANDLE handle = (HANDLE)m_file;
+			if (WriteFile(handle, buf, size, (DWORD*)&ret, &overlapped)) {
+				if (ret > 0) {
+					return ret;
+				}
+			}
+		}
+		return -1;
+	}
+
+	sl_bool File::sync()
+	{
+		if (isOpened()) {
+			HANDLE handle = (HANDLE)m_file;
+			return FlushFileBuffers(handle) != 0;
+		}
+		return sl_false;
+	}
+
 	sl_int32 File::write32(const void* buf, sl_uint32 size)
 	{
 		if (isOpened()) {
@@ -574,6 +627,114 @@ namespace slib
 		return sl_null;
 	}
 
+	sl_bool MappedFile::_map(sl_uint64 offset, sl_size size)
+	{
+		HANDLE handle = (HANDLE)(m_file->getHandle());
+		if (handle == INVALID_HANDLE_VALUE) {
+			return sl_false;
+		}
+		sl_size delta = (sl_size)(offset % _getAlignment());
+		sl_size sizeMap = size + delta;
+		if (sizeMap < size) {
+			return sl_false;
+		}
+		DWORD protect;
+		DWORD access;
+		if (m_mode == FileMapMode::Write) {
+			protect = PAGE_READWRITE;
+			access = FILE_MAP_WRITE;
+		} else if (m_mode == FileMapMode::CopyOnWrite) {
+			protect = PAGE_WRITECOPY;
+			access = FILE_MAP_COPY;
+		} else {
+			protect = PAGE_READONLY;
+			access = FILE_MAP_READ;
+		}
+		sl_uint64 end = offset + size;
+		HANDLE hMapping = CreateFileMappingW(handle, NULL, protect, (DWORD)(end >> 32), (DWORD)end, NULL);
+		if (!hMapping) {
+			return sl_false;
+		}
+		sl_uint64 offsetMap = offset - delta;
+		void* base = MapViewOfFile(hMapping, access, (DWORD)(offsetMap >> 32), (DWORD)offsetMap, sizeMap);
+		// the view keeps the mapping object
+		CloseHandle(hMapping);
+		if (!base) {
+			return sl_false;
+		}
+		m_base = base;
+		m_sizeMapped = sizeMap;
+		m_data = (sl_uint8*)base + delta;
+		m_size = size;
+		m_offset = offset;
+		return sl_true;
+	}
+
+	void MappedFile::_unmap(void* base, sl_size size)
+	{
+		UnmapViewOfFile(base);
+	}
+
+	sl_size MappedFile::_getAlignment()
+	{
+		static sl_size alignment = 0;
+		if (!alignment) {
+			SYSTEM_INFO si;
+			GetSystemInfo(&si);
+			alignment = si.dwAllocationGranularity;
+		}
+		return alignment;
+	}
+
+	sl_bool MappedFile::advise(FileMapHint hint, sl_size offset, sl_size size)
+	{
+		ObjectLocker lock(this);
+		if (!m_data || offset >= m_size) {
+			return sl_false;
+		}
+		if (!size || size > m_size - offset) {
+			size = m_size - offset;
+		}
+		if (hint == FileMapHint::WillNeed) {
+			WINAPI_PrefetchVirtualMemory func = Windows::getAPI_PrefetchVirtualMemory();
+			if (func) {
+				// WIN32_MEMORY_RANGE_ENTRY
+				struct {
+					PVOID VirtualAddress;
+					SIZE_T NumberOfBytes;
+				} range;
+				range.VirtualAddress = m_data + offset;
+				range.NumberOfBytes = size;
+				return func(GetCurrentProcess(), 1, &range, 0) != 0;
+			}
+			return sl_false;
+		}
+		if (hint == FileMapHint::DontNeed) {
+			// removes the pages from the working set
+			return VirtualUnlock(m_data + offset, size) != 0 || GetLastError() == ERROR_NOT_LOCKED;
+		}
+		// the access pattern can not be changed after the file is opened
+		return sl_true;
+	}
+
+	sl_bool MappedFile::flush(sl_bool flagAsync)
+	{
+		ObjectLocker lock(this);
+		if (!m_base) {
+			return sl_false;
+		}
+		if (m_mode != FileMapMode::Write) {
+			return sl_true;
+		}
+		if (!(FlushViewOfFile(m_base, m_sizeMapped))) {
+			return sl_false;
+		}
+		if (flagAsync) {
+			return sl_true;
+		}
+		return FlushFileBuffers((HANDLE)(m_file->getHandle())) != 0;
+	}
+
 }
 
 #endif
@@ -24,43 +24,406 @@
 #include "slib/core/hash_table.h"
 
 #include "slib/core/math.h"
+#include "slib/core/mio.h"
+
+#if defined(SLIB_ARCH_IS_X64) || (defined(SLIB_ARCH_IS_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+#	define SUPPORT_SSE2
+#	include <emmintrin.h>
+#	if defined(SLIB_ARCH_IS_X64) && !defined(SLIB_PLATFORM_IS_MOBILE)
+#		define SUPPORT_AVX2
+#		include <immintrin.h>
+#		include "slib/core/asm.h"
+#		if defined(SLIB_COMPILER_IS_VC)
+#			define AVX2_FUNCTION
+#		else
+#			define AVX2_FUNCTION __attribute__((target("avx2")))
+#		endif
+#	endif
+#endif
 
 namespace slib
 {
 
 	/****************************************************
-	 
-		Fowler–Noll–Vo hash function / FNV-1a hash
-	 
-	 https://en.wikipedia.org/wiki/Fowler%E2%80%93Noll%E2%80%93Vo_hash_function
-	 http://www.isthe.com/chongo/tech/comp/fnv/index.html
-	 
+
+		XXH3 (64-bit) hash function
+
+	 https://github.com/Cyan4973/xxHash
+	 https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+
 	****************************************************/
-	
-	sl_uint32 HashBytes32(const void* _buf, sl_size n) noexcept
+
+	namespace priv
 	{
-		sl_uint8* buf = (sl_uint8*)_buf;
-		sl_uint32 hash = 0x811c9dc5;
-		sl_uint32 prime = 16777619;
-		for (sl_size i = 0; i < n; i++) {
-			hash ^= buf[i];
-			hash *= prime;
+		namespace xxh3
+		{
+
+#define PRIME32_1 SLIB_UINT64(0x9E3779B1)
+#define PRIME32_2 SLIB_UINT64(0x85EBCA77)
+#define PRIME32_3 SLIB_UINT64(0xC2B2AE3D)
+#define PRIME64_1 SLIB_UINT64(0x9E3779B185EBCA87)
+#define PRIME64_2 SLIB_UINT64(0xC2B2AE3D27D4EB4F)
+#define PRIME64_3 SLIB_UINT64(0x165667B19E3779F9)
+#define PRIME64_4 SLIB_UINT64(0x85EBCA77C2B2AE63)
+#define PRIME64_5 SLIB_UINT64(0x27D4EB2F165667C5)
+#define PRIME_MX1 SLIB_UINT64(0x165667919E3779F9)
+#define PRIME_MX2 SLIB_UINT64(0x9FB21C651E98DF25)
+
+#define SECRET_SIZE 192
+#define STRIPE_LEN 64
+#define SECRET_CONSUME_RATE 8
+#define STRIPES_PER_BLOCK ((SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE)
+#define SECRET_LASTACC_START 7
+#define SECRET_MERGEACCS_START 11
+#define MIDSIZE_MAX 240
+#define MIDSIZE_STARTOFFSET 3
+#define MIDSIZE_LASTOFFSET 17
+#define SECRET_SIZE_MIN 136
+#define BUFFER_SIZE 256
+
+			SLIB_ALIGN(64) static const sl_uint8 g_secret[SECRET_SIZE] = {
+				0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+				0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+				0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+				0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+				0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+				0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+				0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+				0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+				0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+				0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+				0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+				0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+			};
+
+			SLIB_INLINE static sl_uint64 Read64(const sl_uint8* p) noexcept
+			{
+				return MIO::readUint64LE(p);
+			}
+
+			SLIB_INLINE static sl_uint32 Read32(const sl_uint8* p) noexcept
+			{
+				return MIO::readUint32LE(p);
+			}
+
+			SLIB_INLINE static sl_uint64 RotateLeft(sl_uint64 x, sl_uint32 n) noexcept
+			{
+				return (x << n) | (x >> (64 - n));
+			}
+
+			// `Endian::swap` goes through the memory
+			SLIB_INLINE static sl_uint32 Swap32(sl_uint32 x) noexcept
+			{
+				return (x >> 24) | ((x >> 8) & 0xFF00) | ((x << 8) & 0xFF0000) | (x << 24);
+			}
+
+			SLIB_INLINE static sl_uint64 Swap64(sl_uint64 x) noexcept
+			{
+				return ((sl_uint64)(Swap32((sl_uint32)x)) << 32) | Swap32((sl_uint32)(x >> 32));
+			}
+
+			SLIB_INLINE static sl_uint64 Mul128Fold64(sl_uint64 a, sl_uint64 b) noexcept
+			{
+				sl_uint64 high, low;
+				Math::mul64(a, b, high, low);
+				return high ^ low;
+			}
+
+			SLIB_INLINE static sl_uint64 Avalanche64(sl_uint64 h) noexcept
+			{
+				h ^= h >> 33;
+				h *= PRIME64_2;
+				h ^= h >> 29;
+				h *= PRIME64_3;
+				h ^= h >> 32;
+				return h;
+			}
+
+			SLIB_INLINE static sl_uint64 Avalanche(sl_uint64 h) noexcept
+			{
+				h ^= h >> 37;
+				h *= PRIME_MX1;
+				h ^= h >> 32;
+				return h;
+			}
+
+			SLIB_INLINE static sl_uint64 Rrmxmx(sl_uint64 h, sl_uint64 len) noexcept
+			{
+				h ^= RotateLeft(h, 49) ^ RotateLeft(h, 24);
+				h *= PRIME_MX2;
+				h ^= (h >> 35) + len;
+				h *= PRIME_MX2;
+				h ^= h >> 28;
+				return h;
+			}
+
+			SLIB_INLINE static sl_uint64 Mix16(const sl_uint8* input, const sl_uint8* secret, sl_uint64 seed) noexcept
+			{
+				return Mul128Fold64(Read64(input) ^ (Read64(secret) + seed), Read64(input + 8) ^ (Read64(secret + 8) - seed));
+			}
+
+			static sl_uint64 Hash0To16(const sl_uint8* input, sl_size len, sl_uint64 seed) noexcept
+			{
+				const sl_uint8* secret = g_secret;
+				if (len > 8) {
+					sl_uint64 bitflip1 = (Read64(secret + 24) ^ Read64(secret + 32)) + seed;
+					sl_uint64 bitflip2 = (Read64(secret + 40) ^ Read64(secret + 48)) - seed;
+					sl_uint64 low = Read64(input) ^ bitflip1;
+					sl_uint64 high = Read64(input + len - 8) ^ bitflip2;
+					return Avalanche(len + Swap64(low) + high + Mul128Fold64(low, high));
+				}
+				if (len >= 4) {
+					seed ^= (sl_uint64)(Swap32((sl_uint32)seed)) << 32;
+					sl_uint64 bitflip = (Read64(secret + 8) ^ Read64(secret + 16)) - seed;
+					sl_uint64 v = (sl_uint64)(Read32(input + len - 4)) + ((sl_uint64)(Read32(input)) << 32);
+					return Rrmxmx(v ^ bitflip, len);
+				}
+				if (len) {
+					sl_uint32 c1 = input[0];
+					sl_uint32 c2 = input[len >> 1];
+					sl_uint32 c3 = input[len - 1];
+					sl_uint32 combined = (c1 << 16) | (c2 << 24) | c3 | ((sl_uint32)len << 8);
+					sl_uint64 bitflip = (sl_uint64)(Read32(secret) ^ Read32(secret + 4)) + seed;
+					return Avalanche64((sl_uint64)combined ^ bitflip);
+				}
+				return Avalanche64(seed ^ Read64(secret + 56) ^ Read64(secret + 64));
+			}
+
+			static sl_uint64 Hash17To128(const sl_uint8* input, sl_size len, sl_uint64 seed) noexcept
+			{
+				const sl_uint8* secret = g_secret;
+				sl_uint64 acc = len * PRIME64_1;
+				if (len > 32) {
+					if (len > 64) {
+						if (len > 96) {
+							acc += Mix16(input + 48, secret + 96, seed);
+							acc += Mix16(input + len - 64, secret + 112, seed);
+						}
+						acc += Mix16(input + 32, secret + 64, seed);
+						acc += Mix16(input + len - 48, secret + 80, seed);
+					}
+					acc += Mix16(input + 16, secret + 32, seed);
+					acc += Mix16(input + len - 32, secret + 48, seed);
+				}
+				acc += Mix16(input, secret, seed);
+				acc += Mix16(input + len - 16, secret + 16, seed);
+				return Avalanche(acc);
+			}
+
+			static sl_uint64 Hash129To240(const sl_uint8* input, sl_size len, sl_uint64 seed) noexcept
+			{
+				const sl_uint8* secret = g_secret;
+				sl_uint64 acc = len * PRIME64_1;
+				sl_uint32 nRounds = (sl_uint32)len / 16;
+				sl_uint32 i;
+				for (i = 0; i < 8; i++) {
+					acc += Mix16(input + 16 * i, secret + 16 * i, seed);
+				}
+				acc = Avalanche(acc);
+				for (i = 8; i < nRounds; i++) {
+					acc += Mix16(input + 16 * i, secret + 16 * (i - 8) + MIDSIZE_STARTOFFSET, seed);
+				}
+				acc += Mix16(input + len - 16, secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET, seed);
+				return Avalanche(acc);
+			}
+
+			SLIB_INLINE static void Accumulate512_General(sl_uint64* acc, const sl_uint8* input, const sl_uint8* secret) noexcept
+			{
+				for (sl_uint32 i = 0; i < 8; i++) {
+					sl_uint64 data = Read64(input + 8 * i);
+					sl_uint64 key = data ^ Read64(secret + 8 * i);
+					acc[i ^ 1] += data;
+					acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+				}
+			}
+
+#if defined(SUPPORT_SSE2)
+			static void Accumulate_Sse2(sl_uint64* acc, const sl_uint8* input, const sl_uint8* secret, sl_size nStripes) noexcept
+			{
+				__m128i a[4];
+				for (sl_uint32 i = 0; i < 4; i++) {
+					a[i] = _mm_loadu_si128((const __m128i*)(acc + 2 * i));
+				}
+				for (sl_size n = 0; n < nStripes; n++) {
+					const sl_uint8* p = input + n * STRIPE_LEN;
+					const sl_uint8* k = secret + n * SECRET_CONSUME_RATE;
+					for (sl_uint32 i = 0; i < 4; i++) {
+						__m128i data = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+						__m128i key = _mm_xor_si128(data, _mm_loadu_si128((const __m128i*)(k + 16 * i)));
+						// (low 32 bits) * (high 32 bits) of each lane
+						__m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+						// data of the neighbor lane
+						a[i] = _mm_add_epi64(a[i], _mm_add_epi64(product, _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2))));
+					}
+				}
+				for (sl_uint32 i = 0; i < 4; i++) {
+					_mm_storeu_si128((__m128i*)(acc + 2 * i), a[i]);
+				}
+			}
+#endif
+
+#if defined(SUPPORT_AVX2)
+			AVX2_FUNCTION static void Accumulate_Avx2(sl_uint64* acc, const sl_uint8* input, const sl_uint8* secret, sl_size nStripes) noexcept
+			{
+				__m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+				__m256i a1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+				for (sl_size n = 0; n < nStripes; n++) {
+					const sl_uint8* p = input + n * STRIPE_LEN;
+					const sl_uint8* k = secret + n * SECRET_CONSUME_RATE;
+					__m256i d0 = _mm256_loadu_si256((const __m256i*)p);
+					__m256i d1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+					__m256i k0 = _mm256_xor_si256(d0, _mm256_loadu_si256((const __m256i*)k));
+					__m256i k1 = _mm256_xor_si256(d1, _mm256_loadu_si256((const __m256i*)(k + 32)));
+					__m256i p0 = _mm256_mul_epu32(k0, _mm256_shuffle_epi32(k0, _MM_SHUFFLE(0, 3, 0, 1)));
+					__m256i p1 = _mm256_mul_epu32(k1, _mm256_shuffle_epi32(k1, _MM_SHUFFLE(0, 3, 0, 1)));
+					a0 = _mm256_add_epi64(a0, _mm256_add_epi64(p0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2))));
+					a1 = _mm256_add_epi64(a1, _mm256_add_epi64(p1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2))));
+				}
+				_mm256_storeu_si256((__m256i*)acc, a0);
+				_mm256_storeu_si256((__m256i*)(acc + 4), a1);
+			}
+#endif
+
+			static void Accumulate(sl_uint64* acc, const sl_uint8* input, const sl_uint8* secret, sl_size nStripes) noexcept
+			{
+#if defined(SUPPORT_AVX2)
+				if (nStripes > 1 && CanUseAvx2()) {
+					Accumulate_Avx2(acc, input, secret, nStripes);
+					return;
+				}
+#endif
+#if defined(SUPPORT_SSE2)
+				Accumulate_Sse2(acc, input, secret, nStripes);
+#else
+				for (sl_size n = 0; n < nStripes; n++) {
+					Accumulate512_General(acc, input + n * STRIPE_LEN, secret + n * SECRET_CONSUME_RATE);
+				}
+#endif
+			}
+
+			SLIB_INLINE static void Accumulate512(sl_uint64* acc, const sl_uint8* input, const sl_uint8* secret) noexcept
+			{
+				Accumulate(acc, input, secret, 1);
+			}
+
+			SLIB_INLINE static void Scramble(sl_uint64* acc, const sl_uint8* secret) noexcept
+			{
+				for (sl_uint32 i = 0; i < 8; i++) {
+					sl_uint64 a = acc[i];
+					a ^= a >> 47;
+					a ^= Read64(secret + 8 * i);
+					a *= PRIME32_1;
+					acc[i] = a;
+				}
+			}
+
+			static sl_uint64 MergeAccumulators(const sl_uint64* acc, const sl_uint8* secret, sl_uint64 start) noexcept
+			{
+				sl_uint64 result = start;
+				for (sl_uint32 i = 0; i < 4; i++) {
+					result += Mul128Fold64(acc[2 * i] ^ Read64(secret + 16 * i), acc[2 * i + 1] ^ Read64(secret + 16 * i + 8));
+				}
+				return Avalanche(result);
+			}
+
+			SLIB_INLINE static void InitAccumulators(sl_uint64* acc) noexcept
+			{
+				acc[0] = PRIME32_3;
+				acc[1] = PRIME64_1;
+				acc[2] = PRIME64_2;
+				acc[3] = PRIME64_3;
+				acc[4] = PRIME64_4;
+				acc[5] = PRIME32_2;
+				acc[6] = PRIME64_5;
+				acc[7] = PRIME32_1;
+			}
+
+			static void InitSecret(sl_uint8* secret, sl_uint64 seed) noexcept
+			{
+				for (sl_uint32 i = 0; i < SECRET_SIZE; i += 16) {
+					MIO::writeUint64LE(secret + i, Read64(g_secret + i) + seed);
+					MIO::writeUint64LE(secret + i + 8, Read64(g_secret + i + 8) - seed);
+				}
+			}
+
+			static sl_uint64 HashLong(const sl_uint8* input, sl_size len, const sl_uint8* secret) noexcept
+			{
+				SLIB_ALIGN(8) sl_uint64 acc[8];
+				InitAccumulators(acc);
+				const sl_size sizeBlock = STRIPE_LEN * STRIPES_PER_BLOCK;
+				sl_size nBlocks = (len - 1) / sizeBlock;
+				for (sl_size n = 0; n < nBlocks; n++) {
+					Accumulate(acc, input + n * sizeBlock, secret, STRIPES_PER_BLOCK);
+					Scramble(acc, secret + SECRET_SIZE - STRIPE_LEN);
+				}
+				sl_size nStripes = ((len - 1) - sizeBlock * nBlocks) / STRIPE_LEN;
+				Accumulate(acc, input + nBlocks * sizeBlock, secret, nStripes);
+				Accumulate512(acc, input + len - STRIPE_LEN, secret + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START);
+				return MergeAccumulators(acc, secret + SECRET_MERGEACCS_START, len * PRIME64_1);
+			}
+
+			static sl_uint64 HashBytes(const void* _input, sl_size len, sl_uint64 seed) noexcept
+			{
+				const sl_uint8* input = (const sl_uint8*)_input;
+				if (len <= 16) {
+					return Hash0To16(input, len, seed);
+				}
+				if (len <= 128) {
+					return Hash17To128(input, len, seed);
+				}
+				if (len <= MIDSIZE_MAX) {
+					return Hash129To240(input, len, seed);
+				}
+				if (seed) {
+					SLIB_ALIGN(8) sl_uint8 secret[SECRET_SIZE];
+					InitSecret(secret, seed);
+					return HashLong(input, len, secret);
+				}
+				return HashLong(input, len, g_secret);
+			}
+
+			// accumulates the stripes, scrambling at the ends of the blocks
+			static void ConsumeStripes(sl_uint64* acc, sl_uint32& nStripesInBlock, const sl_uint8* input, sl_size nStripes, const sl_uint8* secret) noexcept
+			{
+				sl_size nStripesToEnd = STRIPES_PER_BLOCK - nStripesInBlock;
+				if (nStripesToEnd <= nStripes) {
+					Accumulate(acc, input, secret + nStripesInBlock * SECRET_CONSUME_RATE, nStripesToEnd);
+					Scramble(acc, secret + SECRET_SIZE - STRIPE_LEN);
+					Accumulate(acc, input + nStripesToEnd * STRIPE_LEN, secret, nStripes - nStripesToEnd);
+					nStripesInBlock = (sl_uint32)(nStripes - nStripesToEnd);
+				} else {
+					Accumulate(acc, input, secret + nStripesInBlock * SECRET_CONSUME_RATE, nStripes);
+					nStripesInBlock += (sl_uint32)nStripes;
+				}
+			}
+
 		}
-		return hash;
 	}
-	
-	sl_uint64 HashBytes64(const void* _buf, sl_size n) noexcept
+
+	using namespace priv::xxh3;
+
+	sl_uint32 HashBytes32(const void* buf, sl_size n) noexcept
 	{
-		sl_uint8* buf = (sl_uint8*)_buf;
-		sl_uint64 hash = SLIB_UINT64(0xcbf29ce484222325);
-		sl_uint64 prime = SLIB_UINT64(1099511628211);
-		for (sl_size i = 0; i < n; i++) {
-			hash ^= buf[i];
-			hash *= prime;
-		}
-		return hash;
+		sl_uint64 h = priv::xxh3::HashBytes(buf, n, 0);
+		return (sl_uint32)(h ^ (h >> 32));
+	}
+
+	sl_uint32 HashBytes32(const void* buf, sl_size n, sl_uint64 seed) noexcept
+	{
+		sl_uint64 h = priv::xxh3::HashBytes(buf, n, seed);
+		return (sl_uint32)(h ^ (h >> 32));
+	}
+
+	sl_uint64 HashBytes64(const void* buf, sl_size n) noexcept
+	{
+		return priv::xxh3::HashBytes(buf, n, 0);
 	}
-	
+
+	sl_uint64 HashBytes64(const void* buf, sl_size n, sl_uint64 seed) noexcept
+	{
+		return priv::xxh3::HashBytes(buf, n, seed);
+	}
+
 	sl_size HashBytes(const void* buf, sl_size n) noexcept
 	{
 #ifdef SLIB_ARCH_IS_64BIT
@@ -70,6 +433,112 @@ namespace slib
 #endif
 	}
 
+	sl_size HashBytes(const void* buf, sl_size n, sl_uint64 seed) noexcept
+	{
+#ifdef SLIB_ARCH_IS_64BIT
+		return HashBytes64(buf, n, seed);
+#else
+		return HashBytes32(buf, n, seed);
+#endif
+	}
+
+
+	BytesHasher::BytesHasher() noexcept
+	{
+		start(0);
+	}
+
+	BytesHasher::BytesHasher(sl_uint64 seed) noexcept
+	{
+		start(seed);
+	}
+
+	void BytesHasher::start(sl_uint64 seed) noexcept
+	{
+		InitAccumulators(m_acc);
+		if (seed) {
+			InitSecret(m_secret, seed);
+		} else {
+			Base::copyMemory(m_secret, g_secret, SECRET_SIZE);
+		}
+		m_seed = seed;
+		m_sizeTotal = 0;
+		m_sizeBuffered = 0;
+		m_nStripesInBlock = 0;
+	}
+
+	void BytesHasher::update(const void* data, sl_size size) noexcept
+	{
+		if (!size) {
+			return;
+		}
+		const sl_uint8* input = (const sl_uint8*)data;
+		m_sizeTotal += size;
+		if (size <= BUFFER_SIZE - m_sizeBuffered) {
+			Base::copyMemory(m_buffer + m_sizeBuffered, input, size);
+			m_sizeBuffered += (sl_uint32)size;
+			return;
+		}
+		const sl_uint8* end = input + size;
+		if (m_sizeBuffered) {
+			sl_uint32 sizeLoad = BUFFER_SIZE - m_sizeBuffered;
+			Base::copyMemory(m_buffer + m_sizeBuffered, input, sizeLoad);
+			input += sizeLoad;
+			ConsumeStripes(m_acc, m_nStripesInBlock, m_buffer, BUFFER_SIZE / STRIPE_LEN, m_secret);
+			m_sizeBuffered = 0;
+		}
+		// keeps the last bytes in the buffer, so that `finish` always has the last stripe
+		if ((sl_size)(end - input) > BUFFER_SIZE) {
+			do {
+				ConsumeStripes(m_acc, m_nStripesInBlock, input, BUFFER_SIZE / STRIPE_LEN, m_secret);
+				input += BUFFER_SIZE;
+			} while ((sl_size)(end - input) > BUFFER_SIZE);
+			Base::copyMemory(m_buffer + BUFFER_SIZE - STRIPE_LEN, input - STRIPE_LEN, STRIPE_LEN);
+		}
+		m_sizeBuffered = (sl_uint32)(end - input);
+		Base::copyMemory(m_buffer, input, m_sizeBuffered);
+	}
+
+	sl_uint64 BytesHasher::finish64() const noexcept
+	{
+		if (m_sizeTotal <= MIDSIZE_MAX) {
+			return priv::xxh3::HashBytes(m_buffer, (sl_size)m_sizeTotal, m_seed);
+		}
+		SLIB_ALIGN(8) sl_uint64 acc[8];
+		Base::copyMemory(acc, m_acc, sizeof(acc));
+		const sl_uint8* lastStripe;
+		sl_uint8 stripe[STRIPE_LEN];
+		if (m_sizeBuffered >= STRIPE_LEN) {
+			sl_uint32 nStripes = (m_sizeBuffered - 1) / STRIPE_LEN;
+			sl_uint32 nStripesInBlock = m_nStripesInBlock;
+			ConsumeStripes(acc, nStripesInBlock, m_buffer, nStripes, m_secret);
+			lastStripe = m_buffer + m_sizeBuffered - STRIPE_LEN;
+		} else {
+			// the last stripe overlaps the bytes consumed before
+			sl_uint32 sizeCatchup = STRIPE_LEN - m_sizeBuffered;
+			Base::copyMemory(stripe, m_buffer + BUFFER_SIZE - sizeCatchup, sizeCatchup);
+			Base::copyMemory(stripe + sizeCatchup, m_buffer, m_sizeBuffered);
+			lastStripe = stripe;
+		}
+		Accumulate512(acc, lastStripe, m_secret + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START);
+		return MergeAccumulators(acc, m_secret + SECRET_MERGEACCS_START, m_sizeTotal * PRIME64_1);
+	}
+
+	sl_uint32 BytesHasher::finish32() const noexcept
+	{
+		sl_uint64 h = finish64();
+		return (sl_uint32)(h ^ (h >> 32));
+	}
+
+	sl_size BytesHasher::finish() const noexcept
+	{
+#ifdef SLIB_ARCH_IS_64BIT
+		return finish64();
+#else
+		return finish32();
+#endif
+	}
+
 
 	namespace priv
 	{
@@ -332,6 +332,26 @@ namespace slib
 				
 			};
 
+			// the item names share the strings interned by the program. the names from the input are not interned, because the input may be untrusted
+			static String GetItemName(const sl_char8* name, sl_size len) noexcept
+			{
+				String interned = String::findInterned(name, len);
+				if (interned.isNotNull()) {
+					return interned;
+				}
+				return String(name, len);
+			}
+
+			static String GetItemName(const sl_char16* name, sl_size len) noexcept
+			{
+				String str = String::create(name, len);
+				String interned = String::findInterned(str.getData(), str.getLength());
+				if (interned.isNotNull()) {
+					return interned;
+				}
+				return str;
+			}
+
 			template <>
 			Parser<String, sl_char8>::Parser()
 			{
@@ -520,24 +540,37 @@ namespace slib
 							errorMessage = "Object: Missing character } ";
 							return sl_null;
 						}
-						ST key;
+						String key;
 						ch = buf[pos];
 						if (ch == '}') {
 							pos++;
 							return map;
 						} else if (ch == '"' || ch == '\'') {
-							sl_size m = 0;
-							sl_bool f = sl_false;
-							if (sizeof(CT) == 1) {
-								key = ST::from(ParseUtil::parseBackslashEscapes(StringParam(buf + pos, len - pos), &m, &f));
+							sl_size end = pos + 1;
+							while (end < len) {
+								CT c = buf[end];
+								if (c == ch || c == '\\' || !c) {
+									break;
+								}
+								end++;
+							}
+							if (end < len && buf[end] == ch) {
+								key = GetItemName(buf + pos + 1, end - pos - 1);
+								pos = end + 1;
 							} else {
-								key = ST::from(ParseUtil::parseBackslashEscapes16(StringParam(buf + pos, len - pos), &m, &f));
-							}							
-							pos += m;
-							if (f) {
-								flagError = sl_true;
-								errorMessage = "Object Item Name: Missing terminating character \" or ' ";
-								return sl_null;
+								sl_size m = 0;
+								sl_bool f = sl_false;
+								if (sizeof(CT) == 1) {
+									key = String::from(ParseUtil::parseBackslashEscapes(StringParam(buf + pos, len - pos), &m, &f));
+								} else {
+									key = String::from(ParseUtil::parseBackslashEscapes16(StringParam(buf + pos, len - pos), &m, &f));
+								}
+								pos += m;
+								if (f) {
+									flagError = sl_true;
+									errorMessage = "Object Item Name: Missing terminating character \" or ' ";
+									return sl_null;
+								}
 							}
 						} else {
 							sl_size s = pos;
@@ -554,7 +587,7 @@ namespace slib
 								errorMessage = "Object: Missing character : ";
 								return sl_null;
 							}
-							key = ST(buf + s, pos - s);
+							key = GetItemName(buf + s, pos - s);
 						}
 						escapeSpaceAndComments();
 						if (pos == len) {
@@ -576,14 +609,14 @@ namespace slib
 							return sl_null;
 						}
 						if (buf[pos] == '}' || buf[pos] == ',') {
-							map.put_NoLock(String::from(key), Json::null());
+							map.put_NoLock(key, Json::null());
 						} else {
 							Json item = parseJson();
 							if (flagError) {
 								return sl_null;
 							}
 							if (item.isNotUndefined()) {
-								map.put_NoLock(String::from(key), item);
+								map.put_NoLock(key, item);
 							}
 						}
 						flagFirst = sl_false;
@@ -736,8 +769,25 @@ namespace slib
 
 	Json Json::parseJsonFromTextFile(const StringParam& filePath, JsonParseParam& param)
 	{
-		String16 json = File::readAllText16(filePath);
-		return parseJson(json, param);
+		Memory mem = File::mapAllBytes(filePath);
+		if (mem.isNull()) {
+			return sl_null;
+		}
+		sl_uint8* data = (sl_uint8*)(mem.getData());
+		sl_size size = mem.getSize();
+		if (size >= 2 && ((data[0] == 0xFF && data[1] == 0xFE) || (data[0] == 0xFE && data[1] == 0xFF))) {
+			String16 json = File::readAllText16(filePath);
+			return parseJson(json, param);
+		}
+		// UTF-8 text is parsed in place, without converting to UTF-16
+		if (size >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+			data += 3;
+			size -= 3;
+		}
+		if (!size) {
+			return sl_null;
+		}
+		return parseJson((sl_char8*)data, size, param);
 	}
 
 	Json Json::parseJsonFromTextFile(const StringParam& filePath)
@@ -0,0 +1,463 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/open_file_cache.h"
+
+#include "slib/core/system.h"
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+// limits the number of the inotify watches. the entries in the other directories are validated by the interval
+#define MAX_WATCH_DIRECTORIES_COUNT 4096
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace open_file_cache
+		{
+
+			static String GetDirectory(const String& path)
+			{
+#if defined(SLIB_PLATFORM_IS_WINDOWS)
+				sl_reg index = path.lastIndexOf('\\');
+				sl_reg index2 = path.lastIndexOf('/');
+				if (index2 > index) {
+					index = index2;
+				}
+#else
+				sl_reg index = path.lastIndexOf('/');
+#endif
+				if (index < 0) {
+					return ".";
+				}
+				if (!index) {
+					return "/";
+				}
+				return path.substring(0, index);
+			}
+
+			static String JoinPath(const String& directory, const char* name)
+			{
+				if (directory == ".") {
+					return name;
+				}
+				if (directory == "/") {
+					return "/" + String(name);
+				}
+				return directory + "/" + name;
+			}
+
+		}
+	}
+
+	using namespace priv::open_file_cache;
+
+	OpenFileInfo::OpenFileInfo()
+	{
+		flagExists = sl_false;
+		flagDirectory = sl_false;
+		size = 0;
+	}
+
+	OpenFileInfo::~OpenFileInfo()
+	{
+	}
+
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(OpenFileCacheParam)
+
+	OpenFileCacheParam::OpenFileCacheParam()
+	{
+		maxFilesCount = 1000;
+		validationInterval = 2000;
+		flagWatchChanges = sl_true;
+	}
+
+
+	SLIB_DEFINE_OBJECT(OpenFileCache, Object)
+
+	OpenFileCache::OpenFileCache()
+	{
+		m_maxFilesCount = 1000;
+		m_validationInterval = 2000;
+		m_first = sl_null;
+		m_last = sl_null;
+		m_count = 0;
+		m_seqInvalidation = 0;
+		m_fdWatch = -1;
+	}
+
+	OpenFileCache::~OpenFileCache()
+	{
+		release();
+	}
+
+	Ref<OpenFileCache> OpenFileCache::create(const OpenFileCacheParam& param)
+	{
+		Ref<OpenFileCache> ret = new OpenFileCache;
+		if (ret.isNotNull()) {
+			ret->m_maxFilesCount = param.maxFilesCount;
+			if (ret->m_maxFilesCount < 1) {
+				ret->m_maxFilesCount = 1;
+			}
+			ret->m_validationInterval = param.validationInterval;
+			if (param.flagWatchChanges) {
+				ret->_startWatching();
+			}
+			return ret;
+		}
+		return sl_null;
+	}
+
+	Ref<OpenFileCache> OpenFileCache::create()
+	{
+		OpenFileCacheParam param;
+		return create(param);
+	}
+
+	Ref<OpenFileInfo> OpenFileCache::get(const String& path)
+	{
+		sl_uint64 now = System::getTickCount64();
+		{
+			MutexLocker lock(&m_lock);
+			Entry* entry;
+			if (m_map.get_NoLock(path, &entry)) {
+				if (entry->flagWatched || now - entry->timeValidated < m_validationInterval) {
+					if (entry != m_first) {
+						_unlink(entry);
+						_link(entry);
+					}
+					return entry->info;
+				}
+				_remove(entry);
+			}
+		}
+		String directory = GetDirectory(path);
+		// the watch must be added before reading the attributes, not to miss the changes after reading
+		sl_bool flagWatched = _watch(directory);
+		sl_uint64 seq;
+		{
+			MutexLocker lock(&m_lock);
+			seq = m_seqInvalidation;
+		}
+		Ref<OpenFileInfo> info = _load(path);
+		if (info.isNull()) {
+			return sl_null;
+		}
+		MutexLocker lock(&m_lock);
+		if (seq != m_seqInvalidation) {
+			return info;
+		}
+		Entry* entry;
+		if (m_map.get_NoLock(path, &entry)) {
+			// loaded by the other thread
+			return entry->info;
+		}
+		entry = new Entry;
+		if (!entry) {
+			return info;
+		}
+		entry->info = info;
+		entry->directory = directory;
+		entry->timeValidated = now;
+		entry->flagWatched = flagWatched;
+		if (!(m_map.put_NoLock(path, entry))) {
+			delete entry;
+			return info;
+		}
+		_link(entry);
+		m_count++;
+		while (m_count > m_maxFilesCount && m_last) {
+			_remove(m_last);
+		}
+		return info;
+	}
+
+	void OpenFileCache::invalidate(const String& path)
+	{
+		_invalidate(path);
+	}
+
+	void OpenFileCache::invalidateAll()
+	{
+		MutexLocker lock(&m_lock);
+		m_seqInvalidation++;
+		_removeAll();
+	}
+
+	sl_size OpenFileCache::getCount()
+	{
+		return m_count;
+	}
+
+	sl_bool OpenFileCache::isWatching()
+	{
+		return m_fdWatch >= 0;
+	}
+
+	void OpenFileCache::release()
+	{
+		_stopWatching();
+		MutexLocker lock(&m_lock);
+		_removeAll();
+	}
+
+	Ref<OpenFileInfo> OpenFileCache::_load(const String& path)
+	{
+		Ref<OpenFileInfo> info = new OpenFileInfo;
+		if (info.isNull()) {
+			return sl_null;
+		}
+		info->path = path;
+		FileAttributes attrs = File::getAttributes(path);
+		if (attrs & FileAttributes::NotExist) {
+			return info;
+		}
+		if (attrs & FileAttributes::Directory) {
+			info->flagExists = sl_true;
+			info->flagDirectory = sl_true;
+			return info;
+		}
+		Ref<File> file = File::openForRead(path);
+		if (file.isNotNull()) {
+			info->flagExists = sl_true;
+			info->size = file->getSize();
+			info->modifiedTime = file->getModifiedTime();
+			info->file = file;
+		}
+		return info;
+	}
+
+	void OpenFileCache::_link(Entry* entry)
+	{
+		entry->before = sl_null;
+		entry->next = m_first;
+		if (m_first) {
+			m_first->before = entry;
+		} else {
+			m_last = entry;
+		}
+		m_first = entry;
+	}
+
+	void OpenFileCache::_unlink(Entry* entry)
+	{
+		if (entry->before) {
+			entry->before->next = entry->next;
+		} else {
+			m_first = entry->next;
+		}
+		if (entry->next) {
+			entry->next->before = entry->before;
+		} else {
+			m_last = entry->before;
+		}
+	}
+
+	void OpenFileCache::_remove(Entry* entry)
+	{
+		_unlink(entry);
+		m_map.remove_NoLock(entry->info->path);
+		delete entry;
+		m_count--;
+	}
+
+	void OpenFileCache::_removeAll()
+	{
+		Entry* entry = m_first;
+		while (entry) {
+			Entry* next = entry->next;
+			delete entry;
+			entry = next;
+		}
+		m_first = sl_null;
+		m_last = sl_null;
+		m_count = 0;
+		m_map.removeAll_NoLock();
+	}
+
+	void OpenFileCache::_invalidate(const String& path)
+	{
+		MutexLocker lock(&m_lock);
+		m_seqInvalidation++;
+		Entry* entry;
+		if (m_map.get_NoLock(path, &entry)) {
+			_remove(entry);
+		}
+	}
+
+	void OpenFileCache::_invalidateDirectory(const String& directory)
+	{
+		MutexLocker lock(&m_lock);
+		m_seqInvalidation++;
+		Entry* entry = m_first;
+		while (entry) {
+			Entry* next = entry->next;
+			if (entry->directory == directory) {
+				_remove(entry);
+			}
+			entry = next;
+		}
+	}
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+	sl_bool OpenFileCache::_startWatching()
+	{
+		int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (fd < 0) {
+			return sl_false;
+		}
+		m_fdWatch = fd;
+		m_threadWatch = Thread::start(SLIB_FUNCTION_MEMBER(OpenFileCache, _runWatching, this));
+		if (m_threadWatch.isNull()) {
+			close(fd);
+			m_fdWatch = -1;
+			return sl_false;
+		}
+		return sl_true;
+	}
+
+	void OpenFileCache::_stopWatching()
+	{
+		Ref<Thread> thread = m_threadWatch;
+		if (thread.isNotNull()) {
+			thread->finishAndWait();
+			m_threadWatch.setNull();
+		}
+		MutexLocker lock(&m_lockWatch);
+		if (m_fdWatch >= 0) {
+			close(m_fdWatch);
+			m_fdWatch = -1;
+		}
+		m_mapWatchDirectories.removeAll_NoLock();
+		m_mapWatchDescriptors.removeAll_NoLock();
+	}
+
+	sl_bool OpenFileCache::_watch(const String& directory)
+	{
+		MutexLocker lock(&m_lockWatch);
+		if (m_fdWatch < 0) {
+			return sl_false;
+		}
+		if (m_mapWatchDirectories.find_NoLock(directory)) {
+			return sl_true;
+		}
+		if (m_mapWatchDirectories.getCount() >= MAX_WATCH_DIRECTORIES_COUNT) {
+			return sl_false;
+		}
+		int wd = inotify_add_watch(m_fdWatch, directory.getData(), IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+		if (wd < 0) {
+			return sl_false;
+		}
+		List<String> directories;
+		m_mapWatchDescriptors.get_NoLock(wd, &directories);
+		if (directories.isNull()) {
+			directories = List<String>::create();
+		}
+		directories.add_NoLock(directory);
+		m_mapWatchDescriptors.put_NoLock(wd, directories);
+		m_mapWatchDirectories.put_NoLock(directory, wd);
+		return sl_true;
+	}
+
+	void OpenFileCache::_runWatching()
+	{
+		union {
+			inotify_event event;
+			char data[4096];
+		} buf;
+		Ref<Thread> thread = Thread::getCurrent();
+		while (thread.isNull() || thread->isNotStopping()) {
+			pollfd pfd;
+			pfd.fd = m_fdWatch;
+			pfd.events = POLLIN;
+			pfd.revents = 0;
+			if (poll(&pfd, 1, 500) <= 0) {
+				continue;
+			}
+			ssize_t n = read(m_fdWatch, buf.data, sizeof(buf));
+			if (n <= 0) {
+				continue;
+			}
+			char* p = buf.data;
+			char* end = p + n;
+			while (p + sizeof(inotify_event) <= end) {
+				inotify_event* ev = (inotify_event*)p;
+				p += sizeof(inotify_event) + ev->len;
+				if (ev->mask & IN_Q_OVERFLOW) {
+					invalidateAll();
+					continue;
+				}
+				List<String> directories;
+				{
+					MutexLocker lock(&m_lockWatch);
+					m_mapWatchDescriptors.get_NoLock(ev->wd, &directories);
+					if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+						// the paths do not point to the watched directory any more
+						if (ev->mask & IN_MOVE_SELF) {
+							inotify_rm_watch(m_fdWatch, ev->wd);
+						}
+						m_mapWatchDescriptors.remove_NoLock(ev->wd);
+						ListElements<String> items(directories);
+						for (sl_size i = 0; i < items.count; i++) {
+							m_mapWatchDirectories.remove_NoLock(items[i]);
+						}
+					}
+				}
+				ListElements<String> items(directories);
+				for (sl_size i = 0; i < items.count; i++) {
+					if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+						_invalidateDirectory(items[i]);
+					} else if (ev->len) {
+						_invalidate(JoinPath(items[i], ev->name));
+					}
+				}
+			}
+		}
+	}
+#else
+	sl_bool OpenFileCache::_startWatching()
+	{
+		return sl_false;
+	}
+
+	void OpenFileCache::_stopWatching()
+	{
+	}
+
+	sl_bool OpenFileCache::_watch(const String& directory)
+	{
+		return sl_false;
+	}
+
+	void OpenFileCache::_runWatching()
+	{
+	}
+#endif
+
+}
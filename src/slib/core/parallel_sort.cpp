@@ -0,0 +1,118 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+
+#include "slib/core/parallel_sort.h"
+
+#include "slib/core/event.h"
+#include "slib/core/safe_static.h"
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace parallel_sort
+		{
+
+			class TaskGroup : public Referable
+			{
+			public:
+				Function<void(sl_size)> task;
+				sl_reg count;
+				sl_reg indexNext;
+				sl_reg countFinished;
+				Ref<Event> eventFinished;
+
+			public:
+				// returns true when the last task is finished by the caller
+				sl_bool runTasks()
+				{
+					for (;;) {
+						sl_reg index = Base::interlockedIncrement(&indexNext) - 1;
+						if (index >= count) {
+							return sl_false;
+						}
+						task((sl_size)index);
+						if (Base::interlockedIncrement(&countFinished) == count) {
+							eventFinished->set();
+							return sl_true;
+						}
+					}
+				}
+
+			};
+
+			SLIB_SAFE_STATIC_GETTER(Ref<ThreadPool>, GetDefaultThreadPool, ThreadPool::createWorkStealing())
+
+		}
+	}
+
+	using namespace priv::parallel_sort;
+
+	Ref<ThreadPool> ParallelSort::getDefaultThreadPool()
+	{
+		Ref<ThreadPool>* pPool = GetDefaultThreadPool();
+		if (pPool) {
+			return *pPool;
+		}
+		return sl_null;
+	}
+
+	void ParallelSort::run(ThreadPool* pool, sl_size count, const Function<void(sl_size index)>& task)
+	{
+		if (!count) {
+			return;
+		}
+		if (count == 1 || !pool) {
+			for (sl_size i = 0; i < count; i++) {
+				task(i);
+			}
+			return;
+		}
+		Ref<TaskGroup> group = new TaskGroup;
+		Ref<Event> ev = Event::create();
+		if (group.isNull() || ev.isNull()) {
+			for (sl_size i = 0; i < count; i++) {
+				task(i);
+			}
+			return;
+		}
+		group->task = task;
+		group->count = (sl_reg)count;
+		group->indexNext = 0;
+		group->countFinished = 0;
+		group->eventFinished = ev;
+		// the workers starting after all tasks are taken return at once. the group is kept alive until then
+		for (sl_size i = 1; i < count; i++) {
+			if (!(pool->addTask([group]() {
+				group->runTasks();
+			}))) {
+				break;
+			}
+		}
+		if (!(group->runTasks())) {
+			ev->wait();
+		}
+	}
+
+}
@@ -453,6 +453,7 @@ namespace slib
 	GET_API(kernel32, GetQueuedCompletionStatusEx)
 	GET_API(kernel32, GetUserDefaultLocaleName)
 	GET_API(kernel32, GetTickCount64)
+	GET_API(kernel32, PrefetchVirtualMemory)
 
 	LOAD_LIBRARY(user32, "user32.dll")
 	GET_API(user32, ShowScrollBar)
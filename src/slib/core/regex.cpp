@@ -20,60 +20,1887 @@
  *   THE SOFTWARE.
  */
 
+
 #include "slib/core/regex.h"
 
+#include "slib/core/flat_hash_map.h"
+#include "slib/core/mutex.h"
+#include "slib/core/hash.h"
+#include "slib/core/sort.h"
 #include "slib/core/safe_static.h"
 
 #include <regex>
 
 namespace slib
 {
+
+	namespace priv
+	{
+		namespace regex
+		{
+
+			enum {
+				MaxNestingDepth = 256,
+				MaxRepeatCount = 1000,
+				MaxInstructionsCount = 100000,
+				// memory of the cached DFA states. the cache is cleared when it is full
+				DfaMemoryLimit = 2 * 1024 * 1024
+			};
+
+			static const sl_uint32 g_indexNone = 0xFFFFFFFF;
+			static const sl_uint32 g_countInfinite = 0xFFFFFFFF;
+
+			enum AssertKind
+			{
+				AssertBeginText = 1,
+				AssertEndText = 2,
+				AssertWordBoundary = 4,
+				AssertNotWordBoundary = 8
+			};
+
+			enum Opcode
+			{
+				OpBytes = 0, // x: byte set, y: next
+				OpSplit = 1, // x: preferred, y: other
+				OpJump = 2, // x: next
+				OpAssert = 3, // kind: AssertKind, x: next
+				OpMatch = 4 // x: index of the pattern
+			};
+
+			struct Inst
+			{
+				sl_uint8 op;
+				sl_uint8 kind;
+				sl_uint32 x;
+				sl_uint32 y;
+			};
+
+			SLIB_INLINE static sl_bool IsWordByte(sl_uint8 c)
+			{
+				return SLIB_CHAR_IS_C_NAME(c);
+			}
+
+			class ByteSet
+			{
+			public:
+				sl_uint32 bits[8];
+
+			public:
+				void clear()
+				{
+					Base::zeroMemory(bits, sizeof(bits));
+				}
+
+				SLIB_INLINE sl_bool contains(sl_uint8 c) const
+				{
+					return (bits[c >> 5] >> (c & 31)) & 1;
+				}
+
+				SLIB_INLINE void add(sl_uint8 c)
+				{
+					bits[c >> 5] |= (sl_uint32)1 << (c & 31);
+				}
+
+				void addRange(sl_uint32 first, sl_uint32 last)
+				{
+					for (sl_uint32 c = first; c <= last; c++) {
+						add((sl_uint8)c);
+					}
+				}
+
+				void addSet(const ByteSet& other)
+				{
+					for (sl_uint32 i = 0; i < 8; i++) {
+						bits[i] |= other.bits[i];
+					}
+				}
+
+				void invert()
+				{
+					for (sl_uint32 i = 0; i < 8; i++) {
+						bits[i] = ~(bits[i]);
+					}
+				}
+
+				void foldCase()
+				{
+					for (sl_uint32 c = 'A'; c <= 'Z'; c++) {
+						if (contains((sl_uint8)c) || contains((sl_uint8)(c + 32))) {
+							add((sl_uint8)c);
+							add((sl_uint8)(c + 32));
+						}
+					}
+				}
+
+				// returns the byte if the set has only one byte, otherwise -1
+				sl_int32 getSingle() const
+				{
+					sl_int32 ret = -1;
+					for (sl_uint32 i = 0; i < 8; i++) {
+						sl_uint32 n = bits[i];
+						if (n) {
+							if (ret >= 0 || (n & (n - 1))) {
+								return -1;
+							}
+							sl_uint32 k = 0;
+							while (!(n & 1)) {
+								n >>= 1;
+								k++;
+							}
+							ret = (sl_int32)((i << 5) + k);
+						}
+					}
+					return ret;
+				}
+
+			};
+
+			static void GetClassSet(sl_uint8 type, ByteSet& set)
+			{
+				set.clear();
+				switch (type) {
+					case 'd':
+					case 'D':
+						set.addRange('0', '9');
+						break;
+					case 'w':
+					case 'W':
+						set.addRange('0', '9');
+						set.addRange('A', 'Z');
+						set.addRange('a', 'z');
+						set.add('_');
+						break;
+					case 's':
+					case 'S':
+						set.add(' ');
+						set.addRange('\t', '\r');
+						break;
+				}
+				if (type == 'D' || type == 'W' || type == 'S') {
+					set.invert();
+				}
+			}
+
+			static sl_bool GetPosixClassSet(const sl_uint8* name, sl_size len, ByteSet& set)
+			{
+				set.clear();
+				String s((const sl_char8*)name, len);
+				if (s == "alnum") {
+					set.addRange('0', '9');
+					set.addRange('A', 'Z');
+					set.addRange('a', 'z');
+				} else if (s == "alpha") {
+					set.addRange('A', 'Z');
+					set.addRange('a', 'z');
+				} else if (s == "blank") {
+					set.add(' ');
+					set.add('\t');
+				} else if (s == "cntrl") {
+					set.addRange(0, 31);
+					set.add(127);
+				} else if (s == "digit" || s == "d") {
+					set.addRange('0', '9');
+				} else if (s == "graph") {
+					set.addRange(33, 126);
+				} else if (s == "lower") {
+					set.addRange('a', 'z');
+				} else if (s == "print") {
+					set.addRange(32, 126);
+				} else if (s == "punct") {
+					set.addRange(33, 47);
+					set.addRange(58, 64);
+					set.addRange(91, 96);
+					set.addRange(123, 126);
+				} else if (s == "space" || s == "s") {
+					set.add(' ');
+					set.addRange('\t', '\r');
+				} else if (s == "upper") {
+					set.addRange('A', 'Z');
+				} else if (s == "xdigit") {
+					set.addRange('0', '9');
+					set.addRange('A', 'F');
+					set.addRange('a', 'f');
+				} else if (s == "w") {
+					GetClassSet('w', set);
+				} else {
+					return sl_false;
+				}
+				return sl_true;
+			}
+
+			enum class NodeType
+			{
+				Empty,
+				Bytes,
+				Concat,
+				Alternate,
+				Repeat,
+				Assert
+			};
+
+			struct Node
+			{
+				NodeType type;
+				// Bytes: index of the byte set, Assert: AssertKind
+				sl_uint32 value;
+				// first child of Concat, Alternate and Repeat
+				sl_uint32 child;
+				// next child of the parent
+				sl_uint32 sibling;
+				sl_uint32 countMin;
+				sl_uint32 countMax;
+				sl_bool flagGreedy;
+			};
+
+			class Program
+			{
+			public:
+				List<Inst> insts;
+				List<ByteSet> sets;
+				sl_uint32 startAnchored;
+				sl_uint32 startUnanchored;
+				sl_uint32 countPatterns;
+				// AssertKind bits used by the instructions
+				sl_uint32 asserts;
+
+				sl_uint8 byteClasses[256];
+				sl_uint32 countByteClasses;
+
+				// bytes every match starts with
+				String prefix;
+				// the pattern matches the prefix only
+				sl_bool flagLiteral;
+
+			public:
+				Program()
+				{
+					startAnchored = 0;
+					startUnanchored = 0;
+					countPatterns = 0;
+					asserts = 0;
+					countByteClasses = 0;
+					flagLiteral = sl_false;
+				}
+
+			};
+
+			class Compiler
+			{
+			public:
+				Program* program;
+				List<Node> nodes;
+				sl_bool flagIcase;
+				// index of the byte set matching a single byte
+				sl_uint32 setsOfByte[256];
+
+				// parser state
+				const sl_uint8* current;
+				const sl_uint8* end;
+				sl_uint32 depth;
+
+			public:
+				Compiler(Program* _program, sl_bool _flagIcase): program(_program), flagIcase(_flagIcase)
+				{
+					for (sl_uint32 i = 0; i < 256; i++) {
+						setsOfByte[i] = g_indexNone;
+					}
+					current = sl_null;
+					end = sl_null;
+					depth = 0;
+				}
+
+			public:
+				sl_uint32 addNode(NodeType type, sl_uint32 value = 0)
+				{
+					Node node;
+					node.type = type;
+					node.value = value;
+					node.child = g_indexNone;
+					node.sibling = g_indexNone;
+					node.countMin = 0;
+					node.countMax = 0;
+					node.flagGreedy = sl_true;
+					sl_uint32 index = (sl_uint32)(nodes.getCount());
+					if (!(nodes.add_NoLock(node))) {
+						return g_indexNone;
+					}
+					return index;
+				}
+
+				sl_uint32 addSet(ByteSet& set)
+				{
+					if (flagIcase) {
+						set.foldCase();
+					}
+					sl_int32 single = set.getSingle();
+					if (single >= 0) {
+						sl_uint32 index = setsOfByte[single];
+						if (index != g_indexNone) {
+							return index;
+						}
+					}
+					sl_uint32 index = (sl_uint32)(program->sets.getCount());
+					if (!(program->sets.add_NoLock(set))) {
+						return g_indexNone;
+					}
+					if (single >= 0) {
+						setsOfByte[single] = index;
+					}
+					return index;
+				}
+
+				sl_uint32 addBytesNode(ByteSet& set)
+				{
+					sl_uint32 index = addSet(set);
+					if (index == g_indexNone) {
+						return g_indexNone;
+					}
+					return addNode(NodeType::Bytes, index);
+				}
+
+				sl_uint32 addByteNode(sl_uint8 c)
+				{
+					ByteSet set;
+					set.clear();
+					set.add(c);
+					return addBytesNode(set);
+				}
+
+				Node& getNode(sl_uint32 index)
+				{
+					return nodes.getData()[index];
+				}
+
+			public:
+				// returns g_indexNone on syntax errors and the unsupported features
+				sl_uint32 parse(const String& pattern)
+				{
+					current = (const sl_uint8*)(pattern.getData());
+					end = current + pattern.getLength();
+					depth = 0;
+					sl_uint32 node = parseAlternate();
+					if (node == g_indexNone || current != end) {
+						return g_indexNone;
+					}
+					return node;
+				}
+
+				sl_uint32 parseAlternate()
+				{
+					if (depth >= MaxNestingDepth) {
+						return g_indexNone;
+					}
+					depth++;
+					sl_uint32 first = parseConcat();
+					if (first == g_indexNone) {
+						return g_indexNone;
+					}
+					sl_uint32 ret = first;
+					if (current < end && *current == '|') {
+						ret = addNode(NodeType::Alternate);
+						if (ret == g_indexNone) {
+							return g_indexNone;
+						}
+						getNode(ret).child = first;
+						sl_uint32 last = first;
+						while (current < end && *current == '|') {
+							current++;
+							sl_uint32 node = parseConcat();
+							if (node == g_indexNone) {
+								return g_indexNone;
+							}
+							getNode(last).sibling = node;
+							last = node;
+						}
+					}
+					depth--;
+					return ret;
+				}
+
+				sl_uint32 parseConcat()
+				{
+					sl_uint32 first = g_indexNone;
+					sl_uint32 last = g_indexNone;
+					sl_uint32 count = 0;
+					while (current < end && *current != '|' && *current != ')') {
+						sl_uint32 node = parseRepeat();
+						if (node == g_indexNone) {
+							return g_indexNone;
+						}
+						if (last == g_indexNone) {
+							first = node;
+						} else {
+							getNode(last).sibling = node;
+						}
+						last = node;
+						count++;
+					}
+					if (!count) {
+						return addNode(NodeType::Empty);
+					}
+					if (count == 1) {
+						return first;
+					}
+					sl_uint32 ret = addNode(NodeType::Concat);
+					if (ret == g_indexNone) {
+						return g_indexNone;
+					}
+					getNode(ret).child = first;
+					return ret;
+				}
+
+				sl_bool parseNumber(sl_uint32& _out)
+				{
+					sl_uint32 n = 0;
+					const sl_uint8* start = current;
+					while (current < end && SLIB_CHAR_IS_DIGIT(*current)) {
+						n = n * 10 + (*current - '0');
+						if (n > MaxRepeatCount) {
+							return sl_false;
+						}
+						current++;
+					}
+					_out = n;
+					return current != start;
+				}
+
+				sl_uint32 parseRepeat()
+				{
+					sl_bool flagGroup = *current == '(';
+					sl_uint32 atom = parseAtom();
+					if (atom == g_indexNone) {
+						return g_indexNone;
+					}
+					while (current < end) {
+						sl_uint32 countMin, countMax;
+						sl_uint8 c = *current;
+						if (c == '*') {
+							countMin = 0;
+							countMax = g_countInfinite;
+							current++;
+						} else if (c == '+') {
+							countMin = 1;
+							countMax = g_countInfinite;
+							current++;
+						} else if (c == '?') {
+							countMin = 0;
+							countMax = 1;
+							current++;
+						} else if (c == '{') {
+							current++;
+							if (!(parseNumber(countMin))) {
+								return g_indexNone;
+							}
+							if (current < end && *current == ',') {
+								current++;
+								if (current < end && *current == '}') {
+									countMax = g_countInfinite;
+								} else {
+									if (!(parseNumber(countMax))) {
+										return g_indexNone;
+									}
+									if (countMax < countMin) {
+										return g_indexNone;
+									}
+								}
+							} else {
+								countMax = countMin;
+							}
+							if (current >= end || *current != '}') {
+								return g_indexNone;
+							}
+							current++;
+						} else {
+							break;
+						}
+						sl_bool flagGreedy = sl_true;
+						if (current < end && *current == '?') {
+							flagGreedy = sl_false;
+							current++;
+						}
+						// the assertions can be quantified only in a group
+						if (!flagGroup && getNode(atom).type == NodeType::Assert) {
+							return g_indexNone;
+						}
+						sl_uint32 node = addNode(NodeType::Repeat);
+						if (node == g_indexNone) {
+							return g_indexNone;
+						}
+						Node& n = getNode(node);
+						n.child = atom;
+						n.countMin = countMin;
+						n.countMax = countMax;
+						n.flagGreedy = flagGreedy;
+						atom = node;
+					}
+					return atom;
+				}
+
+				sl_uint32 parseAtom()
+				{
+					sl_uint8 c = *current;
+					switch (c) {
+						case '(':
+							{
+								current++;
+								if (current < end && *current == '?') {
+									// only non-capturing groups. look-arounds are not supported
+									if (current + 1 < end && current[1] == ':') {
+										current += 2;
+									} else {
+										return g_indexNone;
+									}
+								}
+								sl_uint32 node = parseAlternate();
+								if (node == g_indexNone) {
+									return g_indexNone;
+								}
+								if (current >= end || *current != ')') {
+									return g_indexNone;
+								}
+								current++;
+								return node;
+							}
+						case '[':
+							current++;
+							return parseClass();
+						case '.':
+							{
+								current++;
+								ByteSet set;
+								set.clear();
+								set.add('\n');
+								set.add('\r');
+								set.invert();
+								return addBytesNode(set);
+							}
+						case '^':
+							current++;
+							program->asserts |= AssertBeginText;
+							return addNode(NodeType::Assert, AssertBeginText);
+						case '$':
+							current++;
+							program->asserts |= AssertEndText;
+							return addNode(NodeType::Assert, AssertEndText);
+						case '\\':
+							{
+								current++;
+								if (current >= end) {
+									return g_indexNone;
+								}
+								c = *current;
+								if (c == 'b' || c == 'B') {
+									current++;
+									sl_uint32 kind = c == 'b' ? AssertWordBoundary : AssertNotWordBoundary;
+									program->asserts |= kind;
+									return addNode(NodeType::Assert, kind);
+								}
+								ByteSet set;
+								if (!(parseEscape(set, sl_false))) {
+									return g_indexNone;
+								}
+								return addBytesNode(set);
+							}
+						case '*':
+						case '+':
+						case '?':
+						case '{':
+						case ')':
+							return g_indexNone;
+						default:
+							current++;
+							return addByteNode(c);
+					}
+				}
+
+				sl_bool parseHex(sl_uint32 nDigits, sl_uint32& _out)
+				{
+					if (current + nDigits > end) {
+						return sl_false;
+					}
+					sl_uint32 n = 0;
+					for (sl_uint32 i = 0; i < nDigits; i++) {
+						sl_uint32 h = SLIB_CHAR_HEX_TO_INT(current[i]);
+						if (h >= 16) {
+							return sl_false;
+						}
+						n = (n << 4) | h;
+					}
+					current += nDigits;
+					_out = n;
+					return sl_true;
+				}
+
+				// `current` is after the backslash
+				sl_bool parseEscape(ByteSet& set, sl_bool flagInClass)
+				{
+					sl_uint8 c = *(current++);
+					set.clear();
+					switch (c) {
+						case 'd':
+						case 'D':
+						case 'w':
+						case 'W':
+						case 's':
+						case 'S':
+							GetClassSet(c, set);
+							return sl_true;
+						case 't':
+							c = '\t';
+							break;
+						case 'n':
+							c = '\n';
+							break;
+						case 'v':
+							c = '\v';
+							break;
+						case 'f':
+							c = '\f';
+							break;
+						case 'r':
+							c = '\r';
+							break;
+						case 'b':
+							// backspace in a class
+							c = '\b';
+							break;
+						case '0':
+							if (current < end && SLIB_CHAR_IS_DIGIT(*current)) {
+								return sl_false;
+							}
+							c = 0;
+							break;
+						case 'c':
+							if (current >= end || !(SLIB_CHAR_IS_ALPHA(*current))) {
+								return sl_false;
+							}
+							c = *(current++) % 32;
+							break;
+						case 'x':
+						case 'u':
+							{
+								sl_uint32 n;
+								if (!(parseHex(c == 'x' ? 2 : 4, n))) {
+									return sl_false;
+								}
+								// the code points above 0x7f are encoded as multiple bytes, which does not fit in a byte set
+								if (n > 0x7f) {
+									return sl_false;
+								}
+								c = (sl_uint8)n;
+								break;
+							}
+						default:
+							// back-references
+							if (c >= '1' && c <= '9') {
+								return sl_false;
+							}
+							if (c == 'B' && flagInClass) {
+								return sl_false;
+							}
+							break;
+					}
+					set.add(c);
+					return sl_true;
+				}
+
+				// `current` is after '['
+				sl_uint32 parseClass()
+				{
+					ByteSet set;
+					set.clear();
+					sl_bool flagNegative = sl_false;
+					if (current < end && *current == '^') {
+						flagNegative = sl_true;
+						current++;
+					}
+					for (;;) {
+						if (current >= end) {
+							return g_indexNone;
+						}
+						sl_uint8 c = *current;
+						if (c == ']') {
+							current++;
+							break;
+						}
+						sl_int32 first;
+						ByteSet item;
+						if (!(parseClassItem(item, first))) {
+							return g_indexNone;
+						}
+						if (first >= 0 && current + 1 < end && *current == '-' && current[1] != ']') {
+							current++;
+							sl_int32 last;
+							if (!(parseClassItem(item, last))) {
+								return g_indexNone;
+							}
+							if (last < first) {
+								return g_indexNone;
+							}
+							set.addRange((sl_uint32)first, (sl_uint32)last);
+						} else {
+							set.addSet(item);
+						}
+					}
+					if (flagIcase) {
+						set.foldCase();
+					}
+					if (flagNegative) {
+						set.invert();
+					}
+					return addBytesNode(set);
+				}
+
+				// `outSingle` is the byte if the item is a single byte, otherwise -1
+				sl_bool parseClassItem(ByteSet& set, sl_int32& outSingle)
+				{
+					outSingle = -1;
+					sl_uint8 c = *current;
+					if (c == '\\') {
+						current++;
+						if (current >= end) {
+							return sl_false;
+						}
+						if (!(parseEscape(set, sl_true))) {
+							return sl_false;
+						}
+						outSingle = set.getSingle();
+						return sl_true;
+					}
+					if (c == '[' && current + 1 < end && current[1] == ':') {
+						const sl_uint8* name = current + 2;
+						const sl_uint8* p = name;
+						while (p + 1 < end && !(p[0] == ':' && p[1] == ']')) {
+							p++;
+						}
+						if (p + 1 >= end) {
+							return sl_false;
+						}
+						if (!(GetPosixClassSet(name, p - name, set))) {
+							return sl_false;
+						}
+						current = p + 2;
+						return sl_true;
+					}
+					if (c == '[' && current + 1 < end && (current[1] == '.' || current[1] == '=')) {
+						// collating elements and equivalence classes
+						return sl_false;
+					}
+					current++;
+					set.clear();
+					set.add(c);
+					outSingle = c;
+					return sl_true;
+				}
+
+			public:
+				sl_uint32 emit(sl_uint8 op, sl_uint32 x, sl_uint32 y = 0, sl_uint8 kind = 0)
+				{
+					sl_uint32 index = (sl_uint32)(program->insts.getCount());
+					if (index >= MaxInstructionsCount) {
+						return g_indexNone;
+					}
+					Inst inst;
+					inst.op = op;
+					inst.kind = kind;
+					inst.x = x;
+					inst.y = y;
+					if (!(program->insts.add_NoLock(inst))) {
+						return g_indexNone;
+					}
+					return index;
+				}
+
+				Inst& getInst(sl_uint32 index)
+				{
+					return program->insts.getData()[index];
+				}
+
+				// returns the entry of the instructions matching `node` and continuing to `next`
+				sl_uint32 compile(sl_uint32 index, sl_uint32 next)
+				{
+					Node& node = getNode(index);
+					switch (node.type) {
+						case NodeType::Empty:
+							return next;
+						case NodeType::Bytes:
+							return emit(OpBytes, node.value, next);
+						case NodeType::Assert:
+							return emit(OpAssert, next, 0, (sl_uint8)(node.value));
+						case NodeType::Concat:
+							{
+								List<sl_uint32> children;
+								sl_uint32 child = node.child;
+								while (child != g_indexNone) {
+									if (!(children.add_NoLock(child))) {
+										return g_indexNone;
+									}
+									child = getNode(child).sibling;
+								}
+								sl_uint32* p = children.getData();
+								sl_size n = children.getCount();
+								while (n) {
+									n--;
+									next = compile(p[n], next);
+									if (next == g_indexNone) {
+										return g_indexNone;
+									}
+								}
+								return next;
+							}
+						case NodeType::Alternate:
+							{
+								sl_uint32 first = g_indexNone;
+								sl_uint32 lastSplit = g_indexNone;
+								sl_uint32 child = node.child;
+								while (child != g_indexNone) {
+									sl_uint32 entry = compile(child, next);
+									if (entry == g_indexNone) {
+										return g_indexNone;
+									}
+									child = getNode(child).sibling;
+									if (child != g_indexNone) {
+										sl_uint32 split = emit(OpSplit, entry, g_indexNone);
+										if (split == g_indexNone) {
+											return g_indexNone;
+										}
+										entry = split;
+									}
+									if (lastSplit == g_indexNone) {
+										first = entry;
+									} else {
+										getInst(lastSplit).y = entry;
+									}
+									lastSplit = entry;
+								}
+								return first;
+							}
+						case NodeType::Repeat:
+							{
+								sl_uint32 child = node.child;
+								sl_uint32 countMin = node.countMin;
+								sl_uint32 countMax = node.countMax;
+								sl_bool flagGreedy = node.flagGreedy;
+								sl_uint32 entry;
+								sl_uint32 i;
+								if (countMax == g_countInfinite) {
+									sl_uint32 loop = emit(OpSplit, 0, 0);
+									if (loop == g_indexNone) {
+										return g_indexNone;
+									}
+									sl_uint32 body = compile(child, loop);
+									if (body == g_indexNone) {
+										return g_indexNone;
+									}
+									Inst& inst = getInst(loop);
+									if (flagGreedy) {
+										inst.x = body;
+										inst.y = next;
+									} else {
+										inst.x = next;
+										inst.y = body;
+									}
+									if (countMin) {
+										// x{n,} is x{n-1} followed by x+
+										entry = body;
+										countMin--;
+									} else {
+										entry = loop;
+									}
+								} else {
+									entry = next;
+									for (i = countMin; i < countMax; i++) {
+										sl_uint32 body = compile(child, entry);
+										if (body == g_indexNone) {
+											return g_indexNone;
+										}
+										entry = flagGreedy ? emit(OpSplit, body, next) : emit(OpSplit, next, body);
+										if (entry == g_indexNone) {
+											return g_indexNone;
+										}
+									}
+								}
+								for (i = 0; i < countMin; i++) {
+									entry = compile(child, entry);
+									if (entry == g_indexNone) {
+										return g_indexNone;
+									}
+								}
+								return entry;
+							}
+					}
+					return g_indexNone;
+				}
+
+				// the literal bytes every match starts with
+				void findPrefix(sl_uint32 root)
+				{
+					List<sl_char8> bytes;
+					sl_bool flagLiteral = sl_true;
+					sl_uint32 node = root;
+					if (getNode(root).type == NodeType::Concat) {
+						node = getNode(root).child;
+					}
+					while (node != g_indexNone) {
+						Node& n = getNode(node);
+						if (n.type == NodeType::Assert && bytes.isEmpty()) {
+							// leading assertions do not consume bytes
+							flagLiteral = sl_false;
+						} else if (n.type == NodeType::Bytes) {
+							sl_int32 c = program->sets.getData()[n.value].getSingle();
+							if (c < 0) {
+								flagLiteral = sl_false;
+								break;
+							}
+							bytes.add_NoLock((sl_char8)c);
+						} else {
+							flagLiteral = sl_false;
+							break;
+						}
+						if (node == root) {
+							break;
+						}
+						node = n.sibling;
+					}
+					program->prefix = String(bytes.getData(), bytes.getCount());
+					program->flagLiteral = flagLiteral && program->prefix.isNotEmpty();
+				}
+
+				void computeByteClasses()
+				{
+					sl_uint8* classes = program->byteClasses;
+					Base::zeroMemory(classes, 256);
+					sl_uint32 nClasses = 1;
+					sl_uint32 nSets = (sl_uint32)(program->sets.getCount());
+					ByteSet* sets = program->sets.getData();
+					ByteSet setWord;
+					GetClassSet('w', setWord);
+					sl_bool flagWord = (program->asserts & (AssertWordBoundary | AssertNotWordBoundary)) != 0;
+					for (sl_uint32 i = 0; i <= nSets; i++) {
+						ByteSet* set;
+						if (i < nSets) {
+							set = sets + i;
+						} else if (flagWord) {
+							set = &setWord;
+						} else {
+							break;
+						}
+						// splits the classes by the membership, then renumbers them in the order of the first byte
+						sl_uint32 split[512];
+						sl_uint32 k;
+						for (k = 0; k < nClasses; k++) {
+							split[k] = g_indexNone;
+						}
+						sl_uint32 classesTemp[256];
+						sl_uint32 n = nClasses;
+						for (k = 0; k < 256; k++) {
+							sl_uint32 c = classes[k];
+							if (set->contains((sl_uint8)k)) {
+								if (split[c] == g_indexNone) {
+									split[c] = n++;
+								}
+								classesTemp[k] = split[c];
+							} else {
+								classesTemp[k] = c;
+							}
+						}
+						sl_uint32 renumber[512];
+						for (k = 0; k < n; k++) {
+							renumber[k] = g_indexNone;
+						}
+						nClasses = 0;
+						for (k = 0; k < 256; k++) {
+							sl_uint32 c = classesTemp[k];
+							if (renumber[c] == g_indexNone) {
+								renumber[c] = nClasses++;
+							}
+							classes[k] = (sl_uint8)(renumber[c]);
+						}
+					}
+					program->countByteClasses = nClasses;
+				}
+
+			};
+
+			static Program* CompileProgram(const String* patterns, sl_uint32 nPatterns, sl_uint32 flags)
+			{
+				if (flags & ~(RegExFlags::Icase | RegExFlags::Nosubs | RegExFlags::Optimize | RegExFlags::ECMAScript)) {
+					return sl_null;
+				}
+				Program* program = new Program;
+				if (!program) {
+					return sl_null;
+				}
+				Compiler compiler(program, (flags & RegExFlags::Icase) != 0);
+				sl_uint32 start = g_indexNone;
+				sl_uint32 rootFirst = g_indexNone;
+				for (sl_uint32 i = 0; i < nPatterns; i++) {
+					sl_uint32 root = compiler.parse(patterns[i]);
+					if (root == g_indexNone) {
+						delete program;
+						return sl_null;
+					}
+					if (!i) {
+						rootFirst = root;
+					}
+					sl_uint32 match = compiler.emit(OpMatch, i);
+					sl_uint32 entry = g_indexNone;
+					if (match != g_indexNone) {
+						entry = compiler.compile(root, match);
+					}
+					if (entry == g_indexNone) {
+						delete program;
+						return sl_null;
+					}
+					if (i) {
+						start = compiler.emit(OpSplit, start, entry);
+						if (start == g_indexNone) {
+							delete program;
+							return sl_null;
+						}
+					} else {
+						start = entry;
+					}
+				}
+				// unanchored entry: tries the pattern at every position
+				sl_uint32 any = (sl_uint32)(program->sets.getCount());
+				ByteSet setAny;
+				setAny.clear();
+				setAny.invert();
+				if (!(program->sets.add_NoLock(setAny))) {
+					delete program;
+					return sl_null;
+				}
+				sl_uint32 skip = compiler.emit(OpBytes, any, 0);
+				sl_uint32 loop = g_indexNone;
+				if (skip != g_indexNone) {
+					loop = compiler.emit(OpSplit, start, skip);
+				}
+				if (loop == g_indexNone) {
+					delete program;
+					return sl_null;
+				}
+				compiler.getInst(skip).y = loop;
+				program->startAnchored = start;
+				program->startUnanchored = loop;
+				program->countPatterns = nPatterns;
+				if (nPatterns == 1) {
+					compiler.findPrefix(rootFirst);
+				}
+				compiler.computeByteClasses();
+				return program;
+			}
+
+			// finds `pattern` in `text`
+			static const sl_uint8* FindBytes(const sl_uint8* text, sl_size n, const sl_uint8* pattern, sl_size len)
+			{
+				if (len > n) {
+					return sl_null;
+				}
+				const sl_uint8* last = text + (n - len);
+				sl_uint8 first = pattern[0];
+				while (text <= last) {
+					text = Base::findMemory(text, first, last - text + 1);
+					if (!text) {
+						return sl_null;
+					}
+					if (Base::equalsMemory(text + 1, pattern + 1, len - 1)) {
+						return text;
+					}
+					text++;
+				}
+				return sl_null;
+			}
+
+			static sl_bool CheckAssert(sl_uint32 kind, const sl_uint8* text, sl_size n, sl_size pos, sl_uint32 flags)
+			{
+				switch (kind) {
+					case AssertBeginText:
+						return !pos && !(flags & RegExMatchFlags::NotBol);
+					case AssertEndText:
+						return pos == n && !(flags & RegExMatchFlags::NotEol);
+					default:
+						{
+							sl_bool flagBoundary;
+							if ((!pos && (flags & RegExMatchFlags::NotBow)) || (pos == n && (flags & RegExMatchFlags::NotEow))) {
+								flagBoundary = sl_false;
+							} else {
+								sl_bool flagPrev = pos && IsWordByte(text[pos - 1]);
+								sl_bool flagNext = pos < n && IsWordByte(text[pos]);
+								flagBoundary = flagPrev != flagNext;
+							}
+							if (kind == AssertWordBoundary) {
+								return flagBoundary;
+							} else {
+								return !flagBoundary;
+							}
+						}
+				}
+			}
+
+			class SparseSet
+			{
+			public:
+				sl_uint32* dense;
+				sl_uint32* sparse;
+				sl_uint32 count;
+
+			public:
+				SparseSet(): dense(sl_null), sparse(sl_null), count(0) {}
+
+				~SparseSet()
+				{
+					if (dense) {
+						Base::freeMemory(dense);
+					}
+					if (sparse) {
+						Base::freeMemory(sparse);
+					}
+				}
+
+			public:
+				sl_bool init(sl_uint32 size)
+				{
+					dense = (sl_uint32*)(Base::createMemory(size * sizeof(sl_uint32)));
+					sparse = (sl_uint32*)(Base::createZeroMemory(size * sizeof(sl_uint32)));
+					return dense && sparse;
+				}
+
+				SLIB_INLINE sl_bool contains(sl_uint32 value) const
+				{
+					sl_uint32 i = sparse[value];
+					return i < count && dense[i] == value;
+				}
+
+				// returns false if the value already exists
+				SLIB_INLINE sl_bool add(sl_uint32 value)
+				{
+					if (contains(value)) {
+						return sl_false;
+					}
+					sparse[value] = count;
+					dense[count++] = value;
+					return sl_true;
+				}
+
+				SLIB_INLINE void clear()
+				{
+					count = 0;
+				}
+
+			};
+
+			/*
+				Pike VM: simulates the NFA with a thread per instruction, kept in the order of the priority.
+				Reports the leftmost match, and among the matches at that position the one preferred by the alternatives and the quantifiers.
+			*/
+			class PikeVM
+			{
+			public:
+				struct Thread
+				{
+					sl_uint32 pc;
+					sl_size start;
+				};
+
+				struct ThreadList
+				{
+					SparseSet set;
+					Thread* threads;
+				};
+
+			public:
+				const Program* program;
+				const Inst* insts;
+				const ByteSet* sets;
+				const sl_uint8* text;
+				sl_size len;
+				sl_uint32 flags;
+				ThreadList lists[2];
+				sl_uint32* stack;
+				Thread* threads;
+
+			public:
+				PikeVM(const Program* _program): program(_program)
+				{
+					insts = program->insts.getData();
+					sets = program->sets.getData();
+					text = sl_null;
+					len = 0;
+					flags = 0;
+					stack = sl_null;
+					threads = sl_null;
+				}
+
+				~PikeVM()
+				{
+					if (stack) {
+						Base::freeMemory(stack);
+					}
+					if (threads) {
+						Base::freeMemory(threads);
+					}
+				}
+
+			public:
+				sl_bool init()
+				{
+					sl_uint32 n = (sl_uint32)(program->insts.getCount());
+					if (!(lists[0].set.init(n)) || !(lists[1].set.init(n))) {
+						return sl_false;
+					}
+					threads = (Thread*)(Base::createMemory(sizeof(Thread) * n * 2));
+					if (!threads) {
+						return sl_false;
+					}
+					lists[0].threads = threads;
+					lists[1].threads = threads + n;
+					stack = (sl_uint32*)(Base::createMemory(sizeof(sl_uint32) * (n * 2 + 1)));
+					return stack != sl_null;
+				}
+
+				void addThread(ThreadList& list, sl_uint32 pc, sl_size start, sl_size pos)
+				{
+					sl_uint32 nStack = 0;
+					stack[nStack++] = pc;
+					while (nStack) {
+						pc = stack[--nStack];
+						if (!(list.set.add(pc))) {
+							continue;
+						}
+						Thread& thread = list.threads[list.set.count - 1];
+						thread.pc = pc;
+						thread.start = start;
+						const Inst& inst = insts[pc];
+						switch (inst.op) {
+							case OpJump:
+								stack[nStack++] = inst.x;
+								break;
+							case OpSplit:
+								stack[nStack++] = inst.y;
+								stack[nStack++] = inst.x;
+								break;
+							case OpAssert:
+								if (CheckAssert(inst.kind, text, len, pos, flags)) {
+									stack[nStack++] = inst.x;
+								}
+								break;
+						}
+					}
+				}
+
+				sl_bool search(const sl_uint8* _text, sl_size _len, sl_uint32 _flags, sl_bool flagAnchored, sl_size* outStart, sl_size* outEnd)
+				{
+					text = _text;
+					len = _len;
+					flags = _flags;
+					sl_bool flagNotNull = (flags & RegExMatchFlags::NotNull) != 0;
+					const sl_uint8* prefix = (const sl_uint8*)(program->prefix.getData());
+					sl_size lenPrefix = program->prefix.getLength();
+					sl_uint32 start = program->startAnchored;
+					ThreadList* current = lists;
+					ThreadList* next = lists + 1;
+					current->set.clear();
+					sl_bool flagMatched = sl_false;
+					sl_size matchStart = 0;
+					sl_size matchEnd = 0;
+					sl_size pos = 0;
+					for (;;) {
+						if (!flagMatched && (!pos || !flagAnchored)) {
+							if (!flagAnchored && !(current->set.count) && lenPrefix && pos < len) {
+								const sl_uint8* p = FindBytes(text + pos, len - pos, prefix, lenPrefix);
+								if (!p) {
+									break;
+								}
+								pos = p - text;
+							}
+							addThread(*current, start, pos, pos);
+						}
+						if (!(current->set.count)) {
+							break;
+						}
+						next->set.clear();
+						sl_uint32 n = current->set.count;
+						for (sl_uint32 i = 0; i < n; i++) {
+							Thread& thread = current->threads[i];
+							const Inst& inst = insts[thread.pc];
+							if (inst.op == OpMatch) {
+								if (!flagNotNull || pos > thread.start) {
+									flagMatched = sl_true;
+									matchStart = thread.start;
+									matchEnd = pos;
+									// the threads of the lower priority are cut off
+									break;
+								}
+							} else if (inst.op == OpBytes) {
+								if (pos < len && sets[inst.x].contains(text[pos])) {
+									addThread(*next, inst.y, thread.start, pos + 1);
+								}
+							}
+						}
+						if (pos >= len) {
+							break;
+						}
+						pos++;
+						ThreadList* t = current;
+						current = next;
+						next = t;
+					}
+					if (flagMatched) {
+						if (outStart) {
+							*outStart = matchStart;
+						}
+						if (outEnd) {
+							*outEnd = matchEnd;
+						}
+					}
+					return flagMatched;
+				}
+
+			};
+
+			enum DfaStateFlags
+			{
+				DfaStateBeginText = 1,
+				DfaStatePrevWord = 2,
+				DfaStateNoBoundary = 4
+			};
+
+			struct DfaState
+			{
+				sl_uint32 flags;
+				sl_uint32 countInsts;
+				// sorted instructions: byte sets, matches, and the assertions waiting for the next byte
+				sl_uint32* insts;
+				// same instructions as the unanchored start state
+				sl_bool flagStart;
+				// by the byte class. null means not computed yet
+				DfaState* next[1];
+			};
+
+			static DfaState* const g_stateDead = (DfaState*)(sl_size)1;
+			static DfaState* const g_stateMatch = (DfaState*)(sl_size)2;
+
+			struct DfaStateKey
+			{
+				const sl_uint32* insts;
+				sl_uint32 countInsts;
+				sl_uint32 flags;
+			};
+
+			class DfaStateKeyHash
+			{
+			public:
+				sl_size operator()(const DfaStateKey& key) const noexcept
+				{
+					return HashBytes(key.insts, key.countInsts * sizeof(sl_uint32)) ^ (sl_size)(key.flags * 0x9E3779B9);
+				}
+			};
+
+			class DfaStateKeyEquals
+			{
+			public:
+				sl_bool operator()(const DfaStateKey& a, const DfaStateKey& b) const noexcept
+				{
+					return a.flags == b.flags && a.countInsts == b.countInsts && Base::equalsMemory(a.insts, b.insts, a.countInsts * sizeof(sl_uint32));
+				}
+			};
+
+			/*
+				Lazily built DFA. A state is the set of the NFA instructions the threads are waiting at.
+				The empty-width assertions are resolved when the next byte is known, so the states also keep whether the previous byte is a word character.
+			*/
+			class Dfa
+			{
+			public:
+				const Program* program;
+				const Inst* insts;
+				const ByteSet* sets;
+				sl_uint32 start;
+				// stops at the first position where a match ends
+				sl_bool flagEarlyMatch;
+				// the matched patterns are kept in the states until the end of the text
+				sl_bool flagPersistentMatch;
+				// skips to the next prefix when the state is same as the start state
+				sl_bool flagUsePrefix;
+				sl_uint32 maskFlags;
+
+				Mutex lock;
+				FlatHashMap<DfaStateKey, DfaState*, DfaStateKeyHash, DfaStateKeyEquals> states;
+				sl_size sizeStates;
+				DfaState* startStates[8];
+
+				SparseSet visited;
+				sl_uint32* stack;
+				sl_uint32* leaves;
+				sl_uint32* buf;
+				sl_uint32* startInsts;
+				sl_uint32 countStartInsts;
+
+			public:
+				Dfa(const Program* _program, sl_uint32 _start, sl_bool _flagEarlyMatch, sl_bool _flagPersistentMatch, sl_bool _flagUsePrefix): program(_program), start(_start), flagEarlyMatch(_flagEarlyMatch), flagPersistentMatch(_flagPersistentMatch)
+				{
+					insts = program->insts.getData();
+					sets = program->sets.getData();
+					flagUsePrefix = _flagUsePrefix && program->prefix.isNotEmpty();
+					maskFlags = 0;
+					if (program->asserts & AssertBeginText) {
+						maskFlags |= DfaStateBeginText;
+					}
+					if (program->asserts & (AssertWordBoundary | AssertNotWordBoundary)) {
+						maskFlags |= DfaStatePrevWord | DfaStateNoBoundary;
+					}
+					sizeStates = 0;
+					Base::zeroMemory(startStates, sizeof(startStates));
+					stack = sl_null;
+					leaves = sl_null;
+					buf = sl_null;
+					startInsts = sl_null;
+					countStartInsts = 0;
+				}
+
+				~Dfa()
+				{
+					clearStates();
+					if (stack) {
+						Base::freeMemory(stack);
+					}
+					if (leaves) {
+						Base::freeMemory(leaves);
+					}
+					if (buf) {
+						Base::freeMemory(buf);
+					}
+					if (startInsts) {
+						Base::freeMemory(startInsts);
+					}
+				}
+
+			public:
+				sl_bool init()
+				{
+					sl_uint32 n = (sl_uint32)(program->insts.getCount());
+					if (!(visited.init(n))) {
+						return sl_false;
+					}
+					stack = (sl_uint32*)(Base::createMemory(sizeof(sl_uint32) * (n * 2 + 1)));
+					leaves = (sl_uint32*)(Base::createMemory(sizeof(sl_uint32) * n));
+					buf = (sl_uint32*)(Base::createMemory(sizeof(sl_uint32) * n));
+					startInsts = (sl_uint32*)(Base::createMemory(sizeof(sl_uint32) * n));
+					if (!stack || !leaves || !buf || !startInsts) {
+						return sl_false;
+					}
+					visited.clear();
+					addClosure(start, startInsts, countStartInsts, sl_false, 0);
+					IntroSort::sortAsc(startInsts, countStartInsts);
+					return sl_true;
+				}
+
+				void clearStates()
+				{
+					for (auto& item : states) {
+						Base::freeMemory(item.value);
+					}
+					states.removeAll();
+					sizeStates = 0;
+					Base::zeroMemory(startStates, sizeof(startStates));
+				}
+
+				// follows the empty transitions. the assertions are resolved by `asserts` (true AssertKind bits) if `flagResolve` is set, otherwise kept
+				void addClosure(sl_uint32 pc, sl_uint32* out, sl_uint32& countOut, sl_bool flagResolve, sl_uint32 asserts)
+				{
+					sl_uint32 nStack = 0;
+					stack[nStack++] = pc;
+					while (nStack) {
+						pc = stack[--nStack];
+						if (!(visited.add(pc))) {
+							continue;
+						}
+						const Inst& inst = insts[pc];
+						switch (inst.op) {
+							case OpJump:
+								stack[nStack++] = inst.x;
+								break;
+							case OpSplit:
+								stack[nStack++] = inst.y;
+								stack[nStack++] = inst.x;
+								break;
+							case OpAssert:
+								if (flagResolve) {
+									if (inst.kind & asserts) {
+										stack[nStack++] = inst.x;
+									}
+								} else {
+									out[countOut++] = pc;
+								}
+								break;
+							default:
+								out[countOut++] = pc;
+								break;
+						}
+					}
+				}
+
+				// `next`: the next byte, or -1 at the end of the text
+				static sl_uint32 getTrueAsserts(sl_uint32 flags, sl_int32 next, sl_uint32 matchFlags)
+				{
+					sl_uint32 ret = 0;
+					if (flags & DfaStateBeginText) {
+						ret |= AssertBeginText;
+					}
+					if (next < 0 && !(matchFlags & RegExMatchFlags::NotEol)) {
+						ret |= AssertEndText;
+					}
+					sl_bool flagBoundary;
+					if ((flags & DfaStateNoBoundary) || (next < 0 && (matchFlags & RegExMatchFlags::NotEow))) {
+						flagBoundary = sl_false;
+					} else {
+						flagBoundary = ((flags & DfaStatePrevWord) != 0) != (next >= 0 && IsWordByte((sl_uint8)next));
+					}
+					ret |= flagBoundary ? AssertWordBoundary : AssertNotWordBoundary;
+					return ret;
+				}
+
+				// resolves the assertions of `state` and returns the number of the byte set and the match instructions in `leaves`
+				sl_uint32 expand(DfaState* state, sl_int32 next, sl_uint32 matchFlags)
+				{
+					sl_uint32 asserts = getTrueAsserts(state->flags, next, matchFlags);
+					visited.clear();
+					sl_uint32 countLeaves = 0;
+					for (sl_uint32 i = 0; i < state->countInsts; i++) {
+						addClosure(state->insts[i], leaves, countLeaves, sl_true, asserts);
+					}
+					return countLeaves;
+				}
+
+				DfaState* getState(const sl_uint32* list, sl_uint32 count, sl_uint32 flags)
+				{
+					flags &= maskFlags;
+					DfaStateKey key;
+					key.insts = list;
+					key.countInsts = count;
+					key.flags = flags;
+					DfaState** pState = states.getItemPointer(key);
+					if (pState) {
+						return *pState;
+					}
+					sl_uint32 nClasses = program->countByteClasses;
+					sl_size size = sizeof(DfaState) + sizeof(DfaState*) * (nClasses - 1) + sizeof(sl_uint32) * count;
+					if (sizeStates + size > DfaMemoryLimit) {
+						clearStates();
+					}
+					DfaState* state = (DfaState*)(Base::createZeroMemory(size));
+					if (!state) {
+						return sl_null;
+					}
+					state->flags = flags;
+					state->countInsts = count;
+					state->insts = (sl_uint32*)(state->next + nClasses);
+					Base::copyMemory(state->insts, list, sizeof(sl_uint32) * count);
+					state->flagStart = flagUsePrefix && count == countStartInsts && Base::equalsMemory(list, startInsts, sizeof(sl_uint32) * count);
+					key.insts = state->insts;
+					if (!(states.put(key, state))) {
+						Base::freeMemory(state);
+						return sl_null;
+					}
+					sizeStates += size;
+					return state;
+				}
+
+				DfaState* getStartState(sl_uint32 matchFlags)
+				{
+					sl_uint32 flags = 0;
+					if (!(matchFlags & RegExMatchFlags::NotBol)) {
+						flags |= DfaStateBeginText;
+					}
+					if (matchFlags & RegExMatchFlags::NotBow) {
+						flags |= DfaStateNoBoundary;
+					}
+					flags &= maskFlags;
+					DfaState* state = startStates[flags];
+					if (state) {
+						return state;
+					}
+					state = getState(startInsts, countStartInsts, flags);
+					startStates[flags] = state;
+					return state;
+				}
+
+				DfaState* computeNext(DfaState* state, sl_uint8 c)
+				{
+					sl_uint32 countLeaves = expand(state, c, 0);
+					sl_uint32 i;
+					if (flagEarlyMatch) {
+						for (i = 0; i < countLeaves; i++) {
+							if (insts[leaves[i]].op == OpMatch) {
+								state->next[program->byteClasses[c]] = g_stateMatch;
+								return g_stateMatch;
+							}
+						}
+					}
+					visited.clear();
+					sl_uint32 count = 0;
+					for (i = 0; i < countLeaves; i++) {
+						sl_uint32 pc = leaves[i];
+						const Inst& inst = insts[pc];
+						if (inst.op == OpBytes) {
+							if (sets[inst.x].contains(c)) {
+								addClosure(inst.y, buf, count, sl_false, 0);
+							}
+						} else if (inst.op == OpMatch) {
+							if (flagPersistentMatch) {
+								if (visited.add(pc)) {
+									buf[count++] = pc;
+								}
+							}
+						}
+					}
+					DfaState* ret;
+					if (count) {
+						IntroSort::sortAsc(buf, count);
+						sl_size sizeOld = sizeStates;
+						ret = getState(buf, count, IsWordByte(c) ? DfaStatePrevWord : 0);
+						if (!ret) {
+							return sl_null;
+						}
+						if (sizeStates < sizeOld) {
+							// the cache was cleared, and `state` is freed
+							return ret;
+						}
+					} else {
+						ret = g_stateDead;
+					}
+					state->next[program->byteClasses[c]] = ret;
+					return ret;
+				}
+
+				// returns 1 if matched, 0 if not matched, -1 if the memory is not enough
+				sl_int32 run(const sl_uint8* text, sl_size len, sl_uint32 matchFlags, List<sl_uint32>* outPatterns)
+				{
+					MutexLocker locker(&lock);
+					DfaState* state = getStartState(matchFlags);
+					if (!state) {
+						return -1;
+					}
+					const sl_uint8* classes = program->byteClasses;
+					const sl_uint8* prefix = (const sl_uint8*)(program->prefix.getData());
+					sl_size lenPrefix = program->prefix.getLength();
+					for (sl_size i = 0; i < len; i++) {
+						if (state->flagStart) {
+							const sl_uint8* p = FindBytes(text + i, len - i, prefix, lenPrefix);
+							if (!p) {
+								return 0;
+							}
+							sl_size k = p - text;
+							if (k > i) {
+								i = k;
+								state = getState(startInsts, countStartInsts, IsWordByte(text[i - 1]) ? DfaStatePrevWord : 0);
+								if (!state) {
+									return -1;
+								}
+							}
+						}
+						sl_uint8 c = text[i];
+						DfaState* next = state->next[classes[c]];
+						if (!next) {
+							next = computeNext(state, c);
+							if (!next) {
+								return -1;
+							}
+						}
+						if (next == g_stateDead) {
+							return 0;
+						}
+						if (next == g_stateMatch) {
+							return 1;
+						}
+						state = next;
+					}
+					sl_uint32 countLeaves = expand(state, -1, matchFlags);
+					sl_bool flagMatched = sl_false;
+					for (sl_uint32 i = 0; i < countLeaves; i++) {
+						const Inst& inst = insts[leaves[i]];
+						if (inst.op == OpMatch) {
+							flagMatched = sl_true;
+							if (outPatterns) {
+								outPatterns->add_NoLock(inst.x);
+							} else {
+								break;
+							}
+						}
+					}
+					return flagMatched ? 1 : 0;
+				}
+
+			};
+
+			static Dfa* CreateDfa(const Program* program, sl_uint32 start, sl_bool flagEarlyMatch, sl_bool flagPersistentMatch, sl_bool flagUsePrefix)
+			{
+				Dfa* dfa = new Dfa(program, start, flagEarlyMatch, flagPersistentMatch, flagUsePrefix);
+				if (dfa) {
+					if (dfa->init()) {
+						return dfa;
+					}
+					delete dfa;
+				}
+				return sl_null;
+			}
+
+			static sl_bool SearchNfa(const Program* program, const sl_uint8* text, sl_size len, sl_uint32 flags, sl_bool flagAnchored, sl_size* outStart, sl_size* outEnd)
+			{
+				PikeVM vm(program);
+				if (!(vm.init())) {
+					return sl_false;
+				}
+				return vm.search(text, len, flags, flagAnchored, outStart, outEnd);
+			}
+
+			static int ToStdSyntaxFlags(int _flags)
+			{
+				int flags = 0;
+				if (_flags & RegExFlags::Icase) {
+					flags |= std::regex_constants::icase;
+				}
+				if (_flags & RegExFlags::Nosubs) {
+					flags |= std::regex_constants::nosubs;
+				}
+				if (_flags & RegExFlags::Optimize) {
+					flags |= std::regex_constants::optimize;
+				}
+				if (_flags & RegExFlags::Collate) {
+					flags |= std::regex_constants::collate;
+				}
+				if (_flags & RegExFlags::ECMAScript) {
+					flags |= std::regex_constants::ECMAScript;
+				}
+				if (_flags & RegExFlags::Basic) {
+					flags |= std::regex_constants::basic;
+				}
+				if (_flags & RegExFlags::Extended) {
+					flags |= std::regex_constants::extended;
+				}
+				if (_flags & RegExFlags::Awk) {
+					flags |= std::regex_constants::awk;
+				}
+				if (_flags & RegExFlags::Grep) {
+					flags |= std::regex_constants::grep;
+				}
+				if (_flags & RegExFlags::Egrep) {
+					flags |= std::regex_constants::egrep;
+				}
+				return flags;
+			}
+
+			static int ToStdMatchFlags(int v)
+			{
+				int flags = 0;
+				if (v) {
+					if (v & RegExMatchFlags::NotBol) {
+						flags |= std::regex_constants::match_not_bol;
+					}
+					if (v & RegExMatchFlags::NotEol) {
+						flags |= std::regex_constants::match_not_eol;
+					}
+					if (v & RegExMatchFlags::NotBow) {
+						flags |= std::regex_constants::match_not_bow;
+					}
+					if (v & RegExMatchFlags::NotEow) {
+						flags |= std::regex_constants::match_not_eow;
+					}
+					if (v & RegExMatchFlags::Any) {
+						flags |= std::regex_constants::match_any;
+					}
+					if (v & RegExMatchFlags::NotNull) {
+						flags |= std::regex_constants::match_not_null;
+					}
+					if (v & RegExMatchFlags::Continuous) {
+						flags |= std::regex_constants::match_continuous;
+					}
+					if (v & RegExMatchFlags::PrevAvail) {
+						flags |= std::regex_constants::match_prev_avail;
+					}
+					if (v & RegExMatchFlags::FormatSed) {
+						flags |= std::regex_constants::format_sed;
+					}
+					if (v & RegExMatchFlags::FormatNoCopy) {
+						flags |= std::regex_constants::format_no_copy;
+					}
+					if (v & RegExMatchFlags::FormatFirstOnly) {
+						flags |= std::regex_constants::format_first_only;
+					}
+				}
+				return flags;
+			}
+
+		}
+	}
+
+	using namespace priv::regex;
+
 	SLIB_DEFINE_OBJECT(CRegEx, Object)
 	
 	CRegEx::CRegEx() noexcept
 	{
+		m_program = sl_null;
+		m_dfaMatch = sl_null;
+		m_dfaSearch = sl_null;
+		m_dfaPrefix = sl_null;
+		m_obj = sl_null;
 	}
 	
 	CRegEx::~CRegEx() noexcept
 	{
-		delete ((std::regex*)m_obj);
+		if (m_dfaMatch) {
+			delete m_dfaMatch;
+		}
+		if (m_dfaSearch) {
+			delete m_dfaSearch;
+		}
+		if (m_dfaPrefix) {
+			delete m_dfaPrefix;
+		}
+		if (m_program) {
+			delete m_program;
+		}
+		if (m_obj) {
+			std::regex* obj = (std::regex*)m_obj;
+			obj->~basic_regex();
+			Base::freeMemory(obj);
+		}
 	}
 	
 	Ref<CRegEx> CRegEx::_create(const String& pattern, int _flags) noexcept
 	{
-		std::regex* obj = (std::regex*)(Base::createMemory(sizeof(std::regex)));
-		if (obj) {
-			int flags = 0;
-			if (_flags & RegExFlags::Icase) {
-				flags |= std::regex_constants::icase;
-			}
-			if (_flags & RegExFlags::Nosubs) {
-				flags |= std::regex_constants::nosubs;
-			}
-			if (_flags & RegExFlags::Optimize) {
-				flags |= std::regex_constants::optimize;
-			}
-			if (_flags & RegExFlags::Collate) {
-				flags |= std::regex_constants::collate;
-			}
-			if (_flags & RegExFlags::ECMAScript) {
-				flags |= std::regex_constants::ECMAScript;
-			}
-			if (_flags & RegExFlags::Basic) {
-				flags |= std::regex_constants::basic;
-			}
-			if (_flags & RegExFlags::Extended) {
-				flags |= std::regex_constants::extended;
+		Program* program = CompileProgram(&pattern, 1, _flags);
+		if (program) {
+			Dfa* dfaMatch = CreateDfa(program, program->startAnchored, sl_false, sl_false, sl_false);
+			Dfa* dfaSearch = CreateDfa(program, program->startUnanchored, sl_true, sl_false, sl_true);
+			Dfa* dfaPrefix = CreateDfa(program, program->startAnchored, sl_true, sl_false, sl_false);
+			if (dfaMatch && dfaSearch && dfaPrefix) {
+				Ref<CRegEx> ret = new CRegEx;
+				if (ret.isNotNull()) {
+					ret->m_program = program;
+					ret->m_dfaMatch = dfaMatch;
+					ret->m_dfaSearch = dfaSearch;
+					ret->m_dfaPrefix = dfaPrefix;
+					return ret;
+				}
 			}
-			if (_flags & RegExFlags::Awk) {
-				flags |= std::regex_constants::awk;
+			if (dfaMatch) {
+				delete dfaMatch;
 			}
-			if (_flags & RegExFlags::Grep) {
-				flags |= std::regex_constants::grep;
+			if (dfaSearch) {
+				delete dfaSearch;
 			}
-			if (_flags & RegExFlags::Egrep) {
-				flags |= std::regex_constants::egrep;
+			if (dfaPrefix) {
+				delete dfaPrefix;
 			}
+			delete program;
+			return sl_null;
+		}
+		std::regex* obj = (std::regex*)(Base::createMemory(sizeof(std::regex)));
+		if (obj) {
+			int flags = ToStdSyntaxFlags(_flags);
 			try {
 				if (flags) {
 					new (obj) std::regex((char*)(pattern.getData()), (std::size_t)(pattern.getLength()), (std::regex_constants::syntax_option_type)flags);
@@ -89,7 +1916,8 @@ namespace slib
 				ret->m_obj = obj;
 				return ret;
 			}
-			delete obj;
+			obj->~basic_regex();
+			Base::freeMemory(obj);
 		}
 		return sl_null;
 	}
@@ -104,49 +1932,97 @@ namespace slib
 		return _create(pattern, flags);
 	}
 	
-	sl_bool CRegEx::match(const String& str, const RegExMatchFlags& _flags) noexcept
+	sl_bool CRegEx::match(const String& str, const RegExMatchFlags& flags) noexcept
 	{
-		int flags = 0;
-		int v = _flags.value;
-		if (v) {
-			if (v & RegExMatchFlags::NotBol) {
-				flags |= std::regex_constants::match_not_bol;
-			}
-			if (v & RegExMatchFlags::NotEol) {
-				flags |= std::regex_constants::match_not_eol;
-			}
-			if (v & RegExMatchFlags::NotBow) {
-				flags |= std::regex_constants::match_not_bow;
-			}
-			if (v & RegExMatchFlags::NotEow) {
-				flags |= std::regex_constants::match_not_eow;
+		const sl_uint8* text = (const sl_uint8*)(str.getData());
+		sl_size len = str.getLength();
+		if (m_program) {
+			if ((flags & RegExMatchFlags::NotNull) && !len) {
+				return sl_false;
 			}
-			if (v & RegExMatchFlags::Any) {
-				flags |= std::regex_constants::match_any;
+			const String& prefix = m_program->prefix;
+			sl_size lenPrefix = prefix.getLength();
+			if (lenPrefix) {
+				if (len < lenPrefix || !(Base::equalsMemory(text, prefix.getData(), lenPrefix))) {
+					return sl_false;
+				}
+				if (m_program->flagLiteral) {
+					return len == lenPrefix;
+				}
 			}
-			if (v & RegExMatchFlags::NotNull) {
-				flags |= std::regex_constants::match_not_null;
+			sl_int32 ret = m_dfaMatch->run(text, len, flags, sl_null);
+			if (ret >= 0) {
+				return ret > 0;
 			}
-			if (v & RegExMatchFlags::Continuous) {
-				flags |= std::regex_constants::match_continuous;
+			sl_size end;
+			return SearchNfa(m_program, text, len, flags, sl_true, sl_null, &end) && end == len;
+		}
+		std::regex* obj = (std::regex*)m_obj;
+		return std::regex_match((const char*)text, (const char*)(text + len), *obj, (std::regex_constants::match_flag_type)(ToStdMatchFlags(flags)));
+	}
+
+	sl_bool CRegEx::search(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		const sl_uint8* text = (const sl_uint8*)(str.getData());
+		sl_size len = str.getLength();
+		if (m_program) {
+			if (flags & RegExMatchFlags::NotNull) {
+				return SearchNfa(m_program, text, len, flags, (flags & RegExMatchFlags::Continuous) != 0, sl_null, sl_null);
 			}
-			if (v & RegExMatchFlags::PrevAvail) {
-				flags |= std::regex_constants::match_prev_avail;
+			if (m_program->flagLiteral) {
+				const String& prefix = m_program->prefix;
+				if (flags & RegExMatchFlags::Continuous) {
+					return len >= prefix.getLength() && Base::equalsMemory(text, prefix.getData(), prefix.getLength());
+				}
+				return FindBytes(text, len, (const sl_uint8*)(prefix.getData()), prefix.getLength()) != sl_null;
 			}
-			if (v & RegExMatchFlags::FormatSed) {
-				flags |= std::regex_constants::format_sed;
+			Dfa* dfa = (flags & RegExMatchFlags::Continuous) ? m_dfaPrefix : m_dfaSearch;
+			sl_int32 ret = dfa->run(text, len, flags, sl_null);
+			if (ret >= 0) {
+				return ret > 0;
 			}
-			if (v & RegExMatchFlags::FormatNoCopy) {
-				flags |= std::regex_constants::format_no_copy;
+			return SearchNfa(m_program, text, len, flags, (flags & RegExMatchFlags::Continuous) != 0, sl_null, sl_null);
+		}
+		std::regex* obj = (std::regex*)m_obj;
+		return std::regex_search((const char*)text, (const char*)(text + len), *obj, (std::regex_constants::match_flag_type)(ToStdMatchFlags(flags)));
+	}
+
+	sl_reg CRegEx::indexOf(const String& str, sl_size* outLength, const RegExMatchFlags& flags) noexcept
+	{
+		const sl_uint8* text = (const sl_uint8*)(str.getData());
+		sl_size len = str.getLength();
+		if (m_program) {
+			sl_bool flagAnchored = (flags & RegExMatchFlags::Continuous) != 0;
+			if (!(flags & RegExMatchFlags::NotNull)) {
+				// most strings are rejected by the DFA
+				Dfa* dfa = flagAnchored ? m_dfaPrefix : m_dfaSearch;
+				if (!(dfa->run(text, len, flags, sl_null))) {
+					return -1;
+				}
 			}
-			if (v & RegExMatchFlags::FormatFirstOnly) {
-				flags |= std::regex_constants::format_first_only;
+			sl_size start, end;
+			if (SearchNfa(m_program, text, len, flags, flagAnchored, &start, &end)) {
+				if (outLength) {
+					*outLength = end - start;
+				}
+				return (sl_reg)start;
 			}
+			return -1;
 		}
 		std::regex* obj = (std::regex*)m_obj;
-		const char* start = (char*)(str.getData());
-		const char* end = start + str.getLength();
-		return std::regex_match(start, end, *obj, (std::regex_constants::match_flag_type)flags);
+		std::cmatch result;
+		if (std::regex_search((const char*)text, (const char*)(text + len), result, *obj, (std::regex_constants::match_flag_type)(ToStdMatchFlags(flags)))) {
+			if (outLength) {
+				*outLength = (sl_size)(result.length(0));
+			}
+			return (sl_reg)(result.position(0));
+		}
+		return -1;
+	}
+
+	sl_bool CRegEx::isNative() noexcept
+	{
+		return m_program != sl_null;
 	}
 	
 	RegEx::RegEx(const String& pattern) noexcept
@@ -166,6 +2042,22 @@ namespace slib
 		}
 		return sl_false;
 	}
+
+	sl_bool RegEx::search(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		if (ref.isNotNull()) {
+			return ref->search(str, flags);
+		}
+		return sl_false;
+	}
+
+	sl_reg RegEx::indexOf(const String& str, sl_size* outLength, const RegExMatchFlags& flags) noexcept
+	{
+		if (ref.isNotNull()) {
+			return ref->indexOf(str, outLength, flags);
+		}
+		return -1;
+	}
 	
 	Atomic<RegEx>::Atomic(const String& pattern) noexcept
 	 : ref(CRegEx::create(pattern, 0))
@@ -186,6 +2078,24 @@ namespace slib
 		return sl_false;
 	}
 
+	sl_bool Atomic<RegEx>::search(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		Ref<CRegEx> ref(this->ref);
+		if (ref.isNotNull()) {
+			return ref->search(str, flags);
+		}
+		return sl_false;
+	}
+
+	sl_reg Atomic<RegEx>::indexOf(const String& str, sl_size* outLength, const RegExMatchFlags& flags) noexcept
+	{
+		Ref<CRegEx> ref(this->ref);
+		if (ref.isNotNull()) {
+			return ref->indexOf(str, outLength, flags);
+		}
+		return -1;
+	}
+
 	
 	sl_bool RegEx::matchEmail(const String& str) noexcept
 	{
@@ -195,5 +2105,80 @@ namespace slib
 		}
 		return regex.match(str);
 	}
+
+
+	SLIB_DEFINE_OBJECT(RegExSet, Object)
+
+	RegExSet::RegExSet() noexcept
+	{
+		m_program = sl_null;
+		m_dfaMatch = sl_null;
+		m_dfaSearch = sl_null;
+	}
+
+	RegExSet::~RegExSet() noexcept
+	{
+		if (m_dfaMatch) {
+			delete m_dfaMatch;
+		}
+		if (m_dfaSearch) {
+			delete m_dfaSearch;
+		}
+		if (m_program) {
+			delete m_program;
+		}
+	}
+
+	Ref<RegExSet> RegExSet::create(const ListParam<String>& _patterns, const RegExFlags& flags) noexcept
+	{
+		ListLocker<String> patterns(_patterns);
+		if (!(patterns.count)) {
+			return sl_null;
+		}
+		Program* program = CompileProgram(patterns.data, (sl_uint32)(patterns.count), flags);
+		if (!program) {
+			return sl_null;
+		}
+		Dfa* dfaMatch = CreateDfa(program, program->startAnchored, sl_false, sl_false, sl_false);
+		Dfa* dfaSearch = CreateDfa(program, program->startUnanchored, sl_false, sl_true, sl_false);
+		if (dfaMatch && dfaSearch) {
+			Ref<RegExSet> ret = new RegExSet;
+			if (ret.isNotNull()) {
+				ret->m_program = program;
+				ret->m_dfaMatch = dfaMatch;
+				ret->m_dfaSearch = dfaSearch;
+				return ret;
+			}
+		}
+		if (dfaMatch) {
+			delete dfaMatch;
+		}
+		if (dfaSearch) {
+			delete dfaSearch;
+		}
+		delete program;
+		return sl_null;
+	}
+
+	sl_uint32 RegExSet::getPatternsCount() noexcept
+	{
+		return m_program->countPatterns;
+	}
+
+	List<sl_uint32> RegExSet::match(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		List<sl_uint32> ret;
+		m_dfaMatch->run((const sl_uint8*)(str.getData()), str.getLength(), flags, &ret);
+		IntroSort::sortAsc(ret.getData(), ret.getCount());
+		return ret;
+	}
+
+	List<sl_uint32> RegExSet::search(const String& str, const RegExMatchFlags& flags) noexcept
+	{
+		List<sl_uint32> ret;
+		m_dfaSearch->run((const sl_uint8*)(str.getData()), str.getLength(), flags, &ret);
+		IntroSort::sortAsc(ret.getData(), ret.getCount());
+		return ret;
+	}
 	
 }
@@ -27,6 +27,8 @@
 #include "slib/core/base.h"
 #include "slib/core/endian.h"
 #include "slib/core/mio.h"
+#include "slib/core/spin_lock.h"
+#include "slib/core/safe_static.h"
 
 namespace slib
 {
@@ -589,7 +591,112 @@ namespace slib
 				}
 				return s;
 			}
-			
+
+
+#define INTERN_SHARD_BITS 4
+#define INTERN_SHARD_COUNT (1 << INTERN_SHARD_BITS)
+#define INTERN_MAX_LENGTH 128
+#define INTERN_MAX_COUNT_PER_SHARD 1024
+
+			struct InternShard
+			{
+				SpinLock lock;
+				// open addressing, null for the empty slots
+				StringContainer** slots;
+				sl_size capacity;
+				sl_size count;
+			};
+
+			struct InternTable
+			{
+				InternShard shards[INTERN_SHARD_COUNT];
+			};
+
+			static InternShard* GetInternShard(sl_size hash) noexcept
+			{
+				SLIB_STATIC_ZERO_INITIALIZED(InternTable, table)
+				if (SLIB_SAFE_STATIC_CHECK_FREED(table)) {
+					return sl_null;
+				}
+				return table.shards + (hash & (INTERN_SHARD_COUNT - 1));
+			}
+
+			static sl_bool GrowInternShard(InternShard* shard) noexcept
+			{
+				sl_size capacity = shard->capacity ? (shard->capacity << 1) : 64;
+				StringContainer** slots = (StringContainer**)(Base::createMemory(capacity * sizeof(StringContainer*)));
+				if (!slots) {
+					return sl_false;
+				}
+				Base::zeroMemory(slots, capacity * sizeof(StringContainer*));
+				sl_size mask = capacity - 1;
+				for (sl_size i = 0; i < shard->capacity; i++) {
+					StringContainer* container = shard->slots[i];
+					if (container) {
+						sl_size index = (container->hash >> INTERN_SHARD_BITS) & mask;
+						while (slots[index]) {
+							index = (index + 1) & mask;
+						}
+						slots[index] = container;
+					}
+				}
+				Base::freeMemory(shard->slots);
+				shard->slots = slots;
+				shard->capacity = capacity;
+				return sl_true;
+			}
+
+			// returns null if the shard is full, or the string is not interned yet when `flagAdd` is false
+			static StringContainer* Intern(const sl_char8* sz, sl_size len, sl_size hash, sl_bool flagAdd) noexcept
+			{
+				InternShard* shard = GetInternShard(hash);
+				if (!shard) {
+					return sl_null;
+				}
+				SpinLocker lock(&(shard->lock));
+				if (shard->capacity) {
+					sl_size mask = shard->capacity - 1;
+					sl_size index = (hash >> INTERN_SHARD_BITS) & mask;
+					for (;;) {
+						StringContainer* container = shard->slots[index];
+						if (!container) {
+							break;
+						}
+						if (container->hash == hash && container->len == len && Base::equalsMemory(container->sz, sz, len)) {
+							return container;
+						}
+						index = (index + 1) & mask;
+					}
+				}
+				if (!flagAdd) {
+					return sl_null;
+				}
+				if (shard->count >= INTERN_MAX_COUNT_PER_SHARD) {
+					return sl_null;
+				}
+				if ((shard->count + 1) << 1 > shard->capacity) {
+					if (!(GrowInternShard(shard))) {
+						return sl_null;
+					}
+				}
+				StringContainer* container = alloc(len);
+				if (!container) {
+					return sl_null;
+				}
+				Base::copyMemory(container->sz, sz, len);
+				container->hash = hash;
+				// never freed
+				container->ref = -1;
+				sl_size mask = shard->capacity - 1;
+				sl_size index = (hash >> INTERN_SHARD_BITS) & mask;
+				while (shard->slots[index]) {
+					index = (index + 1) & mask;
+				}
+				shard->slots[index] = container;
+				shard->count++;
+				return container;
+			}
+
 		}
 	}
 
@@ -1115,7 +1222,65 @@ namespace slib
 		}
 		return sl_null;
 	}
-	
+
+	String String::intern(const sl_char8* str, sl_reg _len) noexcept
+	{
+		if (!str) {
+			return sl_null;
+		}
+		if (_len < 0) {
+			_len = Base::getStringLength(str);
+		}
+		sl_size len = _len;
+		if (!len) {
+			return getEmpty();
+		}
+		if (len <= INTERN_MAX_LENGTH) {
+			StringContainer* container = priv::string::Intern(str, len, getHashCode((sl_char8*)str, len), sl_true);
+			if (container) {
+				return container;
+			}
+		}
+		return priv::string::create(str, len);
+	}
+
+	String String::intern() const noexcept
+	{
+		StringContainer* container = m_container;
+		if (!container || container->ref < 0) {
+			return *this;
+		}
+		sl_size len = container->len;
+		if (len && len <= INTERN_MAX_LENGTH) {
+			StringContainer* interned = priv::string::Intern(container->sz, len, getHashCode(), sl_true);
+			if (interned) {
+				return interned;
+			}
+		}
+		return *this;
+	}
+
+	String String::findInterned(const sl_char8* str, sl_reg _len) noexcept
+	{
+		if (!str) {
+			return sl_null;
+		}
+		if (_len < 0) {
+			_len = Base::getStringLength(str);
+		}
+		sl_size len = _len;
+		if (!len) {
+			return getEmpty();
+		}
+		if (len <= INTERN_MAX_LENGTH) {
+			StringContainer* container = priv::string::Intern(str, len, getHashCode((sl_char8*)str, len), sl_false);
+			if (container) {
+				return container;
+			}
+		}
+		return sl_null;
+	}
+
 	String16 String16::fromRef(const Ref<Referable>& ref, const sl_char16* str, sl_reg len) noexcept
 	{
 		if (str) {
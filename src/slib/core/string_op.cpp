@@ -31,6 +31,7 @@
 #include "slib/core/variant.h"
 #include "slib/core/json.h"
 #include "slib/core/cast.h"
+#include "slib/core/charset.h"
 
 namespace slib
 {
@@ -64,6 +65,50 @@ namespace slib
 			{
 				return Base::compareMemory((sl_uint8*)mem1, (sl_uint8*)mem2, count);
 			}
+
+			SLIB_INLINE static const void* FindPattern(const sl_char8* mem, sl_size count, const sl_char8* pattern, sl_size countPattern) noexcept
+			{
+				return Base::findMemory(mem, count, pattern, countPattern);
+			}
+
+			SLIB_INLINE static const void* FindPattern(const sl_char16* mem, sl_size count, const sl_char16* pattern, sl_size countPattern) noexcept
+			{
+				return Base::findMemory2((sl_uint16*)mem, count, (sl_uint16*)pattern, countPattern);
+			}
+
+			SLIB_INLINE static sl_size CountLeadingWhitespaces(const sl_char8* sz, sl_size n) noexcept
+			{
+				return Base::countLeadingWhitespaces(sz, n);
+			}
+
+			SLIB_INLINE static sl_size CountLeadingWhitespaces(const sl_char16* sz, sl_size n) noexcept
+			{
+				sl_size i = 0;
+				for (; i < n; i++) {
+					sl_char16 c = sz[i];
+					if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+						break;
+					}
+				}
+				return i;
+			}
+
+			SLIB_INLINE static sl_size CountTrailingWhitespaces(const sl_char8* sz, sl_size n) noexcept
+			{
+				return Base::countTrailingWhitespaces(sz, n);
+			}
+
+			SLIB_INLINE static sl_size CountTrailingWhitespaces(const sl_char16* sz, sl_size n) noexcept
+			{
+				sl_size j = n;
+				for (; j > 0; j--) {
+					sl_char16 c = sz[j - 1];
+					if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+						break;
+					}
+				}
+				return n - j;
+			}
 			
 			SLIB_INLINE static sl_compare_result CompareMemory(const sl_char16* mem1, const sl_char16* mem2, sl_size count) noexcept
 			{
@@ -71,41 +116,88 @@ namespace slib
 			}
 			
 		
-			template <class CT>
-			SLIB_INLINE static sl_size CalcHash(const CT* buf, sl_size len) noexcept
+			SLIB_INLINE static void ToUpper(sl_char8* dst, const sl_char8* src, sl_size n) noexcept
 			{
-				sl_size hash = 0;
-				for (sl_size i = 0; i < len; i++) {
-					sl_uint32 ch = buf[i];
-					if (ch) {
-						hash = hash * 31 + ch;
-					} else {
-						break;
-					}
+				for (sl_size i = 0; i < n; i++) {
+					dst[i] = (sl_char8)(SLIB_CHAR_LOWER_TO_UPPER(src[i]));
+				}
+			}
+
+			SLIB_INLINE static void ToUpper(sl_char8* buf, sl_size n) noexcept
+			{
+				ToUpper(buf, buf, n);
+			}
+
+			// the strings are hashed by their UTF-8 forms, so that the equal String and String16 have the same hash
+			template <sl_bool flagIgnoreCase>
+			static sl_size CalcHash(const sl_char8* str, sl_reg _len) noexcept
+			{
+				sl_size len = _len < 0 ? Base::getStringLength(str) : (sl_size)_len;
+				if (!len) {
+					return 0;
 				}
-				if (hash) {
-					hash = Rehash(hash);
+				if (!flagIgnoreCase) {
+					return HashBytes(str, len);
 				}
-				return hash;
+				sl_char8 buf[256];
+				if (len <= sizeof(buf)) {
+					ToUpper(buf, str, len);
+					return HashBytes(buf, len);
+				}
+				BytesHasher hasher;
+				sl_size i = 0;
+				while (i < len) {
+					sl_size n = len - i;
+					if (n > sizeof(buf)) {
+						n = sizeof(buf);
+					}
+					ToUpper(buf, str + i, n);
+					hasher.update(buf, n);
+					i += n;
+				}
+				return hasher.finish();
 			}
-			
-			template <class CT>
-			SLIB_INLINE static sl_size CalcHashIgnoreCase(const CT* buf, sl_size len) noexcept
+
+			template <sl_bool flagIgnoreCase>
+			static sl_size CalcHash(const sl_char16* str, sl_reg _len) noexcept
 			{
-				sl_size hash = 0;
-				for (sl_size i = 0; i < len; i++) {
-					sl_uint32 ch = buf[i];
-					if (ch) {
-						ch = SLIB_CHAR_LOWER_TO_UPPER(ch);
-						hash = hash * 31 + ch;
-					} else {
-						break;
+				sl_size len = _len < 0 ? Base::getStringLength2(str) : (sl_size)_len;
+				// at most 3 bytes per unit in UTF-8
+				sl_char8 buf[192];
+				if (len <= 64) {
+					sl_size m = Charsets::utf16ToUtf8(str, len, buf, sizeof(buf));
+					if (!m) {
+						return 0;
 					}
+					if (flagIgnoreCase) {
+						ToUpper(buf, m);
+					}
+					return HashBytes(buf, m);
 				}
-				if (hash) {
-					hash = Rehash(hash);
+				BytesHasher hasher;
+				sl_size total = 0;
+				sl_size i = 0;
+				while (i < len) {
+					sl_size n = len - i;
+					if (n > 64) {
+						// the chunks end after the non-surrogate units, so the surrogate pairs are not split
+						n = 64;
+						while (n && ((sl_uint16)(str[i + n - 1]) & 0xF800) == 0xD800) {
+							n--;
+						}
+						if (!n) {
+							n = 64;
+						}
+					}
+					sl_size m = Charsets::utf16ToUtf8(str + i, n, buf, sizeof(buf));
+					if (flagIgnoreCase) {
+						ToUpper(buf, m);
+					}
+					hasher.update(buf, m);
+					total += m;
+					i += n;
 				}
-				return hash;
+				return total ? hasher.finish() : 0;
 			}
 			
 		}
@@ -118,7 +210,7 @@ namespace slib
 			if (n > 0) {
 				sl_size hash = m_container->hash;
 				if (hash == 0) {
-					hash = priv::string::CalcHash(m_container->sz, n);
+					hash = priv::string::CalcHash<sl_false>(m_container->sz, n);
 					m_container->hash = hash;
 				}
 				return hash;
@@ -129,7 +221,7 @@ namespace slib
 
 	sl_size String::getHashCode(sl_char8* str, sl_reg len) noexcept
 	{
-		return priv::string::CalcHash(str, len);
+		return priv::string::CalcHash<sl_false>(str, len);
 	}
 
 	sl_size String16::getHashCode() const noexcept
@@ -139,7 +231,7 @@ namespace slib
 			if (n > 0) {
 				sl_size hash = m_container->hash;
 				if (hash == 0) {
-					hash = priv::string::CalcHash(m_container->sz, n);
+					hash = priv::string::CalcHash<sl_false>(m_container->sz, n);
 					m_container->hash = hash;
 				}
 				return hash;
@@ -150,7 +242,7 @@ namespace slib
 
 	sl_size String16::getHashCode(sl_char16* str, sl_reg len) noexcept
 	{
-		return priv::string::CalcHash(str, len);
+		return priv::string::CalcHash<sl_false>(str, len);
 	}
 
 	sl_size Atomic<String>::getHashCode() const noexcept
@@ -167,38 +259,38 @@ namespace slib
 	
 	sl_size StringView::getHashCode() const noexcept
 	{
-		return priv::string::CalcHash(data, length);
+		return priv::string::CalcHash<sl_false>(data, length);
 	}
 
 	sl_size StringView16::getHashCode() const noexcept
 	{
-		return priv::string::CalcHash(data, length);
+		return priv::string::CalcHash<sl_false>(data, length);
 	}
 
 	sl_size String::getHashCodeIgnoreCase() const noexcept
 	{
 		if (m_container) {
-			return priv::string::CalcHashIgnoreCase(m_container->sz, m_container->len);
+			return priv::string::CalcHash<sl_true>(m_container->sz, m_container->len);
 		}
 		return 0;
 	}
 
 	sl_size String::getHashCodeIgnoreCase(sl_char8* str, sl_reg len) noexcept
 	{
-		return priv::string::CalcHashIgnoreCase(str, len);
+		return priv::string::CalcHash<sl_true>(str, len);
 	}
 
 	sl_size String16::getHashCodeIgnoreCase() const noexcept
 	{
 		if (m_container) {
-			return priv::string::CalcHashIgnoreCase(m_container->sz, m_container->len);
+			return priv::string::CalcHash<sl_true>(m_container->sz, m_container->len);
 		}
 		return 0;
 	}
 
 	sl_size String16::getHashCodeIgnoreCase(sl_char16* str, sl_reg len) noexcept
 	{
-		return priv::string::CalcHashIgnoreCase(str, len);
+		return priv::string::CalcHash<sl_true>(str, len);
 	}
 
 	sl_size Atomic<String>::getHashCodeIgnoreCase() const noexcept
@@ -215,12 +307,12 @@ namespace slib
 
 	sl_size StringView::getHashCodeIgnoreCase() const noexcept
 	{
-		return priv::string::CalcHashIgnoreCase(data, length);
+		return priv::string::CalcHash<sl_true>(data, length);
 	}
 
 	sl_size StringView16::getHashCodeIgnoreCase() const noexcept
 	{
-		return priv::string::CalcHashIgnoreCase(data, length);
+		return priv::string::CalcHash<sl_true>(data, length);
 	}
 
 
@@ -880,6 +972,17 @@ namespace slib
 				}
 				return sl_true;
 			}
+
+			SLIB_INLINE static sl_bool EqualsIgnoreCase(const sl_uint8* s1, sl_size l1, const sl_uint8* s2, sl_size l2) noexcept
+			{
+				if (s1 == s2) {
+					return sl_true;
+				}
+				if (l1 != l2) {
+					return sl_false;
+				}
+				return Base::equalsMemoryIgnoreCase(s1, s2, l1);
+			}
 		}
 	}
 
@@ -962,6 +1065,24 @@ namespace slib
 				}
 				return 0;
 			}
+
+			SLIB_INLINE static sl_compare_result CompareIgnoreCase(const sl_uint8* s1, sl_size len1, const sl_uint8* s2, sl_size len2) noexcept
+			{
+				if (s1 == s2) {
+					return 0;
+				}
+				sl_size len = SLIB_MIN(len1, len2);
+				sl_compare_result result = Base::compareStringIgnoreCase((const sl_char8*)s1, (const sl_char8*)s2, len);
+				// the comparison stops at a null character as in the generic version
+				if (result || len1 == len2 || Base::findMemory(s1, 0, len)) {
+					return result;
+				}
+				if (len1 < len2) {
+					return s2[len1] ? -1 : 0;
+				} else {
+					return s1[len2] ? 1 : 0;
+				}
+			}
 		}
 	}
 
@@ -1267,16 +1388,9 @@ namespace slib
 						return -1;
 					}
 				}
-				while (start <= count - countPat) {
-					const CT* pt = (const CT*)(FindMemory(buf + start, bufPat[0], count - start - countPat + 1));
-					if (pt == sl_null) {
-						return -1;
-					}
-					if (CompareMemory(pt + 1, bufPat + 1, countPat - 1) == 0) {
-						return (sl_reg)(pt - buf);
-					} else {
-						start = (sl_size)(pt - buf + 1);
-					}
+				const CT* pt = (const CT*)(FindPattern(buf + start, count - start, bufPat, countPat));
+				if (pt) {
+					return (sl_reg)(pt - buf);
 				}
 				return -1;
 			}
@@ -2145,24 +2259,12 @@ namespace slib
 			{
 				const CT* sz = str.getData();
 				sl_size n = str.getLength();
-				sl_size i = 0;
-				for (; i < n; i++) {
-					CT c = sz[i];
-					if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
-						break;
-					}
-				}
+				sl_size i = CountLeadingWhitespaces(sz, n);
 				if (i >= n) {
 					return sl_null;
 				}
-				sl_size j = n - 1;
-				for (; j >= i; j--) {
-					CT c = sz[j];
-					if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
-						break;
-					}
-				}
-				return str.substring(i, j + 1);
+				sl_size j = n - CountTrailingWhitespaces(sz + i, n - i);
+				return str.substring(i, j);
 			}
 
 			template <class ST, class CT>
@@ -2170,13 +2272,7 @@ namespace slib
 			{
 				const CT* sz = str.getData();
 				sl_size n = str.getLength();
-				sl_size i = 0;
-				for (; i < n; i++) {
-					CT c = sz[i];
-					if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
-						break;
-					}
-				}
+				sl_size i = CountLeadingWhitespaces(sz, n);
 				if (i >= n) {
 					return sl_null;
 				}
@@ -2188,13 +2284,7 @@ namespace slib
 			{
 				const CT* sz = str.getData();
 				sl_size n = str.getLength();
-				sl_size j = n;
-				for (; j > 0; j--) {
-					CT c = sz[j-1];
-					if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
-						break;
-					}
-				}
+				sl_size j = n - CountTrailingWhitespaces(sz, n);
 				if (j == 0) {
 					return sl_null;
 				}
@@ -115,6 +115,17 @@ namespace slib
 	}
 #endif
 
+	sl_uint32 System::getProcessorsCount()
+	{
+#if defined(_SC_NPROCESSORS_ONLN)
+		long n = sysconf(_SC_NPROCESSORS_ONLN);
+		if (n > 0) {
+			return (sl_uint32)n;
+		}
+#endif
+		return 1;
+	}
+
 	sl_uint32 System::getTickCount()
 	{
 		return (sl_uint32)(getTickCount64());
@@ -146,6 +146,13 @@ namespace slib
 		return getUserName();
 	}
 
+	sl_uint32 System::getProcessorsCount()
+	{
+		SYSTEM_INFO si;
+		GetNativeSystemInfo(&si);
+		return (sl_uint32)(si.dwNumberOfProcessors);
+	}
+
 	sl_uint32 System::getTickCount()
 	{
 #if defined(SLIB_PLATFORM_IS_WIN32)
@@ -140,6 +140,12 @@ namespace slib
 		}
 	}
 
+	sl_bool Thread::setProcessorAffinity(sl_uint32 indexProcessor)
+	{
+		// Apple platforms provide affinity tags only as scheduling hints
+		return sl_false;
+	}
+
 	sl_uint64 Thread::getCurrentThreadId()
 	{
 #ifndef SLIB_PLATFORM_IS_IOS_CATALYST
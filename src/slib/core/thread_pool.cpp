@@ -22,20 +22,228 @@
 
 #include "slib/core/thread_pool.h"
 
+#include "slib/core/system.h"
+
+#include <atomic>
+
 namespace slib
 {
 
+	namespace priv
+	{
+		namespace thread_pool
+		{
+			
+			typedef UniqueFunction<void()> Task;
+			
+			/*
+				Chase-Lev work-stealing deque, holding the tasks by value.
+				Only the owner worker calls `push` and `pop` at the bottom, and other workers `steal` at the top.
+				An item is moved out only after its index is claimed, and the sequence of the slot keeps the owner from
+				reusing the slot until the claiming worker finishes moving the item out.
+				The capacity is fixed: `push` fails when the deque is full.
+			*/
+			class WorkDeque
+			{
+			public:
+				enum {
+					Capacity = 1024,
+					Mask = Capacity - 1
+				};
+				
+				struct Slot
+				{
+					// the index which can be written to the slot next, or the written index + 1 while the item is stored
+					std::atomic<sl_int64> sequence;
+					Task task;
+				};
+				
+			public:
+				WorkDeque()
+				{
+					m_top = 0;
+					m_bottom = 0;
+					m_slots = new Slot[Capacity];
+					if (m_slots) {
+						for (sl_int64 i = 0; i < Capacity; i++) {
+							m_slots[i].sequence.store(i, std::memory_order_relaxed);
+						}
+					}
+				}
+				
+				~WorkDeque()
+				{
+					if (m_slots) {
+						delete[] m_slots;
+					}
+				}
+				
+			public:
+				// `task` is not moved if failed
+				sl_bool push(Task&& task)
+				{
+					if (!m_slots) {
+						return sl_false;
+					}
+					sl_int64 b = m_bottom.load(std::memory_order_relaxed);
+					Slot& slot = m_slots[b & Mask];
+					if (slot.sequence.load(std::memory_order_acquire) != b) {
+						// full, or a thief is still moving out the previous item
+						return sl_false;
+					}
+					slot.task = Move(task);
+					slot.sequence.store(b + 1, std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_release);
+					m_bottom.store(b + 1, std::memory_order_relaxed);
+					return sl_true;
+				}
+				
+				sl_bool pop(Task& _out)
+				{
+					if (!m_slots) {
+						return sl_false;
+					}
+					sl_int64 b = m_bottom.load(std::memory_order_relaxed) - 1;
+					m_bottom.store(b, std::memory_order_relaxed);
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					sl_int64 t = m_top.load(std::memory_order_relaxed);
+					if (t < b) {
+						Slot& slot = m_slots[b & Mask];
+						_out = Move(slot.task);
+						// the next push uses the same index
+						slot.sequence.store(b, std::memory_order_relaxed);
+						return sl_true;
+					}
+					sl_bool flagClaimed = sl_false;
+					if (t == b) {
+						// last item: race against the thieves
+						flagClaimed = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+					}
+					m_bottom.store(b + 1, std::memory_order_relaxed);
+					if (flagClaimed) {
+						take(b, _out);
+					}
+					return flagClaimed;
+				}
+				
+				sl_bool steal(Task& _out)
+				{
+					if (!m_slots) {
+						return sl_false;
+					}
+					sl_int64 t = m_top.load(std::memory_order_acquire);
+					std::atomic_thread_fence(std::memory_order_seq_cst);
+					sl_int64 b = m_bottom.load(std::memory_order_acquire);
+					if (t < b) {
+						if (m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+							take(t, _out);
+							return sl_true;
+						}
+					}
+					return sl_false;
+				}
+				
+				sl_bool isEmpty()
+				{
+					sl_int64 t = m_top.load(std::memory_order_seq_cst);
+					sl_int64 b = m_bottom.load(std::memory_order_seq_cst);
+					return b <= t;
+				}
+				
+			private:
+				// moves out the item of the index claimed by advancing the top
+				void take(sl_int64 index, Task& _out)
+				{
+					Slot& slot = m_slots[index & Mask];
+					_out = Move(slot.task);
+					// the slot is written again after a lap
+					slot.sequence.store(index + Capacity, std::memory_order_release);
+				}
+				
+			private:
+				std::atomic<sl_int64> m_top;
+				std::atomic<sl_int64> m_bottom;
+				Slot* m_slots;
+				
+			};
+			
+		}
+	}
+	
+	class ThreadPool::StealingWorker
+	{
+	public:
+		ThreadPool* pool;
+		sl_uint32 index;
+		sl_uint32 seed;
+		Ref<Thread> thread;
+		priv::thread_pool::WorkDeque deque;
+		LinkedQueue< UniqueFunction<void()> > inbox;
+		std::atomic<sl_bool> flagSleeping;
+		
+	public:
+		StealingWorker(ThreadPool* _pool, sl_uint32 _index): pool(_pool), index(_index), seed(_index * 0x9E3779B9 + 1), flagSleeping(sl_false)
+		{
+		}
+		
+		~StealingWorker()
+		{
+			inbox.removeAll();
+		}
+		
+	public:
+		sl_uint32 random()
+		{
+			// xorshift32
+			sl_uint32 x = seed;
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			seed = x;
+			return x;
+		}
+		
+		sl_bool hasTasks()
+		{
+			return !(deque.isEmpty()) || inbox.isNotEmpty();
+		}
+		
+	};
+	
+	namespace priv
+	{
+		namespace thread_pool
+		{
+			SLIB_THREAD ThreadPool::StealingWorker* g_currentWorker = sl_null;
+			
+			SLIB_INLINE static std::atomic<sl_int32>& GetSleepingCounter(sl_int32* p)
+			{
+				return *((std::atomic<sl_int32>*)p);
+			}
+		}
+	}
+
 	SLIB_DEFINE_OBJECT(ThreadPool, Dispatcher)
 
 	ThreadPool::ThreadPool()
 	{
 		setThreadStackSize(SLIB_THREAD_DEFAULT_STACK_SIZE);
 		m_flagRunning = sl_true;
+		m_stealingWorkers = sl_null;
+		m_nStealingWorkers = 0;
+		m_indexNextWorker = 0;
+		m_nSleepingWorkers = 0;
 	}
 
 	ThreadPool::~ThreadPool()
 	{
 		release();
+		if (m_stealingWorkers) {
+			for (sl_uint32 i = 0; i < m_nStealingWorkers; i++) {
+				delete m_stealingWorkers[i];
+			}
+			delete[] m_stealingWorkers;
+		}
 	}
 
 	Ref<ThreadPool> ThreadPool::create(sl_uint32 minThreads, sl_uint32 maxThreads)
@@ -48,15 +256,68 @@ namespace slib
 		return ret;
 	}
 
+	Ref<ThreadPool> ThreadPool::createWorkStealing(sl_uint32 nWorkers)
+	{
+		if (!nWorkers) {
+			nWorkers = System::getProcessorsCount();
+			if (!nWorkers) {
+				nWorkers = 1;
+			}
+		}
+		Ref<ThreadPool> ret = new ThreadPool();
+		if (ret.isNull()) {
+			return sl_null;
+		}
+		ret->setMinimumThreadsCount(nWorkers);
+		ret->setMaximumThreadsCount(nWorkers);
+		StealingWorker** workers = new StealingWorker*[nWorkers];
+		if (!workers) {
+			return sl_null;
+		}
+		sl_uint32 i;
+		for (i = 0; i < nWorkers; i++) {
+			workers[i] = new StealingWorker(ret.get(), i);
+		}
+		ret->m_stealingWorkers = workers;
+		ret->m_nStealingWorkers = nWorkers;
+		ThreadPool* pool = ret.get();
+		for (i = 0; i < nWorkers; i++) {
+			workers[i]->thread = Thread::start([pool, i]() {
+				pool->onRunStealingWorker(i);
+			}, ret->getThreadStackSize());
+			if (workers[i]->thread.isNull()) {
+				ret->release();
+				return sl_null;
+			}
+			ret->m_threadWorkers.add_NoLock(workers[i]->thread);
+		}
+		return ret;
+	}
+
 	void ThreadPool::release()
 	{
-		ObjectLocker lock(this);
-		if (!m_flagRunning) {
-			return;
+		List< Ref<Thread> > workers;
+		{
+			ObjectLocker lock(this);
+			if (!m_flagRunning) {
+				return;
+			}
+			m_flagRunning = sl_false;
+			workers = m_threadWorkers.duplicate_NoLock();
+		}
+		// joins the threads without the lock: the timer thread calls `addTask` while dispatching the expired tasks
+		
+		Ref<Thread> threadTimer;
+		{
+			MutexLocker lockTimer(&m_lockTimer);
+			threadTimer = m_threadTimer;
+			m_timerWheel.removeAll();
+		}
+		if (threadTimer.isNotNull()) {
+			threadTimer->finishAndWait();
 		}
-		m_flagRunning = sl_false;
 		
-		ListElements< Ref<Thread> > threads(m_threadWorkers);
+		ListElements< Ref<Thread> > threads(workers);
 		sl_size i;
 		for (i = 0; i < threads.count; i++) {
 			threads[i]->finish();
@@ -76,17 +337,25 @@ namespace slib
 		return (sl_uint32)(m_threadWorkers.getCount());
 	}
 
-	sl_bool ThreadPool::addTask(const Function<void()>& task)
+	sl_bool ThreadPool::isWorkStealing()
+	{
+		return m_stealingWorkers != sl_null;
+	}
+
+	sl_bool ThreadPool::addTask(UniqueFunction<void()>&& task)
 	{
 		if (task.isNull()) {
 			return sl_false;
 		}
+		if (m_stealingWorkers) {
+			return _addStealingTask(Move(task));
+		}
 		ObjectLocker lock(this);
 		if (!m_flagRunning) {
 			return sl_false;
 		}
 		// add task
-		if (!(m_tasks.push(task))) {
+		if (!(m_tasks.push(Move(task)))) {
 			return sl_false;
 		}
 
@@ -112,9 +381,30 @@ namespace slib
 		return sl_true;
 	}
 
-	sl_bool ThreadPool::dispatch(const Function<void()>& callback, sl_uint64 delay_ms)
+	sl_bool ThreadPool::dispatch(UniqueFunction<void()>&& task, sl_uint64 delay_ms)
 	{
-		return addTask(callback);
+		if (!delay_ms) {
+			return addTask(Move(task));
+		}
+		if (task.isNull()) {
+			return sl_false;
+		}
+		MutexLocker lock(&m_lockTimer);
+		if (!m_flagRunning) {
+			return sl_false;
+		}
+		if (!(m_timerWheel.add(m_timeCounter.getElapsedMilliseconds(), delay_ms, Move(task)))) {
+			return sl_false;
+		}
+		if (m_threadTimer.isNull()) {
+			m_threadTimer = Thread::start(SLIB_FUNCTION_MEMBER(ThreadPool, onRunTimer, this));
+			if (m_threadTimer.isNull()) {
+				return sl_false;
+			}
+		} else {
+			m_threadTimer->wakeSelfEvent();
+		}
+		return sl_true;
 	}
 
 	void ThreadPool::onRunWorker()
@@ -124,11 +414,15 @@ namespace slib
 			return;
 		}
 		while (m_flagRunning && thread->isNotStopping()) {
-			Function<void()> task;
+			UniqueFunction<void()> task;
 			if (m_tasks.pop(&task)) {
 				task();
 			} else {
 				ObjectLocker lock(this);
+				if (m_tasks.isNotEmpty()) {
+					// a task was added before this worker is registered as sleeping
+					continue;
+				}
 				sl_size nThreads = m_threadWorkers.getCount();
 				if (nThreads > getMinimumThreadsCount()) {
 					m_threadWorkers.remove_NoLock(thread);
@@ -142,4 +436,137 @@ namespace slib
 		}
 	}
 
+	sl_bool ThreadPool::_addStealingTask(UniqueFunction<void()>&& task)
+	{
+		if (!m_flagRunning) {
+			return sl_false;
+		}
+		StealingWorker* current = priv::thread_pool::g_currentWorker;
+		if (current && current->pool == this) {
+			// local tasks are executed LIFO by the owner for the cache locality
+			if (!(current->deque.push(Move(task)))) {
+				// the deque is full
+				if (!(current->inbox.push(Move(task)))) {
+					return sl_false;
+				}
+			}
+		} else {
+			sl_uint32 index = ((sl_uint32)(Base::interlockedIncrement32((sl_int32*)&m_indexNextWorker))) % m_nStealingWorkers;
+			StealingWorker* worker = m_stealingWorkers[index];
+			if (!(worker->inbox.push(Move(task)))) {
+				return sl_false;
+			}
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (worker->flagSleeping.load()) {
+				worker->thread->wakeSelfEvent();
+				return sl_true;
+			}
+		}
+		_wakeStealingWorker();
+		return sl_true;
+	}
+
+	void ThreadPool::_wakeStealingWorker()
+	{
+		// orders the preceding push before reading the sleeping state
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (priv::thread_pool::GetSleepingCounter(&m_nSleepingWorkers).load() <= 0) {
+			return;
+		}
+		for (sl_uint32 i = 0; i < m_nStealingWorkers; i++) {
+			StealingWorker* worker = m_stealingWorkers[i];
+			if (worker->flagSleeping.load()) {
+				worker->thread->wakeSelfEvent();
+				return;
+			}
+		}
+	}
+
+	void ThreadPool::onRunStealingWorker(sl_uint32 index)
+	{
+		Ref<Thread> thread = Thread::getCurrent();
+		if (thread.isNull()) {
+			return;
+		}
+		StealingWorker* worker = m_stealingWorkers[index];
+		priv::thread_pool::g_currentWorker = worker;
+		std::atomic<sl_int32>& nSleeping = priv::thread_pool::GetSleepingCounter(&m_nSleepingWorkers);
+		sl_uint32 nWorkers = m_nStealingWorkers;
+		while (m_flagRunning && thread->isNotStopping()) {
+			UniqueFunction<void()> task;
+			if (worker->deque.pop(task)) {
+				task();
+				continue;
+			}
+			if (worker->inbox.pop(&task)) {
+				task();
+				continue;
+			}
+			// steal from a random victim
+			if (nWorkers > 1) {
+				sl_uint32 start = worker->random() % nWorkers;
+				for (sl_uint32 k = 0; k < nWorkers; k++) {
+					StealingWorker* victim = m_stealingWorkers[(start + k) % nWorkers];
+					if (victim == worker) {
+						continue;
+					}
+					if (victim->deque.steal(task)) {
+						break;
+					}
+					if (victim->inbox.pop(&task)) {
+						break;
+					}
+				}
+				if (task.isNotNull()) {
+					task();
+					continue;
+				}
+			}
+			// sleep
+			worker->flagSleeping.store(sl_true);
+			nSleeping++;
+			sl_bool flagFound = sl_false;
+			for (sl_uint32 k = 0; k < nWorkers; k++) {
+				if (m_stealingWorkers[k]->hasTasks()) {
+					flagFound = sl_true;
+					break;
+				}
+			}
+			if (!flagFound) {
+				thread->wait();
+			}
+			nSleeping--;
+			worker->flagSleeping.store(sl_false);
+		}
+		priv::thread_pool::g_currentWorker = sl_null;
+	}
+
+	void ThreadPool::onRunTimer()
+	{
+		Ref<Thread> thread = Thread::getCurrent();
+		if (thread.isNull()) {
+			return;
+		}
+		while (m_flagRunning && thread->isNotStopping()) {
+			LinkedQueue< UniqueFunction<void()> > tasks;
+			sl_int64 timeout;
+			{
+				MutexLocker lock(&m_lockTimer);
+				sl_uint64 now = m_timeCounter.getElapsedMilliseconds();
+				m_timerWheel.collect(now, &tasks);
+				timeout = m_timerWheel.getTimeout(now);
+			}
+			UniqueFunction<void()> task;
+			while (tasks.pop_NoLock(&task)) {
+				addTask(Move(task));
+			}
+			if (timeout != 0) {
+				if (timeout < 0 || timeout > 10000) {
+					timeout = 10000;
+				}
+				thread->wait((sl_int32)timeout);
+			}
+		}
+	}
+
 }
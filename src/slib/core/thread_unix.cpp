@@ -147,6 +147,20 @@ namespace slib
 		}
 	}
 
+	sl_bool Thread::setProcessorAffinity(sl_uint32 indexProcessor)
+	{
+#if defined(SLIB_PLATFORM_IS_LINUX) && !defined(SLIB_PLATFORM_IS_ANDROID) && defined(CPU_SET)
+		pthread_t thread = (pthread_t)m_handle;
+		if (thread && indexProcessor < CPU_SETSIZE) {
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(indexProcessor, &set);
+			return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+		}
+#endif
+		return sl_false;
+	}
+
 	sl_uint64 Thread::getCurrentThreadId()
 	{
 #if defined(SLIB_PLATFORM_IS_ANDROID)
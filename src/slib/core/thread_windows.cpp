@@ -113,6 +113,17 @@ namespace slib
 		}
 	}
 
+	sl_bool Thread::setProcessorAffinity(sl_uint32 indexProcessor)
+	{
+#if defined(SLIB_PLATFORM_IS_WIN32)
+		HANDLE hThread = (HANDLE)m_handle;
+		if (hThread && indexProcessor < sizeof(DWORD_PTR) * 8) {
+			return SetThreadAffinityMask(hThread, ((DWORD_PTR)1) << indexProcessor) != 0;
+		}
+#endif
+		return sl_false;
+	}
+
 	sl_uint64 Thread::getCurrentThreadId()
 	{
 		return (sl_uint32)(GetCurrentThreadId());
@@ -0,0 +1,324 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/core/timer_wheel.h"
+
+#if defined(SLIB_COMPILER_IS_VC)
+#	include <intrin.h>
+#endif
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace timer_wheel
+		{
+
+			// `x` must not be zero
+			SLIB_INLINE static sl_uint32 GetLowestBit(sl_uint64 x) noexcept
+			{
+#if defined(SLIB_COMPILER_IS_VC)
+				unsigned long index;
+#	if defined(SLIB_ARCH_IS_64BIT)
+				_BitScanForward64(&index, x);
+#	else
+				if ((sl_uint32)x) {
+					_BitScanForward(&index, (sl_uint32)x);
+				} else {
+					_BitScanForward(&index, (sl_uint32)(x >> 32));
+					index += 32;
+				}
+#	endif
+				return (sl_uint32)index;
+#else
+				return (sl_uint32)(__builtin_ctzll(x));
+#endif
+			}
+
+		}
+	}
+
+	TimerWheel::TimerWheel(sl_uint32 tickMilliseconds) noexcept
+	{
+		if (tickMilliseconds < 1) {
+			tickMilliseconds = 1;
+		}
+		m_tick = tickMilliseconds;
+		Base::zeroMemory(m_slots, sizeof(m_slots));
+		Base::zeroMemory(m_bitmaps, sizeof(m_bitmaps));
+		m_flagInit = sl_false;
+		m_tickCurrent = 0;
+		m_lastId = 0;
+		m_count = 0;
+	}
+
+	TimerWheel::~TimerWheel() noexcept
+	{
+		removeAll();
+	}
+
+	void TimerWheel::_init(sl_uint64 now) noexcept
+	{
+		if (!m_flagInit) {
+			m_tickCurrent = now / m_tick;
+			m_flagInit = sl_true;
+		}
+	}
+
+	void TimerWheel::_link(Node* node) noexcept
+	{
+		// lowest level whose current block contains the expiration
+		sl_uint32 level = 0;
+		while (level < LevelsCount - 1) {
+			sl_uint32 shift = SlotBits * (level + 1);
+			if ((node->tick >> shift) == (m_tickCurrent >> shift)) {
+				break;
+			}
+			level++;
+		}
+		sl_uint32 slot = (sl_uint32)((node->tick >> (SlotBits * level)) & (SlotsCount - 1));
+		Node*& first = m_slots[level][slot];
+		node->level = level;
+		node->slot = slot;
+		node->before = sl_null;
+		node->next = first;
+		if (first) {
+			first->before = node;
+		}
+		first = node;
+		m_bitmaps[level] |= ((sl_uint64)1) << slot;
+	}
+
+	void TimerWheel::_unlink(Node* node) noexcept
+	{
+		if (node->before) {
+			node->before->next = node->next;
+		} else {
+			Node*& first = m_slots[node->level][node->slot];
+			first = node->next;
+			if (!first) {
+				m_bitmaps[node->level] &= ~(((sl_uint64)1) << node->slot);
+			}
+		}
+		if (node->next) {
+			node->next->before = node->before;
+		}
+	}
+
+	void TimerWheel::_cascade(sl_uint32 level) noexcept
+	{
+		sl_uint32 slot = (sl_uint32)((m_tickCurrent >> (SlotBits * level)) & (SlotsCount - 1));
+		Node* node = m_slots[level][slot];
+		if (!node) {
+			return;
+		}
+		m_slots[level][slot] = sl_null;
+		m_bitmaps[level] &= ~(((sl_uint64)1) << slot);
+		while (node) {
+			Node* next = node->next;
+			_link(node);
+			node = next;
+		}
+	}
+
+	sl_bool TimerWheel::_getNextTick(sl_uint64& tick, sl_uint32& level) noexcept
+	{
+		if (!m_count) {
+			return sl_false;
+		}
+		for (level = 0; level < LevelsCount; level++) {
+			sl_uint64 bits = m_bitmaps[level];
+			if (!bits) {
+				continue;
+			}
+			sl_uint32 shift = SlotBits * level;
+			sl_uint32 index = (sl_uint32)((m_tickCurrent >> shift) & (SlotsCount - 1));
+			// the start of the current block of this level
+			sl_uint64 base = (m_tickCurrent >> (shift + SlotBits)) << (shift + SlotBits);
+			sl_uint64 bitsAfter = index < SlotsCount - 1 ? (bits & ((~((sl_uint64)0)) << (index + 1))) : 0;
+			if (bitsAfter) {
+				tick = base + (((sl_uint64)(priv::timer_wheel::GetLowestBit(bitsAfter))) << shift);
+				return sl_true;
+			}
+			if (level == LevelsCount - 1) {
+				// the slots of the top level behind the current one are processed in the next rotation
+				base += ((sl_uint64)1) << (shift + SlotBits);
+				tick = base + (((sl_uint64)(priv::timer_wheel::GetLowestBit(bits))) << shift);
+				return sl_true;
+			}
+		}
+		return sl_false;
+	}
+
+	sl_uint64 TimerWheel::add(sl_uint64 now, sl_uint64 delay, UniqueFunction<void()>&& task) noexcept
+	{
+		if (task.isNull()) {
+			return 0;
+		}
+		_init(now);
+		Node* node = new Node;
+		if (!node) {
+			return 0;
+		}
+		m_lastId++;
+		node->id = m_lastId;
+		node->tick = (now + delay + m_tick - 1) / m_tick;
+		if (node->tick <= m_tickCurrent) {
+			node->tick = m_tickCurrent + 1;
+		}
+		node->task = Move(task);
+		if (!(m_mapNodes.put_NoLock(node->id, node))) {
+			delete node;
+			return 0;
+		}
+		_link(node);
+		m_count++;
+		return node->id;
+	}
+
+	sl_bool TimerWheel::cancel(sl_uint64 taskId) noexcept
+	{
+		Node* node;
+		if (m_mapNodes.remove_NoLock(taskId, &node)) {
+			_unlink(node);
+			delete node;
+			m_count--;
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	void TimerWheel::removeAll() noexcept
+	{
+		for (sl_uint32 level = 0; level < LevelsCount; level++) {
+			for (sl_uint32 slot = 0; slot < SlotsCount; slot++) {
+				Node* node = m_slots[level][slot];
+				while (node) {
+					Node* next = node->next;
+					delete node;
+					node = next;
+				}
+				m_slots[level][slot] = sl_null;
+			}
+			m_bitmaps[level] = 0;
+		}
+		m_mapNodes.removeAll_NoLock();
+		m_count = 0;
+	}
+
+	sl_size TimerWheel::getCount() const noexcept
+	{
+		return m_count;
+	}
+
+	sl_bool TimerWheel::isEmpty() const noexcept
+	{
+		return !m_count;
+	}
+
+	sl_uint32 TimerWheel::getTickMilliseconds() const noexcept
+	{
+		return m_tick;
+	}
+
+	sl_size TimerWheel::collect(sl_uint64 now, LinkedQueue< UniqueFunction<void()> >* output) noexcept
+	{
+		_init(now);
+		sl_uint64 tickNow = now / m_tick;
+		sl_size nExpired = 0;
+		while (m_tickCurrent < tickNow) {
+			sl_uint64 tick;
+			sl_uint32 level;
+			if (!(_getNextTick(tick, level)) || tick > tickNow) {
+				m_tickCurrent = tickNow;
+				break;
+			}
+			m_tickCurrent = tick;
+			// the upper levels first, because their tasks can move to the slots of the lower levels processed at this tick
+			for (level = LevelsCount - 1; level > 0; level--) {
+				if (!(tick & ((((sl_uint64)1) << (SlotBits * level)) - 1))) {
+					_cascade(level);
+				}
+			}
+			sl_uint32 slot = (sl_uint32)(tick & (SlotsCount - 1));
+			Node* node = m_slots[0][slot];
+			m_slots[0][slot] = sl_null;
+			m_bitmaps[0] &= ~(((sl_uint64)1) << slot);
+			while (node) {
+				Node* next = node->next;
+				m_mapNodes.remove_NoLock(node->id);
+				if (output) {
+					output->push_NoLock(Move(node->task));
+				}
+				delete node;
+				m_count--;
+				nExpired++;
+				node = next;
+			}
+		}
+		return nExpired;
+	}
+
+	sl_int64 TimerWheel::getTimeout(sl_uint64 now) noexcept
+	{
+		if (!m_count) {
+			return -1;
+		}
+		_init(now);
+		sl_uint64 tickNext;
+		sl_uint32 level;
+		if (!(_getNextTick(tickNext, level))) {
+			return -1;
+		}
+		// the tasks of a slot of the lowest level expire exactly at its tick
+		sl_uint64 tickExpire = tickNext;
+		if (level) {
+			// a slot of an upper level is only cascaded at `tickNext`. finds its earliest task
+			sl_uint32 slotStart, slotEnd;
+			if (level < LevelsCount - 1) {
+				slotStart = (sl_uint32)((tickNext >> (SlotBits * level)) & (SlotsCount - 1));
+				slotEnd = slotStart + 1;
+			} else {
+				// the top level can hold the tasks beyond one rotation in any slot
+				slotStart = 0;
+				slotEnd = SlotsCount;
+			}
+			tickExpire = 0;
+			for (sl_uint32 slot = slotStart; slot < slotEnd; slot++) {
+				Node* node = m_slots[level][slot];
+				while (node) {
+					if (!tickExpire || node->tick < tickExpire) {
+						tickExpire = node->tick;
+					}
+					node = node->next;
+				}
+			}
+		}
+		sl_uint64 timeExpire = tickExpire * m_tick;
+		if (timeExpire <= now) {
+			return 0;
+		}
+		return (sl_int64)(timeExpire - now);
+	}
+
+}
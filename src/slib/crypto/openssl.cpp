@@ -785,13 +785,13 @@ namespace slib
 					return sl_true;
 				}
 				
-				sl_bool addTask(const Function<void()>& callback) override
+				sl_bool addTask(UniqueFunction<void()>&& task) override
 				{
 					ObjectLocker lock(this);
 					if (m_baseStream.isNull()) {
 						return sl_false;
 					}
-					return m_baseStream->addTask(callback);
+					return m_baseStream->addTask(Move(task));
 				}
 				
 			};
@@ -216,6 +216,7 @@ namespace slib
 	DEFINE_HTTP_HEADER(Cookie, "Cookie")
 	DEFINE_HTTP_HEADER(Range, "Range")
 	DEFINE_HTTP_HEADER(IfModifiedSince, "If-Modified-Since")
+	DEFINE_HTTP_HEADER(IfNoneMatch, "If-None-Match")
 
 	DEFINE_HTTP_HEADER(TransferEncoding, "Transfer-Encoding")
 	DEFINE_HTTP_HEADER(AccessControlAllowOrigin, "Access-Control-Allow-Origin")
@@ -224,6 +225,63 @@ namespace slib
 	DEFINE_HTTP_HEADER(ContentRange, "Content-Range")
 	DEFINE_HTTP_HEADER(LastModified, "Last-Modified")
 	DEFINE_HTTP_HEADER(Location, "Location")
+	DEFINE_HTTP_HEADER(ETag, "ETag")
+	DEFINE_HTTP_HEADER(Vary, "Vary")
+
+	namespace priv
+	{
+		namespace http
+		{
+
+			SLIB_STATIC_STRING(g_header_Accept, "Accept")
+			SLIB_STATIC_STRING(g_header_AcceptLanguage, "Accept-Language")
+			SLIB_STATIC_STRING(g_header_UserAgent, "User-Agent")
+			SLIB_STATIC_STRING(g_header_Referer, "Referer")
+			SLIB_STATIC_STRING(g_header_Upgrade, "Upgrade")
+			SLIB_STATIC_STRING(g_header_Pragma, "Pragma")
+			SLIB_STATIC_STRING(g_header_XForwardedFor, "X-Forwarded-For")
+			SLIB_STATIC_STRING(g_header_XRequestedWith, "X-Requested-With")
+
+			SLIB_STATIC_STRING(g_version_1_1, "HTTP/1.1")
+			SLIB_STATIC_STRING(g_version_1_0, "HTTP/1.0")
+
+			// shares the string of the common names instead of allocating for every header.
+			// the other names are not interned: they come from the peer, and would fill the intern table permanently
+			static String GetCommonHeaderName(const sl_char8* name, sl_size len)
+			{
+				static const String* names[] = {
+					&HttpHeader::Host, &HttpHeader::Connection, &HttpHeader::KeepAlive, &HttpHeader::CacheControl, &HttpHeader::Authorization,
+					&HttpHeader::ContentLength, &HttpHeader::ContentType, &HttpHeader::ContentEncoding, &HttpHeader::AcceptEncoding,
+					&HttpHeader::Origin, &HttpHeader::Cookie, &HttpHeader::Range, &HttpHeader::IfModifiedSince, &HttpHeader::IfNoneMatch,
+					&HttpHeader::TransferEncoding, &g_header_Accept, &g_header_AcceptLanguage, &g_header_UserAgent, &g_header_Referer,
+					&g_header_Upgrade, &g_header_Pragma, &g_header_XForwardedFor, &g_header_XRequestedWith
+				};
+				for (sl_size i = 0; i < CountOfArray(names); i++) {
+					const String& str = *(names[i]);
+					if (str.getLength() == len && *(str.getData()) == *name && Base::equalsMemory(str.getData(), name, len)) {
+						return str;
+					}
+				}
+				return String(name, len);
+			}
+
+			static const String& GetCommonMethodName(const sl_char8* method, sl_size len)
+			{
+				static const String* names[] = {
+					&g_method_GET, &g_method_POST, &g_method_HEAD, &g_method_PUT, &g_method_DELETE,
+					&g_method_OPTIONS, &g_method_PATCH, &g_method_CONNECT, &g_method_TRACE
+				};
+				for (sl_size i = 0; i < CountOfArray(names); i++) {
+					const String& str = *(names[i]);
+					if (str.getLength() == len && Base::equalsMemory(str.getData(), method, len)) {
+						return str;
+					}
+				}
+				return String::null();
+			}
+
+		}
+	}
 
 	sl_reg HttpHeaderHelper::parseHeaders(HttpHeaderMap& map, const void* _data, sl_size size)
 	{
@@ -261,7 +319,7 @@ namespace slib
 			String name;
 			String value;
 			if (indexSplit != 0) {
-				name = String::fromUtf8(data + posStart, indexSplit - posStart);
+				name = priv::http::GetCommonHeaderName(data + posStart, indexSplit - posStart);
 				sl_size startValue = indexSplit + 1;
 				sl_size endValue = posCurrent;
 				while (startValue < endValue) {
@@ -276,7 +334,10 @@ namespace slib
 					}
 					endValue--;
 				}
-				value = Url::decodePercent(String::fromUtf8(data + startValue, endValue - startValue));
+				value = String::fromUtf8(data + startValue, endValue - startValue);
+				if (Base::findMemory(data + startValue, '%', endValue - startValue)) {
+					value = Url::decodePercent(value);
+				}
 			} else {
 				name = String::fromUtf8(data + posStart, posCurrent - posStart);
 			}
@@ -957,6 +1018,48 @@ namespace slib
 		}
 	}
 	
+	String HttpRequest::getRequestIfNoneMatch() const
+	{
+		return getRequestHeader(HttpHeader::IfNoneMatch);
+	}
+	
+	void HttpRequest::setRequestIfNoneMatch(const String& etags)
+	{
+		setRequestHeader(HttpHeader::IfNoneMatch, etags);
+	}
+	
+	sl_bool HttpRequest::isAcceptingEncoding(const String& encoding) const
+	{
+		String value = getRequestHeader(HttpHeader::AcceptEncoding);
+		if (value.isEmpty()) {
+			return sl_false;
+		}
+		sl_bool flagWildcard = sl_false;
+		ListElements<String> items(value.split(","));
+		for (sl_size i = 0; i < items.count; i++) {
+			String item = items[i];
+			String coding;
+			float q = 1;
+			sl_reg index = item.indexOf(';');
+			if (index >= 0) {
+				coding = item.substring(0, index).trim();
+				String param = item.substring(index + 1).trim();
+				if (param.startsWith("q=")) {
+					q = param.substring(2).trim().parseFloat(1);
+				}
+			} else {
+				coding = item.trim();
+			}
+			if (coding.equalsIgnoreCase(encoding)) {
+				return q > 0;
+			}
+			if (coding == "*") {
+				flagWildcard = q > 0;
+			}
+		}
+		return flagWildcard;
+	}
+	
 	HttpCacheControlRequest HttpRequest::getRequestCacheControl() const
 	{
 		HttpCacheControlRequest cc;
@@ -1358,7 +1461,16 @@ namespace slib
 		if (posCurrent == size) {
 			return 0;
 		}
-		setMethod(String::fromUtf8(data + posStart, posCurrent - posStart));
+		{
+			const String& method = priv::http::GetCommonMethodName(data + posStart, posCurrent - posStart);
+			if (method.isNotNull()) {
+				m_methodText = method;
+				m_methodTextUpper = method;
+				m_method = HttpMethodHelper::fromString(method);
+			} else {
+				setMethod(String::fromUtf8(data + posStart, posCurrent - posStart));
+			}
+		}
 		posCurrent++;
 
 		// uri
@@ -1404,7 +1516,16 @@ namespace slib
 		if (data[posCurrent + 1] != '\n') {
 			return -1;
 		}
-		setRequestVersion(String::fromUtf8(data + posStart, posCurrent - posStart));
+		{
+			sl_size lenVersion = posCurrent - posStart;
+			if (lenVersion == 8 && Base::equalsMemory(data + posStart, "HTTP/1.1", 8)) {
+				setRequestVersion(priv::http::g_version_1_1);
+			} else if (lenVersion == 8 && Base::equalsMemory(data + posStart, "HTTP/1.0", 8)) {
+				setRequestVersion(priv::http::g_version_1_0);
+			} else {
+				setRequestVersion(String::fromUtf8(data + posStart, lenVersion));
+			}
+		}
 		posCurrent += 2;
 
 		sl_reg iRet = HttpHeaderHelper::parseHeaders(m_requestHeaders, data + posCurrent, size - posCurrent);
@@ -1838,6 +1959,20 @@ namespace slib
 		}
 	}
 	
+	String HttpResponse::getResponseETag() const
+	{
+		return getResponseHeader(HttpHeader::ETag);
+	}
+	
+	void HttpResponse::setResponseETag(const String& etag)
+	{
+		if (etag.isNotEmpty()) {
+			setResponseHeader(HttpHeader::ETag, etag);
+		} else {
+			removeResponseHeader(HttpHeader::ETag);
+		}
+	}
+	
 	HttpCacheControlResponse HttpResponse::getResponseCacheControl() const
 	{
 		HttpCacheControlResponse cc;
@@ -0,0 +1,271 @@
+/*
+ *   Copyright (c) 2008-2018 SLIBIO <https://github.com/SLIBIO>
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"), to deal
+ *   in the Software without restriction, including without limitation the rights
+ *   to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *   copies of the Software, and to permit persons to whom the Software is
+ *   furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included in
+ *   all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *   AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *   OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *   THE SOFTWARE.
+ */
+
+#include "slib/network/http_content_cache.h"
+
+#include "slib/crypto/md5.h"
+#include "slib/crypto/zlib.h"
+
+namespace slib
+{
+
+	namespace priv
+	{
+		namespace http_content_cache
+		{
+
+			static String MakeETag(const Memory& data, const char* suffix)
+			{
+				sl_uint8 hash[MD5::HashSize];
+				MD5::hash(data, hash);
+				return "\"" + String::makeHexString(hash, sizeof(hash)) + suffix + "\"";
+			}
+
+		}
+	}
+
+	using namespace priv::http_content_cache;
+
+	HttpContent::HttpContent()
+	{
+	}
+
+	HttpContent::~HttpContent()
+	{
+	}
+
+	sl_size HttpContent::getMemorySize() const
+	{
+		return data.getSize() + dataGzip.getSize() + key.getLength() + sizeof(HttpContent);
+	}
+
+
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(HttpContentCacheParam)
+
+	HttpContentCacheParam::HttpContentCacheParam()
+	{
+		maxMemorySize = 0x2000000; // 32MB
+		maxContentSize = 0x100000; // 1MB
+		minCompressSize = 256;
+		compressionLevel = 9;
+	}
+
+
+	SLIB_DEFINE_OBJECT(HttpContentCache, Object)
+
+	HttpContentCache::HttpContentCache()
+	{
+		m_maxMemorySize = 0x2000000;
+		m_maxContentSize = 0x100000;
+		m_minCompressSize = 256;
+		m_compressionLevel = 9;
+
+		m_first = sl_null;
+		m_last = sl_null;
+		m_count = 0;
+		m_memorySize = 0;
+	}
+
+	HttpContentCache::~HttpContentCache()
+	{
+		removeAll();
+	}
+
+	Ref<HttpContentCache> HttpContentCache::create(const HttpContentCacheParam& param)
+	{
+		Ref<HttpContentCache> ret = new HttpContentCache;
+		if (ret.isNotNull()) {
+			ret->m_maxMemorySize = param.maxMemorySize;
+			ret->m_maxContentSize = param.maxContentSize;
+			ret->m_minCompressSize = param.minCompressSize;
+			ret->m_compressionLevel = param.compressionLevel;
+			return ret;
+		}
+		return sl_null;
+	}
+
+	Ref<HttpContentCache> HttpContentCache::create()
+	{
+		HttpContentCacheParam param;
+		return create(param);
+	}
+
+	Ref<HttpContent> HttpContentCache::get(const String& key)
+	{
+		MutexLocker lock(&m_lock);
+		Entry* entry;
+		if (m_map.get_NoLock(key, &entry)) {
+			if (entry != m_first) {
+				_unlink(entry);
+				_link(entry);
+			}
+			return entry->content;
+		}
+		return sl_null;
+	}
+
+	Ref<HttpContent> HttpContentCache::add(const String& key, const Memory& data, const String& contentType, const Time& modifiedTime)
+	{
+		if (data.isNull()) {
+			return sl_null;
+		}
+		Ref<HttpContent> content = new HttpContent;
+		if (content.isNull()) {
+			return sl_null;
+		}
+		content->key = key;
+		content->contentType = contentType;
+		content->modifiedTime = modifiedTime;
+		content->data = data;
+		content->etag = MakeETag(data, "");
+		sl_size size = data.getSize();
+		if (size >= m_minCompressSize && isCompressibleContentType(contentType)) {
+			Memory gzip = Zlib::compressGzip(data.getData(), size, m_compressionLevel);
+			if (gzip.isNotNull() && gzip.getSize() < size) {
+				content->dataGzip = gzip;
+				// the encoded representation needs its own strong tag
+				content->etagGzip = MakeETag(data, "-gz");
+			}
+		}
+		sl_size sizeContent = content->getMemorySize();
+		if (size > m_maxContentSize || sizeContent > m_maxMemorySize) {
+			return content;
+		}
+		Entry* entryNew = new Entry;
+		if (!entryNew) {
+			return content;
+		}
+		entryNew->content = content;
+		MutexLocker lock(&m_lock);
+		Entry* entryOld;
+		if (m_map.get_NoLock(key, &entryOld)) {
+			_remove(entryOld);
+		}
+		if (!(m_map.put_NoLock(key, entryNew))) {
+			delete entryNew;
+			return content;
+		}
+		_link(entryNew);
+		m_count++;
+		m_memorySize += sizeContent;
+		while (m_memorySize > m_maxMemorySize && m_last) {
+			_remove(m_last);
+		}
+		return content;
+	}
+
+	void HttpContentCache::remove(const String& key)
+	{
+		MutexLocker lock(&m_lock);
+		Entry* entry;
+		if (m_map.get_NoLock(key, &entry)) {
+			_remove(entry);
+		}
+	}
+
+	void HttpContentCache::removeAll()
+	{
+		MutexLocker lock(&m_lock);
+		Entry* entry = m_first;
+		while (entry) {
+			Entry* next = entry->next;
+			delete entry;
+			entry = next;
+		}
+		m_first = sl_null;
+		m_last = sl_null;
+		m_count = 0;
+		m_memorySize = 0;
+		m_map.removeAll_NoLock();
+	}
+
+	sl_size HttpContentCache::getCount()
+	{
+		return m_count;
+	}
+
+	sl_uint64 HttpContentCache::getMemorySize()
+	{
+		return m_memorySize;
+	}
+
+	sl_uint32 HttpContentCache::getMaxContentSize()
+	{
+		return m_maxContentSize;
+	}
+
+	sl_bool HttpContentCache::isCompressibleContentType(const String& _contentType)
+	{
+		String contentType = _contentType;
+		sl_reg index = contentType.indexOf(';');
+		if (index >= 0) {
+			contentType = contentType.substring(0, index);
+		}
+		contentType = contentType.trim().toLower();
+		if (contentType.startsWith("text/")) {
+			return sl_true;
+		}
+		if (contentType.endsWith("+xml") || contentType.endsWith("+json") || contentType.endsWith("/xml") || contentType.endsWith("/json") || contentType.endsWith("/javascript") || contentType.endsWith("/x-javascript")) {
+			return sl_true;
+		}
+		if (contentType == "application/wasm" || contentType == "font/ttf" || contentType == "font/otf" || contentType == "application/x-font-ttf" || contentType == "application/vnd.ms-fontobject") {
+			return sl_true;
+		}
+		return sl_false;
+	}
+
+	void HttpContentCache::_link(Entry* entry)
+	{
+		entry->before = sl_null;
+		entry->next = m_first;
+		if (m_first) {
+			m_first->before = entry;
+		} else {
+			m_last = entry;
+		}
+		m_first = entry;
+	}
+
+	void HttpContentCache::_unlink(Entry* entry)
+	{
+		if (entry->before) {
+			entry->before->next = entry->next;
+		} else {
+			m_first = entry->next;
+		}
+		if (entry->next) {
+			entry->next->before = entry->before;
+		} else {
+			m_last = entry->before;
+		}
+	}
+
+	void HttpContentCache::_remove(Entry* entry)
+	{
+		_unlink(entry);
+		m_map.remove_NoLock(entry->content->key);
+		m_memorySize -= entry->content->getMemorySize();
+		m_count--;
+		delete entry;
+	}
+
+}
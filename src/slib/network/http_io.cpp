@@ -71,6 +71,11 @@ namespace slib
 		m_bufferOutput.copyFromFile(path, dispatcher);
 	}
 
+	void HttpOutputBuffer::sendFile(const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		m_bufferOutput.sendFile(file, offset, size);
+	}
+
 	sl_uint64 HttpOutputBuffer::getOutputLength() const
 	{
 		return m_bufferOutput.getOutputLength();
@@ -507,4 +512,290 @@ namespace slib
 		}
 	}
 
+/***********************************************************************
+						HttpContentCompressor
+***********************************************************************/
+
+#define COMPRESSOR_INPUT_BUFFER_SIZE 0x10000
+#define COMPRESSOR_OUTPUT_BUFFER_SIZE 0x4000
+// chunk-size (8 hex digits at most) CRLF chunk-data CRLF
+#define CHUNK_OVERHEAD 12
+#define MIN_READ_SIZE 32
+
+	SLIB_DEFINE_OBJECT(HttpContentCompressor, AsyncStream)
+	
+	HttpContentCompressor::HttpContentCompressor()
+	{
+		m_flagOpened = sl_true;
+		m_flagError = sl_false;
+		m_flagReadingBody = sl_false;
+		m_flagProcessing = sl_false;
+		m_flagCompressed = sl_false;
+		m_flagEnded = sl_false;
+	}
+	
+	HttpContentCompressor::~HttpContentCompressor()
+	{
+		close();
+	}
+	
+	Ref<HttpContentCompressor> HttpContentCompressor::create(AsyncOutputBuffer* source, sl_bool flagGzip, sl_int32 level)
+	{
+		Ref<HttpContentCompressor> ret = new HttpContentCompressor;
+		if (ret.isNotNull()) {
+			ret->m_bufInput = Memory::create(COMPRESSOR_INPUT_BUFFER_SIZE);
+			ret->m_bufOutput = Memory::create(COMPRESSOR_OUTPUT_BUFFER_SIZE);
+			if (ret->m_bufInput.isNotNull() && ret->m_bufOutput.isNotNull()) {
+				sl_bool flagStarted;
+				if (flagGzip) {
+					flagStarted = ret->m_zlib.startGzip(level);
+				} else {
+					flagStarted = ret->m_zlib.start(level);
+				}
+				if (flagStarted) {
+					if (source) {
+						Ref<AsyncOutputBufferElement> element;
+						while (source->popElement(&element)) {
+							ret->m_elements.push(element);
+						}
+					}
+					return ret;
+				}
+			}
+		}
+		return sl_null;
+	}
+	
+	void HttpContentCompressor::close()
+	{
+		Ref<AsyncStreamRequest> request;
+		{
+			MutexLocker lock(&m_lock);
+			if (!m_flagOpened) {
+				return;
+			}
+			m_flagOpened = sl_false;
+			m_elements.removeAll();
+			m_elementCurrent.setNull();
+			m_bufCompressed.clear();
+			m_zlib.abort();
+			request = m_requestRead;
+			m_requestRead.setNull();
+		}
+		if (request.isNotNull()) {
+			request->runCallback(this, 0, sl_true);
+		}
+	}
+	
+	sl_bool HttpContentCompressor::isOpened()
+	{
+		return m_flagOpened;
+	}
+	
+	sl_bool HttpContentCompressor::read(void* data, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject)
+	{
+		if (!data || size < MIN_READ_SIZE) {
+			return sl_false;
+		}
+		Ref<AsyncStreamRequest> request = AsyncStreamRequest::createRead(data, size, userObject, callback);
+		if (request.isNull()) {
+			return sl_false;
+		}
+		{
+			MutexLocker lock(&m_lock);
+			if (!m_flagOpened || m_requestRead.isNotNull()) {
+				return sl_false;
+			}
+			m_requestRead = request;
+		}
+		_process();
+		return sl_true;
+	}
+	
+	sl_bool HttpContentCompressor::write(const void* data, sl_uint32 size, const Function<void(AsyncStreamResult&)>& callback, Referable* userObject)
+	{
+		return sl_false;
+	}
+	
+	sl_bool HttpContentCompressor::addTask(UniqueFunction<void()>&& task)
+	{
+		return sl_false;
+	}
+	
+	void HttpContentCompressor::_process()
+	{
+		Ref<AsyncStreamRequest> request;
+		sl_uint32 sizeResult = 0;
+		sl_bool flagError = sl_false;
+		{
+			MutexLocker lock(&m_lock);
+			request = m_requestRead;
+			if (request.isNull()) {
+				return;
+			}
+			m_flagProcessing = sl_true;
+			sl_bool flagReady = _prepareChunk(request->size - CHUNK_OVERHEAD);
+			m_flagProcessing = sl_false;
+			if (!flagReady) {
+				return;
+			}
+			m_requestRead.setNull();
+			if (m_flagError) {
+				flagError = sl_true;
+			} else {
+				sizeResult = _popChunk(request->data, request->size);
+			}
+		}
+		request->runCallback(this, sizeResult, flagError);
+	}
+	
+	sl_bool HttpContentCompressor::_prepareChunk(sl_uint32 sizeChunk)
+	{
+		for (;;) {
+			if (m_flagError || m_flagCompressed) {
+				return sl_true;
+			}
+			if (m_bufCompressed.getSize() >= sizeChunk) {
+				return sl_true;
+			}
+			if (m_flagReadingBody) {
+				// sends the compressed data while waiting for the body
+				return m_bufCompressed.getSize() > 0;
+			}
+			if (m_elementCurrent.isNull()) {
+				if (!(m_elements.pop(&m_elementCurrent))) {
+					if (!(_compress(sl_null, 0, sl_true))) {
+						m_flagError = sl_true;
+					}
+					m_flagCompressed = sl_true;
+					continue;
+				}
+			}
+			MemoryQueue& header = m_elementCurrent->getHeader();
+			if (header.getSize() > 0) {
+				MemoryData data;
+				while (header.pop(data)) {
+					if (!(_compress(data.data, data.size, sl_false))) {
+						m_flagError = sl_true;
+						break;
+					}
+				}
+				continue;
+			}
+			sl_uint64 sizeBody = m_elementCurrent->getBodySize();
+			if (sizeBody > 0) {
+				sl_uint32 sizeRead = (sl_uint32)(m_bufInput.getSize());
+				if (sizeRead > sizeBody) {
+					sizeRead = (sl_uint32)sizeBody;
+				}
+				Ref<File> file = m_elementCurrent->getBodyFile();
+				if (file.isNotNull()) {
+					sl_int32 n = file->readAt32(m_elementCurrent->getBodyFileOffset(), m_bufInput.getData(), sizeRead);
+					if (n > 0 && _compress(m_bufInput.getData(), n, sl_false)) {
+						m_elementCurrent->skipBodyFile(n);
+					} else {
+						m_flagError = sl_true;
+					}
+					continue;
+				}
+				Ref<AsyncStream> body = m_elementCurrent->getBody();
+				if (body.isNotNull()) {
+					m_flagReadingBody = sl_true;
+					if (!(body->read(m_bufInput.getData(), sizeRead, SLIB_FUNCTION_WEAKREF(HttpContentCompressor, _onReadBody, this)))) {
+						m_flagReadingBody = sl_false;
+						m_flagError = sl_true;
+					}
+					continue;
+				}
+			}
+			m_elementCurrent.setNull();
+		}
+	}
+	
+	sl_uint32 HttpContentCompressor::_popChunk(void* _data, sl_uint32 size)
+	{
+		sl_char8* data = (sl_char8*)_data;
+		sl_uint32 pos = 0;
+		sl_size sizeCompressed = m_bufCompressed.getSize();
+		if (sizeCompressed > 0) {
+			sl_uint32 sizeChunk = size - CHUNK_OVERHEAD;
+			if (sizeChunk > sizeCompressed) {
+				sizeChunk = (sl_uint32)sizeCompressed;
+			}
+			String hex = String::fromUint32(sizeChunk, 16);
+			sl_size lenHex = hex.getLength();
+			Base::copyMemory(data, hex.getData(), lenHex);
+			pos = (sl_uint32)lenHex;
+			data[pos++] = '\r';
+			data[pos++] = '\n';
+			pos += (sl_uint32)(m_bufCompressed.pop(data + pos, sizeChunk));
+			data[pos++] = '\r';
+			data[pos++] = '\n';
+		}
+		if (m_flagCompressed && !m_flagEnded && m_bufCompressed.getSize() == 0 && size - pos >= 5) {
+			// last-chunk and the empty trailer
+			Base::copyMemory(data + pos, "0\r\n\r\n", 5);
+			pos += 5;
+			m_flagEnded = sl_true;
+		}
+		return pos;
+	}
+	
+	sl_bool HttpContentCompressor::_compress(const void* _data, sl_size size, sl_bool flagFinish)
+	{
+		const sl_uint8* data = (const sl_uint8*)_data;
+		sl_uint8* output = (sl_uint8*)(m_bufOutput.getData());
+		sl_uint32 sizeOutput = (sl_uint32)(m_bufOutput.getSize());
+		for (;;) {
+			sl_uint32 sizeInput = size > 0x40000000 ? 0x40000000 : (sl_uint32)size;
+			sl_bool flagLast = flagFinish && sizeInput == size;
+			// deflate does not accept the empty input without flushing
+			if (!sizeInput && !flagLast) {
+				return sl_true;
+			}
+			sl_uint32 sizeInputPassed = 0, sizeOutputUsed = 0;
+			sl_int32 iRet = m_zlib.compress(data, sizeInput, sizeInputPassed, output, sizeOutput, sizeOutputUsed, flagLast);
+			if (iRet < 0) {
+				return sl_false;
+			}
+			if (sizeOutputUsed > 0) {
+				if (!(m_bufCompressed.add(Memory::create(output, sizeOutputUsed)))) {
+					return sl_false;
+				}
+			}
+			data += sizeInputPassed;
+			size -= sizeInputPassed;
+			if (iRet == 0) {
+				return sl_true;
+			}
+		}
+	}
+	
+	void HttpContentCompressor::_onReadBody(AsyncStreamResult& result)
+	{
+		{
+			MutexLocker lock(&m_lock);
+			m_flagReadingBody = sl_false;
+			if (!m_flagOpened) {
+				return;
+			}
+			if (result.flagError || !(result.size) || m_elementCurrent.isNull()) {
+				m_flagError = sl_true;
+			} else {
+				if (_compress(result.data, result.size, sl_false)) {
+					Ref<AsyncStream> body = m_elementCurrent->getBody();
+					sl_uint64 sizeBody = m_elementCurrent->getBodySize();
+					m_elementCurrent->setBody(body.get(), sizeBody > result.size ? sizeBody - result.size : 0);
+				} else {
+					m_flagError = sl_true;
+				}
+			}
+			if (m_flagProcessing) {
+				// completed in `_prepareChunk()`
+				return;
+			}
+		}
+		_process();
+	}
+
 }
@@ -35,8 +35,7 @@ namespace slib
 			class ServerConnectionProvider : public HttpServerConnectionProvider
 			{
 			public:
-				Ref<AsyncTcpServer> m_server;
-				Ref<AsyncIoLoop> m_loop;
+				List< Ref<AsyncTcpServer> > m_listeners;
 				TlsAcceptStreamParam m_tlsParam;
 				
 				struct StreamDesc
@@ -67,25 +66,17 @@ namespace slib
 							return sl_null;
 						}
 					}
-					Ref<AsyncIoLoop> loop = server->getAsyncIoLoop();
-					if (loop.isNotNull()) {
-						Ref<ServerConnectionProvider> ret = new ServerConnectionProvider;
-						if (ret.isNotNull()) {
-							ret->m_tlsParam = tlsParam;
-							ret->m_tlsParam.context = context;
-							ret->m_tlsParam.flagAutoStartHandshake = sl_false;
-							ret->m_tlsParam.onHandshake = SLIB_FUNCTION_WEAKREF(ServerConnectionProvider, onHandshake, ret);
-							ret->m_loop = loop;
-							ret->setServer(server);
-							AsyncTcpServerParam sp;
-							sp.bindAddress = addressListen;
-							sp.onAccept = SLIB_FUNCTION_WEAKREF(ServerConnectionProvider, onAccept, ret);
-							sp.ioLoop = loop;
-							Ref<AsyncTcpServer> server = AsyncTcpServer::create(sp);
-							if (server.isNotNull()) {
-								ret->m_server = server;
-								return ret;
-							}
+					Ref<ServerConnectionProvider> ret = new ServerConnectionProvider;
+					if (ret.isNotNull()) {
+						ret->m_tlsParam = tlsParam;
+						ret->m_tlsParam.context = context;
+						ret->m_tlsParam.flagAutoStartHandshake = sl_false;
+						ret->m_tlsParam.onHandshake = SLIB_FUNCTION_WEAKREF(ServerConnectionProvider, onHandshake, ret);
+						ret->setServer(server);
+						List< Ref<AsyncTcpServer> > listeners = server->createTcpListeners(addressListen, SLIB_FUNCTION_WEAKREF(ServerConnectionProvider, onAccept, ret));
+						if (listeners.isNotEmpty()) {
+							ret->m_listeners = listeners;
+							return ret;
 						}
 					}
 					return sl_null;
@@ -94,8 +85,9 @@ namespace slib
 				void release() override
 				{
 					ObjectLocker lock(this);
-					if (m_server.isNotNull()) {
-						m_server->close();
+					ListElements< Ref<AsyncTcpServer> > listeners(m_listeners);
+					for (sl_size i = 0; i < listeners.count; i++) {
+						listeners[i]->close();
 					}
 					m_streamsHandshaking.setNull();
 				}
@@ -104,7 +96,7 @@ namespace slib
 				{
 					Ref<HttpServer> server = getServer();
 					if (server.isNotNull()) {
-						Ref<AsyncIoLoop> loop = m_loop;
+						Ref<AsyncIoLoop> loop = server->getAcceptIoLoop(socketListen);
 						if (loop.isNull()) {
 							return;
 						}
@@ -30,6 +30,7 @@
 #include "slib/core/xml.h"
 #include "slib/core/content_type.h"
 #include "slib/core/log.h"
+#include "slib/core/system.h"
 
 #define SERVER_TAG "HTTP SERVER"
 
@@ -44,14 +45,20 @@ namespace slib
 
 	HttpServerContext::HttpServerContext()
 	{
+		m_flagParsedRequestHeader = sl_false;
+		m_requestHeaderData = sl_null;
+		m_requestHeaderSize = 0;
 		m_requestContentLength = 0;
+		m_requestBodySizeReceived = 0;
 		
 		m_flagProcessed = sl_false;
 		m_flagClosingConnection = sl_false;
 		m_flagProcessingByThread = sl_true;
 		m_flagKeepAlive = sl_true;
+		m_flagCompressingResponse = sl_false;
 		
 		m_flagBeganProcessing = sl_false;
+		m_flagCompleted = sl_false;
 	}
 
 	HttpServerContext::~HttpServerContext()
@@ -72,7 +79,10 @@ namespace slib
 
 	Memory HttpServerContext::getRawRequestHeader() const
 	{
-		return m_requestHeader;
+		if (m_requestHeaderData) {
+			return Memory::createStatic(m_requestHeaderData, m_requestHeaderSize, m_refRequestHeader.get());
+		}
+		return sl_null;
 	}
 
 	sl_uint64 HttpServerContext::getRequestContentLength() const
@@ -129,6 +139,13 @@ namespace slib
 
 	Ref<AsyncIoLoop> HttpServerContext::getAsyncIoLoop()
 	{
+		Ref<AsyncStream> io = getIO();
+		if (io.isNotNull()) {
+			Ref<AsyncIoLoop> loop = io->getIoLoop();
+			if (loop.isNotNull()) {
+				return loop;
+			}
+		}
 		Ref<HttpServer> server = getServer();
 		if (server.isNotNull()) {
 			return server->getAsyncIoLoop();
@@ -196,6 +213,24 @@ namespace slib
 		m_flagKeepAlive = flag;
 	}
 
+	sl_bool HttpServerContext::isCompressingResponse() const
+	{
+		return m_flagCompressingResponse;
+	}
+
+	void HttpServerContext::setCompressingResponse(sl_bool flag)
+	{
+		m_flagCompressingResponse = flag;
+	}
+
+	const Ref<Arena>& HttpServerContext::getArena()
+	{
+		if (m_arena.isNull()) {
+			m_arena = new Arena;
+		}
+		return m_arena;
+	}
+
 /******************************************************
 			HttpServerConnection
 ******************************************************/
@@ -208,7 +243,22 @@ namespace slib
 	{
 		m_flagClosed = sl_true;
 		m_flagReading = sl_false;
+		m_flagReadingBody = sl_false;
 		m_flagKeepAlive = sl_true;
+		m_flagStopInput = sl_false;
+		m_flagInputEnded = sl_false;
+		m_flagIdle = sl_false;
+		m_flagProcessingInput = sl_false;
+		m_flagWritingResponses = sl_false;
+		
+		m_posRead = 0;
+		m_sizeRead = 0;
+		m_posHeaderScan = 0;
+		
+		m_countRequests = 0;
+		m_timeRequestStart = 0;
+		m_timeDeadline = 0;
+		m_timeTimer = 0;
 	}
 
 	HttpServerConnection::~HttpServerConnection()
@@ -256,17 +306,21 @@ namespace slib
 		}
 		m_io->close();
 		m_output->close();
-		m_bufReadUnprocessed.setNull();
+		m_sizeRead = 0;
+		m_timeDeadline = 0;
+		m_contextCurrent.setNull();
+		m_queueContexts.removeAll_NoLock();
 	}
 
 	void HttpServerConnection::start()
 	{
-		m_contextCurrent.setNull();
-		if (m_bufReadUnprocessed.isNotEmpty()) {
-			_processInput(sl_null, 0);
-		} else {
-			_read();
+		{
+			ObjectLocker lock(this);
+			m_contextCurrent.setNull();
+			m_queueContexts.removeAll_NoLock();
+			m_flagStopInput = sl_false;
 		}
+		_processInput();
 	}
 
 	Ref<AsyncStream> HttpServerConnection::getIO()
@@ -290,17 +344,96 @@ namespace slib
 		if (m_flagClosed) {
 			return;
 		}
+		Ref<HttpServer> server = m_server;
+		if (server.isNotNull()) {
+			_updateDeadline(server.get());
+		}
 		if (m_flagReading) {
 			return;
 		}
+		Function<void(AsyncStreamResult&)> callback = SLIB_FUNCTION_WEAKREF(HttpServerConnection, onReadStream, this);
+		Ref<HttpServerContext> context = m_contextCurrent;
+		if (context.isNotNull() && context->m_flagParsedRequestHeader && !m_sizeRead) {
+			sl_size sizeBody = (sl_size)(context->m_requestContentLength);
+			sl_size sizeReceived = context->m_requestBodySizeReceived;
+			if (sizeReceived < sizeBody) {
+				// the body is read directly, without passing the read buffer
+				Memory body = context->m_requestBody;
+				sl_size sizeRead = sizeBody - sizeReceived;
+				if (sizeRead > 0x40000000) {
+					sizeRead = 0x40000000;
+				}
+				m_flagReading = sl_true;
+				m_flagReadingBody = sl_true;
+				if (!(m_io->read((sl_uint8*)(body.getData()) + sizeReceived, (sl_uint32)sizeRead, callback, body.ref.get()))) {
+					m_flagReading = sl_false;
+					m_flagReadingBody = sl_false;
+					close();
+				}
+				return;
+			}
+		}
+		// the raw headers of the pending requests refer to the buffer, so the buffer is replaced instead of being overwritten
+		sl_bool flagShared = m_queueContexts.isNotEmpty();
+		if (!m_sizeRead && !flagShared) {
+			m_posRead = 0;
+		}
+		sl_uint8* buf = (sl_uint8*)(m_bufRead.getData());
+		sl_size sizeBuf = m_bufRead.getSize();
+		if (m_posRead + m_sizeRead >= sizeBuf) {
+			if (m_posRead && !flagShared) {
+				Base::moveMemory(buf, buf + m_posRead, m_sizeRead);
+				m_posRead = 0;
+			} else {
+				if (!(_growReadBuffer(m_sizeRead < (sizeBuf >> 1) ? sizeBuf : sizeBuf << 1))) {
+					close();
+					return;
+				}
+				buf = (sl_uint8*)(m_bufRead.getData());
+				sizeBuf = m_bufRead.getSize();
+			}
+		}
+		sl_size sizeRead = sizeBuf - m_posRead - m_sizeRead;
 		m_flagReading = sl_true;
-		if (!(m_io->readToMemory(m_bufRead, SLIB_FUNCTION_WEAKREF(HttpServerConnection, onReadStream, this)))) {
+		if (!(m_io->read(buf + m_posRead + m_sizeRead, (sl_uint32)sizeRead, callback, m_bufRead.ref.get()))) {
 			m_flagReading = sl_false;
 			close();
 		}
 	}
 
-	void HttpServerConnection::_processInput(const void* _data, sl_uint32 size)
+	sl_bool HttpServerConnection::_growReadBuffer(sl_size size)
+	{
+		Memory mem = Memory::create(size);
+		if (mem.isNull()) {
+			return sl_false;
+		}
+		Base::copyMemory(mem.getData(), (sl_uint8*)(m_bufRead.getData()) + m_posRead, m_sizeRead);
+		m_bufRead = mem;
+		m_posRead = 0;
+		return sl_true;
+	}
+
+	sl_size HttpServerConnection::_findHeaderEnd()
+	{
+		const sl_uint8* data = (const sl_uint8*)(m_bufRead.getData()) + m_posRead;
+		sl_size size = m_sizeRead;
+		sl_size i = m_posHeaderScan > 3 ? m_posHeaderScan - 3 : 0;
+		while (i + 4 <= size) {
+			const sl_uint8* p = Base::findMemory(data + i, '\r', size - 3 - i);
+			if (!p) {
+				break;
+			}
+			i = p - data;
+			if (data[i + 1] == '\n' && data[i + 2] == '\r' && data[i + 3] == '\n') {
+				return i + 4;
+			}
+			i++;
+		}
+		m_posHeaderScan = size;
+		return 0;
+	}
+
+	void HttpServerConnection::_processInput()
 	{
 		Ref<HttpServer> server = m_server;
 		if (server.isNull()) {
@@ -309,170 +442,276 @@ namespace slib
 		
 		ObjectLocker lock(this);
 		
-		if (m_flagClosed) {
+		if (m_flagProcessingInput) {
+			// called while processing a request synchronously. the loop below continues
 			return;
 		}
-		
-		char* data = (char*)_data;
-		if (m_bufReadUnprocessed.isNotEmpty()) {
-			if (size) {
-				if (!(m_bufReadUnprocessed.addElements_NoLock((char*)data, size))) {
-					close();
-					return;
-				}
-			}
-			data = m_bufReadUnprocessed.getData();
-			size = (sl_uint32)(m_bufReadUnprocessed.getCount());
+		m_flagProcessingInput = sl_true;
+		while (_processNextInput(server.get())) {
 		}
-		
-		if (!size) {
-			_read();
-			return;
+		m_flagProcessingInput = sl_false;
+	}
+
+	sl_bool HttpServerConnection::_processNextInput(HttpServer* server)
+	{
+		if (m_flagClosed) {
+			return sl_false;
 		}
 		
 		const HttpServerParam& param = server->getParam();
-		sl_uint64 maxRequestHeadersSize = param.maxRequestHeadersSize;
-		sl_uint64 maxRequestBodySize = param.maxRequestBodySize;
 
 		Ref<HttpServerContext> _context = m_contextCurrent;
 		if (_context.isNull()) {
+			if (m_flagStopInput) {
+				return sl_false;
+			}
+			sl_size maxPipelined = param.maxPipelinedRequestsCount;
+			if (m_queueContexts.getCount() >= (maxPipelined ? maxPipelined : 1)) {
+				// resumed after the pending responses are written
+				return sl_false;
+			}
+			if (!m_sizeRead) {
+				if (!m_flagInputEnded) {
+					_read();
+				}
+				return sl_false;
+			}
 			_context = HttpServerContext::create(this);
 			if (_context.isNull()) {
 				close();
-				return;
+				return sl_false;
 			}
 			m_contextCurrent = _context;
 			_context->setProcessingByThread(param.flagProcessByThreads);
+			m_timeRequestStart = System::getTickCount64();
+			m_flagIdle = sl_false;
 		}
 		HttpServerContext* context = _context.get();
-		if (context->m_requestHeader.isNull()) {
-			sl_size posBody;
-			if (context->m_requestHeaderReader.add(data, size, posBody)) {
-				context->m_requestHeader = context->m_requestHeaderReader.mergeHeader();
-				if (context->m_requestHeader.isNull()) {
-					sendResponseAndClose_ServerError();
-					return;
+		if (!(context->m_flagParsedRequestHeader)) {
+			sl_size sizeHeader = _findHeaderEnd();
+			if (!sizeHeader) {
+				if (m_sizeRead > param.maxRequestHeadersSize) {
+					_processBadRequest();
+					return sl_false;
 				}
-				if (posBody > size) {
-					sendResponseAndClose_ServerError();
-					return;
+				_read();
+				return sl_false;
+			}
+			sl_uint8* data = (sl_uint8*)(m_bufRead.getData()) + m_posRead;
+			sl_reg iRet = context->parseRequestPacket(data, sizeHeader);
+			if (iRet != (sl_reg)sizeHeader) {
+				_processBadRequest();
+				return sl_false;
+			}
+			context->m_flagParsedRequestHeader = sl_true;
+			context->m_requestHeaderData = data;
+			context->m_requestHeaderSize = sizeHeader;
+			context->m_refRequestHeader = m_bufRead.ref;
+			m_posRead += sizeHeader;
+			m_sizeRead -= sizeHeader;
+			m_posHeaderScan = 0;
+			context->m_requestContentLength = context->getRequestContentLengthHeader();
+			if (context->m_requestContentLength > param.maxRequestBodySize) {
+				_processBadRequest();
+				return sl_false;
+			}
+			context->setKeepAlive(context->isRequestKeepAlive());
+			if (context->m_requestContentLength) {
+				context->m_requestBody = Memory::create((sl_size)(context->m_requestContentLength));
+				if (context->m_requestBody.isNull()) {
+					_processServerError();
+					return sl_false;
 				}
-				context->m_requestHeaderReader.clear();
-				Memory header = context->getRawRequestHeader();
-				sl_reg iRet = context->parseRequestPacket(header.getData(), header.getSize());
-				if (iRet != (sl_reg)(context->m_requestHeader.getSize())) {
-					sendResponseAndClose_BadRequest();
-					return;
+			}
+			context->applyQueryToParameters();
+			if (server->preprocessRequest(context)) {
+				_setDeadline(0);
+				return sl_false;
+			}
+		}
+		
+		sl_size sizeBody = (sl_size)(context->m_requestContentLength);
+		if (m_sizeRead && context->m_requestBodySizeReceived < sizeBody) {
+			sl_size n = sizeBody - context->m_requestBodySizeReceived;
+			if (n > m_sizeRead) {
+				n = m_sizeRead;
+			}
+			Memory body = context->m_requestBody;
+			Base::copyMemory((sl_uint8*)(body.getData()) + context->m_requestBodySizeReceived, (sl_uint8*)(m_bufRead.getData()) + m_posRead, n);
+			context->m_requestBodySizeReceived += n;
+			m_posRead += n;
+			m_sizeRead -= n;
+		}
+		if (context->m_requestBodySizeReceived < sizeBody) {
+			_read();
+			return sl_false;
+		}
+		
+		context->m_flagBeganProcessing = sl_true;
+		m_contextCurrent.setNull();
+		m_countRequests++;
+		// the processing time is not limited
+		_setDeadline(0);
+		if (!(m_queueContexts.push_NoLock(_context))) {
+			close();
+			return sl_false;
+		}
+		if (!(context->isKeepAlive()) || context->getMethod() == HttpMethod::CONNECT) {
+			m_flagStopInput = sl_true;
+		}
+
+		String multipartBoundary = context->getRequestMultipartFormDataBoundary();
+		if (multipartBoundary.isNotEmpty()) {
+			Memory body = context->getRequestBody();
+			context->applyMultipartFormData(multipartBoundary, body);
+		} else if (context->getMethod() == HttpMethod::POST) {
+			String reqContentType = context->getRequestContentTypeNoParams();
+			if (reqContentType == ContentType::WebForm) {
+				Memory body = context->getRequestBody();
+				context->applyFormUrlEncoded(body.getData(), body.getSize());
+			}
+		}
+		
+		if (context->isProcessingByThread()) {
+			Ref<ThreadPool> threadPool = server->getThreadPool();
+			if (threadPool.isNull() || !(threadPool->addTask(SLIB_BIND_WEAKREF(void(), HttpServerConnection, _processContext, this, _context)))) {
+				_completeContextWithServerError(context);
+				return sl_false;
+			}
+		} else {
+			_processContext(context);
+		}
+		return sl_true;
+	}
+
+	void HttpServerConnection::_updateDeadline(HttpServer* server)
+	{
+		const HttpServerParam& param = server->getParam();
+		sl_uint64 now = System::getTickCount64();
+		sl_uint64 deadline = 0;
+		m_flagIdle = sl_false;
+		Ref<HttpServerContext> context = m_contextCurrent;
+		if (context.isNotNull()) {
+			if (context->m_flagParsedRequestHeader) {
+				if (param.requestBodyTimeout) {
+					deadline = now + param.requestBodyTimeout;
 				}
-				context->m_requestContentLength = context->getRequestContentLengthHeader();
-				if (context->m_requestContentLength > maxRequestBodySize) {
-					sendResponseAndClose_BadRequest();
-					return;
+			} else {
+				if (param.requestHeaderTimeout) {
+					deadline = m_timeRequestStart + param.requestHeaderTimeout;
 				}
-				context->setKeepAlive(context->isRequestKeepAlive());
-				if (size > posBody) {
-					sl_size sizeRemain = (sl_size)size - posBody;
-					sl_size sizeRequired = (sl_size)(context->m_requestContentLength);
-					if (sizeRequired) {
-						if (sizeRequired < sizeRemain) {
-							context->m_requestBody = Memory::create(data + posBody, sizeRequired);
-							m_bufReadUnprocessed = List<char>::create(data + posBody + sizeRequired, sizeRemain - sizeRequired);
-						} else {
-							context->m_requestBody = Memory::create(data + posBody, sizeRemain);
-							m_bufReadUnprocessed.setNull();
-						}
-						if (!(context->m_requestBodyBuffer.add(context->m_requestBody))) {
-							sendResponseAndClose_ServerError();
-							return;
-						}
-					} else {
-						m_bufReadUnprocessed = List<char>::create(data + posBody, sizeRemain);
-					}
-				} else {
-					m_bufReadUnprocessed.setNull();
+			}
+			if (param.requestTimeout) {
+				sl_uint64 t = m_timeRequestStart + param.requestTimeout;
+				if (!deadline || t < deadline) {
+					deadline = t;
 				}
-				context->applyQueryToParameters();
-				if (server->preprocessRequest(context)) {
-					return;
+			}
+		} else if (m_queueContexts.isEmpty()) {
+			if (m_countRequests) {
+				m_flagIdle = sl_true;
+				if (param.keepAliveTimeout) {
+					deadline = now + param.keepAliveTimeout;
 				}
 			} else {
-				m_bufReadUnprocessed.setNull();
-				if (context->m_requestHeaderReader.getHeaderSize() > maxRequestHeadersSize) {
-					sendResponseAndClose_BadRequest();
-					return;
+				if (param.requestHeaderTimeout) {
+					deadline = now + param.requestHeaderTimeout;
 				}
 			}
+		}
+		_setDeadline(deadline);
+	}
+
+	void HttpServerConnection::_setDeadline(sl_uint64 deadline)
+	{
+		m_timeDeadline = deadline;
+		if (!deadline) {
+			return;
+		}
+		if (m_timeTimer && m_timeTimer <= deadline) {
+			// the armed timer is extended when it expires
+			return;
+		}
+		Ref<AsyncIoLoop> loop = m_io->getIoLoop();
+		if (loop.isNull()) {
+			return;
+		}
+		sl_uint64 now = System::getTickCount64();
+		if (loop->dispatch(SLIB_BIND_WEAKREF(void(), HttpServerConnection, _onTimer, this, deadline), deadline > now ? deadline - now : 1)) {
+			m_timeTimer = deadline;
+		}
+	}
+
+	void HttpServerConnection::_onTimer(sl_uint64 timeTimer)
+	{
+		ObjectLocker lock(this);
+		if (m_flagClosed || timeTimer != m_timeTimer) {
+			return;
+		}
+		m_timeTimer = 0;
+		if (!m_timeDeadline) {
+			return;
+		}
+		if (System::getTickCount64() < m_timeDeadline) {
+			_setDeadline(m_timeDeadline);
+			return;
+		}
+		m_timeDeadline = 0;
+		Ref<HttpServer> server = m_server;
+		if (server.isNotNull() && server->getParam().flagLogDebug) {
+			Log(SERVER_TAG, "[%s] Connection Timeout", String::fromPointerValue(this));
+		}
+		if (m_queueContexts.isEmpty()) {
+			close();
 		} else {
-			sl_size sizeBody = (sl_size)(context->m_requestContentLength);
-			sl_size sizeCurrent = context->m_requestBodyBuffer.getSize();
-			if (sizeCurrent < sizeBody) {
-				sl_size sizeRemain = sizeBody - sizeCurrent;
-				if (sizeRemain < size) {
-					if (!(context->m_requestBodyBuffer.add(Memory::create(data, sizeRemain)))) {
-						sendResponseAndClose_ServerError();
-						return;
-					}
-					m_bufReadUnprocessed = List<char>::create(data + sizeRemain, size - sizeRemain);
-				} else {
-					if (!(context->m_requestBodyBuffer.add(Memory::create(data, size)))) {
-						sendResponseAndClose_ServerError();
-						return;
-					}
-					m_bufReadUnprocessed.setNull();
-				}
-			}
+			// the connection is closed after the pending responses are written
+			m_flagStopInput = sl_true;
+			m_flagInputEnded = sl_true;
+			m_contextCurrent.setNull();
+			m_sizeRead = 0;
 		}
-		
-		if (!(context->m_flagBeganProcessing)) {
-			
-			if (context->m_requestHeader.isNotNull()) {
-				
-				sl_size sizeBody = (sl_size)(context->m_requestContentLength);
-				sl_size sizeCurrent = context->m_requestBodyBuffer.getSize();
-
-				if (sizeCurrent >= sizeBody) {
-					
-					context->m_flagBeganProcessing = sl_true;
-
-					if (sizeBody) {
-						if (context->m_requestBody.getSize() < sizeBody) {
-							context->m_requestBody = context->m_requestBodyBuffer.merge();
-							if (context->m_requestBody.isNull()) {
-								sendResponseAndClose_ServerError();
-								return;
-							}
-						}
-					}
-					context->m_requestBodyBuffer.clear();
-
-					String multipartBoundary = context->getRequestMultipartFormDataBoundary();
-					if (multipartBoundary.isNotEmpty()) {
-						Memory body = context->getRequestBody();
-						context->applyMultipartFormData(multipartBoundary, body);
-					} else if (context->getMethod() == HttpMethod::POST) {
-						String reqContentType = context->getRequestContentTypeNoParams();
-						if (reqContentType == ContentType::WebForm) {
-							Memory body = context->getRequestBody();
-							context->applyFormUrlEncoded(body.getData(), body.getSize());
-						}
-					}
-					
-					if (context->isProcessingByThread()) {
-						Ref<ThreadPool> threadPool = server->getThreadPool();
-						if (threadPool.isNotNull()) {
-							threadPool->addTask(SLIB_BIND_WEAKREF(void(), HttpServerConnection, _processContext, this, _context));
-						} else {
-							sendResponseAndClose_ServerError();
-						}
-					} else {
-						_processContext(context);
-					}
-					return;
-				}
-			}
-			
+	}
+
+	sl_bool HttpServerConnection::isIdle()
+	{
+		return m_flagIdle;
+	}
+
+	void HttpServerConnection::_processBadRequest()
+	{
+		m_contextCurrent.setNull();
+		if (m_queueContexts.isEmpty()) {
+			sendResponseAndClose_BadRequest();
+			return;
+		}
+		// the connection is closed after the pending responses are written
+		m_flagStopInput = sl_true;
+		m_flagInputEnded = sl_true;
+		m_sizeRead = 0;
+	}
+
+	void HttpServerConnection::_processServerError()
+	{
+		m_contextCurrent.setNull();
+		if (m_queueContexts.isEmpty()) {
+			sendResponseAndClose_ServerError();
+			return;
 		}
-		_read();
+		// the connection is closed after the pending responses are written
+		m_flagStopInput = sl_true;
+		m_flagInputEnded = sl_true;
+		m_sizeRead = 0;
+	}
+
+	void HttpServerConnection::_completeContextWithServerError(HttpServerContext* context)
+	{
+		m_flagStopInput = sl_true;
+		m_flagInputEnded = sl_true;
+		m_sizeRead = 0;
+		context->setResponseCode(HttpStatus::InternalServerError);
+		context->setResponseContentLengthHeader(0);
+		context->setKeepAlive(sl_false);
+		completeContext(context);
 	}
 
 	void HttpServerConnection::_processContext(const Ref<HttpServerContext>& context)
@@ -489,35 +728,121 @@ namespace slib
 	}
 
 	void HttpServerConnection::completeContext(HttpServerContext* context)
+	{
+		{
+			ObjectLocker lock(this);
+			context->m_flagCompleted = sl_true;
+		}
+		_writeResponses();
+	}
+
+	void HttpServerConnection::_writeResponses()
+	{
+		{
+			ObjectLocker lock(this);
+			if (m_flagWritingResponses) {
+				// the writing thread writes this response too
+				return;
+			}
+			m_flagWritingResponses = sl_true;
+		}
+		sl_bool flagWritten = sl_false;
+		for (;;) {
+			Ref<HttpServerContext> context;
+			{
+				ObjectLocker lock(this);
+				Link< Ref<HttpServerContext> >* front = m_queueContexts.getFront();
+				if (m_flagClosed || !front || !(front->value->m_flagCompleted)) {
+					m_flagWritingResponses = sl_false;
+					break;
+				}
+				m_queueContexts.pop_NoLock(&context);
+			}
+			if (!(_writeResponse(context.get()))) {
+				ObjectLocker lock(this);
+				m_flagWritingResponses = sl_false;
+				close();
+				return;
+			}
+			flagWritten = sl_true;
+			if (!(context->isKeepAlive())) {
+				ObjectLocker lock(this);
+				m_flagKeepAlive = sl_false;
+				m_flagStopInput = sl_true;
+				m_contextCurrent.setNull();
+				m_queueContexts.removeAll_NoLock();
+				m_flagWritingResponses = sl_false;
+				m_output->startWriting();
+				return;
+			}
+		}
+		if (flagWritten) {
+			{
+				ObjectLocker lock(this);
+				if (m_flagInputEnded && m_queueContexts.isEmpty()) {
+					m_flagKeepAlive = sl_false;
+				}
+			}
+			m_output->startWriting();
+			_processInput();
+		}
+	}
+
+	sl_bool HttpServerConnection::_writeResponse(HttpServerContext* context)
 	{
 		Memory header = context->makeResponsePacket();
 		if (header.isNull()) {
-			close();
-			return;
+			return sl_false;
 		}
 		if (!(m_output->write(header))) {
-			close();
-			return;
+			return sl_false;
 		}
-		m_output->mergeBuffer(&(context->m_bufferOutput));
-		if (context->isKeepAlive()) {
-			m_output->startWriting();
-			start();
+		if (context->isCompressingResponse()) {
+			sl_int32 level = 6;
+			Ref<HttpServer> server = getServer();
+			if (server.isNotNull()) {
+				level = server->getParam().responseCompressionLevel;
+			}
+			Ref<HttpContentCompressor> compressor = HttpContentCompressor::create(&(context->m_bufferOutput), context->getResponseContentEncoding() == "gzip", level);
+			if (compressor.isNull()) {
+				return sl_false;
+			}
+			m_output->copyFrom(compressor.get(), SLIB_UINT64_MAX);
 		} else {
-			m_contextCurrent.setNull();
-			m_flagKeepAlive = sl_false;
-			m_output->startWriting();
+			m_output->mergeBuffer(&(context->m_bufferOutput));
 		}
+		return sl_true;
 	}
 
 	void HttpServerConnection::onReadStream(AsyncStreamResult& result)
 	{
-		m_flagReading = sl_false;
-		if (result.flagError) {
-			close();
-		} else {
-			_processInput(result.data, result.size);
+		{
+			ObjectLocker lock(this);
+			m_flagReading = sl_false;
+			if (result.flagError) {
+				m_flagReadingBody = sl_false;
+				if (m_queueContexts.isEmpty()) {
+					close();
+				} else {
+					// the connection is closed after the pending responses are written
+					m_flagStopInput = sl_true;
+					m_flagInputEnded = sl_true;
+					m_contextCurrent.setNull();
+					m_sizeRead = 0;
+				}
+				return;
+			}
+			if (m_flagReadingBody) {
+				m_flagReadingBody = sl_false;
+				Ref<HttpServerContext> context = m_contextCurrent;
+				if (context.isNotNull()) {
+					context->m_requestBodySizeReceived += result.size;
+				}
+			} else {
+				m_sizeRead += result.size;
+			}
 		}
+		_processInput();
 	}
 
 	void HttpServerConnection::onAsyncOutputEnd(AsyncOutput* output, sl_bool flagError)
@@ -637,8 +962,7 @@ namespace slib
 			class DefaultConnectionProvider : public HttpServerConnectionProvider
 			{
 			public:
-				Ref<AsyncTcpServer> m_server;
-				Ref<AsyncIoLoop> m_loop;
+				List< Ref<AsyncTcpServer> > m_listeners;
 
 			public:
 				DefaultConnectionProvider()
@@ -653,21 +977,13 @@ namespace slib
 			public:
 				static Ref<HttpServerConnectionProvider> create(HttpServer* server, const SocketAddress& addressListen)
 				{
-					Ref<AsyncIoLoop> loop = server->getAsyncIoLoop();
-					if (loop.isNotNull()) {
-						Ref<DefaultConnectionProvider> ret = new DefaultConnectionProvider;
-						if (ret.isNotNull()) {
-							ret->m_loop = loop;
-							ret->setServer(server);
-							AsyncTcpServerParam sp;
-							sp.bindAddress = addressListen;
-							sp.onAccept = SLIB_FUNCTION_WEAKREF(DefaultConnectionProvider, onAccept, ret);
-							sp.ioLoop = loop;
-							Ref<AsyncTcpServer> server = AsyncTcpServer::create(sp);
-							if (server.isNotNull()) {
-								ret->m_server = server;
-								return ret;
-							}
+					Ref<DefaultConnectionProvider> ret = new DefaultConnectionProvider;
+					if (ret.isNotNull()) {
+						ret->setServer(server);
+						List< Ref<AsyncTcpServer> > listeners = server->createTcpListeners(addressListen, SLIB_FUNCTION_WEAKREF(DefaultConnectionProvider, onAccept, ret));
+						if (listeners.isNotEmpty()) {
+							ret->m_listeners = listeners;
+							return ret;
 						}
 					}
 					return sl_null;
@@ -676,8 +992,9 @@ namespace slib
 				void release() override
 				{
 					ObjectLocker lock(this);
-					if (m_server.isNotNull()) {
-						m_server->close();
+					ListElements< Ref<AsyncTcpServer> > listeners(m_listeners);
+					for (sl_size i = 0; i < listeners.count; i++) {
+						listeners[i]->close();
 					}
 				}
 
@@ -685,7 +1002,7 @@ namespace slib
 				{
 					Ref<HttpServer> server = getServer();
 					if (server.isNotNull()) {
-						Ref<AsyncIoLoop> loop = m_loop;
+						Ref<AsyncIoLoop> loop = server->getAcceptIoLoop(socketListen);
 						if (loop.isNull()) {
 							return;
 						}
@@ -1071,21 +1388,374 @@ namespace slib
 		add(HttpMethod::Unknown, path, onRequest);
 	}
 	
+	Ref<HttpServerCompiledRouter> HttpServerRouter::compile() const
+	{
+		return HttpServerCompiledRouter::create(*this);
+	}
 	
-	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(HttpServerParam)
-
-	HttpServerParam::HttpServerParam()
+	
+	HttpServerRouteParameters::HttpServerRouteParameters()
 	{
-		port = 8080;
-		
-		maxThreadsCount = 32;
-		flagProcessByThreads = sl_true;
-		
-		flagUseWebRoot = sl_false;
-		flagUseAsset = sl_false;
-		
-		maxRequestHeadersSize = 0x10000; // 64KB
-		maxRequestBodySize = 0x2000000; // 32MB
+		count = 0;
+	}
+	
+	
+	namespace priv
+	{
+		namespace http_server
+		{
+			
+			static sl_compare_result CompareSegment(const sl_char8* s1, sl_size n1, const sl_char8* s2, sl_size n2)
+			{
+				sl_compare_result c = Base::compareMemory((const sl_uint8*)s1, (const sl_uint8*)s2, n1 < n2 ? n1 : n2);
+				if (c) {
+					return c;
+				}
+				if (n1 < n2) {
+					return -1;
+				}
+				if (n1 > n2) {
+					return 1;
+				}
+				return 0;
+			}
+			
+		}
+	}
+	
+	HttpServerCompiledRoute::HttpServerCompiledRoute()
+	{
+	}
+	
+	HttpServerCompiledRoute::~HttpServerCompiledRoute()
+	{
+	}
+	
+	Ref<HttpServerCompiledRoute> HttpServerCompiledRoute::create(const HttpServerRoute& route)
+	{
+		Ref<HttpServerCompiledRoute> ret = new HttpServerCompiledRoute;
+		if (ret.isNotNull()) {
+			if (ret->_build(route) >= 0) {
+				return ret;
+			}
+		}
+		return sl_null;
+	}
+	
+	sl_int32 HttpServerCompiledRoute::_build(const HttpServerRoute& route)
+	{
+		sl_int32 index = (sl_int32)(m_nodes.getCount());
+		if (!(m_nodes.add_NoLock(Node()))) {
+			return -1;
+		}
+		
+		Node node;
+		node.onRequest = route.onRequest;
+		node.indexDefault = -1;
+		node.indexEllipsis = -1;
+		
+		List<Edge> edges;
+		for (auto& item : route.routes) {
+			Edge edge;
+			edge.label = item.key;
+			edge.lengthFirstSegment = edge.label.getLength();
+			const HttpServerRoute* child = &(item.value);
+			// merges the chain of the nodes having only one static child
+			while (child->onRequest.isNull() && child->parameterRoutes.isEmpty() && child->defaultRoute.isNull() && child->ellipsisRoute.isNull() && child->routes.getCount() == 1) {
+				auto next = child->routes.getFirstNode();
+				edge.label += "/";
+				edge.label += next->key;
+				child = &(next->value);
+			}
+			sl_int32 indexChild = _build(*child);
+			if (indexChild < 0) {
+				return -1;
+			}
+			edge.indexNode = (sl_uint32)indexChild;
+			if (!(edges.add_NoLock(edge))) {
+				return -1;
+			}
+		}
+		class EdgeCompare
+		{
+		public:
+			sl_compare_result operator()(const Edge& a, const Edge& b) const
+			{
+				return priv::http_server::CompareSegment(a.label.getData(), a.lengthFirstSegment, b.label.getData(), b.lengthFirstSegment);
+			}
+		};
+		edges.sort_NoLock(EdgeCompare());
+		node.countStaticEdges = (sl_uint32)(edges.getCount());
+		
+		{
+			ListElements< Pair<String, HttpServerRoute> > list(route.parameterRoutes);
+			for (sl_size i = 0; i < list.count; i++) {
+				Edge edge;
+				edge.label = list[i].first;
+				edge.lengthFirstSegment = edge.label.getLength();
+				sl_int32 indexChild = _build(list[i].second);
+				if (indexChild < 0) {
+					return -1;
+				}
+				edge.indexNode = (sl_uint32)indexChild;
+				if (!(edges.add_NoLock(edge))) {
+					return -1;
+				}
+			}
+			node.countParameterEdges = (sl_uint32)(list.count);
+		}
+		if (route.defaultRoute.isNotNull()) {
+			node.indexDefault = _build(*(route.defaultRoute));
+			if (node.indexDefault < 0) {
+				return -1;
+			}
+		}
+		if (route.ellipsisRoute.isNotNull()) {
+			node.indexEllipsis = _build(*(route.ellipsisRoute));
+			if (node.indexEllipsis < 0) {
+				return -1;
+			}
+		}
+		
+		node.indexEdges = (sl_uint32)(m_edges.getCount());
+		if (!(m_edges.addAll_NoLock(edges))) {
+			return -1;
+		}
+		*(m_nodes.getPointerAt(index)) = node;
+		return index;
+	}
+	
+	const Function<Variant(HttpServerContext*)>* HttpServerCompiledRoute::match(const StringView& path, HttpServerRouteParameters& parameters) const
+	{
+		parameters.count = 0;
+		if (m_nodes.isEmpty()) {
+			return sl_null;
+		}
+		return _match(m_nodes.getData(), m_edges.getData(), 0, path.getData(), path.getLength(), parameters);
+	}
+	
+	const Function<Variant(HttpServerContext*)>* HttpServerCompiledRoute::_match(const Node* nodes, const Edge* edges, sl_uint32 indexNode, const sl_char8* path, sl_size len, HttpServerRouteParameters& parameters) const
+	{
+		const Node& node = nodes[indexNode];
+		if (len && *path == '/') {
+			path++;
+			len--;
+		}
+		if (!len) {
+			if (node.onRequest.isNotNull()) {
+				return &(node.onRequest);
+			}
+			return sl_null;
+		}
+		const sl_char8* end = (const sl_char8*)(Base::findMemory(path, '/', len));
+		sl_size lenSegment = end ? (sl_size)(end - path) : len;
+		const Edge* nodeEdges = edges + node.indexEdges;
+		const Function<Variant(HttpServerContext*)>* ret;
+		
+		// static edges
+		{
+			sl_size low = 0;
+			sl_size high = node.countStaticEdges;
+			while (low < high) {
+				sl_size mid = (low + high) >> 1;
+				const Edge& edge = nodeEdges[mid];
+				sl_compare_result c = priv::http_server::CompareSegment(edge.label.getData(), edge.lengthFirstSegment, path, lenSegment);
+				if (c < 0) {
+					low = mid + 1;
+				} else if (c > 0) {
+					high = mid;
+				} else {
+					sl_size lenLabel = edge.label.getLength();
+					if (lenLabel == lenSegment || (lenLabel <= len && (lenLabel == len || path[lenLabel] == '/') && Base::equalsMemory(path, edge.label.getData(), lenLabel))) {
+						ret = _match(nodes, edges, edge.indexNode, path + lenLabel, len - lenLabel, parameters);
+						if (ret) {
+							return ret;
+						}
+					}
+					break;
+				}
+			}
+		}
+		
+		const sl_char8* next = path + lenSegment;
+		sl_size lenNext = len - lenSegment;
+		
+		// parameter edges
+		if (node.countParameterEdges) {
+			sl_uint32 n = parameters.count;
+			if (n < HttpServerRouteParameters::MaxCount) {
+				const Edge* edge = nodeEdges + node.countStaticEdges;
+				for (sl_uint32 i = 0; i < node.countParameterEdges; i++) {
+					parameters.names[n] = &(edge[i].label);
+					parameters.values[n] = StringView(path, lenSegment);
+					parameters.count = n + 1;
+					ret = _match(nodes, edges, edge[i].indexNode, next, lenNext, parameters);
+					if (ret) {
+						return ret;
+					}
+				}
+				parameters.count = n;
+			}
+		}
+		
+		// `*`
+		if (node.indexDefault >= 0) {
+			ret = _match(nodes, edges, node.indexDefault, next, lenNext, parameters);
+			if (ret) {
+				return ret;
+			}
+		}
+		
+		// `**`, matches one or more segments
+		if (node.indexEllipsis >= 0) {
+			for (;;) {
+				ret = _match(nodes, edges, node.indexEllipsis, next, lenNext, parameters);
+				if (ret) {
+					return ret;
+				}
+				if (lenNext <= 1) {
+					break;
+				}
+				end = (const sl_char8*)(Base::findMemory(next + 1, '/', lenNext - 1));
+				if (!end) {
+					break;
+				}
+				lenNext -= end - next;
+				next = end;
+			}
+			const Node& ellipsis = nodes[node.indexEllipsis];
+			if (ellipsis.onRequest.isNotNull()) {
+				return &(ellipsis.onRequest);
+			}
+		}
+		return sl_null;
+	}
+	
+	Variant HttpServerCompiledRoute::processRequest(const String& path, HttpServerContext* context) const
+	{
+		HttpServerRouteParameters params;
+		const Function<Variant(HttpServerContext*)>* onRequest = match(path, params);
+		if (onRequest) {
+			if (params.count) {
+				HashMap<String, String>& map = context->getParameters();
+				for (sl_uint32 i = 0; i < params.count; i++) {
+					StringView& view = params.values[i];
+					String value(view.getData(), view.getLength());
+					if (Base::findMemory(view.getData(), '%', view.getLength())) {
+						value = Url::decodePercent(value);
+					}
+					map.add_NoLock(*(params.names[i]), value);
+				}
+			}
+			return (*onRequest)(context);
+		}
+		return sl_false;
+	}
+	
+	
+	HttpServerCompiledRouter::HttpServerCompiledRouter()
+	{
+	}
+	
+	HttpServerCompiledRouter::~HttpServerCompiledRouter()
+	{
+	}
+	
+	Ref<HttpServerCompiledRouter> HttpServerCompiledRouter::create(const HttpServerRouter& router)
+	{
+		Ref<HttpServerCompiledRouter> ret = new HttpServerCompiledRouter;
+		if (ret.isNotNull()) {
+			_compile(ret->m_routes, router.routes);
+			_compile(ret->m_preRoutes, router.preRoutes);
+			_compile(ret->m_postRoutes, router.postRoutes);
+			return ret;
+		}
+		return sl_null;
+	}
+	
+	void HttpServerCompiledRouter::_compile(Ref<HttpServerCompiledRoute>* dst, const HashMap<HttpMethod, HttpServerRoute>& src)
+	{
+		for (auto& item : src) {
+			sl_uint32 method = (sl_uint32)(item.key);
+			if (method < MethodsCount) {
+				dst[method] = HttpServerCompiledRoute::create(item.value);
+			}
+		}
+	}
+	
+	Variant HttpServerCompiledRouter::_process(const Ref<HttpServerCompiledRoute>* routes, const String& path, HttpServerContext* context)
+	{
+		sl_uint32 method = (sl_uint32)(context->getMethod());
+		if (method && method < MethodsCount) {
+			HttpServerCompiledRoute* route = routes[method].get();
+			if (route) {
+				Variant result = route->processRequest(path, context);
+				if (!(result.isFalse())) {
+					return result;
+				}
+			}
+		}
+		HttpServerCompiledRoute* route = routes[(sl_uint32)(HttpMethod::Unknown)].get();
+		if (route) {
+			Variant result = route->processRequest(path, context);
+			if (!(result.isFalse())) {
+				return result;
+			}
+		}
+		return sl_false;
+	}
+	
+	Variant HttpServerCompiledRouter::processRequest(const String& path, HttpServerContext* context) const
+	{
+		return _process(m_routes, path, context);
+	}
+	
+	Variant HttpServerCompiledRouter::preProcessRequest(const String& path, HttpServerContext* context) const
+	{
+		return _process(m_preRoutes, path, context);
+	}
+	
+	Variant HttpServerCompiledRouter::postProcessRequest(const String& path, HttpServerContext* context) const
+	{
+		return _process(m_postRoutes, path, context);
+	}
+	
+	
+	SLIB_DEFINE_CLASS_DEFAULT_MEMBERS(HttpServerParam)
+
+	HttpServerParam::HttpServerParam()
+	{
+		port = 8080;
+		
+		maxThreadsCount = 32;
+		flagProcessByThreads = sl_true;
+		
+		ioLoopsCount = 1;
+		flagPinIoLoops = sl_false;
+		flagReusePort = sl_false;
+		
+		flagUseWebRoot = sl_false;
+		maxOpenFilesCount = 1000;
+		flagUseSendFile = sl_true;
+		flagUseAsset = sl_false;
+		
+		flagUseContentCache = sl_true;
+		contentCacheSize = 0x2000000; // 32MB
+		maxCachedContentSize = 0x100000; // 1MB
+		
+		flagCompressResponse = sl_false;
+		minCompressResponseSize = 256;
+		responseCompressionLevel = 6;
+		
+		maxRequestHeadersSize = 0x10000; // 64KB
+		maxRequestBodySize = 0x2000000; // 32MB
+		maxPipelinedRequestsCount = 16;
+		
+		maxConnectionsCount = 10000;
+		requestHeaderTimeout = 30000;
+		requestBodyTimeout = 60000;
+		requestTimeout = 300000;
+		keepAliveTimeout = 75000;
 		
 		flagAllowCrossOrigin = sl_false;
 		
@@ -1123,6 +1793,23 @@ namespace slib
 			}
 		}
 		
+		ioLoopsCount = conf["io_loops"].getUint32(ioLoopsCount);
+		flagPinIoLoops = conf["pin_io_loops"].getBoolean(flagPinIoLoops);
+		flagReusePort = conf["reuse_port"].getBoolean(flagReusePort);
+		
+		maxOpenFilesCount = conf["max_open_files"].getUint32(maxOpenFilesCount);
+		flagUseSendFile = conf["sendfile"].getBoolean(flagUseSendFile);
+		flagUseContentCache = conf["content_cache"].getBoolean(flagUseContentCache);
+		{
+			sl_uint32 n;
+			if (conf["content_cache_size"].getString().parseUint32(10, &n)) {
+				contentCacheSize = (sl_uint64)n * 1024 * 1024;
+			}
+		}
+		flagCompressResponse = conf["compress_response"].getBoolean(flagCompressResponse);
+		minCompressResponseSize = conf["min_compress_response_size"].getUint32(minCompressResponseSize);
+		responseCompressionLevel = conf["compression_level"].getInt32(responseCompressionLevel);
+		
 		Json cacheControl = conf["cache_control"];
 		if (cacheControl.isNotNull()) {
 			flagUseCacheControl = sl_true;
@@ -1136,6 +1823,12 @@ namespace slib
 				maxRequestBodySize = n * 1024 * 1024;
 			}
 		}
+		maxPipelinedRequestsCount = conf["max_pipelined_requests"].getUint32(maxPipelinedRequestsCount);
+		maxConnectionsCount = conf["max_connections"].getUint32(maxConnectionsCount);
+		requestHeaderTimeout = conf["request_header_timeout"].getUint32(requestHeaderTimeout);
+		requestBodyTimeout = conf["request_body_timeout"].getUint32(requestBodyTimeout);
+		requestTimeout = conf["request_timeout"].getUint32(requestTimeout);
+		keepAliveTimeout = conf["keep_alive_timeout"].getUint32(keepAliveTimeout);
 	}
 	
 	sl_bool HttpServerParam::parseJsonFile(const String& filePath)
@@ -1179,11 +1872,27 @@ namespace slib
 	sl_bool HttpServer::_init(const HttpServerParam& param)
 	{
 		m_param = param;
-		Ref<AsyncIoLoop> ioLoop = AsyncIoLoop::create(sl_false);
-		if (ioLoop.isNull()) {
+		m_router = param.router.compile();
+		if (m_router.isNull()) {
 			return sl_false;
 		}
-		m_ioLoop = ioLoop;
+		Ref<AsyncIoLoopGroup> ioLoopGroup = AsyncIoLoopGroup::create(param.ioLoopsCount, sl_false, param.flagPinIoLoops);
+		if (ioLoopGroup.isNull()) {
+			return sl_false;
+		}
+		m_ioLoopGroup = ioLoopGroup;
+		m_ioLoop = ioLoopGroup->getLoop(0);
+		if (param.flagUseWebRoot && param.maxOpenFilesCount) {
+			OpenFileCacheParam cacheParam;
+			cacheParam.maxFilesCount = param.maxOpenFilesCount;
+			m_fileCache = OpenFileCache::create(cacheParam);
+		}
+		if ((param.flagUseWebRoot || param.flagUseAsset) && param.flagUseContentCache) {
+			HttpContentCacheParam cacheParam;
+			cacheParam.maxMemorySize = param.contentCacheSize;
+			cacheParam.maxContentSize = param.maxCachedContentSize;
+			m_contentCache = HttpContentCache::create(cacheParam);
+		}
 		if (param.port) {
 			if (!(addHttpBinding(param.addressBind, param.port))) {
 				return sl_false;
@@ -1206,13 +1915,13 @@ namespace slib
 		if (m_flagRunning) {
 			return sl_true;
 		}
-		Ref<AsyncIoLoop> loop = m_ioLoop;
-		if (loop.isNotNull()) {
+		Ref<AsyncIoLoopGroup> ioLoopGroup = m_ioLoopGroup;
+		if (ioLoopGroup.isNotNull()) {
 			Ref<ThreadPool> threadPool = ThreadPool::create();
 			if (threadPool.isNotNull()) {
 				threadPool->setMaximumThreadsCount(m_param.maxThreadsCount);
 				m_threadPool = threadPool;
-				loop->start();
+				ioLoopGroup->start();
 				return sl_true;
 			}
 		}
@@ -1238,16 +1947,23 @@ namespace slib
 		}
 		m_connectionProviders.removeAll();
 		
-		Ref<AsyncIoLoop> ioLoop = m_ioLoop;
-		if (ioLoop.isNotNull()) {
-			ioLoop->release();
-			m_ioLoop.setNull();
+		Ref<AsyncIoLoopGroup> ioLoopGroup = m_ioLoopGroup;
+		if (ioLoopGroup.isNotNull()) {
+			ioLoopGroup->release();
+			m_ioLoopGroup.setNull();
 		}
+		m_ioLoop.setNull();
 		Ref<ThreadPool> threadPool = m_threadPool;
 		if (threadPool.isNotNull()) {
 			threadPool->release();
 			m_threadPool.setNull();
 		}
+		Ref<OpenFileCache> fileCache = m_fileCache;
+		if (fileCache.isNotNull()) {
+			fileCache->release();
+			m_fileCache.setNull();
+		}
+		m_contentCache.setNull();
 		m_connections.removeAll();
 	}
 
@@ -1261,6 +1977,11 @@ namespace slib
 		return m_ioLoop;
 	}
 
+	Ref<AsyncIoLoopGroup> HttpServer::getAsyncIoLoopGroup()
+	{
+		return m_ioLoopGroup;
+	}
+
 	Ref<ThreadPool> HttpServer::getThreadPool()
 	{
 		return m_threadPool;
@@ -1438,6 +2159,27 @@ namespace slib
 				String filePath = Assets::getFilePath(path);
 				return processFile(context, filePath);
 			} else {
+				Ref<HttpContentCache> contentCache = m_contentCache;
+				if (contentCache.isNotNull()) {
+					// assets do not change while running
+					String key = "asset:" + path;
+					Ref<HttpContent> content = contentCache->get(key);
+					if (content.isNull()) {
+						Memory mem = Assets::readAllBytes(path);
+						if (mem.isNull()) {
+							return sl_false;
+						}
+						String contentType = ContentTypeHelper::getFromFileExtension(ext);
+						if (contentType.isEmpty()) {
+							contentType = ContentType::OctetStream;
+						}
+						content = contentCache->add(key, mem, contentType, Time::zero());
+					}
+					if (content.isNotNull()) {
+						return processContent(context, content.get());
+					}
+					return sl_false;
+				}
 				Memory mem = Assets::readAllBytes(path);
 				if (mem.isNotNull()) {
 					String oldResponseContentType = context->getResponseContentType();
@@ -1457,71 +2199,279 @@ namespace slib
 		return sl_false;
 	}
 
-	sl_bool HttpServer::processFile(HttpServerContext* context, const String& path)
+	namespace priv
 	{
-		if (File::exists(path) && !(File::isDirectory(path))) {
+		namespace http_server
+		{
 
-			sl_uint64 totalSize = File::getSize(path);
+			static Ref<AsyncStream> OpenFileStream(HttpServerContext* context, const String& path, const Ref<Dispatcher>& dispatcher)
+			{
+#if defined(SLIB_PLATFORM_IS_LINUX)
+				// completed by the io_uring of the connection's loop, without the round trip to the thread pool
+				Ref<AsyncStream> stream = AsyncFile::openIoUring(path, FileMode::Read, context->getAsyncIoLoop());
+				if (stream.isNotNull()) {
+					return stream;
+				}
+#endif
+				return AsyncFile::openForRead(path, dispatcher);
+			}
 
-			String ext = File::getFileExtension(path);
-			
-			String oldResponseContentType = context->getResponseContentType();
-			if (oldResponseContentType.isEmpty()) {
-				String contentType = ContentTypeHelper::getFromFileExtension(ext);
-				if (contentType.isEmpty()) {
-					contentType = ContentType::OctetStream;
+			// `If-None-Match` uses the weak comparison
+			static sl_bool MatchETag(const String& ifNoneMatch, const String& etag)
+			{
+				ListElements<String> items(ifNoneMatch.split(","));
+				for (sl_size i = 0; i < items.count; i++) {
+					String item = items[i].trim();
+					if (item == "*") {
+						return sl_true;
+					}
+					if (item.startsWith("W/")) {
+						item = item.substring(2);
+					}
+					if (item == etag) {
+						return sl_true;
+					}
 				}
-				context->setResponseContentType(contentType);
+				return sl_false;
 			}
 
-			context->setResponseAcceptRanges(sl_true);
-			
-			_processCacheControl(context);
+		}
+	}
+
+	sl_bool HttpServer::processFile(HttpServerContext* context, const String& path)
+	{
+		Ref<OpenFileCache> cache = m_fileCache;
+		if (cache.isNotNull()) {
+			Ref<OpenFileInfo> info = cache->get(path);
+			if (info.isNotNull() && info->file.isNotNull()) {
+				return _processFile(context, path, info->size, info->modifiedTime, info->file);
+			}
+			return sl_false;
+		}
+		if (File::exists(path) && !(File::isDirectory(path))) {
+			return _processFile(context, path, File::getSize(path), File::getModifiedTime(path), sl_null);
+		}
+		return sl_false;
+	}
+
+	Ref<OpenFileCache> HttpServer::getOpenFileCache()
+	{
+		return m_fileCache;
+	}
 
-			Time lastModifiedTime = File::getModifiedTime(path);
-			context->setResponseLastModified(lastModifiedTime);
+	Ref<HttpContentCache> HttpServer::getContentCache()
+	{
+		return m_contentCache;
+	}
+
+	sl_bool HttpServer::processContent(HttpServerContext* context, HttpContent* content)
+	{
+		if (context->getResponseContentType().isEmpty()) {
+			context->setResponseContentType(content->contentType);
+		}
+		
+		context->setResponseAcceptRanges(sl_true);
+		
+		_processCacheControl(context);
+		
+		context->setResponseLastModified(content->modifiedTime);
+		
+		String rangeHeader = context->getRequestRange();
+		
+		sl_bool flagGzip = sl_false;
+		if (content->dataGzip.isNotNull()) {
+			context->setResponseHeader(HttpHeader::Vary, HttpHeader::AcceptEncoding);
+			// ranges are served from the identity representation
+			flagGzip = rangeHeader.isEmpty() && context->isAcceptingEncoding("gzip");
+		}
+		const String& etag = flagGzip ? content->etagGzip : content->etag;
+		context->setResponseETag(etag);
+		
+		String ifNoneMatch = context->getRequestIfNoneMatch();
+		if (ifNoneMatch.isNotEmpty()) {
+			if (priv::http_server::MatchETag(ifNoneMatch, etag)) {
+				context->setResponseCode(HttpStatus::NotModified);
+				return sl_true;
+			}
+		} else {
 			Time ifModifiedSince = context->getRequestIfModifiedSince();
-			if (ifModifiedSince.isNotZero() && ifModifiedSince == lastModifiedTime) {
+			if (ifModifiedSince.isNotZero() && ifModifiedSince == content->modifiedTime) {
 				context->setResponseCode(HttpStatus::NotModified);
 				return sl_true;
 			}
+		}
+		
+		if (rangeHeader.isNotEmpty()) {
+			sl_uint64 start;
+			sl_uint64 len;
+			if (processRangeRequest(context, content->data.getSize(), rangeHeader, start, len)) {
+				context->write(content->data.sub((sl_size)start, (sl_size)len));
+			}
+			return sl_true;
+		}
+		
+		if (flagGzip) {
+			context->setResponseContentEncoding("gzip");
+			context->write(content->dataGzip);
+		} else {
+			context->write(content->data);
+		}
+		return sl_true;
+	}
+
+	sl_bool HttpServer::_processFile(HttpServerContext* context, const String& path, sl_uint64 totalSize, const Time& lastModifiedTime, const Ref<File>& file)
+	{
+		String ext = File::getFileExtension(path);
+		
+		String oldResponseContentType = context->getResponseContentType();
+		
+		Ref<HttpContentCache> contentCache = m_contentCache;
+		if (contentCache.isNotNull() && totalSize <= contentCache->getMaxContentSize()) {
+			String contentType = oldResponseContentType;
+			if (contentType.isEmpty()) {
+				contentType = ContentTypeHelper::getFromFileExtension(ext);
+			}
+			// the other files are sent from the page cache
+			if (HttpContentCache::isCompressibleContentType(contentType)) {
+				String key = "file:" + path;
+				Ref<HttpContent> content = contentCache->get(key);
+				if (content.isNull() || content->modifiedTime != lastModifiedTime || content->data.getSize() != totalSize) {
+					content = contentCache->add(key, File::readAllBytes(path), contentType, lastModifiedTime);
+				}
+				if (content.isNotNull()) {
+					return processContent(context, content.get());
+				}
+			}
+		}
+		
+		if (oldResponseContentType.isEmpty()) {
+			String contentType = ContentTypeHelper::getFromFileExtension(ext);
+			if (contentType.isEmpty()) {
+				contentType = ContentType::OctetStream;
+			}
+			context->setResponseContentType(contentType);
+		}
+
+		context->setResponseAcceptRanges(sl_true);
+		
+		_processCacheControl(context);
+
+		context->setResponseLastModified(lastModifiedTime);
+		Time ifModifiedSince = context->getRequestIfModifiedSince();
+		if (ifModifiedSince.isNotZero() && ifModifiedSince == lastModifiedTime) {
+			context->setResponseCode(HttpStatus::NotModified);
+			return sl_true;
+		}
+		
+		String rangeHeader = context->getRequestRange();
+		
+		if (rangeHeader.isNotEmpty()) {
 			
-			String rangeHeader = context->getRequestRange();
+			sl_uint64 start;
+			sl_uint64 len;
 			
-			if (rangeHeader.isNotEmpty()) {
-				
-				sl_uint64 start;
-				sl_uint64 len;
-				
-				if (processRangeRequest(context, totalSize, rangeHeader, start, len)) {
+			if (processRangeRequest(context, totalSize, rangeHeader, start, len)) {
 
-					Ref<AsyncFile> file = AsyncFile::openForRead(path, m_threadPool);
-					if (file.isNotNull()) {
-						file->seek(start);
-						context->copyFrom(file.get(), len);
-						return sl_true;
-					}
-					
-				} else {
+				if (file.isNotNull() && _sendFile(context, file, start, len)) {
+					return sl_true;
+				}
+				Ref<AsyncStream> stream = priv::http_server::OpenFileStream(context, path, m_threadPool);
+				if (stream.isNotNull()) {
+					stream->seek(start);
+					context->copyFrom(stream.get(), len);
 					return sl_true;
 				}
 				
 			} else {
-				if (totalSize > 100000) {
-					context->copyFromFile(path, m_threadPool);
+				return sl_true;
+			}
+			
+		} else {
+			if (file.isNotNull() && _sendFile(context, file, 0, totalSize)) {
+				return sl_true;
+			}
+			if (totalSize > 100000) {
+				Ref<AsyncStream> stream = priv::http_server::OpenFileStream(context, path, m_threadPool);
+				if (stream.isNotNull()) {
+					context->copyFrom(stream.get(), totalSize);
+				}
+				return sl_true;
+			} else {
+				Memory mem = File::readAllBytes(path);
+				if (mem.isNotNull()) {
+					context->write(mem);
 					return sl_true;
-				} else {
-					Memory mem = File::readAllBytes(path);
-					if (mem.isNotNull()) {
-						context->write(mem);
-						return sl_true;
-					}
 				}
 			}
-			
 		}
 		return sl_false;
 	}
+
+	sl_bool HttpServer::_prepareCompressingResponse(HttpServerContext* context)
+	{
+		if (!(m_param.flagCompressResponse)) {
+			return sl_false;
+		}
+		// the chunked transfer coding is not supported by HTTP/1.0
+		if (context->getRequestVersion() != "HTTP/1.1") {
+			return sl_false;
+		}
+		sl_uint32 code = (sl_uint32)(context->getResponseCode());
+		if (code < 200 || code == (sl_uint32)(HttpStatus::NoContent) || code == (sl_uint32)(HttpStatus::PartialContent) || code == (sl_uint32)(HttpStatus::NotModified)) {
+			return sl_false;
+		}
+		if (context->getResponseContentLength() < m_param.minCompressResponseSize) {
+			return sl_false;
+		}
+		if (context->containsResponseHeader(HttpHeader::ContentEncoding) || context->containsResponseHeader(HttpHeader::ContentRange) || context->containsResponseHeader(HttpHeader::TransferEncoding)) {
+			return sl_false;
+		}
+		if (context->getResponseHeader(HttpHeader::CacheControl).contains("no-transform")) {
+			return sl_false;
+		}
+		if (!(HttpContentCache::isCompressibleContentType(context->getResponseContentType()))) {
+			return sl_false;
+		}
+		String encoding;
+		if (context->isAcceptingEncoding("gzip")) {
+			encoding = "gzip";
+		} else if (context->isAcceptingEncoding("deflate")) {
+			encoding = "deflate";
+		}
+		String vary = context->getResponseHeader(HttpHeader::Vary);
+		if (vary.isEmpty()) {
+			context->setResponseHeader(HttpHeader::Vary, HttpHeader::AcceptEncoding);
+		} else if (vary.indexOf(HttpHeader::AcceptEncoding) < 0 && vary != "*") {
+			context->setResponseHeader(HttpHeader::Vary, vary + ", " + HttpHeader::AcceptEncoding);
+		}
+		if (encoding.isNull()) {
+			return sl_false;
+		}
+		// the compressed bytes are not the same at the other compression levels
+		String etag = context->getResponseETag();
+		if (etag.isNotEmpty() && !(etag.startsWith("W/"))) {
+			context->setResponseETag("W/" + etag);
+		}
+		context->removeResponseHeader(HttpHeader::ContentLength);
+		context->setResponseContentEncoding(encoding);
+		context->setResponseTransferEncoding("chunked");
+		context->setCompressingResponse();
+		return sl_true;
+	}
+
+	sl_bool HttpServer::_sendFile(HttpServerContext* context, const Ref<File>& file, sl_uint64 offset, sl_uint64 size)
+	{
+		if (!(m_param.flagUseSendFile)) {
+			return sl_false;
+		}
+		// TLS connections need the contents in the user space
+		Ref<AsyncStream> io = context->getIO();
+		if (io.isNull() || !(io->isSupportedSendFile())) {
+			return sl_false;
+		}
+		context->sendFile(file, offset, size);
+		return sl_true;
+	}
 	
 	void HttpServer::_processCacheControl(HttpServerContext* context)
 	{
@@ -1563,7 +2513,8 @@ namespace slib
 				return sl_false;
 			}
 		}
-		if (indexSplit == 0) {
+		if (indexSplit == 6) {
+			// suffix range: "bytes=-N"
 			if (n2 == 0) {
 				context->setResponseCode(HttpStatus::NoContent);
 				return sl_false;
@@ -1574,7 +2525,7 @@ namespace slib
 				return sl_false;
 			}
 			outStart = totalLength - n2;
-			outLength = totalLength - 1;
+			outLength = n2;
 		} else {
 			if (n1 >= totalLength) {
 				context->setResponseCode(HttpStatus::RequestRangeNotSatisfiable);
@@ -1612,13 +2563,13 @@ namespace slib
 			}
 		}
 		{
-			Variant result = m_param.router.preProcessRequest(context->getPath(), context);
+			Variant result = m_router->preProcessRequest(context->getPath(), context);
 			if (!(result.isFalse())) {
 				return result;
 			}
 		}
 		{
-			Variant result = m_param.router.processRequest(context->getPath(), context);
+			Variant result = m_router->processRequest(context->getPath(), context);
 			if (!(result.isFalse())) {
 				return result;
 			}
@@ -1642,7 +2593,7 @@ namespace slib
 			context->setResponseAccessControlAllowOrigin("*");
 		}
 
-		m_param.router.postProcessRequest(context->getPath(), context);
+		m_router->postProcessRequest(context->getPath(), context);
 		m_param.onPostRequest(context);
 		onPostRequest(context);
 		
@@ -1665,12 +2616,30 @@ namespace slib
 			context->setResponseContentType(ContentType::TextHtml_Utf8);
 		}
 
-		context->setResponseContentLengthHeader(context->getResponseContentLength());
+		if (!(_prepareCompressingResponse(context))) {
+			context->setResponseContentLengthHeader(context->getResponseContentLength());
+		}
 
 	}
 
 	Ref<HttpServerConnection> HttpServer::addConnection(const Ref<AsyncStream>& stream, const SocketAddress& remoteAddress, const SocketAddress& localAddress)
 	{
+		sl_uint32 maxConnections = m_param.maxConnectionsCount;
+		if (maxConnections && m_connections.getCount() >= maxConnections) {
+			if (!(_closeIdleConnection())) {
+				if (m_param.flagLogDebug) {
+					Log(SERVER_TAG, "Connection Rejected - Address: %s", remoteAddress.toString());
+				}
+				static char s[] = "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\nConnection: close\r\nRetry-After: 1\r\n\r\n";
+				Ref<AsyncStream> refStream = stream;
+				if (!(stream->writeFromMemory(Memory::createStatic(s, sizeof(s) - 1), [refStream](AsyncStreamResult&) {
+					refStream->close();
+				}))) {
+					stream->close();
+				}
+				return sl_null;
+			}
+		}
 		Ref<HttpServerConnection> connection = HttpServerConnection::create(this, stream.get());
 		if (connection.isNotNull()) {
 			if (m_param.flagLogDebug) {
@@ -1694,6 +2663,30 @@ namespace slib
 		m_connections.remove(connection);
 	}
 
+	sl_size HttpServer::getConnectionsCount()
+	{
+		return m_connections.getCount();
+	}
+
+	sl_bool HttpServer::_closeIdleConnection()
+	{
+		Ref<HttpServerConnection> connection;
+		{
+			MutexLocker lock(m_connections.getLocker());
+			for (auto& item : m_connections) {
+				if (item.key->isIdle()) {
+					connection = item.value;
+					break;
+				}
+			}
+		}
+		if (connection.isNotNull()) {
+			connection->close();
+			return sl_true;
+		}
+		return sl_false;
+	}
+
 	void HttpServer::addConnectionProvider(const Ref<HttpServerConnectionProvider>& provider)
 	{
 		m_connectionProviders.add(provider);
@@ -1724,4 +2717,53 @@ namespace slib
 		return addHttpBinding(SocketAddress(addr, port));
 	}
 
+	List< Ref<AsyncTcpServer> > HttpServer::createTcpListeners(const SocketAddress& addr, const Function<void(AsyncTcpServer*, Socket*, const SocketAddress&)>& onAccept)
+	{
+		Ref<AsyncIoLoopGroup> ioLoopGroup = m_ioLoopGroup;
+		if (ioLoopGroup.isNull()) {
+			return sl_null;
+		}
+		sl_uint32 nLoops = ioLoopGroup->getLoopsCount();
+		sl_bool flagReusePort = m_param.flagReusePort && nLoops > 1;
+		if (!flagReusePort) {
+			nLoops = 1;
+		}
+		List< Ref<AsyncTcpServer> > listeners;
+		for (sl_uint32 i = 0; i < nLoops; i++) {
+			AsyncTcpServerParam sp;
+			sp.bindAddress = addr;
+			sp.flagReusePort = flagReusePort;
+			sp.onAccept = onAccept;
+			sp.ioLoop = ioLoopGroup->getLoop(i);
+			Ref<AsyncTcpServer> listener = AsyncTcpServer::create(sp);
+			if (listener.isNull()) {
+				ListElements< Ref<AsyncTcpServer> > list(listeners);
+				for (sl_size k = 0; k < list.count; k++) {
+					list[k]->close();
+				}
+				return sl_null;
+			}
+			listeners.add_NoLock(listener);
+		}
+		return listeners;
+	}
+
+	Ref<AsyncIoLoop> HttpServer::getAcceptIoLoop(AsyncTcpServer* listener)
+	{
+		if (m_param.flagReusePort) {
+			// sharded by the kernel: the connection stays on the listener's loop
+			if (listener) {
+				Ref<AsyncIoLoop> loop = listener->getIoLoop();
+				if (loop.isNotNull()) {
+					return loop;
+				}
+			}
+		}
+		Ref<AsyncIoLoopGroup> ioLoopGroup = m_ioLoopGroup;
+		if (ioLoopGroup.isNotNull()) {
+			return ioLoopGroup->getLeastLoadedLoop();
+		}
+		return sl_null;
+	}
+
 }
@@ -135,18 +135,19 @@ namespace slib
 			}
 		}
 
-		Ref<AsyncTcpSocketInstance> instance = _createInstance(socket);
-		if (instance.isNotNull()) {
-			Ref<AsyncIoLoop> loop = param.ioLoop;
+		Ref<AsyncIoLoop> loop = param.ioLoop;
+		if (loop.isNull()) {
+			loop = AsyncIoLoop::getDefault();
 			if (loop.isNull()) {
-				loop = AsyncIoLoop::getDefault();
-				if (loop.isNull()) {
-					return sl_null;
-				}
+				return sl_null;
 			}
+		}
+		Ref<AsyncTcpSocketInstance> instance = _createInstance(socket, loop);
+		if (instance.isNotNull()) {
 			Ref<AsyncTcpSocket> ret = new AsyncTcpSocket;
 			if (ret.isNotNull()) {
-				if (ret->_initialize(instance.get(), AsyncIoMode::InOut, loop)) {
+				// completion-based instances are not registered for the readiness events
+				if (ret->_initialize(instance.get(), instance->getMode(), loop)) {
 					ret->m_onConnect = param.onConnect;
 					ret->m_onError = param.onError;
 					if (param.connectAddress.isValid()) {
@@ -336,6 +337,7 @@ namespace slib
 		
 		flagAutoStart = sl_true;
 		flagLogError = sl_true;
+		flagReusePort = sl_false;
 	}
 
 
@@ -378,6 +380,14 @@ namespace slib
 			 */
 			socket->setOption_ReuseAddress(sl_true);
 #endif
+			if (param.flagReusePort) {
+				if (!(socket->setOption_ReusePort(sl_true))) {
+					if (param.flagLogError) {
+						LogError(TAG, "AsyncTcpServer reuse-port error: %s, %s", param.bindAddress.toString(), socket->getLastErrorMessage());
+					}
+					return sl_null;
+				}
+			}
 
 			if (!(socket->bind(param.bindAddress))) {
 				if (param.flagLogError) {
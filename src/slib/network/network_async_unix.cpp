@@ -26,6 +26,22 @@
 
 #include "network_async.h"
 
+#include "slib/core/pipe.h"
+
+#include "../core/async_io_uring.h"
+
+#if defined(SLIB_PLATFORM_IS_LINUX)
+#include <errno.h>
+#include <sys/sendfile.h>
+#endif
+
+#if defined(ASYNC_USE_IO_URING)
+#include <sys/socket.h>
+#endif
+
+// bytes moved through the pipe by one `splice`
+#define ASYNC_SPLICE_SIZE 0x10000
+
 namespace slib
 {
 	
@@ -125,6 +141,37 @@ namespace slib
 					}
 				}
 				
+#if defined(SLIB_PLATFORM_IS_LINUX)
+				sl_bool isSupportedSendFile() override
+				{
+					return sl_true;
+				}
+
+				// returns the sent size, zero if the socket would block, or negative on error
+				sl_int64 sendFile(Socket* socket, AsyncStreamRequest* request)
+				{
+					Ref<File>& file = request->file;
+					off_t offset = (off_t)(request->offsetFile + m_sizeWritten);
+					for (;;) {
+						ssize_t n = ::sendfile((int)(socket->getHandle()), (int)(file->getHandle()), &offset, request->size - m_sizeWritten);
+						if (n > 0) {
+							return n;
+						}
+						if (!n) {
+							// the file is truncated
+							return -1;
+						}
+						int err = errno;
+						if (err == EAGAIN || err == EWOULDBLOCK) {
+							return 0;
+						}
+						if (err != EINTR) {
+							return -1;
+						}
+					}
+				}
+#endif
+
 				void processWrite(sl_bool flagError)
 				{
 					Ref<Socket> socket = m_socket;
@@ -149,6 +196,32 @@ namespace slib
 								return;
 							}
 						}
+#if defined(SLIB_PLATFORM_IS_LINUX)
+						if (request->file.isNotNull()) {
+							sl_int64 n = sendFile(socket.get(), request.get());
+							if (n > 0) {
+								m_sizeWritten += (sl_uint32)n;
+								if (m_sizeWritten >= request->size) {
+									_onSend(request.get(), request->size, flagError);
+								} else {
+									m_requestWriting = request;
+									return;
+								}
+							} else if (n < 0) {
+								_onSend(request.get(), m_sizeWritten, sl_true);
+								return;
+							} else {
+								if (flagError) {
+									_onSend(request.get(), m_sizeWritten, sl_true);
+								} else {
+									m_requestWriting = request;
+								}
+								return;
+							}
+							request.setNull();
+							continue;
+						}
+#endif
 						if (request->data && request->size) {
 							sl_uint32 size = request->size - m_sizeWritten;
 							sl_int32 n = socket->send((char*)(request->data) + m_sizeWritten, size);
@@ -157,7 +230,9 @@ namespace slib
 								if (m_sizeWritten >= request->size) {
 									_onSend(request.get(), request->size, flagError);
 								} else {
+									// the send buffer is full: the following requests must wait for the remaining data
 									m_requestWriting = request;
+									return;
 								}
 							} else if (n < 0) {
 								_onSend(request.get(), m_sizeWritten, sl_true);
@@ -234,6 +309,333 @@ namespace slib
 				}
 			};
 
+#if defined(ASYNC_USE_IO_URING)
+			class IoUringTcpSocketInstanceImpl;
+
+			class IoUringSocketOperation : public priv::async_io_uring::Operation
+			{
+			public:
+				WeakRef<IoUringTcpSocketInstanceImpl> instance;
+				Ref<AsyncStreamRequest> request;
+				Ref<Socket> socket;
+				Ref<Pipe> pipe;
+				sl_uint8 addr[128];
+
+			public:
+				void onComplete(sl_int32 result) override;
+
+			};
+
+			/*
+				Completion-based socket: receiving, sending and connecting are submitted to the io_uring of the loop.
+				The socket is not registered to epoll, and an operation in flight keeps the socket opened until its completion.
+			*/
+			class IoUringTcpSocketInstanceImpl : public AsyncTcpSocketInstance
+			{
+			public:
+				Ref<IoUringSocketOperation> m_opReading;
+				Ref<IoUringSocketOperation> m_opWriting;
+				Ref<IoUringSocketOperation> m_opConnecting;
+				sl_uint32 m_sizeWritten;
+
+				// sending a file: the file is spliced into the pipe, and then the pipe is spliced into the socket
+				Ref<Pipe> m_pipe;
+				sl_uint32 m_sizeInPipe;
+				sl_bool m_flagSplicingFile;
+
+			public:
+				IoUringTcpSocketInstanceImpl()
+				{
+					m_sizeWritten = 0;
+					m_sizeInPipe = 0;
+					m_flagSplicingFile = sl_false;
+				}
+
+				~IoUringTcpSocketInstanceImpl()
+				{
+					close();
+				}
+
+			public:
+				static Ref<IoUringTcpSocketInstanceImpl> create(const Ref<Socket>& socket)
+				{
+					if (socket.isNotNull()) {
+						// the ring waits on the socket, so the operations need not fail with EAGAIN
+						if (socket->setNonBlockingMode(sl_false)) {
+							sl_file handle = (sl_file)(socket->getHandle());
+							if (handle != SLIB_FILE_INVALID_HANDLE) {
+								Ref<IoUringTcpSocketInstanceImpl> ret = new IoUringTcpSocketInstanceImpl();
+								if (ret.isNotNull()) {
+									ret->m_socket = socket;
+									ret->setHandle(handle);
+									ret->setMode(AsyncIoMode::None);
+									return ret;
+								}
+							}
+						}
+					}
+					return sl_null;
+				}
+
+				void close() override
+				{
+					Ref<Socket> socket = m_socket;
+					if (socket.isNotNull()) {
+						// completes the pending operations
+						socket->shutdown(SocketShutdownMode::Both);
+					}
+					AsyncTcpSocketInstance::close();
+					setHandle(SLIB_FILE_INVALID_HANDLE);
+					m_socket.setNull();
+				}
+
+				priv::async_io_uring::IoUring* getRing()
+				{
+					Ref<AsyncIoLoop> loop = getLoop();
+					return priv::async_io_uring::GetIoUring(loop.get());
+				}
+
+				sl_bool isSupportedSendFile() override
+				{
+					priv::async_io_uring::IoUring* ring = getRing();
+					return ring && ring->isSupportingSplice();
+				}
+
+				// submits the next step of sending the file of the writing operation
+				sl_bool prepareSplice(priv::async_io_uring::IoUring* ring, IoUringSocketOperation* op)
+				{
+					AsyncStreamRequest* request = op->request.get();
+					if (m_sizeInPipe) {
+						m_flagSplicingFile = sl_false;
+						return ring->prepareSplice((int)(op->pipe->getReadHandle()), -1, (int)(op->socket->getHandle()), -1, m_sizeInPipe, op);
+					} else {
+						sl_uint32 size = request->size - m_sizeWritten;
+						if (size > ASYNC_SPLICE_SIZE) {
+							size = ASYNC_SPLICE_SIZE;
+						}
+						m_flagSplicingFile = sl_true;
+						return ring->prepareSplice((int)(request->file->getHandle()), (sl_int64)(request->offsetFile + m_sizeWritten), (int)(op->pipe->getWriteHandle()), -1, size, op);
+					}
+				}
+
+				Ref<IoUringSocketOperation> createOperation(const Ref<Socket>& socket, AsyncStreamRequest* request)
+				{
+					Ref<IoUringSocketOperation> op = new IoUringSocketOperation;
+					if (op.isNotNull()) {
+						op->instance = this;
+						op->request = request;
+						op->socket = socket;
+					}
+					return op;
+				}
+
+				void processRead()
+				{
+					if (m_opReading.isNotNull() || m_opConnecting.isNotNull()) {
+						return;
+					}
+					Ref<Socket> socket = m_socket;
+					if (socket.isNull()) {
+						return;
+					}
+					priv::async_io_uring::IoUring* ring = getRing();
+					if (!ring) {
+						return;
+					}
+					for (;;) {
+						Ref<AsyncStreamRequest> request;
+						if (!(popReadRequest(request))) {
+							return;
+						}
+						if (request.isNull()) {
+							return;
+						}
+						if (request->data && request->size) {
+							Ref<IoUringSocketOperation> op = createOperation(socket, request.get());
+							if (op.isNotNull() && ring->prepareRecv((int)(socket->getHandle()), request->data, request->size, op.get())) {
+								m_opReading = op;
+							} else {
+								_onReceive(request.get(), 0, sl_true);
+							}
+							return;
+						} else {
+							_onReceive(request.get(), request->size, sl_false);
+						}
+					}
+				}
+
+				void processWrite()
+				{
+					if (m_opConnecting.isNotNull()) {
+						return;
+					}
+					Ref<Socket> socket = m_socket;
+					if (socket.isNull()) {
+						return;
+					}
+					priv::async_io_uring::IoUring* ring = getRing();
+					if (!ring) {
+						return;
+					}
+					if (m_opWriting.isNotNull()) {
+						return;
+					}
+					for (;;) {
+						Ref<AsyncStreamRequest> request;
+						if (!(popWriteRequest(request))) {
+							return;
+						}
+						if (request.isNull()) {
+							return;
+						}
+						if (request->file.isNotNull()) {
+							m_sizeWritten = 0;
+							m_sizeInPipe = 0;
+							if (m_pipe.isNull()) {
+								m_pipe = Pipe::create();
+							}
+							Ref<IoUringSocketOperation> op = createOperation(socket, request.get());
+							if (op.isNotNull() && m_pipe.isNotNull()) {
+								op->pipe = m_pipe;
+								if (prepareSplice(ring, op.get())) {
+									m_opWriting = op;
+									return;
+								}
+							}
+							_onSend(request.get(), 0, sl_true);
+							return;
+						}
+						if (request->data && request->size) {
+							m_sizeWritten = 0;
+							Ref<IoUringSocketOperation> op = createOperation(socket, request.get());
+							if (op.isNotNull() && ring->prepareSend((int)(socket->getHandle()), request->data, request->size, op.get())) {
+								m_opWriting = op;
+							} else {
+								_onSend(request.get(), 0, sl_true);
+							}
+							return;
+						} else {
+							_onSend(request.get(), request->size, sl_false);
+						}
+					}
+				}
+
+				void onOrder() override
+				{
+					Ref<Socket> socket = m_socket;
+					if (socket.isNull()) {
+						return;
+					}
+					if (m_opConnecting.isNotNull()) {
+						return;
+					}
+					if (m_flagRequestConnect) {
+						m_flagRequestConnect = sl_false;
+						priv::async_io_uring::IoUring* ring = getRing();
+						Ref<IoUringSocketOperation> op = createOperation(socket, sl_null);
+						if (ring && op.isNotNull()) {
+							sl_uint32 sizeAddr = m_addressRequestConnect.getSystemSocketAddress(op->addr);
+							if (sizeAddr) {
+								if (ring->prepareConnect((int)(socket->getHandle()), op->addr, sizeAddr, op.get())) {
+									m_opConnecting = op;
+									return;
+								}
+							}
+						}
+						_onConnect(sl_true);
+						return;
+					}
+					processRead();
+					processWrite();
+				}
+
+				void onEvent(EventDesc* pev) override
+				{
+				}
+
+				void onComplete(IoUringSocketOperation* op, sl_int32 result)
+				{
+					if (op == m_opConnecting.get()) {
+						m_opConnecting.setNull();
+						_onConnect(result != 0);
+					} else if (op == m_opReading.get()) {
+						Ref<IoUringSocketOperation> ref = m_opReading;
+						m_opReading.setNull();
+						if (result > 0) {
+							_onReceive(op->request.get(), (sl_uint32)result, sl_false);
+						} else {
+							// zero: closed by the peer
+							_onReceive(op->request.get(), 0, sl_true);
+						}
+					} else if (op == m_opWriting.get() && op->pipe.isNotNull()) {
+						Ref<IoUringSocketOperation> ref = m_opWriting;
+						AsyncStreamRequest* request = op->request.get();
+						sl_bool flagError = sl_false;
+						if (result > 0) {
+							if (m_flagSplicingFile) {
+								m_sizeInPipe = (sl_uint32)result;
+							} else {
+								m_sizeInPipe -= (sl_uint32)result;
+								m_sizeWritten += (sl_uint32)result;
+							}
+						} else if (result != -EAGAIN && result != -EINTR) {
+							// zero: the file is truncated
+							flagError = sl_true;
+						}
+						if (!flagError && m_sizeWritten >= request->size) {
+							m_opWriting.setNull();
+							_onSend(request, request->size, sl_false);
+						} else {
+							priv::async_io_uring::IoUring* ring = getRing();
+							if (flagError || !ring || !(prepareSplice(ring, op))) {
+								m_opWriting.setNull();
+								if (m_sizeInPipe) {
+									// the pipe can not be reused with the remaining data
+									m_pipe.setNull();
+									m_sizeInPipe = 0;
+								}
+								_onSend(request, m_sizeWritten, sl_true);
+							}
+						}
+					} else if (op == m_opWriting.get()) {
+						Ref<IoUringSocketOperation> ref = m_opWriting;
+						AsyncStreamRequest* request = op->request.get();
+						if (result > 0) {
+							m_sizeWritten += result;
+						}
+						if (m_sizeWritten >= request->size) {
+							m_opWriting.setNull();
+							_onSend(request, request->size, sl_false);
+						} else if (result > 0 || result == -EAGAIN || result == -EINTR) {
+							// sends the remaining data
+							priv::async_io_uring::IoUring* ring = getRing();
+							if (!ring || !(ring->prepareSend((int)(op->socket->getHandle()), (char*)(request->data) + m_sizeWritten, request->size - m_sizeWritten, op))) {
+								m_opWriting.setNull();
+								_onSend(request, m_sizeWritten, sl_true);
+							}
+						} else {
+							m_opWriting.setNull();
+							_onSend(request, m_sizeWritten, sl_true);
+						}
+					} else {
+						return;
+					}
+					if (isOpened() && !(isClosing())) {
+						onOrder();
+					}
+				}
+
+			};
+
+			void IoUringSocketOperation::onComplete(sl_int32 result)
+			{
+				Ref<IoUringTcpSocketInstanceImpl> _instance(instance);
+				if (_instance.isNotNull()) {
+					_instance->onComplete(this, result);
+				}
+			}
+#endif
+
 			class AsyncTcpServerInstanceImpl : public AsyncTcpServerInstance
 			{
 			public:
@@ -393,8 +795,14 @@ namespace slib
 		}
 	}
 
-	Ref<AsyncTcpSocketInstance> AsyncTcpSocket::_createInstance(const Ref<Socket>& socket)
+	Ref<AsyncTcpSocketInstance> AsyncTcpSocket::_createInstance(const Ref<Socket>& socket, const Ref<AsyncIoLoop>& loop)
 	{
+#if defined(ASYNC_USE_IO_URING)
+		priv::async_io_uring::IoUring* ring = priv::async_io_uring::GetIoUring(loop.get());
+		if (ring && ring->isSupportingSocket()) {
+			return priv::network_async::IoUringTcpSocketInstanceImpl::create(socket);
+		}
+#endif
 		return priv::network_async::AsyncTcpSocketInstanceImpl::create(socket);
 	}
 
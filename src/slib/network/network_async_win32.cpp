@@ -588,7 +588,7 @@ namespace slib
 		}
 	}
 
-	Ref<AsyncTcpSocketInstance> AsyncTcpSocket::_createInstance(const Ref<Socket>& socket)
+	Ref<AsyncTcpSocketInstance> AsyncTcpSocket::_createInstance(const Ref<Socket>& socket, const Ref<AsyncIoLoop>& loop)
 	{
 		return priv::network_async::AsyncTcpSocketInstanceImpl::create(socket);
 	}
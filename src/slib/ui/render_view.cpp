@@ -69,14 +69,14 @@ namespace slib
 				WeakRef<RenderView> m_view;
 				
 			public:
-				sl_bool dispatch(const Function<void()>& callback, sl_uint64 delay_ms) override
+				sl_bool dispatch(UniqueFunction<void()>&& task, sl_uint64 delay_ms) override
 				{
 					Ref<RenderView> view(m_view);
 					if (view.isNotNull()) {
 						if (delay_ms > 0x7fffffff) {
 							delay_ms = 0x7fffffff;
 						}
-						view->dispatchToDrawingThread(callback, (sl_uint32)delay_ms);
+						view->dispatchToDrawingThread(task.release(), (sl_uint32)delay_ms);
 						return sl_true;
 					}
 					return sl_false;
@@ -88,12 +88,12 @@ namespace slib
 			class DispatcherImpl : public Dispatcher
 			{
 			public:
-				sl_bool dispatch(const Function<void()>& callback, sl_uint64 delay_ms) override
+				sl_bool dispatch(UniqueFunction<void()>&& task, sl_uint64 delay_ms) override
 				{
 					if (delay_ms > 0x7fffffff) {
 						delay_ms = 0x7fffffff;
 					}
-					UI::dispatchToUiThread(callback, (sl_uint32)delay_ms);
+					UI::dispatchToUiThread(task.release(), (sl_uint32)delay_ms);
 					return sl_true;
 				}
 			};